@@ -31,6 +31,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <arpa/inet.h>
 
 #ifdef HAVE_LIBZ
 #include "zlib.h"
@@ -39,6 +40,7 @@
 #include "getopt_long.h"
 #include "receivelog.h"
 #include "streamutil.h"
+#include "replication/walcompress.h"
 #include "bin/elog.h"
 
 /* Global options */
@@ -52,6 +54,13 @@ int compresslevel = 0;
 bool includewal = true;
 bool streamwal = true;
 bool fastcheckpoint = false;
+/* start location of the previous backup, for an incremental backup */
+char *incremental_lsn = NULL;
+/* number of connections the backup is received over */
+#define MAX_BACKUP_JOBS 64
+int jobs = 1;
+/* compression method of the backup stream, NULL if not compressed */
+char *stream_compression = NULL;
 
 extern char **tblspaceDirectory;
 extern int tblspaceCount;
@@ -71,6 +80,15 @@ static int bgpipe[2] = {-1, -1};
 /* Handle to child process */
 static pid_t bgchild = -1;
 
+/* Handles to the processes receiving the files sent by the workers of a parallel backup */
+static pid_t *workerchildren = NULL;
+static int workerchildcount = 0;
+
+/* Decompression of the backup stream, the history covers the stream of this process only */
+static WalStreamDecompressor *stream_decompressor = NULL;
+static char *decompress_buf = NULL;
+static uint32 decompress_buf_size = 0;
+
 /* End position for xlog streaming, empty string if unknown yet */
 static XLogRecPtr xlogendptr;
 
@@ -123,6 +141,11 @@ static void usage(void)
     printf(_("\nGeneral options:\n"));
     printf(_("  -c, --checkpoint=fast|spread\n"
         "                         set fast or spread checkpointing\n"));
+    printf(_("  -C, --stream-compression=METHOD\n"
+        "                         compress the backup stream with METHOD (lz4)\n"));
+    printf(_("  -i, --incremental=LSN  send only the blocks changed since LSN, the start location\n"
+        "                         of the previous backup\n"));
+    printf(_("  -j, --jobs=NUM         receive the backup over NUM connections in parallel\n"));
     printf(_("  -l, --label=LABEL      set backup label\n"));
     printf(_("  -P, --progress         show progress information\n"));
     printf(_("  -v, --verbose          output verbose messages\n"));
@@ -481,6 +504,57 @@ static void writeGzFile(gzFile ztarfile, char *copybuf, int buf_size, char *file
 #endif
 
 
+/*
+ * Get the next CopyData message of the backup stream like PQgetCopyData(), decompressing it
+ * if the stream is compressed. The data is released with free_backup_copy_data().
+ */
+static int get_backup_copy_data(PGconn *copyconn, char **buffer)
+{
+    uint32 rawLen;
+    int ret;
+    int r = PQgetCopyData(copyconn, buffer, 0);
+    errno_t errorno = EOK;
+
+    if (r < 0 || stream_decompressor == NULL)
+        return r;
+
+    if (r < (int)sizeof(uint32)) {
+        fprintf(stderr, _("%s: compressed backup message too small: %d\n"), progname, r);
+        return -2;
+    }
+    errorno = memcpy_s(&rawLen, sizeof(uint32), *buffer, sizeof(uint32));
+    securec_check_c(errorno, "\0", "\0");
+    rawLen = ntohl(rawLen);
+    if (rawLen == 0 || rawLen > (uint32)PG_INT32_MAX) {
+        fprintf(stderr, _("%s: invalid compressed backup message length: %u\n"), progname, rawLen);
+        return -2;
+    }
+
+    if (decompress_buf_size < rawLen) {
+        GS_FREE(decompress_buf);
+        decompress_buf = (char *)xmalloc0(rawLen);
+        decompress_buf_size = rawLen;
+    }
+
+    ret = WalStreamDecompress(
+        stream_decompressor, *buffer + sizeof(uint32), r - (int)sizeof(uint32), decompress_buf, (int)rawLen);
+    PQfreemem(*buffer);
+    *buffer = NULL;
+    if (ret != (int)rawLen) {
+        fprintf(stderr, _("%s: could not decompress backup data\n"), progname);
+        return -2;
+    }
+
+    *buffer = decompress_buf;
+    return ret;
+}
+
+static void free_backup_copy_data(char *buffer)
+{
+    if (buffer != decompress_buf)
+        PQfreemem(buffer);
+}
+
 /*
  * Receive a tar format file from the connection to the server, and write
  * the data from this file directly into a tar file. If compression is
@@ -608,11 +682,11 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 
     while (true) {
         if (copybuf != NULL) {
-            PQfreemem(copybuf);
+            free_backup_copy_data(copybuf);
             copybuf = NULL;
         }
 
-        int r = PQgetCopyData(conn, &copybuf, 0);
+        int r = get_backup_copy_data(conn, &copybuf);
         if (r == -1) {
             /*
              * End of chunk. Close file (but not stdout).
@@ -682,7 +756,7 @@ static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
     } /* while (1) */
 
     if (copybuf != NULL) {
-        PQfreemem(copybuf);
+        free_backup_copy_data(copybuf);
         copybuf = NULL;
     }
 
@@ -723,24 +797,10 @@ static bool IsXlogDir(const char* filename)
 }
 
 /*
- * Receive a tar format stream from the connection to the server, and unpack
- * the contents of it into a directory. Only files, directories and
- * symlinks are supported, no other kinds of special files.
- *
- * If the data is for the main data directory, it will be restored in the
- * specified directory. If it's for another tablespace, it will be restored
- * in the original directory, since relocation of tablespaces is not
- * supported.
+ * Get the directory the tablespace described by the header row is restored in.
  */
-static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
+static void get_tablespace_restore_path(PGresult *res, int rownum, char *current_path)
 {
-    char current_path[MAXPGPATH] = {0};
-    char filename[MAXPGPATH] = {0};
-    char absolut_path[MAXPGPATH] = {0};
-    uint64 current_len_left = 0;
-    uint64 current_padding = 0;
-    char *copybuf = NULL;
-    FILE *file = NULL;
     char *get_value = NULL;
     errno_t errorno = EOK;
 
@@ -764,6 +824,30 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
         }
         current_path[MAXPGPATH - 1] = '\0';
     }
+}
+
+/*
+ * Receive a tar format stream from the connection to the server, and unpack
+ * the contents of it into a directory. Only files, directories and
+ * symlinks are supported, no other kinds of special files.
+ *
+ * If the data is for the main data directory, it will be restored in the
+ * specified directory. If it's for another tablespace, it will be restored
+ * in the original directory, since relocation of tablespaces is not
+ * supported.
+ */
+static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
+{
+    char current_path[MAXPGPATH] = {0};
+    char filename[MAXPGPATH] = {0};
+    char absolut_path[MAXPGPATH] = {0};
+    uint64 current_len_left = 0;
+    uint64 current_padding = 0;
+    char *copybuf = NULL;
+    FILE *file = NULL;
+    errno_t errorno = EOK;
+
+    get_tablespace_restore_path(res, rownum, current_path);
 
     /*
      * Get the COPY data
@@ -774,11 +858,11 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
         int r;
 
         if (copybuf != NULL) {
-            PQfreemem(copybuf);
+            free_backup_copy_data(copybuf);
             copybuf = NULL;
         }
 
-        r = PQgetCopyData(conn, &copybuf, 0);
+        r = get_backup_copy_data(conn, &copybuf);
         if (r == -1) {
             /*
              * End of chunk
@@ -848,10 +932,11 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
                     if (mkdir(filename, S_IRWXU) != 0) {
                         /*
                          * When streaming WAL, pg_xlog will have been created
-                         * by the wal receiver process, so just ignore failure
-                         * on that.
+                         * by the wal receiver process, and the processes
+                         * receiving the files of a parallel backup create the
+                         * directories they need, so just ignore failure on that.
                          */
-                        if (!IsXlogDir(filename)) {
+                        if (!IsXlogDir(filename) && !(workerchildcount > 0 && errno == EEXIST)) {
                             fprintf(stderr, _("%s: could not create directory \"%s\": %s\n"), progname, filename,
                                 strerror(errno));
                             disconnect_and_exit(1);
@@ -972,11 +1057,251 @@ static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
     }
 
     if (copybuf != NULL) {
-        PQfreemem(copybuf);
+        free_backup_copy_data(copybuf);
+        copybuf = NULL;
+    }
+}
+
+/*
+ * Get the path a file sent by a worker of a parallel backup is restored at. The files of
+ * the tablespaces other than the data directory are named pg_tblspc/<oid>/...
+ */
+static void get_parallel_file_path(PGresult *header, const char *tarname, char *filename)
+{
+    char current_path[MAXPGPATH] = {0};
+    const char *relname = tarname;
+    const char *prefix = "pg_tblspc/";
+    errno_t errorno = EOK;
+
+    errorno = strncpy_s(current_path, MAXPGPATH, basedir, strlen(basedir));
+    securec_check_c(errorno, "", "");
+
+    if (strncmp(tarname, prefix, strlen(prefix)) == 0) {
+        const char *oid = tarname + strlen(prefix);
+        const char *slash = strchr(oid, '/');
+
+        for (int i = 0; slash != NULL && i < PQntuples(header); i++) {
+            char *spcoid = PQgetvalue(header, i, 0);
+            if (!PQgetisnull(header, i, 0) && strlen(spcoid) == (size_t)(slash - oid) &&
+                strncmp(spcoid, oid, slash - oid) == 0) {
+                get_tablespace_restore_path(header, i, current_path);
+                relname = slash + 1;
+                break;
+            }
+        }
+        if (relname == tarname) {
+            fprintf(stderr, _("%s: unknown tablespace of parallel backup file \"%s\"\n"), progname, tarname);
+            disconnect_and_exit(1);
+        }
+    }
+
+    errorno = snprintf_s(filename, MAXPGPATH, MAXPGPATH - 1, "%s/%s", current_path, relname);
+    securec_check_ss_c(errorno, "", "");
+    canonicalize_path(filename);
+}
+
+/*
+ * Receive the files sent by a worker of a parallel backup, and write them into
+ * their tablespace. The worker only sends regular files, their directories are
+ * created here if the stream of the leader has not reached them yet.
+ */
+static void ReceiveParallelFiles(PGconn *conn, PGresult *header)
+{
+    char filename[MAXPGPATH] = {0};
+    char parentdir[MAXPGPATH] = {0};
+    uint64 current_len_left = 0;
+    uint64 current_padding = 0;
+    char *copybuf = NULL;
+    FILE *file = NULL;
+    errno_t errorno = EOK;
+
+    PQclear(backup_get_result(conn));
+
+    while (1) {
+        int r;
+
+        if (copybuf != NULL) {
+            free_backup_copy_data(copybuf);
+            copybuf = NULL;
+        }
+
+        r = get_backup_copy_data(conn, &copybuf);
+        if (r == -1) {
+            break;
+        } else if (r == -2) {
+            fprintf(stderr, _("%s: could not read COPY data: %s"), progname, PQerrorMessage(conn));
+            disconnect_and_exit(1);
+        }
+
+        if (file == NULL) {
+            int filemode;
+
+            if (r != 2560) {
+                fprintf(stderr, _("%s: invalid tar block header size: %d\n"), progname, r);
+                disconnect_and_exit(1);
+            }
+            if (sscanf_s(copybuf + 1048, "%201o", &current_len_left) != 1) {
+                fprintf(stderr, _("%s: could not parse file size\n"), progname);
+                disconnect_and_exit(1);
+            }
+            if (sscanf_s(&copybuf[1024], "%07o ", (unsigned int *)&filemode) != 1) {
+                fprintf(stderr, _("%s: could not parse file mode\n"), progname);
+                disconnect_and_exit(1);
+            }
+            current_padding = ((current_len_left + 511) & ~511) - current_len_left;
+
+            if (check_input_path_relative_path(copybuf)) {
+                fprintf(stderr, _("%s: the copybuf file path including .. is unallowed\n"), progname);
+                disconnect_and_exit(1);
+            }
+            get_parallel_file_path(header, copybuf, filename);
+
+            file = fopen(filename, "wb");
+            if (file == NULL && errno == ENOENT) {
+                errorno = strncpy_s(parentdir, MAXPGPATH, filename, strlen(filename));
+                securec_check_c(errorno, "", "");
+                get_parent_directory(parentdir);
+                if (pg_mkdir_p(parentdir, S_IRWXU) != 0 && errno != EEXIST) {
+                    fprintf(stderr, _("%s: could not create directory \"%s\": %s\n"), progname, parentdir,
+                        strerror(errno));
+                    disconnect_and_exit(1);
+                }
+                file = fopen(filename, "wb");
+            }
+            if (file == NULL) {
+                fprintf(stderr, _("%s: could not create file \"%s\": %s\n"), progname, filename, strerror(errno));
+                disconnect_and_exit(1);
+            }
+            if (chmod(filename, (mode_t)filemode))
+                fprintf(stderr, _("%s: could not set permissions on file \"%s\": %s\n"), progname, filename,
+                    strerror(errno));
+
+            if (current_len_left == 0) {
+                fclose(file);
+                file = NULL;
+            }
+            continue;
+        }
+
+        if (current_len_left == 0 && (uint64)r == current_padding) {
+            /* the padding block of the file */
+            fclose(file);
+            file = NULL;
+            continue;
+        }
+
+        if (fwrite(copybuf, r, 1, file) != 1) {
+            fprintf(stderr, _("%s: could not write to file \"%s\": %s\n"), progname, filename, strerror(errno));
+            fclose(file);
+            file = NULL;
+            disconnect_and_exit(1);
+        }
+        current_len_left -= r;
+        if (current_len_left == 0 && current_padding == 0) {
+            fclose(file);
+            file = NULL;
+        }
+    }
+
+    if (file != NULL) {
+        fprintf(stderr, _("%s: COPY stream ended before last file was finished\n"), progname);
+        fclose(file);
+        file = NULL;
+        disconnect_and_exit(1);
+    }
+
+    if (copybuf != NULL) {
+        free_backup_copy_data(copybuf);
         copybuf = NULL;
     }
 }
 
+/*
+ * Whether BASE_BACKUP failed because the server does not know its COMPRESSION option,
+ * or the method given with it.
+ */
+static bool CompressionRejected(PGresult *res)
+{
+    const char *sqlstate = NULL;
+
+    if (PQresultStatus(res) != PGRES_FATAL_ERROR)
+        return false;
+    sqlstate = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+    return sqlstate != NULL && (strcmp(sqlstate, "42601") == 0 || strcmp(sqlstate, "0A000") == 0);
+}
+
+/*
+ * Fork the processes receiving the files sent by the workers of a parallel backup,
+ * each over a connection of its own. The tablespace header must be known by then,
+ * so that the files can be restored in their tablespace.
+ */
+static void StartParallelWorkers(const char *backupid, PGresult *header)
+{
+    char command[MAXPGPATH] = {0};
+    PGresult *res = NULL;
+    errno_t rc = EOK;
+
+    rc = snprintf_s(command, sizeof(command), sizeof(command) - 1, "BASE_BACKUP WORKER '%s' %s%s", backupid,
+        stream_compression != NULL ? "COMPRESSION " : "", stream_compression != NULL ? stream_compression : "");
+    securec_check_ss_c(rc, "", "");
+
+    workerchildren = (pid_t *)xmalloc0(sizeof(pid_t) * (jobs - 1));
+    for (int i = 0; i < jobs - 1; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            /* the connection of the leader belongs to the parent, leave it alone */
+            conn = GetConnection();
+            if (conn == NULL) {
+                /* Error message already written in GetConnection() */
+                exit(1);
+            }
+            if (PQsendQuery(conn, command) == 0) {
+                fprintf(stderr, _("%s: could not send replication command \"%s\": %s"), progname, "BASE_BACKUP",
+                    PQerrorMessage(conn));
+                disconnect_and_exit(1);
+            }
+            if (stream_decompressor != NULL)
+                WalStreamDecompressorReset(stream_decompressor);
+
+            ReceiveParallelFiles(conn, header);
+
+            res = PQgetResult(conn);
+            if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+                fprintf(stderr, _("%s: final receive failed: %s"), progname, PQerrorMessage(conn));
+                disconnect_and_exit(1);
+            }
+            PQclear(res);
+            PQfinish(conn);
+            exit(0);
+        } else if (pid < 0) {
+            fprintf(stderr, _("%s: could not create background process: %s\n"), progname, strerror(errno));
+            disconnect_and_exit(1);
+        }
+        workerchildren[workerchildcount++] = pid;
+    }
+
+    if (verbose)
+        fprintf(stderr, _("%s: receiving the backup over %d connections\n"), progname, jobs);
+}
+
+static void WaitParallelWorkers(void)
+{
+    for (int i = 0; i < workerchildcount; i++) {
+        int status;
+
+        if (waitpid(workerchildren[i], &status, 0) == -1) {
+            fprintf(stderr, _("%s: could not wait for child process: %s\n"), progname, strerror(errno));
+            disconnect_and_exit(1);
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, _("%s: parallel backup process %d failed\n"), progname, (int)workerchildren[i]);
+            disconnect_and_exit(1);
+        }
+    }
+    workerchildcount = 0;
+    GS_FREE(workerchildren);
+}
+
 static void BaseBackup(void)
 {
     PGresult *res = NULL;
@@ -988,6 +1313,7 @@ static void BaseBackup(void)
     int i = 0;
     char xlogstart[64];
     char xlogend[64];
+    char backupid[64] = {0};
     errno_t rc = EOK;
     char *get_value = NULL;
 
@@ -1026,21 +1352,47 @@ static void BaseBackup(void)
      * Start the actual backup
      */
     PQescapeStringConn(conn, escaped_label, label, sizeof(escaped_label), &i);
-    rc = snprintf_s(current_path, sizeof(current_path), sizeof(current_path) - 1, "BASE_BACKUP LABEL '%s' %s %s %s %s",
-        escaped_label, showprogress ? "PROGRESS" : "", includewal && !streamwal ? "WAL" : "",
-        fastcheckpoint ? "FAST" : "", includewal ? "NOWAIT" : "");
-    securec_check_ss_c(rc, "", "");
+    for (;;) {
+        rc = snprintf_s(current_path, sizeof(current_path), sizeof(current_path) - 1,
+            "BASE_BACKUP LABEL '%s' %s %s %s %s %s%s%s %s %s%s", escaped_label, showprogress ? "PROGRESS" : "",
+            includewal && !streamwal ? "WAL" : "", fastcheckpoint ? "FAST" : "", includewal ? "NOWAIT" : "",
+            incremental_lsn != NULL ? "INCREMENTAL '" : "", incremental_lsn != NULL ? incremental_lsn : "",
+            incremental_lsn != NULL ? "'" : "", jobs > 1 ? "PARALLEL" : "",
+            stream_compression != NULL ? "COMPRESSION " : "", stream_compression != NULL ? stream_compression : "");
+        securec_check_ss_c(rc, "", "");
+
+        if (PQsendQuery(conn, current_path) == 0) {
+            fprintf(stderr, _("%s: could not send replication command \"%s\": %s"), progname, "BASE_BACKUP",
+                PQerrorMessage(conn));
+            free(sysidentifier);
+            disconnect_and_exit(1);
+        }
+        /*
+         * get the xlog location
+         */
+        res = PQgetResult(conn);
+        if (stream_compression == NULL || !CompressionRejected(res))
+            break;
 
-    if (PQsendQuery(conn, current_path) == 0) {
-        fprintf(stderr, _("%s: could not send replication command \"%s\": %s"), progname, "BASE_BACKUP",
-            PQerrorMessage(conn));
-        free(sysidentifier);
-        disconnect_and_exit(1);
+        /* a server of an older version, or without the method, sends the backup uncompressed */
+        fprintf(stderr, _("%s: server does not support stream compression %s, continuing without it: %s"), progname,
+            stream_compression, PQerrorMessage(conn));
+        do {
+            PQclear(res);
+        } while ((res = PQgetResult(conn)) != NULL);
+        GS_FREE(stream_compression);
+
+        /* the walsender may have given up the connection on the error */
+        if (PQstatus(conn) != CONNECTION_OK) {
+            PQfinish(conn);
+            conn = GetConnection();
+            if (conn == NULL) {
+                /* Error message already written in GetConnection() */
+                free(sysidentifier);
+                exit(1);
+            }
+        }
     }
-    /*
-     * get the xlog location
-     */
-    res = PQgetResult(conn);
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         fprintf(stderr, _("could not get xlog location: %s"), PQerrorMessage(conn));
         free(sysidentifier);
@@ -1081,6 +1433,27 @@ static void BaseBackup(void)
         fprintf(stderr, "transaction log start point: %s\n", xlogstart);
     PQclear(res);
 
+    /*
+     * Get the id the workers of a parallel backup attach with, 0 if the server
+     * sends the backup over this connection only
+     */
+    if (jobs > 1) {
+        res = PQgetResult(conn);
+        if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) != 1) {
+            fprintf(stderr, _("%s: could not get parallel backup id: %s"), progname, PQerrorMessage(conn));
+            free(sysidentifier);
+            disconnect_and_exit(1);
+        }
+        rc = strncpy_s(backupid, sizeof(backupid), PQgetvalue(res, 0, 0), sizeof(backupid) - 1);
+        securec_check_c(rc, "", "");
+        PQclear(res);
+    }
+
+    if (stream_compression != NULL) {
+        stream_decompressor = (WalStreamDecompressor *)xmalloc0(sizeof(WalStreamDecompressor));
+        WalStreamDecompressorReset(stream_decompressor);
+    }
+
     rc = memset_s(xlogend, sizeof(xlogend), 0, sizeof(xlogend));
     securec_check_c(rc, "", "");
 
@@ -1165,6 +1538,10 @@ static void BaseBackup(void)
         StartLogStreamer((const char *)xlogstart, timeline, sysidentifier);
     }
 
+    if (jobs > 1 && strcmp(backupid, "0") != 0) {
+        StartParallelWorkers(backupid, res);
+    }
+
     /*
      * Start receiving chunks
      */
@@ -1175,6 +1552,9 @@ static void BaseBackup(void)
             ReceiveAndUnpackTarFile(conn, res, i);
     } /* Loop over all tablespaces */
 
+    /* the server sends the end of the leader's stream only after the workers are done */
+    WaitParallelWorkers();
+
     if (showprogress) {
         progress_report(PQntuples(res), NULL);
         fprintf(stderr, "\n"); /* Need to move to next line */
@@ -1396,6 +1776,9 @@ int main(int argc, char **argv)
                                            {"gzip", no_argument, NULL, 'z'},
                                            {"compress", required_argument, NULL, 'Z'},
                                            {"label", required_argument, NULL, 'l'},
+                                           {"incremental", required_argument, NULL, 'i'},
+                                           {"jobs", required_argument, NULL, 'j'},
+                                           {"stream-compression", required_argument, NULL, 'C'},
                                            {"host", required_argument, NULL, 'h'},
                                            {"port", required_argument, NULL, 'p'},
                                            {"username", required_argument, NULL, 'U'},
@@ -1422,7 +1805,7 @@ int main(int argc, char **argv)
         }
     }
 
-    while ((c = getopt_long(argc, argv, "D:l:c:h:p:U:s:wWvP", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "D:l:i:j:C:c:h:p:U:s:wWvP", long_options, &option_index)) != -1) {
         switch (c) {
             case 'D': {
                 GS_FREE(basedir);
@@ -1453,6 +1836,37 @@ int main(int argc, char **argv)
                 check_env_value_c(optarg);
                 label = xstrdup(optarg);
                 break;
+            case 'i': {
+                uint32 hi = 0;
+                uint32 lo = 0;
+
+                GS_FREE(incremental_lsn);
+                check_env_value_c(optarg);
+                if (sscanf_s(optarg, "%X/%X", &hi, &lo) != 2 || (hi == 0 && lo == 0)) {
+                    fprintf(stderr, _("%s: invalid incremental start location \"%s\"\n"), progname, optarg);
+                    exit(1);
+                }
+                incremental_lsn = xstrdup(optarg);
+                break;
+            }
+            case 'j':
+                check_env_value_c(optarg);
+                jobs = atoi(optarg);
+                if (jobs <= 0 || jobs > MAX_BACKUP_JOBS) {
+                    fprintf(stderr, _("%s: invalid number of parallel jobs \"%s\", must be between 1 and %d\n"),
+                        progname, optarg, MAX_BACKUP_JOBS);
+                    exit(1);
+                }
+                break;
+            case 'C':
+                GS_FREE(stream_compression);
+                check_env_value_c(optarg);
+                if (!WalStreamCompressionIsSupported(optarg)) {
+                    fprintf(stderr, _("%s: invalid stream compression method \"%s\"\n"), progname, optarg);
+                    exit(1);
+                }
+                stream_compression = xstrdup(optarg);
+                break;
             case 'z':
 #ifdef HAVE_LIBZ
                 compresslevel = Z_DEFAULT_COMPRESSION;
@@ -1551,6 +1965,18 @@ int main(int argc, char **argv)
         exit(1);
     }
 
+    if (jobs > 1 && format != 'p') {
+        fprintf(stderr, _("%s: only plain mode backups can be received in parallel\n"), progname);
+        fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+        exit(1);
+    }
+
+    if (jobs > 1 && incremental_lsn != NULL) {
+        fprintf(stderr, _("%s: an incremental backup cannot be received in parallel\n"), progname);
+        fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+        exit(1);
+    }
+
     if (format != 'p' && streamwal) {
         fprintf(stderr, _("%s: wal streaming can only be used in plain mode\n"), progname);
         fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
@@ -1588,4 +2014,8 @@ static void free_basebackup()
     GS_FREE(dbhost);
     GS_FREE(dbport);
     GS_FREE(dbuser);
+    GS_FREE(incremental_lsn);
+    GS_FREE(stream_compression);
+    GS_FREE(stream_decompressor);
+    GS_FREE(decompress_buf);
 }
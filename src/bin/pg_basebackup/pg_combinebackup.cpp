@@ -0,0 +1,482 @@
+/* ---------------------------------------------------------------------------------------
+ *
+ * pg_combinebackup.cpp
+ *    reconstruct a full data directory from a base backup and the incremental
+ *    backups taken after it
+ *
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * IDENTIFICATION
+ *    src/bin/pg_basebackup/pg_combinebackup.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#define FRONTEND 1
+
+#include "postgres.h"
+#include "knl/knl_variable.h"
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "getopt_long.h"
+#include "streamutil.h"
+#include "replication/incrbackup.h"
+#include "bin/elog.h"
+
+/* one backup of the chain the blocks of a file are looked up in, newest first */
+typedef struct BlockSource {
+    int fd;
+    bool incremental;
+    IncrementalFileHeader header; /* only if incremental */
+    BlockNumber* blocks;          /* only if incremental */
+    BlockNumber fileBlocks;       /* only if not incremental */
+} BlockSource;
+
+static char* output_dir = NULL;
+static char** backup_dirs = NULL;
+static int backup_count = 0;
+static bool verbose = false;
+
+static void usage(void)
+{
+    printf(_("%s reconstructs a full data directory from a base backup and the incremental\n"
+             "base backups taken after it.\n\n"), progname);
+    printf(_("Usage:\n"));
+    printf(_("  %s [OPTION]... BACKUPDIR...\n"), progname);
+    printf(_("\nThe backup directories are given from the oldest, which must be a full backup, to the newest.\n"));
+    printf(_("\nOptions:\n"));
+    printf(_("  -o, --output=DIRECTORY write the reconstructed data directory into DIRECTORY\n"));
+    printf(_("  -v, --verbose          output verbose messages\n"));
+    printf(_("  -V, --version          output version information, then exit\n"));
+    printf(_("  -?, --help             show this help, then exit\n"));
+}
+
+static char* join_path(const char* dir, const char* name)
+{
+    size_t len = strlen(dir) + strlen(name) + 2;
+    char* path = (char*)xmalloc0(len);
+    int rc = snprintf_s(path, len, len - 1, "%s%s%s", dir, (dir[0] == '\0') ? "" : "/", name);
+    securec_check_ss_c(rc, "", "");
+    return path;
+}
+
+/*
+ * Read a line of the form "<prefix>%X/%X" from a label file of a backup. Returns false if the
+ * file doesn't exist.
+ */
+static bool read_label_lsn(const char* backupdir, const char* filename, const char* prefix, XLogRecPtr* lsn)
+{
+    char* path = join_path(backupdir, filename);
+    char line[MAXPGPATH];
+    bool found = false;
+    FILE* fp = fopen(path, "r");
+
+    if (fp == NULL) {
+        if (errno != ENOENT) {
+            fprintf(stderr, _("%s: could not open file \"%s\": %s\n"), progname, path, strerror(errno));
+            exit(1);
+        }
+        free(path);
+        return false;
+    }
+
+    while (!found && fgets(line, sizeof(line), fp) != NULL) {
+        uint32 hi = 0;
+        uint32 lo = 0;
+
+        if (strncmp(line, prefix, strlen(prefix)) == 0 && sscanf_s(line + strlen(prefix), "%X/%X", &hi, &lo) == 2) {
+            *lsn = (((XLogRecPtr)hi) << 32) | lo;
+            found = true;
+        }
+    }
+    fclose(fp);
+
+    if (!found) {
+        fprintf(stderr, _("%s: invalid data in file \"%s\"\n"), progname, path);
+        exit(1);
+    }
+    free(path);
+    return true;
+}
+
+/*
+ * Check that each incremental backup was taken from the start of the backup before it, so
+ * that it holds all the blocks changed since then.
+ */
+static void check_backup_chain(void)
+{
+    XLogRecPtr prevStart = InvalidXLogRecPtr;
+
+    for (int i = 0; i < backup_count; i++) {
+        XLogRecPtr fromLsn = InvalidXLogRecPtr;
+        XLogRecPtr start = InvalidXLogRecPtr;
+        bool incremental = read_label_lsn(backup_dirs[i], INCREMENTAL_LABEL_FILE, "INCREMENTAL FROM LSN: ", &fromLsn);
+
+        if (!read_label_lsn(backup_dirs[i], "backup_label", "START WAL LOCATION: ", &start)) {
+            fprintf(stderr, _("%s: \"%s\" is not a base backup, backup_label is missing\n"), progname,
+                backup_dirs[i]);
+            exit(1);
+        }
+
+        if (i == 0 && incremental) {
+            fprintf(stderr, _("%s: the oldest backup \"%s\" must be a full backup\n"), progname, backup_dirs[i]);
+            exit(1);
+        }
+        if (i > 0 && !incremental) {
+            fprintf(stderr, _("%s: \"%s\" is not an incremental backup\n"), progname, backup_dirs[i]);
+            exit(1);
+        }
+        if (i > 0 && XLByteLT(prevStart, fromLsn)) {
+            fprintf(stderr,
+                _("%s: backup \"%s\" is incremental from %X/%X, after the start %X/%X of the backup before it\n"),
+                progname, backup_dirs[i], (uint32)(fromLsn >> 32), (uint32)fromLsn, (uint32)(prevStart >> 32),
+                (uint32)prevStart);
+            exit(1);
+        }
+        prevStart = start;
+    }
+}
+
+static void read_fully(int fd, const char* path, char* buf, size_t len, off_t offset)
+{
+    ssize_t rd = pread(fd, buf, len, offset);
+
+    if (rd < 0) {
+        fprintf(stderr, _("%s: could not read file \"%s\": %s\n"), progname, path, strerror(errno));
+        exit(1);
+    }
+    if ((size_t)rd != len) {
+        fprintf(stderr, _("%s: file \"%s\" is too short\n"), progname, path);
+        exit(1);
+    }
+}
+
+static void write_fully(int fd, const char* path, const char* buf, size_t len)
+{
+    if (write(fd, buf, len) != (ssize_t)len) {
+        fprintf(stderr, _("%s: could not write file \"%s\": %s\n"), progname, path,
+            (errno != 0) ? strerror(errno) : "no space left on device");
+        exit(1);
+    }
+}
+
+static int create_output_file(const char* path, mode_t mode)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL | PG_BINARY, mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+
+    if (fd < 0) {
+        fprintf(stderr, _("%s: could not create file \"%s\": %s\n"), progname, path, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+static void copy_file(const char* src, const char* dst, mode_t mode)
+{
+    char buf[BLCKSZ * 8];
+    int srcfd = open(src, O_RDONLY | PG_BINARY, 0);
+    int dstfd;
+    ssize_t rd;
+
+    if (srcfd < 0) {
+        fprintf(stderr, _("%s: could not open file \"%s\": %s\n"), progname, src, strerror(errno));
+        exit(1);
+    }
+    dstfd = create_output_file(dst, mode);
+
+    while ((rd = read(srcfd, buf, sizeof(buf))) > 0)
+        write_fully(dstfd, dst, buf, rd);
+    if (rd < 0) {
+        fprintf(stderr, _("%s: could not read file \"%s\": %s\n"), progname, src, strerror(errno));
+        exit(1);
+    }
+
+    close(srcfd);
+    if (close(dstfd) != 0) {
+        fprintf(stderr, _("%s: could not close file \"%s\": %s\n"), progname, dst, strerror(errno));
+        exit(1);
+    }
+}
+
+static void open_incremental_source(BlockSource* source, const char* path)
+{
+    size_t blocksLen;
+
+    source->fd = open(path, O_RDONLY | PG_BINARY, 0);
+    if (source->fd < 0) {
+        fprintf(stderr, _("%s: could not open file \"%s\": %s\n"), progname, path, strerror(errno));
+        exit(1);
+    }
+    source->incremental = true;
+    read_fully(source->fd, path, (char*)&source->header, sizeof(IncrementalFileHeader), 0);
+    if (source->header.magic != INCREMENTAL_FILE_MAGIC || source->header.blockCount > RELSEG_SIZE ||
+        source->header.truncateBlockLength > source->header.fileBlockLength) {
+        fprintf(stderr, _("%s: file \"%s\" is not a valid incremental file\n"), progname, path);
+        exit(1);
+    }
+
+    blocksLen = source->header.blockCount * sizeof(BlockNumber);
+    source->blocks = (BlockNumber*)xmalloc0(Max(blocksLen, 1));
+    read_fully(source->fd, path, (char*)source->blocks, blocksLen, sizeof(IncrementalFileHeader));
+}
+
+/* returns the position of blkno in the blocks held by an incremental source, or -1 */
+static int find_incremental_block(const BlockSource* source, BlockNumber blkno)
+{
+    int low = 0;
+    int high = (int)source->header.blockCount - 1;
+
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+
+        if (source->blocks[mid] == blkno)
+            return mid;
+        if (source->blocks[mid] < blkno)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
+/*
+ * Reconstruct the relation file segment "dir/name" from the incremental file of the newest
+ * backup and the same file in the backups before it. Each block comes from the newest backup
+ * that holds it, up to a full copy of the file. Blocks past a truncation are zero.
+ */
+static void reconstruct_file(const char* dir, const char* name, mode_t mode)
+{
+    BlockSource* sources = (BlockSource*)xmalloc0(backup_count * sizeof(BlockSource));
+    int sourceCount = 0;
+    size_t incrnameLen = strlen(INCREMENTAL_FILE_PREFIX) + strlen(name) + 1;
+    char* incrname = (char*)xmalloc0(incrnameLen);
+    char* outdir = join_path(output_dir, dir);
+    char* outfile = join_path(outdir, name);
+    char page[BLCKSZ];
+    int outfd;
+    int rc;
+
+    rc = snprintf_s(incrname, incrnameLen, incrnameLen - 1, "%s%s", INCREMENTAL_FILE_PREFIX, name);
+    securec_check_ss_c(rc, "", "");
+
+    for (int i = backup_count - 1; i >= 0; i--) {
+        char* backupdir = join_path(backup_dirs[i], dir);
+        char* incrpath = join_path(backupdir, incrname);
+        char* fullpath = join_path(backupdir, name);
+        struct stat st;
+        bool done = false;
+
+        if (i > 0 && stat(incrpath, &st) == 0) {
+            open_incremental_source(&sources[sourceCount++], incrpath);
+        } else {
+            /* a full copy, or the file did not exist yet and all older blocks are zero */
+            if (stat(fullpath, &st) == 0) {
+                BlockSource* source = &sources[sourceCount++];
+
+                source->fd = open(fullpath, O_RDONLY | PG_BINARY, 0);
+                if (source->fd < 0) {
+                    fprintf(stderr, _("%s: could not open file \"%s\": %s\n"), progname, fullpath, strerror(errno));
+                    exit(1);
+                }
+                source->fileBlocks = (BlockNumber)(st.st_size / BLCKSZ);
+            }
+            done = true;
+        }
+
+        free(backupdir);
+        free(incrpath);
+        free(fullpath);
+        if (done)
+            break;
+    }
+
+    outfd = create_output_file(outfile, mode);
+
+    for (BlockNumber blkno = 0; blkno < sources[0].header.fileBlockLength; blkno++) {
+        bool found = false;
+
+        for (int s = 0; s < sourceCount && !found; s++) {
+            BlockSource* source = &sources[s];
+
+            if (source->incremental) {
+                int pos = find_incremental_block(source, blkno);
+
+                if (pos >= 0) {
+                    off_t offset = sizeof(IncrementalFileHeader) +
+                                   (off_t)source->header.blockCount * sizeof(BlockNumber) + (off_t)pos * BLCKSZ;
+                    read_fully(source->fd, outfile, page, BLCKSZ, offset);
+                    found = true;
+                } else if (blkno >= source->header.truncateBlockLength) {
+                    break;
+                }
+            } else {
+                if (blkno < source->fileBlocks) {
+                    read_fully(source->fd, outfile, page, BLCKSZ, (off_t)blkno * BLCKSZ);
+                    found = true;
+                }
+                break;
+            }
+        }
+
+        if (!found) {
+            rc = memset_s(page, BLCKSZ, 0, BLCKSZ);
+            securec_check_c(rc, "", "");
+        }
+        write_fully(outfd, outfile, page, BLCKSZ);
+    }
+
+    if (close(outfd) != 0) {
+        fprintf(stderr, _("%s: could not close file \"%s\": %s\n"), progname, outfile, strerror(errno));
+        exit(1);
+    }
+    if (verbose)
+        fprintf(stderr, _("%s: reconstructed \"%s\" from %d backups\n"), progname, outfile, sourceCount);
+
+    for (int s = 0; s < sourceCount; s++) {
+        close(sources[s].fd);
+        free(sources[s].blocks);
+    }
+    free(sources);
+    free(incrname);
+    free(outdir);
+    free(outfile);
+}
+
+/*
+ * Walk the directory "dir" of the newest backup, copying its files into the output and
+ * reconstructing those sent incrementally. Tablespace links are followed, and their contents
+ * are written as directories.
+ */
+static void combine_dir(const char* dir)
+{
+    char* srcdir = join_path(backup_dirs[backup_count - 1], dir);
+    char* dstdir = join_path(output_dir, dir);
+    DIR* xldir = NULL;
+    struct dirent* de = NULL;
+
+    xldir = opendir(srcdir);
+    if (xldir == NULL) {
+        fprintf(stderr, _("%s: could not open directory \"%s\": %s\n"), progname, srcdir, strerror(errno));
+        exit(1);
+    }
+
+    while ((de = readdir(xldir)) != NULL) {
+        struct stat st;
+        char* srcpath = NULL;
+        char* relpath = NULL;
+
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+            continue;
+        /* the combined backup is a full one */
+        if (dir[0] == '\0' && strcmp(de->d_name, INCREMENTAL_LABEL_FILE) == 0)
+            continue;
+
+        srcpath = join_path(srcdir, de->d_name);
+        relpath = join_path(dir, de->d_name);
+        if (stat(srcpath, &st) != 0) {
+            fprintf(stderr, _("%s: could not stat file \"%s\": %s\n"), progname, srcpath, strerror(errno));
+            exit(1);
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            char* dstpath = join_path(dstdir, de->d_name);
+
+            if (mkdir(dstpath, S_IRWXU) != 0) {
+                fprintf(stderr, _("%s: could not create directory \"%s\": %s\n"), progname, dstpath,
+                    strerror(errno));
+                exit(1);
+            }
+            free(dstpath);
+            combine_dir(relpath);
+        } else if (strncmp(de->d_name, INCREMENTAL_FILE_PREFIX, strlen(INCREMENTAL_FILE_PREFIX)) == 0) {
+            reconstruct_file(dir, de->d_name + strlen(INCREMENTAL_FILE_PREFIX), st.st_mode);
+        } else if (S_ISREG(st.st_mode)) {
+            char* dstpath = join_path(dstdir, de->d_name);
+
+            copy_file(srcpath, dstpath, st.st_mode);
+            free(dstpath);
+        }
+
+        free(srcpath);
+        free(relpath);
+    }
+
+    (void)closedir(xldir);
+    free(srcdir);
+    free(dstdir);
+}
+
+int main(int argc, char** argv)
+{
+    static struct option long_options[] = {{"help", no_argument, NULL, '?'},
+        {"version", no_argument, NULL, 'V'},
+        {"output", required_argument, NULL, 'o'},
+        {"verbose", no_argument, NULL, 'v'},
+        {NULL, 0, NULL, 0}};
+    int c;
+    int option_index;
+
+    progname = get_progname(argv[0]);
+    set_pglocale_pgservice(argv[0], PG_TEXTDOMAIN("gs_combinebackup"));
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-?") == 0) {
+            usage();
+            exit(0);
+        } else if (strcmp(argv[1], "-V") == 0 || strcmp(argv[1], "--version") == 0) {
+            puts("gs_combinebackup " DEF_GS_VERSION);
+            exit(0);
+        }
+    }
+
+    while ((c = getopt_long(argc, argv, "o:v", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'o':
+                GS_FREE(output_dir);
+                check_env_value_c(optarg);
+                output_dir = xstrdup(optarg);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+                exit(1);
+        }
+    }
+
+    if (output_dir == NULL) {
+        fprintf(stderr, _("%s: no output directory specified\n"), progname);
+        fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+        exit(1);
+    }
+    if (argc - optind < 2) {
+        fprintf(stderr, _("%s: at least a full backup and an incremental backup must be specified\n"), progname);
+        fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+        exit(1);
+    }
+
+    backup_count = argc - optind;
+    backup_dirs = argv + optind;
+    for (int i = 0; i < backup_count; i++)
+        check_env_value_c(backup_dirs[i]);
+
+    check_backup_chain();
+
+    if (mkdir(output_dir, S_IRWXU) != 0) {
+        fprintf(stderr, _("%s: could not create directory \"%s\": %s\n"), progname, output_dir, strerror(errno));
+        exit(1);
+    }
+
+    combine_dir("");
+
+    if (verbose)
+        fprintf(stderr, _("%s: reconstructed data directory \"%s\"\n"), progname, output_dir);
+
+    GS_FREE(output_dir);
+    return 0;
+}
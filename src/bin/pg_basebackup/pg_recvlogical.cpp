@@ -18,6 +18,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <sys/time.h>
+#include <arpa/inet.h>
 
 /* local includes */
 #include "streamutil.h"
@@ -28,6 +29,7 @@
 #include "libpq/libpq-fe.h"
 #include "libpq/pqsignal.h"
 #include "libpq/pqexpbuffer.h"
+#include "replication/walcompress.h"
 #include "replication/walprotocol.h"
 #include "securec.h"
 #include "bin/elog.h"
@@ -43,6 +45,7 @@ static XLogRecPtr startpos = InvalidXLogRecPtr;
 static bool do_create_slot = false;
 static bool do_start_slot = false;
 static bool do_drop_slot = false;
+static bool stream_compression = false;
 
 /* filled pairwise with option, value. value may be NULL */
 static char** options;
@@ -57,6 +60,9 @@ static int64 output_last_fsync = -1;
 static bool output_unsynced = false;
 static XLogRecPtr output_written_lsn = InvalidXLogRecPtr;
 static XLogRecPtr output_fsync_lsn = InvalidXLogRecPtr;
+static WalStreamDecompressor* stream_decompressor = NULL;
+static char* decompress_buf = NULL;
+static uint32 decompress_buf_size = 0;
 
 static void usage(void);
 static void StreamLogicalLog();
@@ -90,6 +96,8 @@ static void usage(void)
              "                         time between status packets sent to server (in seconds, defaults to 10)\n"));
     printf(_("  -S, --slot=SLOT        use existing replication slot SLOT instead of starting a new one\n"));
     printf(_("  -I, --startpos=PTR     Where in an existing slot should the streaming start\n"));
+    printf(_("      --compress         request the server to compress the change stream\n"));
+    printf(_("      --stream-changes   ask the output plugin to stream large transactions before they commit\n"));
     printf(_("\nAction to be performed:\n"));
     printf(_("      --create           create a new replication slot (for the slotname see --slot)\n"));
     printf(_("      --start            start streaming in a replication slot (for the slotname see --slot)\n"));
@@ -240,6 +248,15 @@ static int sendStartReplicationCmd()
         (uint32)(startpos >> 32),
         (uint32)startpos);
 
+    if (stream_compression) {
+        appendPQExpBufferStr(query, " COMPRESSION " WAL_STREAM_COMPRESSION_LZ4);
+
+        /* the stream history starts over with every START_REPLICATION */
+        if (stream_decompressor == NULL)
+            stream_decompressor = (WalStreamDecompressor*)pg_malloc(sizeof(WalStreamDecompressor));
+        WalStreamDecompressorReset(stream_decompressor);
+    }
+
     /* print options if there are any */
     if (noptions)
         appendPQExpBufferStr(query, " (");
@@ -274,6 +291,47 @@ static int sendStartReplicationCmd()
     return ret;
 }
 
+/*
+ * Decompress the changes of a 'z' message: the length of the uncompressed data
+ * in network byte order, followed by the data compressed with the stream history.
+ * Returns the uncompressed length, or -1 on error.
+ */
+static int DecompressStreamData(const char* buf, int len, char** data)
+{
+    uint32 rawLen;
+    int ret;
+    errno_t errorno = 0;
+
+    if (len < (int)sizeof(uint32)) {
+        fprintf(stderr, _("%s: compressed streaming message too small: %d\n"), progname, len);
+        return -1;
+    }
+    errorno = memcpy_s(&rawLen, sizeof(uint32), buf, sizeof(uint32));
+    securec_check(errorno, "\0", "\0");
+    rawLen = ntohl(rawLen);
+    if (rawLen > (uint32)PG_INT32_MAX) {
+        fprintf(stderr, _("%s: invalid compressed streaming message length: %u\n"), progname, rawLen);
+        return -1;
+    }
+
+    if (decompress_buf_size < rawLen) {
+        if (decompress_buf != NULL)
+            free(decompress_buf);
+        decompress_buf = (char*)pg_malloc(rawLen);
+        decompress_buf_size = rawLen;
+    }
+
+    ret = WalStreamDecompress(
+        stream_decompressor, buf + sizeof(uint32), len - (int)sizeof(uint32), decompress_buf, (int)rawLen);
+    if (ret != (int)rawLen) {
+        fprintf(stderr, _("%s: could not decompress streaming data\n"), progname);
+        return -1;
+    }
+
+    *data = decompress_buf;
+    return ret;
+}
+
 /*
  * Start the log streaming
  */
@@ -311,6 +369,8 @@ static void StreamLogicalLog(void)
         int bytes_written;
         int64 now;
         int hdr_len;
+        char* data = NULL;
+        int data_len;
 
         if (copybuf != NULL) {
             PQfreemem(copybuf);
@@ -444,7 +504,7 @@ static void StreamLogicalLog(void)
                 last_status = now;
             }
             continue;
-        } else if (copybuf[0] != 'w') {
+        } else if (copybuf[0] != 'w' && (copybuf[0] != 'z' || stream_decompressor == NULL)) {
             fprintf(stderr, _("%s: unrecognized streaming header: \"%c\"\n"), progname, copybuf[0]);
             goto error;
         }
@@ -454,7 +514,7 @@ static void StreamLogicalLog(void)
          * message. We only need the WAL location field (dataStart), the rest
          * of the header is ignored.
          */
-        hdr_len = 1;  /* msgtype 'w' */
+        hdr_len = 1;  /* msgtype 'w' or 'z' */
         hdr_len += 8; /* dataStart */
         hdr_len += 8; /* walEnd */
         hdr_len += 8; /* sendTime */
@@ -470,6 +530,14 @@ static void StreamLogicalLog(void)
             output_written_lsn = Max(temp, output_written_lsn);
         }
 
+        data = copybuf + hdr_len;
+        data_len = r - hdr_len;
+        if (copybuf[0] == 'z') {
+            data_len = DecompressStreamData(copybuf + hdr_len, r - hdr_len, &data);
+            if (data_len < 0)
+                goto error;
+        }
+
         /* redirect output to stdout */
         if (outfd == -1 && strcmp(outfile, "-") == 0) {
             outfd = fileno(stdout);
@@ -493,7 +561,7 @@ static void StreamLogicalLog(void)
             }
         }
 
-        bytes_left = r - hdr_len;
+        bytes_left = data_len;
         bytes_written = 0;
 
         /* signal that a fsync is needed */
@@ -502,7 +570,7 @@ static void StreamLogicalLog(void)
         while (bytes_left) {
             int ret;
 
-            ret = write(outfd, copybuf + hdr_len + bytes_written, bytes_left);
+            ret = write(outfd, data + bytes_written, bytes_left);
             if (ret < 0) {
                 fprintf(stderr,
                     _("%s: could not write %d bytes to log file \"%s\": %s\n"),
@@ -629,6 +697,8 @@ static int getOptions(const int argc, char* const* argv)
         {"create", no_argument, NULL, 1},
         {"start", no_argument, NULL, 2},
         {"drop", no_argument, NULL, 3},
+        {"compress", no_argument, NULL, 4},
+        {"stream-changes", no_argument, NULL, 5},
         {NULL, 0, NULL, 0}};
 
     int c;
@@ -744,6 +814,17 @@ static int getOptions(const int argc, char* const* argv)
             case 3:
                 do_drop_slot = true;
                 break;
+            case 4:
+                stream_compression = true;
+                break;
+            case 5:
+                /* same as -o stream-changes=on */
+                noptions += 1;
+                options = (char**)pg_realloc(options, sizeof(char*) * noptions * 2);
+
+                options[(noptions - 1) * 2] = pg_strdup("stream-changes");
+                options[(noptions - 1) * 2 + 1] = pg_strdup("on");
+                break;
 
             default:
 
@@ -26,6 +26,8 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <arpa/inet.h>
 
 #ifdef HAVE_LIBZ
 #include "zlib.h"
@@ -36,6 +38,7 @@
 #include "getopt_long.h"
 #include "receivelog.h"
 #include "streamutil.h"
+#include "replication/walcompress.h"
 
 #include "pg_build.h"
 #include "backup.h"
@@ -63,6 +66,10 @@ bool includewal = true;
 bool streamwal = true;
 /* modified checkpoint mode during build */
 bool fastcheckpoint = true;
+/* number of connections a full build receives the data directory over */
+int build_jobs = 1;
+/* compression method of the build stream, NULL if not compressed */
+char* build_stream_compression = NULL;
 
 int standby_message_timeout = 10;  /* 10 sec = default */
 int standby_recv_timeout = 120;    /* 120 sec = default */
@@ -99,6 +106,17 @@ static int bgpipe[2] = {-1, -1};
 /* Handle to child process */
 static pid_t bgchild = -1;
 
+/* Handles to the processes receiving the files sent by the workers of a parallel build */
+static pid_t* workerchildren = NULL;
+static int workerchildcount = 0;
+/* Bytes received by each of those processes, shared with them for progress reporting */
+static volatile uint64* workerdone = NULL;
+
+/* Decompression of the build stream, the history covers the stream of this process only */
+static WalStreamDecompressor* stream_decompressor = NULL;
+static char* decompress_buf = NULL;
+static uint32 decompress_buf_size = 0;
+
 volatile sig_atomic_t build_interrupted = false;
 
 /* End position for xlog streaming, empty string if unknown yet */
@@ -337,6 +355,8 @@ static void disconnect_and_exit(int code)
      */
     if (bgchild > 0)
         (void)kill(bgchild, SIGTERM);
+    for (int i = 0; i < workerchildcount; i++)
+        (void)kill(workerchildren[i], SIGTERM);
 #endif
 
     removeCreatedTblspace();
@@ -618,7 +638,8 @@ static void verify_dir_is_empty_or_create(char* dirname)
  */
 static void progress_report(int tablespacenum, const char* filename, bool force)
 {
-    int percent = (int)((totaldone / 1024) * 100 / totalsize);
+    uint64 done = totaldone;
+    int percent = 0;
     GaussState g_state;
     errno_t rc = 0;
     pg_time_t now = 0;
@@ -626,6 +647,11 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
     int caculate_secs = 0;
     static bool print = true;
 
+    /* add the files received over the other connections of a parallel build */
+    for (int i = 0; workerdone != NULL && i < build_jobs - 1; i++)
+        done += workerdone[i];
+    percent = (int)((done / 1024) * 100 / totalsize);
+
     /*
      * report and cacluate speed for every report_timeout or the sync percent changed.
      */
@@ -640,8 +666,8 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
 
     caculate_secs = abs(now - last_caculate_time);
     if (caculate_secs >= CACULATE_MIN_TIME) {
-        sync_speed = (totaldone / 1024 - checkpoint_size) / caculate_secs;
-        checkpoint_size = totaldone / 1024;
+        sync_speed = (done / 1024 - checkpoint_size) / caculate_secs;
+        checkpoint_size = done / 1024;
         last_caculate_time = now;
     }
 
@@ -657,8 +683,8 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
     if (percent > 100) {
         percent = 100;
     }
-    if (totaldone / 1024 > totalsize)
-        totalsize = totaldone / 1024;
+    if (done / 1024 > totalsize)
+        totalsize = done / 1024;
 
     g_state.mode = STANDBY_MODE;
     g_state.conn_num = replconn_num;
@@ -666,11 +692,11 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
     g_state.sync_stat = false;
 
     g_state.build_info.build_mode = FULL_BUILD;
-    g_state.build_info.total_done = totaldone / 1024;
+    g_state.build_info.total_done = done / 1024;
     g_state.build_info.total_size = totalsize;
     g_state.build_info.process_schedule = percent;
     if (sync_speed > 0)
-        g_state.build_info.estimated_time = (totalsize - totaldone / 1024) / sync_speed;
+        g_state.build_info.estimated_time = (totalsize - done / 1024) / sync_speed;
     else
         g_state.build_info.estimated_time = -1;
     UpdateDBStateFile(gaussdb_state_file, &g_state);
@@ -682,26 +708,62 @@ static void progress_report(int tablespacenum, const char* filename, bool force)
 }
 
 /*
- * Receive a tar format stream from the connection to the server, and unpack
- * the contents of it into a directory. Only files, directories and
- * symlinks are supported, no other kinds of special files.
- *
- * If the data is for the main data directory, it will be restored in the
- * specified directory. If it's for another tablespace, it will be restored
- * in the original directory, since relocation of tablespaces is not
- * supported.
+ * Get the next CopyData message of the build stream like PQgetCopyData(), decompressing it
+ * if the stream is compressed. The data is released with free_backup_copy_data().
  */
-static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
+static int get_backup_copy_data(PGconn* copyconn, char** buffer)
+{
+    uint32 rawLen;
+    int ret;
+    int r = PQgetCopyData(copyconn, buffer, 0);
+    errno_t rc = EOK;
+
+    if (r < 0 || stream_decompressor == NULL)
+        return r;
+
+    if (r < (int)sizeof(uint32)) {
+        pg_log(PG_WARNING, _("compressed build message too small: %d\n"), r);
+        return -2;
+    }
+    rc = memcpy_s(&rawLen, sizeof(uint32), *buffer, sizeof(uint32));
+    securec_check_c(rc, "\0", "\0");
+    rawLen = ntohl(rawLen);
+    if (rawLen == 0 || rawLen > (uint32)PG_INT32_MAX) {
+        pg_log(PG_WARNING, _("invalid compressed build message length: %u\n"), rawLen);
+        return -2;
+    }
+
+    if (decompress_buf_size < rawLen) {
+        pg_free(decompress_buf);
+        decompress_buf = (char*)pg_malloc0(rawLen);
+        decompress_buf_size = rawLen;
+    }
+
+    ret = WalStreamDecompress(
+        stream_decompressor, *buffer + sizeof(uint32), r - (int)sizeof(uint32), decompress_buf, (int)rawLen);
+    PQfreemem(*buffer);
+    *buffer = NULL;
+    if (ret != (int)rawLen) {
+        pg_log(PG_WARNING, _("could not decompress build data\n"));
+        return -2;
+    }
+
+    *buffer = decompress_buf;
+    return ret;
+}
+
+static void free_backup_copy_data(char* buffer)
+{
+    if (buffer != decompress_buf)
+        PQfreemem(buffer);
+}
+
+/*
+ * Get the directory the tablespace described by the header row is restored in.
+ */
+static void get_tablespace_restore_path(PGresult* res, int rownum, char* current_path)
 {
-    char current_path[MAXPGPATH] = {0};
-    char filename[MAXPGPATH] = {0};
-    char absolut_path[MAXPGPATH] = {0};
-    uint64 current_len_left = 0;
-    uint64 current_padding = 0;
-    char* copybuf = NULL;
-    FILE* file = NULL;
     char* get_value = NULL;
-    struct stat st;
     errno_t rc = EOK;
     int nRet = 0;
 
@@ -726,6 +788,31 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
         }
         current_path[MAXPGPATH - 1] = '\0';
     }
+}
+
+/*
+ * Receive a tar format stream from the connection to the server, and unpack
+ * the contents of it into a directory. Only files, directories and
+ * symlinks are supported, no other kinds of special files.
+ *
+ * If the data is for the main data directory, it will be restored in the
+ * specified directory. If it's for another tablespace, it will be restored
+ * in the original directory, since relocation of tablespaces is not
+ * supported.
+ */
+static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
+{
+    char current_path[MAXPGPATH] = {0};
+    char filename[MAXPGPATH] = {0};
+    char absolut_path[MAXPGPATH] = {0};
+    uint64 current_len_left = 0;
+    uint64 current_padding = 0;
+    char* copybuf = NULL;
+    FILE* file = NULL;
+    struct stat st;
+    int nRet = 0;
+
+    get_tablespace_restore_path(res, rownum, current_path);
 
     /*
      * Get the COPY data
@@ -746,11 +833,11 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
         }
 
         if (copybuf != NULL) {
-            PQfreemem(copybuf);
+            free_backup_copy_data(copybuf);
             copybuf = NULL;
         }
 
-        r = PQgetCopyData(conn, &copybuf, 0);
+        r = get_backup_copy_data(conn, &copybuf);
         if (r == -1) {
             /*
              * End of chunk
@@ -820,10 +907,12 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
                         if (mkdir(filename, S_IRWXU) != 0) {
                             /*
                              * When streaming WAL, pg_xlog will have been created
-                             * by the wal receiver process, so just ignore failure
-                             * on that.
+                             * by the wal receiver process, and the processes
+                             * receiving the files of a parallel build create the
+                             * directories they need, so just ignore failure on that.
                              */
-                            if (!streamwal || strcmp(filename + strlen(filename) - len, "/pg_xlog") != 0) {
+                            if ((!streamwal || strcmp(filename + strlen(filename) - len, "/pg_xlog") != 0) &&
+                                !(workerchildcount > 0 && errno == EEXIST)) {
                                 pg_log(PG_WARNING,
                                     _("could not create directory \"%s\": %s\n"),
                                     filename,
@@ -961,11 +1050,284 @@ static void ReceiveAndUnpackTarFile(PGconn* conn, PGresult* res, int rownum)
     }
 
     if (copybuf != NULL) {
-        PQfreemem(copybuf);
+        free_backup_copy_data(copybuf);
         copybuf = NULL;
     }
 }
 
+/*
+ * Get the path a file sent by a worker of a parallel build is restored at. The files of
+ * the tablespaces other than the data directory are named pg_tblspc/<oid>/...
+ */
+static void get_parallel_file_path(PGresult* header, char* tarname, char* filename)
+{
+    char current_path[MAXPGPATH] = {0};
+    char* relname = tarname;
+    const char* prefix = "pg_tblspc/";
+    errno_t rc = EOK;
+    int nRet = 0;
+
+    rc = strncpy_s(current_path, MAXPGPATH, basedir, strlen(basedir));
+    securec_check_c(rc, "", "");
+
+    if (strncmp(tarname, prefix, strlen(prefix)) == 0) {
+        char* oid = tarname + strlen(prefix);
+        char* slash = strchr(oid, '/');
+
+        for (int i = 0; slash != NULL && i < PQntuples(header); i++) {
+            char* spcoid = PQgetvalue(header, i, 0);
+            if (!PQgetisnull(header, i, 0) && strlen(spcoid) == (size_t)(slash - oid) &&
+                strncmp(spcoid, oid, slash - oid) == 0) {
+                get_tablespace_restore_path(header, i, current_path);
+                relname = slash + 1;
+                break;
+            }
+        }
+        if (relname == tarname) {
+            pg_log(PG_WARNING, _("unknown tablespace of parallel build file \"%s\"\n"), tarname);
+            disconnect_and_exit(1);
+        }
+    }
+
+    /* the tablespace version directory is named after the node, as in the stream of the leader */
+    if (NULL != conn_str)
+        (void)replace_node_name(relname, (const char*)remotenodename, (const char*)pgxcnodename);
+    nRet = snprintf_s(filename, MAXPGPATH, MAXPGPATH - 1, "%s/%s", current_path, relname);
+    securec_check_ss_c(nRet, "", "");
+    canonicalize_path(filename);
+}
+
+/*
+ * Receive the files sent by a worker of a parallel build, and write them into their
+ * tablespace. The worker only sends regular files, their directories are created here
+ * if the stream of the leader has not reached them yet.
+ */
+static void ReceiveParallelFiles(PGconn* conn, PGresult* header, int worker)
+{
+    char filename[MAXPGPATH] = {0};
+    char parentdir[MAXPGPATH] = {0};
+    uint64 current_len_left = 0;
+    uint64 current_padding = 0;
+    char* copybuf = NULL;
+    FILE* file = NULL;
+    PGresult* res = NULL;
+    errno_t rc = EOK;
+
+    res = PQgetResult(conn);
+    if (PQresultStatus(res) != PGRES_COPY_OUT) {
+        pg_log(PG_WARNING, _("could not get COPY data stream: %s"), PQerrorMessage(conn));
+        disconnect_and_exit(1);
+    }
+    PQclear(res);
+
+    while (1) {
+        int r;
+
+        if (copybuf != NULL) {
+            free_backup_copy_data(copybuf);
+            copybuf = NULL;
+        }
+
+        r = get_backup_copy_data(conn, &copybuf);
+        if (r == -1) {
+            break;
+        } else if (r == -2) {
+            pg_log(PG_WARNING, _("could not read COPY data: %s"), PQerrorMessage(conn));
+            disconnect_and_exit(1);
+        }
+        workerdone[worker] += r;
+
+        if (file == NULL) {
+            mode_t filemode;
+
+            if (r != BUILD_PATH_LEN) {
+                pg_log(PG_WARNING, _("invalid tar block header size: %d\n"), r);
+                disconnect_and_exit(1);
+            }
+            if (sscanf_s(copybuf + 1048, "%20lo", &current_len_left) != 1) {
+                pg_log(PG_WARNING, _("could not parse file size\n"));
+                disconnect_and_exit(1);
+            }
+            if (sscanf_s(&copybuf[1024], "%07o ", &filemode) != 1) {
+                pg_log(PG_WARNING, _("could not parse file mode\n"));
+                disconnect_and_exit(1);
+            }
+            current_padding = ((current_len_left + 511) & ~511) - current_len_left;
+
+            if (strstr(copybuf, "..") != NULL) {
+                pg_log(PG_WARNING, _("the file path \"%s\" including .. is unallowed\n"), copybuf);
+                disconnect_and_exit(1);
+            }
+            get_parallel_file_path(header, copybuf, filename);
+
+            file = fopen(filename, "wb");
+            if (file == NULL && errno == ENOENT) {
+                rc = strncpy_s(parentdir, MAXPGPATH, filename, strlen(filename));
+                securec_check_c(rc, "", "");
+                get_parent_directory(parentdir);
+                if (pg_mkdir_p(parentdir, S_IRWXU) != 0 && errno != EEXIST) {
+                    pg_log(PG_WARNING, _("could not create directory \"%s\": %s\n"), parentdir, strerror(errno));
+                    disconnect_and_exit(1);
+                }
+                file = fopen(filename, "wb");
+            }
+            if (file == NULL) {
+                pg_log(PG_WARNING, _("could not create file \"%s\": %s\n"), filename, strerror(errno));
+                disconnect_and_exit(1);
+            }
+            if (chmod(filename, filemode))
+                pg_log(PG_WARNING, _("could not set permissions on file \"%s\": %s\n"), filename, strerror(errno));
+
+            if (current_len_left == 0) {
+                fclose(file);
+                file = NULL;
+            }
+            continue;
+        }
+
+        if (current_len_left == 0 && r == (int)current_padding) {
+            /* the padding block of the file */
+            fclose(file);
+            file = NULL;
+            continue;
+        }
+
+        if (fwrite(copybuf, r, 1, file) != 1) {
+            pg_log(PG_WARNING, _("could not write to file \"%s\": %s\n"), filename, strerror(errno));
+            fclose(file);
+            file = NULL;
+            disconnect_and_exit(1);
+        }
+        current_len_left -= r;
+        if (current_len_left == 0 && current_padding == 0) {
+            fclose(file);
+            file = NULL;
+        }
+    }
+
+    if (file != NULL) {
+        fclose(file);
+        file = NULL;
+        pg_log(PG_WARNING, _("COPY stream ended before last file was finished\n"));
+        disconnect_and_exit(1);
+    }
+
+    if (copybuf != NULL) {
+        free_backup_copy_data(copybuf);
+        copybuf = NULL;
+    }
+}
+
+/*
+ * Whether BASE_BACKUP failed because the server does not know its COMPRESSION option,
+ * or the method given with it.
+ */
+static bool CompressionRejected(PGresult* res)
+{
+    const char* sqlstate = NULL;
+
+    if (PQresultStatus(res) != PGRES_FATAL_ERROR)
+        return false;
+    sqlstate = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+    return sqlstate != NULL && (strcmp(sqlstate, "42601") == 0 || strcmp(sqlstate, "0A000") == 0);
+}
+
+/*
+ * Fork the processes receiving the files sent by the workers of a parallel build, each
+ * over a connection of its own to the same primary. The tablespace header must be known
+ * by then, so that the files can be restored in their tablespace.
+ */
+static void StartParallelWorkers(const char* backupid, PGresult* header, uint32 term)
+{
+    char command[MAXPGPATH] = {0};
+    PGresult* res = NULL;
+    int nRet = 0;
+
+    nRet = snprintf_s(command,
+        sizeof(command),
+        sizeof(command) - 1,
+        "BASE_BACKUP WORKER '%s' %s%s",
+        backupid,
+        build_stream_compression != NULL ? "COMPRESSION " : "",
+        build_stream_compression != NULL ? build_stream_compression : "");
+    securec_check_ss_c(nRet, "", "");
+
+    /* the children add up the bytes they receive here, for the progress of the build */
+    workerdone = (volatile uint64*)mmap(
+        NULL, sizeof(uint64) * (build_jobs - 1), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (workerdone == MAP_FAILED) {
+        pg_log(PG_WARNING, _("could not map progress counters: %s\n"), strerror(errno));
+        workerdone = NULL;
+        disconnect_and_exit(1);
+    }
+
+    workerchildren = (pid_t*)pg_malloc0(sizeof(pid_t) * (build_jobs - 1));
+    for (int i = 0; i < build_jobs - 1; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            /*
+             * The connection, the wal receiver and the tablespace directories belong to
+             * the parent, leave them alone when exiting.
+             */
+            streamConn = NULL;
+            bgchild = -1;
+            workerchildcount = 0;
+            TABLESPACE_LIST_RELEASE();
+
+            streamConn = check_and_conn(standby_connect_timeout, standby_recv_timeout, term);
+            if (streamConn == NULL) {
+                pg_log(PG_WARNING, _("could not connect to server for parallel build.\n"));
+                exit(1);
+            }
+            (void)PQsetRwTimeout(streamConn, standby_recv_timeout);
+            if (PQsendQuery(streamConn, command) == 0) {
+                pg_log(PG_WARNING, _("could not send base backup command: %s"), PQerrorMessage(streamConn));
+                disconnect_and_exit(1);
+            }
+            if (stream_decompressor != NULL)
+                WalStreamDecompressorReset(stream_decompressor);
+
+            ReceiveParallelFiles(streamConn, header, i);
+
+            res = PQgetResult(streamConn);
+            if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+                pg_log(PG_WARNING, _("final receive failed: %s"), PQerrorMessage(streamConn));
+                disconnect_and_exit(1);
+            }
+            PQclear(res);
+            PQfinish(streamConn);
+            exit(0);
+        } else if (pid < 0) {
+            pg_log(PG_WARNING, _("could not create background process: %s\n"), strerror(errno));
+            disconnect_and_exit(1);
+        }
+        workerchildren[workerchildcount++] = pid;
+    }
+
+    if (verbose) {
+        pg_log(PG_WARNING, _("receiving the build over %d connections\n"), build_jobs);
+    }
+}
+
+static void WaitParallelWorkers(void)
+{
+    for (int i = 0; i < workerchildcount; i++) {
+        int status;
+
+        if (waitpid(workerchildren[i], &status, 0) == -1) {
+            pg_log(PG_WARNING, _("could not wait for child process: %s\n"), strerror(errno));
+            disconnect_and_exit(1);
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            pg_log(PG_WARNING, _("parallel build process %d failed\n"), (int)workerchildren[i]);
+            disconnect_and_exit(1);
+        }
+    }
+    workerchildcount = 0;
+    pg_free(workerchildren);
+    workerchildren = NULL;
+}
+
 /*
  * Brief            : @@GaussDB@@
  * Description    :  create .done
@@ -1005,6 +1367,7 @@ static void BaseBackup(const char* dirname, uint32 term)
     int i;
     char xlogstart[MAXFNAMELEN] = {0};
     char xlogend[MAXFNAMELEN] = {0};
+    char backupid[MAXFNAMELEN] = {0};
     bool ret = FALSE;
     char* get_value = NULL;
     char xlog_location[MAXPGPATH] = {0};
@@ -1099,26 +1462,55 @@ static void BaseBackup(const char* dirname, uint32 term)
      */
     (void)PQsetRwTimeout(streamConn, Max(BUILD_RW_TIMEOUT, standby_recv_timeout));
     (void)PQescapeStringConn(streamConn, escaped_label, label, sizeof(escaped_label), &i);
-    nRet = snprintf_s(current_path,
-        MAXPGPATH,
-        sizeof(current_path) - 1,
-        "BASE_BACKUP LABEL '%s' %s %s %s %s",
-        escaped_label,
-        showprogress ? "PROGRESS" : "",
-        includewal && !streamwal ? "WAL" : "",
-        fastcheckpoint ? "FAST" : "",
-        includewal ? "NOWAIT" : "");
-    securec_check_ss_c(nRet, "", "");
+    for (;;) {
+        nRet = snprintf_s(current_path,
+            MAXPGPATH,
+            sizeof(current_path) - 1,
+            "BASE_BACKUP LABEL '%s' %s %s %s %s %s %s%s",
+            escaped_label,
+            showprogress ? "PROGRESS" : "",
+            includewal && !streamwal ? "WAL" : "",
+            fastcheckpoint ? "FAST" : "",
+            includewal ? "NOWAIT" : "",
+            build_jobs > 1 ? "PARALLEL" : "",
+            build_stream_compression != NULL ? "COMPRESSION " : "",
+            build_stream_compression != NULL ? build_stream_compression : "");
+        securec_check_ss_c(nRet, "", "");
+
+        if (PQsendQuery(streamConn, current_path) == 0) {
+            pg_log(PG_WARNING, _("could not send base backup command: %s"), PQerrorMessage(streamConn));
+            disconnect_and_exit(1);
+        }
 
-    if (PQsendQuery(streamConn, current_path) == 0) {
-        pg_log(PG_WARNING, _("could not send base backup command: %s"), PQerrorMessage(streamConn));
-        disconnect_and_exit(1);
-    }
+        /*
+         *  get the xlog location
+         */
+        res = PQgetResult(streamConn);
+        if (build_stream_compression == NULL || !CompressionRejected(res))
+            break;
 
-    /*
-     *  get the xlog location
-     */
-    res = PQgetResult(streamConn);
+        /* a primary of an older version, or without the method, sends the build uncompressed */
+        pg_log(PG_WARNING,
+            _("server does not support stream compression %s, continuing without it: %s"),
+            build_stream_compression,
+            PQerrorMessage(streamConn));
+        do {
+            PQclear(res);
+        } while ((res = PQgetResult(streamConn)) != NULL);
+        pg_free(build_stream_compression);
+        build_stream_compression = NULL;
+
+        /* the walsender may have given up the connection on the error */
+        if (PQstatus(streamConn) != CONNECTION_OK) {
+            PQfinish(streamConn);
+            streamConn = check_and_conn(standby_connect_timeout, standby_recv_timeout, term);
+            if (streamConn == NULL) {
+                show_full_build_process("could not connect to server.");
+                disconnect_and_exit(1);
+            }
+            (void)PQsetRwTimeout(streamConn, Max(BUILD_RW_TIMEOUT, standby_recv_timeout));
+        }
+    }
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         pg_log(PG_WARNING, _("could not get xlog location: %s"), PQerrorMessage(streamConn));
         disconnect_and_exit(1);
@@ -1168,6 +1560,27 @@ static void BaseBackup(const char* dirname, uint32 term)
         pg_log(PG_WARNING, "xlog start point: %s\n", xlogstart);
     }
     PQclear(res);
+
+    /*
+     * Get the id the workers of a parallel build attach with, 0 if the primary
+     * sends the build over this connection only
+     */
+    if (build_jobs > 1) {
+        res = PQgetResult(streamConn);
+        if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) != 1) {
+            pg_log(PG_WARNING, _("could not get parallel build id: %s"), PQerrorMessage(streamConn));
+            disconnect_and_exit(1);
+        }
+        rc = strncpy_s(backupid, sizeof(backupid), PQgetvalue(res, 0, 0), sizeof(backupid) - 1);
+        securec_check_c(rc, "", "");
+        PQclear(res);
+    }
+
+    if (build_stream_compression != NULL) {
+        stream_decompressor = (WalStreamDecompressor*)pg_malloc0(sizeof(WalStreamDecompressor));
+        WalStreamDecompressorReset(stream_decompressor);
+    }
+
     rc = memset_s(xlogend, sizeof(xlogend), 0, sizeof(xlogend));
     securec_check_c(rc, "", "");
 
@@ -1261,6 +1674,10 @@ static void BaseBackup(const char* dirname, uint32 term)
         StartLogStreamer(xlogstart, timeline, sysidentifier, (const char*)xlog_location, term);
     }
 
+    if (build_jobs > 1 && strcmp(backupid, "0") != 0) {
+        StartParallelWorkers(backupid, res, term);
+    }
+
     /* free sysidentifier after use */
     pg_free(sysidentifier);
     show_full_build_process("begin receive tar files");
@@ -1272,6 +1689,9 @@ static void BaseBackup(const char* dirname, uint32 term)
         ReceiveAndUnpackTarFile(streamConn, res, i);
     }
 
+    /* the primary ends the stream of the leader only after the workers are done */
+    WaitParallelWorkers();
+
     if (showprogress)
         progress_report(PQntuples(res), NULL, true);
     PQclear(res);
@@ -1460,7 +1880,21 @@ void backup_incremental_xlog(char* dir)
 /* BuildReaper -- signal handler after wal receiver dies. */
 static void BuildReaper(SIGNAL_ARGS)
 {
+    int save_errno = errno;
+    siginfo_t info;
+
+    /* the processes receiving a parallel build exit when done, only the wal receiver exiting interrupts it */
+    if (workerchildcount > 0) {
+        info.si_pid = 0;
+        if (bgchild <= 0 || waitid(P_PID, (id_t)bgchild, &info, WEXITED | WNOHANG | WNOWAIT) != 0 ||
+            info.si_pid != bgchild) {
+            errno = save_errno;
+            return;
+        }
+    }
+
     build_interrupted = true;
+    errno = save_errno;
 }
 
 /*
@@ -7,6 +7,8 @@
 extern int standby_recv_timeout;
 extern int standby_connect_timeout;
 extern int standby_message_timeout;
+extern int build_jobs;
+extern char* build_stream_compression;
 
 extern char* conn_str;
 extern pid_t process_id;
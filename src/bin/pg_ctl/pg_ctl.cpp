@@ -46,6 +46,7 @@
 #include "bin/elog.h"
 #include "common/build_query/build_query.h"
 #include "replication/replicainternal.h"
+#include "replication/walcompress.h"
 #include "libpq/libpq-fe.h"
 #include "libpq/libpq-int.h"
 #include "hotpatch/hotpatch_client.h"
@@ -3342,7 +3343,8 @@ static void do_help(void)
     printf(_("  %s restart [-w] [-t SECS] [-Z NODE-TYPE] [-D DATADIR] [-s] [-m SHUTDOWN-MODE]\n"
              "                 [-o \"OPTIONS\"]\n"),
         progname);
-    printf(_("  %s build   [-D DATADIR] [-Z NODE-TYPE] [-b BUILD_MODE] [-r SECS] [-C CONNECTOR] [-q]\n"), progname);
+    printf(_("  %s build   [-D DATADIR] [-Z NODE-TYPE] [-b BUILD_MODE] [-r SECS] [-C CONNECTOR] [-q]\n"
+             "                 [-j NUM]\n"), progname);
     printf(_("  %s restore [-D DATADIR] [-Z NODE-TYPE] [-s] [--remove-backup]\n"), progname);
 #else
     printf(
@@ -3350,7 +3352,7 @@ static void do_help(void)
     printf(_("  %s restart [-w] [-t SECS] [-D DATADIR] [-s] [-m SHUTDOWN-MODE]\n"
              "                 [-o \"OPTIONS\"]\n"),
         progname);
-    printf(_("  %s build   [-D DATADIR] [-b BUILD_MODE] [-r SECS] [-q]\n"), progname);
+    printf(_("  %s build   [-D DATADIR] [-b BUILD_MODE] [-r SECS] [-q] [-j NUM]\n"), progname);
     printf(_("  %s restore [-D DATADIR] [-s] [--remove-backup]\n"), progname);
 #endif
 
@@ -3460,6 +3462,10 @@ static void do_help(void)
 #endif
     printf(_("  -r, --recvtimeout=INTERVAL    time that receiver waits for communication from server (in seconds)\n"));
     printf(_("  -q                     do not start automatically after build finishing, needed start by caller\n"));
+    printf(_("  -j, --jobs=NUM         full build receives the data directory over NUM connections, incremental\n"
+             "                         build reads WAL with NUM threads and fetches files over NUM connections\n"));
+    printf(_("  --stream-compression=METHOD\n"
+             "                         compress the full build stream with METHOD (lz4)\n"));
 
 
 #ifndef ENABLE_MULTIPLE_NODES  
@@ -4445,6 +4451,8 @@ int main(int argc, char** argv)
         {"connect-string", required_argument, NULL, 'C'},
         {"remove-backup", no_argument, NULL, 1},
         {"action", required_argument, NULL, 'a'},
+        {"jobs", required_argument, NULL, 'j'},
+        {"stream-compression", required_argument, NULL, 2},
         {NULL, 0, NULL, 0}};
 
     int option_index;
@@ -4519,13 +4527,13 @@ int main(int argc, char** argv)
     while (optind < argc) {
 #ifdef ENABLE_MULTIPLE_NODES
         while ((c = getopt_long(
-                    argc, argv, "a:b:cD:l:m:M:N:n:o:p:P:r:sS:t:U:wWZ:C:T:dqL:", long_options, &option_index)) != -1)
+                    argc, argv, "a:b:cD:j:l:m:M:N:n:o:p:P:r:sS:t:U:wWZ:C:T:dqL:", long_options, &option_index)) != -1)
 #else
         // The node defaults to a datanode
         FREE_AND_RESET(pgxcCommand);
         pgxcCommand = xstrdup("--datanode");
         
-        while ((c = getopt_long(argc, argv, "b:cD:l:m:M:N:o:p:P:r:sS:t:U:wWdqL:T:", long_options, &option_index)) != -1)
+        while ((c = getopt_long(argc, argv, "b:cD:j:l:m:M:N:o:p:P:r:sS:t:U:wWdqL:T:", long_options, &option_index)) != -1)
 #endif
         {
             switch (c) {
@@ -4719,6 +4727,16 @@ int main(int argc, char** argv)
                 case 'q':
                     needstartafterbuild = false;
                     break;
+                case 'j':
+                    check_input_for_security(optarg);
+                    rewind_jobs = atoi(optarg);
+                    if (rewind_jobs <= 0 || rewind_jobs > MAX_REWIND_JOBS) {
+                        pg_log(PG_WARNING, _("invalid number of parallel jobs \"%s\", must be between 1 and %d\n"),
+                            optarg, MAX_REWIND_JOBS);
+                        exit(1);
+                    }
+                    build_jobs = rewind_jobs;
+                    break;
                 case 'a': {
                     check_input_for_security(optarg);
                     int opt_len = strlen(optarg);
@@ -4732,6 +4750,15 @@ int main(int argc, char** argv)
                 case 1:
                     clear_backup_dir = true;
                     break;
+                case 2:
+                    check_input_for_security(optarg);
+                    if (!WalStreamCompressionIsSupported(optarg)) {
+                        pg_log(PG_WARNING, _("invalid stream compression method \"%s\"\n"), optarg);
+                        exit(1);
+                    }
+                    FREE_AND_RESET(build_stream_compression);
+                    build_stream_compression = xstrdup(optarg);
+                    break;
                 default:
                     /* getopt_long already issued a suitable error message */
                     do_advice();
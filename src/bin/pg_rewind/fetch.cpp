@@ -10,6 +10,7 @@
 #include "postgres_fe.h"
 
 #include <fcntl.h>
+#include <pthread.h>
 
 /* for ntohl/htonl */
 #include <arpa/inet.h>
@@ -47,34 +48,83 @@ const int XLOG_NAME_LENGTH = 24;
 #define INVALID_LINES_IDX (int)(~0)
 #define MAX_PARAM_LEN 1024
 
-static BuildErrorCode receiveFileChunks(const char* sql, FILE* file);
+/*
+ * A range of a file to fetch from the source. All the ranges of a file are
+ * queued one after another, and fetched over the same connection.
+ */
+typedef struct fetch_range_t {
+    const char* path;
+    unsigned int begin;
+    unsigned int len;
+    int worker; /* connection fetching it, see assignFetchWorkers */
+} fetch_range_t;
+
+typedef struct fetch_queue_t {
+    fetch_range_t* ranges;
+    int nranges;
+    int maxranges;
+} fetch_queue_t;
+
+static fetch_queue_t fetchqueue = {NULL, 0, 0};
+
+/* A connection fetching its share of the queue in a thread of its own */
+typedef struct fetch_worker_t {
+    pthread_t thread;
+    int id;
+    FILE* file;
+    BuildErrorCode rv;
+} fetch_worker_t;
+
+static PGconn* connectSource(const char* connstr);
+static BuildErrorCode receiveFileChunks(PGconn* fetchconn, const char* sql, FILE* file);
 static BuildErrorCode execute_pagemap(datapagemap_t* pagemap, const char* path, FILE* file);
 static void execute_waldatamap(datapagemap_t* pagemap, const char* path, size_t block_size);
+static void fetch_file_range(const char* path, unsigned int begin, unsigned int end);
+static BuildErrorCode copyFetchQueue(PGconn* fetchconn, int worker);
+static void resetFetchQueue(void);
+static int assignFetchWorkers(int jobs);
+static BuildErrorCode fetchQueuedRanges(PGconn* fetchconn, int worker, FILE* file);
+static BuildErrorCode fetchQueuedRangesParallel(int nworkers, FILE* file);
+static void* fetchWorkerMain(void* arg);
 static char* run_simple_query(const char* sql);
 static BuildErrorCode recurse_dir(const char* datadir, const char* path, process_file_callback_t callback);
 static void get_slot_name_by_app_name(void);
 
 BuildErrorCode libpqConnect(const char* connstr)
 {
-    PGresult* res = NULL;
-
-    conn = PQconnectdb(connstr);
-    if (PQstatus(conn) == CONNECTION_BAD) {
-        pg_log(PG_ERROR, "could not connect to server %s: %s", connstr, PQerrorMessage(conn));
+    conn = connectSource(connstr);
+    if (conn == NULL)
         return BUILD_ERROR;
-    }
 
     pg_log(PG_PROGRESS, "connected to server: %s\n", connstr);
+    return BUILD_SUCCESS;
+}
+
+/*
+ * Open a connection to the source server and set it up for fetching files.
+ * Returns NULL on failure.
+ */
+static PGconn* connectSource(const char* connstr)
+{
+    PGconn* newconn = NULL;
+    PGresult* res = NULL;
+
+    newconn = PQconnectdb(connstr);
+    if (PQstatus(newconn) == CONNECTION_BAD) {
+        pg_log(PG_ERROR, "could not connect to server %s: %s", connstr, PQerrorMessage(newconn));
+        PQfinish(newconn);
+        return NULL;
+    }
 
-    res = PQexec(conn, "SET xc_maintenance_mode to on");
+    res = PQexec(newconn, "SET xc_maintenance_mode to on");
     PQclear(res);
 
-    res = PQexec(conn, "SET session_timeout = 0");
+    res = PQexec(newconn, "SET session_timeout = 0");
     PQclear(res);
 
-    res = PQexec(conn, "SET statement_timeout = 0");
+    res = PQexec(newconn, "SET statement_timeout = 0");
     PQclear(res);
-    return BUILD_SUCCESS;
+    return newconn;
 }
 
 void libpqDisconnect()
@@ -371,24 +421,24 @@ BuildErrorCode fetchSourceFileList()
  * chunk	bytea	-- file content
  * ----
  */
-static BuildErrorCode receiveFileChunks(const char* sql, FILE* file)
+static BuildErrorCode receiveFileChunks(PGconn* fetchconn, const char* sql, FILE* file)
 {
     PGresult* res = NULL;
     errno_t errorno = EOK;
 
-    if (PQsendQueryParams(conn, sql, 0, NULL, NULL, NULL, NULL, 1) != 1) {
-        pg_fatal("could not send query: %s", PQerrorMessage(conn));
+    if (PQsendQueryParams(fetchconn, sql, 0, NULL, NULL, NULL, NULL, 1) != 1) {
+        pg_fatal("could not send query: %s", PQerrorMessage(fetchconn));
         return BUILD_FATAL;
     }
 
     pg_log(PG_DEBUG, "getting file chunks\n");
 
-    if (PQsetSingleRowMode(conn) != 1) {
+    if (PQsetSingleRowMode(fetchconn) != 1) {
         pg_fatal("could not set libpq connection to single row mode\n");
         return BUILD_FATAL;
     }
 
-    while ((res = PQgetResult(conn)) != NULL) {
+    while ((res = PQgetResult(fetchconn)) != NULL) {
         char* filename = NULL;
         int filenamelen;
         int chunkoff;
@@ -475,7 +525,8 @@ static BuildErrorCode receiveFileChunks(const char* sql, FILE* file)
         }
 
         pg_log(PG_DEBUG, "received chunk for file \"%s\", offset %d, size %d\n", filename, chunkoff, chunksize);
-        fprintf(file, "received chunk for file \"%s\", offset %d, size %d\n", filename, chunkoff, chunksize);
+        if (file != NULL)
+            fprintf(file, "received chunk for file \"%s\", offset %d, size %d\n", filename, chunkoff, chunksize);
 
         open_target_file(filename, false);
         pg_free(filename);
@@ -540,19 +591,17 @@ char* fetchFile(char* filename, size_t* filesize)
 }
 
 /*
- * Write a file range to a temporary table in the server.
+ * Queue a file range to fetch.
  *
- * The range is sent to the server as a COPY formatted line, to be inserted
- * into the 'fetchchunks' temporary table. It is used in receiveFileChunks()
- * function to actually fetch the data.
+ * The ranges are later sent to the server as COPY formatted lines, to be
+ * inserted into the 'fetchchunks' temporary table. It is used in
+ * receiveFileChunks() function to actually fetch the data.
  */
 static void fetch_file_range(const char* path, unsigned int begin, unsigned int end)
 {
-    char linebuf[MAXPGPATH + 23];
-    int ss_c = 0;
-
     /* Split the range into CHUNKSIZE chunks */
     while (end - begin > 0) {
+        fetch_range_t* range = NULL;
         unsigned int len;
 
         if (end - begin > CHUNKSIZE) {
@@ -560,37 +609,133 @@ static void fetch_file_range(const char* path, unsigned int begin, unsigned int
         } else {
             len = end - begin;
         }
-        ss_c = snprintf_s(linebuf, sizeof(linebuf), sizeof(linebuf) - 1, "%s\t%u\t%u\n", path, begin, len);
-        securec_check_ss_c(ss_c, "\0", "\0");
 
-        if (PQputCopyData(conn, linebuf, strlen(linebuf)) != 1)
-            pg_fatal("could not send COPY data: %s", PQerrorMessage(conn));
+        if (fetchqueue.nranges == fetchqueue.maxranges) {
+            fetchqueue.maxranges = (fetchqueue.maxranges == 0) ? 1024 : fetchqueue.maxranges * 2;
+            fetchqueue.ranges =
+                (fetch_range_t*)pg_realloc(fetchqueue.ranges, fetchqueue.maxranges * sizeof(fetch_range_t));
+        }
+        range = &fetchqueue.ranges[fetchqueue.nranges++];
+        range->path = path;
+        range->begin = begin;
+        range->len = len;
+        range->worker = 0;
 
         begin += len;
     }
 }
 
 /*
- * Fetch all changed blocks from remote source data directory.
+ * Send the queued ranges fetched by 'worker', or all of them if it is negative,
+ * to the COPY in progress on 'fetchconn'.
  */
-BuildErrorCode executeFileMap(filemap_t* map, FILE* file)
+static BuildErrorCode copyFetchQueue(PGconn* fetchconn, int worker)
 {
-    file_entry_t* entry = NULL;
-    const char* sql = NULL;
-    PGresult* res = NULL;
+    char linebuf[MAXPGPATH + 23];
+    int ss_c = 0;
     int i;
-    int nRet;
-    char bkup_file[MAXPGPATH] = {0};
 
-    nRet = snprintf_s(bkup_file, MAXPGPATH, MAXPGPATH - 1, "%s/%s", datadir_target, "pg_rewind_bak");
-    securec_check_ss_c(nRet, "", "");
+    for (i = 0; i < fetchqueue.nranges; i++) {
+        fetch_range_t* range = &fetchqueue.ranges[i];
+
+        if (worker >= 0 && range->worker != worker)
+            continue;
+
+        ss_c = snprintf_s(
+            linebuf, sizeof(linebuf), sizeof(linebuf) - 1, "%s\t%u\t%u\n", range->path, range->begin, range->len);
+        securec_check_ss_c(ss_c, "\0", "\0");
+
+        if (PQputCopyData(fetchconn, linebuf, strlen(linebuf)) != 1) {
+            pg_fatal("could not send COPY data: %s", PQerrorMessage(fetchconn));
+            return BUILD_FATAL;
+        }
+    }
+    return BUILD_SUCCESS;
+}
+
+static void resetFetchQueue(void)
+{
+    pg_free(fetchqueue.ranges);
+    fetchqueue.ranges = NULL;
+    fetchqueue.nranges = 0;
+    fetchqueue.maxranges = 0;
+}
+
+static int fetch_file_cmp(const void* a, const void* b)
+{
+    uint64 sizea = ((const uint64*)a)[1];
+    uint64 sizeb = ((const uint64*)b)[1];
+
+    if (sizea != sizeb)
+        return (sizea > sizeb) ? -1 : 1;
+    return 0;
+}
+
+/*
+ * Spread the queued files over up to 'jobs' connections: the largest file
+ * first, each to the connection with the fewest bytes so far. A file is never
+ * split between connections, so that a file removed on the source meanwhile
+ * is removed on the target for good. Returns the number of connections needed.
+ */
+static int assignFetchWorkers(int jobs)
+{
+    uint64* files = NULL; /* pairs of index of the first range of a file and size of the file */
+    uint64 load[MAX_REWIND_JOBS] = {0};
+    int nfiles = 0;
+    int nworkers;
+    int i;
+
+    if (jobs <= 1 || fetchqueue.nranges == 0)
+        return 1;
+
+    files = (uint64*)pg_malloc(fetchqueue.nranges * 2 * sizeof(uint64));
+    for (i = 0; i < fetchqueue.nranges; i++) {
+        if (i == 0 || fetchqueue.ranges[i].path != fetchqueue.ranges[i - 1].path) {
+            files[nfiles * 2] = i;
+            files[nfiles * 2 + 1] = 0;
+            nfiles++;
+        }
+        files[(nfiles - 1) * 2 + 1] += fetchqueue.ranges[i].len;
+    }
+
+    nworkers = Min(Min(jobs, MAX_REWIND_JOBS), nfiles);
+    qsort(files, nfiles, 2 * sizeof(uint64), fetch_file_cmp);
+
+    for (i = 0; i < nfiles; i++) {
+        int first = (int)files[i * 2];
+        int worker = 0;
+        int j;
+
+        for (j = 1; j < nworkers; j++) {
+            if (load[j] < load[worker])
+                worker = j;
+        }
+        load[worker] += files[i * 2 + 1];
+
+        for (j = first; j < fetchqueue.nranges && fetchqueue.ranges[j].path == fetchqueue.ranges[first].path; j++)
+            fetchqueue.ranges[j].worker = worker;
+    }
+
+    pg_free(files);
+    return nworkers;
+}
+
+/*
+ * Fetch the queued ranges of 'worker', or all of them if it is negative, over
+ * 'fetchconn' and write them into the target files.
+ */
+static BuildErrorCode fetchQueuedRanges(PGconn* fetchconn, int worker, FILE* file)
+{
+    const char* sql = NULL;
+    PGresult* res = NULL;
+    BuildErrorCode rv = BUILD_SUCCESS;
 
     /*
      * First create a temporary table, and load it with the blocks that we
      * need to fetch.
      */
     sql = "CREATE TEMPORARY TABLE fetchchunks(path text, begin int4, len int4);";
-    res = PQexec(conn, sql);
+    res = PQexec(fetchconn, sql);
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
         pg_fatal("could not create temporary table: %s", PQresultErrorMessage(res));
         PQclear(res);
@@ -601,14 +746,118 @@ BuildErrorCode executeFileMap(filemap_t* map, FILE* file)
     res = NULL;
 
     sql = "set enable_data_replicate= off; COPY fetchchunks FROM STDIN";
-    res = PQexec(conn, sql);
+    res = PQexec(fetchconn, sql);
 
     if (PQresultStatus(res) != PGRES_COPY_IN) {
         pg_fatal("could not send file list: %s", PQresultErrorMessage(res));
         PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
     }
+    PQclear(res);
+    res = NULL;
+
+    rv = copyFetchQueue(fetchconn, worker);
+    PG_CHECKRETURN_AND_RETURN(rv);
+
+    if (PQputCopyEnd(fetchconn, NULL) != 1) {
+        pg_fatal("could not send end-of-COPY: %s", PQerrorMessage(fetchconn));
+        return BUILD_FATAL;
+    }
 
-    fprintf(file, "copy file list to temporary table fetchchunks.\n");
+    while ((res = PQgetResult(fetchconn)) != NULL) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+            pg_fatal("unexpected result while sending file list: %s", PQresultErrorMessage(res));
+            PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
+        }
+        PQclear(res);
+        res = NULL;
+    }
+
+    /*
+     * We've now copied the list of file ranges that we need to fetch to the
+     * temporary table. Now, actually fetch all of those ranges.
+     */
+    sql = "SELECT path, begin, \n"
+          "  pg_read_binary_file(path, begin, len, true) AS chunk,\n"
+          "  len \n"
+          "FROM fetchchunks\n";
+
+    if (file != NULL)
+        fprintf(file, "fetch and write file based on temporary table fetchchunks.\n");
+    return receiveFileChunks(fetchconn, sql, file);
+}
+
+/*
+ * Fetch the queued ranges over 'nworkers' connections at once. This thread
+ * fetches the share of the first one over the main connection, the others get
+ * a thread and a connection of their own.
+ */
+static BuildErrorCode fetchQueuedRangesParallel(int nworkers, FILE* file)
+{
+    fetch_worker_t* workers = NULL;
+    BuildErrorCode rv = BUILD_SUCCESS;
+    int i;
+
+    pg_log(PG_PROGRESS, "fetching changed files over %d connections\n", nworkers);
+
+    workers = (fetch_worker_t*)pg_malloc0(nworkers * sizeof(fetch_worker_t));
+    for (i = 1; i < nworkers; i++) {
+        int rc;
+
+        workers[i].id = i;
+        workers[i].file = file;
+        workers[i].rv = BUILD_SUCCESS;
+        rc = pthread_create(&workers[i].thread, NULL, fetchWorkerMain, &workers[i]);
+        if (rc != 0) {
+            pg_fatal("could not create thread to fetch files: %s\n", strerror(rc));
+            workers[i].thread = 0;
+            workers[i].rv = BUILD_FATAL;
+        }
+    }
+
+    rv = fetchQueuedRanges(conn, 0, file);
+
+    for (i = 1; i < nworkers; i++) {
+        if (workers[i].thread != 0)
+            (void)pthread_join(workers[i].thread, NULL);
+        if (rv == BUILD_SUCCESS)
+            rv = workers[i].rv;
+    }
+    pg_free(workers);
+
+    if (rv == BUILD_SUCCESS)
+        rv = increment_return_code;
+    return rv;
+}
+
+static void* fetchWorkerMain(void* arg)
+{
+    fetch_worker_t* worker = (fetch_worker_t*)arg;
+    PGconn* workerconn = NULL;
+
+    workerconn = connectSource(connstr_source);
+    if (workerconn == NULL) {
+        worker->rv = BUILD_ERROR;
+        return NULL;
+    }
+
+    worker->rv = fetchQueuedRanges(workerconn, worker->id, worker->file);
+
+    close_target_file();
+    PQfinish(workerconn);
+    return NULL;
+}
+
+/*
+ * Fetch all changed blocks from remote source data directory.
+ */
+BuildErrorCode executeFileMap(filemap_t* map, FILE* file)
+{
+    file_entry_t* entry = NULL;
+    BuildErrorCode rv = BUILD_SUCCESS;
+    int nworkers;
+    int i;
+
+    fprintf(file, "queue file ranges to fetch.\n");
     for (i = 0; i < map->narray; i++) {
         entry = map->array[i];
 
@@ -618,7 +867,7 @@ BuildErrorCode executeFileMap(filemap_t* map, FILE* file)
 
         /* If this is a relation file, copy the modified blocks */
         execute_pagemap(&entry->pagemap, entry->path, file);
-        PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
+        PG_CHECKBUILD_AND_RETURN();
         if (strcmp(entry->path, "pg_xlog") == 0) {
             pg_log(PG_PROGRESS, "pg_xlog type %d.\n", entry->type);
         }
@@ -631,29 +880,27 @@ BuildErrorCode executeFileMap(filemap_t* map, FILE* file)
             case FILE_ACTION_COPY:
                 /* Truncate the old file out of the way, if any */
                 open_target_file(entry->path, true);
-                PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
+                PG_CHECKBUILD_AND_RETURN();
                 fetch_file_range(entry->path, 0, entry->newsize);
-                PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
                 break;
 
             case FILE_ACTION_TRUNCATE:
                 truncate_target_file(entry->path, entry->newsize);
-                PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
+                PG_CHECKBUILD_AND_RETURN();
                 break;
 
             case FILE_ACTION_COPY_TAIL:
                 fetch_file_range(entry->path, entry->oldsize, entry->newsize);
-                PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
                 break;
 
             case FILE_ACTION_REMOVE:
                 remove_target(entry);
-                PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
+                PG_CHECKBUILD_AND_RETURN();
                 break;
 
             case FILE_ACTION_CREATE:
                 create_target(entry);
-                PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
+                PG_CHECKBUILD_AND_RETURN();
                 break;
 
             default:
@@ -661,34 +908,15 @@ BuildErrorCode executeFileMap(filemap_t* map, FILE* file)
         }
     }
 
-    if (PQputCopyEnd(conn, NULL) != 1) {
-        pg_fatal("could not send end-of-COPY: %s", PQerrorMessage(conn));
-        PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
-    }
-
-    PQclear(res);
-    res = NULL;
-
-    while ((res = PQgetResult(conn)) != NULL) {
-        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-            pg_fatal("unexpected result while sending file list: %s", PQresultErrorMessage(res));
-            PG_CHECKBUILD_AND_FREE_PGRESULT_RETURN(res);
-        }
-        PQclear(res);
-        res = NULL;
-    }
-
-    /*
-     * We've now copied the list of file ranges that we need to fetch to the
-     * temporary table. Now, actually fetch all of those ranges.
-     */
-    sql = "SELECT path, begin, \n"
-          "  pg_read_binary_file(path, begin, len, true) AS chunk,\n"
-          "  len \n"
-          "FROM fetchchunks\n";
+    /* the main connection is always used, rewind_jobs - 1 more may be opened */
+    nworkers = assignFetchWorkers(rewind_jobs);
+    if (nworkers > 1)
+        rv = fetchQueuedRangesParallel(nworkers, file);
+    else
+        rv = fetchQueuedRanges(conn, -1, file);
 
-    fprintf(file, "fetch and write file based on temporary table fetchchunks.\n");
-    return receiveFileChunks(sql, file);
+    resetFetchQueue();
+    return rv;
 }
 
 /*
@@ -731,6 +959,8 @@ BuildErrorCode executeWalDataMap(filemap_t* map)
         if (entry->isrelfile)
             execute_waldatamap(&entry->pagemap, entry->path, entry->block_size);
     }
+    (void)copyFetchQueue(conn, -1);
+    resetFetchQueue();
 
     if (PQputCopyEnd(conn, NULL) != 1) {
         pg_fatal("could not send end-of-COPY: %s", PQerrorMessage(conn));
@@ -753,7 +983,7 @@ BuildErrorCode executeWalDataMap(filemap_t* map)
           "  pg_read_binary_file(path, begin, len, true) AS chunk\n"
           "FROM fetchchunks_ws\n";
 
-    return receiveFileChunks(sql, NULL);
+    return receiveFileChunks(conn, sql, NULL);
 }
 
 static void execute_waldatamap(datapagemap_t* pagemap, const char* path, size_t block_size)
@@ -841,18 +1071,30 @@ BuildErrorCode backupFileMap(filemap_t* map, const char* lastoff)
     return BUILD_SUCCESS;
 }
 
+/*
+ * Queue the changed blocks of a file, adjacent blocks as one range.
+ */
 static BuildErrorCode execute_pagemap(datapagemap_t* pagemap, const char* path, FILE* file)
 {
     datapagemap_iterator_t* iter = NULL;
     BlockNumber blkno;
-    off_t offset;
+    BlockNumber startblkno = InvalidBlockNumber;
+    BlockNumber endblkno = InvalidBlockNumber;
 
     iter = datapagemap_iterate(pagemap);
     while (datapagemap_next(iter, &blkno)) {
         fprintf(file, "  block %u\n", blkno);
-        offset = blkno * BLCKSZ;
-        fetch_file_range(path, offset, offset + BLCKSZ);
+        if (startblkno != InvalidBlockNumber && blkno == endblkno) {
+            endblkno++;
+            continue;
+        }
+        if (startblkno != InvalidBlockNumber)
+            fetch_file_range(path, startblkno * BLCKSZ, endblkno * BLCKSZ);
+        startblkno = blkno;
+        endblkno = blkno + 1;
     }
+    if (startblkno != InvalidBlockNumber)
+        fetch_file_range(path, startblkno * BLCKSZ, endblkno * BLCKSZ);
     pg_free(iter);
     return BUILD_SUCCESS;
 }
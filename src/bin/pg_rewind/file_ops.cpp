@@ -17,6 +17,7 @@
 #include "knl/knl_variable.h"
 
 #include <fcntl.h>
+#include <pthread.h>
 
 #include "file_ops.h"
 #include "logging.h"
@@ -28,10 +29,13 @@
 #include "replication/replicainternal.h"
 
 /*
- * Currently open target file.
+ * Currently open target file. Each thread fetching from the source has its own.
  */
-static int dstfd = -1;
-static char dstpath[MAXPGPATH] = "";
+static THR_LOCAL int dstfd = -1;
+static THR_LOCAL char dstpath[MAXPGPATH] = "";
+
+/* protects the progress counters against concurrent fetching threads */
+static pthread_mutex_t progress_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static void create_target_dir(const char* path);
 static void remove_target_dir(const char* path);
@@ -148,8 +152,10 @@ void write_target_range(char* buf, off_t begin, size_t size, int space)
     }
 
     /* update progress report */
+    (void)pthread_mutex_lock(&progress_lock);
     fetch_done += size;
     progress_report(false);
+    (void)pthread_mutex_unlock(&progress_lock);
 
     /* keep the file open, in case we need to copy more blocks in it */
 }
@@ -25,6 +25,8 @@
 #include "access/xlogreader.h"
 #include "catalog/pg_control.h"
 #include <stdlib.h>
+#include <dirent.h>
+#include <pthread.h>
 
 #define CONFIG_CASCADE_STANDBY "cascade_standby"
 #define CONFIG_NODENAME "pgxc_node_name"
@@ -39,6 +41,25 @@ typedef struct XLogPageReadPrivate {
     TimeLineID tli;
 } XLogPageReadPrivate;
 
+/*
+ * A thread extracting the page map from a part of the WAL, see
+ * extractPageMapParallel.
+ */
+typedef struct PageMapWorker {
+    pthread_t thread;
+    const char* datadir;
+    TimeLineID tli;
+    XLogRecPtr startpoint; /* first record, or the start of the segment to look for it in */
+    bool findstart;        /* startpoint is the start of a segment */
+    XLogRecPtr endpoint;   /* records from here on belong to the next worker, invalid for the last one */
+} PageMapWorker;
+
+/* the workers add to the page maps of the shared filemap */
+static pthread_mutex_t pagemap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool extractPageMapParallel(const char* datadir, XLogRecPtr startpoint, TimeLineID tli);
+static void* extractPageMapWorker(void* arg);
+static bool findLastXlogSegment(const char* datadir, TimeLineID tli, XLogSegNo* segno);
 static void extractPageInfo(XLogReaderState* record);
 static void extractWalDataInfo(XLogReaderState* record);
 bool checkCommonAncestorByXlog(XLogRecPtr recptr, pg_crc32 standby_reccrc, uint32 term = 0);
@@ -62,6 +83,9 @@ void extractPageMap(const char* datadir, XLogRecPtr startpoint, TimeLineID tli)
     char* errormsg = NULL;
     XLogPageReadPrivate readprivate;
 
+    if (rewind_jobs > 1 && extractPageMapParallel(datadir, startpoint, tli))
+        return;
+
     readprivate.datadir = datadir;
     readprivate.tli = tli;
     xlogreader = XLogReaderAllocate(&SimpleXLogPageRead, &readprivate);
@@ -97,6 +121,169 @@ void extractPageMap(const char* datadir, XLogRecPtr startpoint, TimeLineID tli)
     CloseXlogFile();
 }
 
+/*
+ * extractPageMap with rewind_jobs threads. The segments from the one holding
+ * startpoint up to the last one of the timeline are split into as many runs,
+ * and each thread reads the records starting in its run. A thread other than
+ * the first finds its first record with XLogFindNextRecord, which skips the
+ * tail of a record continued from the previous segment, so every record is
+ * read by exactly one thread.
+ *
+ * Unlike the serial read, the threads after a broken record still go on, so
+ * the page map may get some blocks the serial read would have left out.
+ * Copying more blocks from the source is harmless.
+ *
+ * Returns false if the WAL is too short to split, the caller then reads it
+ * serially.
+ */
+static bool extractPageMapParallel(const char* datadir, XLogRecPtr startpoint, TimeLineID tli)
+{
+    PageMapWorker* workers = NULL;
+    XLogSegNo startseg;
+    XLogSegNo lastseg;
+    uint64 nsegs;
+    int nworkers;
+    int i;
+
+    XLByteToSeg(startpoint, startseg);
+    if (!findLastXlogSegment(datadir, tli, &lastseg) || lastseg <= startseg)
+        return false;
+    nsegs = lastseg - startseg + 1;
+    nworkers = (nsegs < (uint64)rewind_jobs) ? (int)nsegs : rewind_jobs;
+
+    workers = (PageMapWorker*)pg_malloc0(nworkers * sizeof(PageMapWorker));
+    for (i = 0; i < nworkers; i++) {
+        PageMapWorker* worker = &workers[i];
+
+        worker->datadir = datadir;
+        worker->tli = tli;
+        if (i == 0) {
+            worker->startpoint = startpoint;
+            worker->findstart = false;
+        } else {
+            worker->startpoint = (startseg + nsegs * i / nworkers) * XLogSegSize;
+            worker->findstart = true;
+        }
+        if (i == nworkers - 1)
+            worker->endpoint = InvalidXLogRecPtr;
+        else
+            worker->endpoint = (startseg + nsegs * (i + 1) / nworkers) * XLogSegSize;
+    }
+
+    pg_log(PG_PROGRESS, "reading %lu WAL segments in target with %d threads\n", nsegs, nworkers);
+
+    for (i = 0; i < nworkers; i++) {
+        int rc = pthread_create(&workers[i].thread, NULL, extractPageMapWorker, &workers[i]);
+        if (rc != 0) {
+            /* read this run ourselves */
+            pg_log(PG_WARNING, "could not create thread to read WAL: %s\n", strerror(rc));
+            workers[i].thread = 0;
+            (void)extractPageMapWorker(&workers[i]);
+        }
+    }
+    for (i = 0; i < nworkers; i++) {
+        if (workers[i].thread != 0)
+            (void)pthread_join(workers[i].thread, NULL);
+    }
+
+    pg_free(workers);
+    return true;
+}
+
+static void* extractPageMapWorker(void* arg)
+{
+    PageMapWorker* worker = (PageMapWorker*)arg;
+    XLogRecord* record = NULL;
+    XLogReaderState* xlogreader = NULL;
+    char* errormsg = NULL;
+    XLogPageReadPrivate readprivate;
+    XLogRecPtr startpoint = worker->startpoint;
+
+    readprivate.datadir = worker->datadir;
+    readprivate.tli = worker->tli;
+    xlogreader = XLogReaderAllocate(&SimpleXLogPageRead, &readprivate);
+    if (xlogreader == NULL) {
+        pg_log(PG_ERROR, "out of memory\n");
+        return NULL;
+    }
+
+    if (worker->findstart) {
+        startpoint = XLogFindNextRecord(xlogreader, startpoint);
+        if (XLogRecPtrIsInvalid(startpoint)) {
+            /* no valid record from here on, WAL ends before this run */
+            XLogReaderFree(xlogreader);
+            CloseXlogFile();
+            return NULL;
+        }
+    }
+
+    do {
+        record = XLogReadRecord(xlogreader, startpoint, &errormsg);
+        if (record == NULL) {
+            XLogRecPtr errptr = XLByteEQ(startpoint, InvalidXLogRecPtr) ? xlogreader->EndRecPtr : startpoint;
+
+            if (errormsg != NULL)
+                pg_log(PG_WARNING,
+                    "could not read WAL record at %X/%X: %s\n",
+                    (uint32)(errptr >> 32),
+                    (uint32)errptr,
+                    errormsg);
+            else
+                pg_log(PG_WARNING, "could not read WAL record at %X/%X\n", (uint32)(errptr >> 32), (uint32)errptr);
+            break;
+        }
+        if (!XLogRecPtrIsInvalid(worker->endpoint) && XLByteLE(worker->endpoint, xlogreader->ReadRecPtr))
+            break;
+        extractPageInfo(xlogreader);
+        startpoint = InvalidXLogRecPtr; /* continue reading at next record */
+    } while (true);
+
+    XLogReaderFree(xlogreader);
+    CloseXlogFile();
+    return NULL;
+}
+
+/*
+ * Find the last WAL segment of timeline 'tli' in datadir/pg_xlog.
+ */
+static bool findLastXlogSegment(const char* datadir, TimeLineID tli, XLogSegNo* segno)
+{
+    char xlogdir[MAXPGPATH];
+    DIR* dir = NULL;
+    struct dirent* de = NULL;
+    bool found = false;
+    int ss_c = 0;
+
+    ss_c = snprintf_s(xlogdir, MAXPGPATH, MAXPGPATH - 1, "%s/%s", datadir, XLOGDIR);
+    securec_check_ss_c(ss_c, "\0", "\0");
+
+    dir = opendir(xlogdir);
+    if (dir == NULL)
+        return false;
+
+    while ((de = readdir(dir)) != NULL) {
+        TimeLineID filetli;
+        uint32 log;
+        uint32 seg;
+        XLogSegNo filesegno;
+
+        if (strlen(de->d_name) != XLOG_FILE_NAME_LENGTH - 1 ||
+            strspn(de->d_name, "0123456789ABCDEF") != XLOG_FILE_NAME_LENGTH - 1)
+            continue;
+        if (sscanf_s(de->d_name, "%08X%08X%08X", &filetli, &log, &seg) != 3 || filetli != tli)
+            continue;
+
+        filesegno = (uint64)log * XLogSegmentsPerXLogId + seg;
+        if (!found || filesegno > *segno) {
+            *segno = filesegno;
+            found = true;
+        }
+    }
+    (void)closedir(dir);
+
+    return found;
+}
+
 /*
  * Read WAL from the datadir/pg_xlog, starting from 'startpoint' on timeline
  * 'tli'. The read process shall not end until error happens and we get an invalid
@@ -327,7 +514,9 @@ static void extractPageInfo(XLogReaderState* record)
             forknum,
             blkno);
 
+        (void)pthread_mutex_lock(&pagemap_lock);
         process_block_change(forknum, rnode, blkno);
+        (void)pthread_mutex_unlock(&pagemap_lock);
     }
 
     pg_log(PG_DEBUG, "\n");
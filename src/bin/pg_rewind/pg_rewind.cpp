@@ -56,6 +56,7 @@ char* connstr_source = NULL;
 uint32 term = 0;
 bool debug = false;
 bool dry_run = false;
+int rewind_jobs = 1; /* number of threads reading WAL and connections fetching blocks */
 int replication_type = RT_WITH_DUMMY_STANDBY;
 bool ws_replication = false;
 char divergeXlogFileName[MAXFNAMELEN] = {0};
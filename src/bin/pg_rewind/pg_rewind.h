@@ -34,6 +34,7 @@
 #define MAX_ERR_MSG_LENTH 1024
 #define XLOG_FILE_NAME_LENGTH 25
 #define MAX_CONFIG_FILE_SIZE 0xFFFFF /* max file size for configurations = 1M */
+#define MAX_REWIND_JOBS 64 /* max value of rewind_jobs */
 typedef enum { BUILD_SUCCESS = 0, BUILD_ERROR, BUILD_FATAL } BuildErrorCode;
 
 /* Configuration options */
@@ -43,6 +44,7 @@ extern char* connstr_source;
 extern bool debug;
 extern bool showprogress;
 extern bool dry_run;
+extern int rewind_jobs;
 extern int replication_type;
 extern bool backup;
 extern pid_t process_id;
@@ -1488,6 +1488,48 @@ CREATE VIEW pg_stat_bgwriter AS
         pg_stat_get_buf_alloc() AS buffers_alloc,
         pg_stat_get_bgwriter_stat_reset_time() AS stats_reset;
 
+CREATE VIEW pg_catalog.gs_xact_status_cache AS
+    SELECT
+        S.csn_single_hits,
+        S.csn_lookups,
+        S.csn_hits,
+        CASE WHEN S.csn_lookups = 0 THEN 0
+             ELSE round(S.csn_hits::numeric / S.csn_lookups, 4) END AS csn_hit_ratio,
+        S.clog_single_hits,
+        S.clog_lookups,
+        S.clog_hits,
+        CASE WHEN S.clog_lookups = 0 THEN 0
+             ELSE round(S.clog_hits::numeric / S.clog_lookups, 4) END AS clog_hit_ratio
+    FROM pg_catalog.gs_xact_status_cache_stat() AS S;
+
+CREATE VIEW pg_catalog.gs_redo_record_latency AS
+    SELECT
+        S.name AS rmgr,
+        S.detail AS record_type,
+        S.bucket_us,
+        S.count AS sampled_count,
+        S.total_us
+    FROM pg_catalog.gs_redo_stat() AS S
+    WHERE S.stat_type = 'record_latency';
+
+CREATE VIEW pg_catalog.gs_redo_relation_heat AS
+    SELECT
+        S.name AS relfilenode,
+        S.detail AS bucketid,
+        S.count AS sampled_count,
+        S.total_us
+    FROM pg_catalog.gs_redo_stat() AS S
+    WHERE S.stat_type = 'relation_heat'
+    ORDER BY S.total_us DESC;
+
+CREATE VIEW pg_catalog.gs_redo_worker_queue AS
+    SELECT
+        S.name::int4 AS worker_id,
+        S.sample_time,
+        S.count AS queue_depth
+    FROM pg_catalog.gs_redo_stat() AS S
+    WHERE S.stat_type = 'worker_queue';
+
 CREATE VIEW pg_user_mappings AS
     SELECT
         U.oid       AS umid,
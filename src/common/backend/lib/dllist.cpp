@@ -255,6 +255,15 @@ void DllistWithLock::AddTail(Dlelem* e)
     END_CRIT_SECTION();
 }
 
+void DllistWithLock::AddHead(Dlelem* e)
+{
+    START_CRIT_SECTION();
+    SpinLockAcquire(&(m_lock));
+    DLAddHead(&m_list, e);
+    SpinLockRelease(&(m_lock));
+    END_CRIT_SECTION();
+}
+
 Dlelem* DllistWithLock::RemoveHead()
 {
     Dlelem* head = NULL;
@@ -266,6 +275,41 @@ Dlelem* DllistWithLock::RemoveHead()
     return head;
 }
 
+/* Remove and return the head, if there is one and cond holds for it. */
+Dlelem* DllistWithLock::RemoveHeadIf(bool (*cond)(Dlelem* e, void* arg), void* arg)
+{
+    Dlelem* head = NULL;
+    START_CRIT_SECTION();
+    SpinLockAcquire(&(m_lock));
+    head = DLGetHead(&m_list);
+    if (head != NULL && cond(head, arg)) {
+        DLRemove(head);
+    } else {
+        head = NULL;
+    }
+    SpinLockRelease(&(m_lock));
+    END_CRIT_SECTION();
+    return head;
+}
+
+/* Move every element for which cond holds to the tail of removed, a list of the caller's own. */
+void DllistWithLock::RemoveAllIf(bool (*cond)(Dlelem* e, void* arg), void* arg, Dllist* removed)
+{
+    START_CRIT_SECTION();
+    SpinLockAcquire(&(m_lock));
+    Dlelem* elem = DLGetHead(&m_list);
+    while (elem != NULL) {
+        Dlelem* next = DLGetSucc(elem);
+        if (cond(elem, arg)) {
+            DLRemove(elem);
+            DLAddTail(removed, elem);
+        }
+        elem = next;
+    }
+    SpinLockRelease(&(m_lock));
+    END_CRIT_SECTION();
+}
+
 bool DllistWithLock::IsEmpty()
 {
     START_CRIT_SECTION();
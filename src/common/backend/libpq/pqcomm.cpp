@@ -57,6 +57,8 @@
  *		pq_flush		- flush pending output
  *		pq_flush_if_writable - flush pending output if writable without blocking
  *		pq_getbyte_if_available - get a byte if available without blocking
+ *		pq_has_buffered_message - is a whole message waiting in the input buffer
+ *		pq_wait_for_input - wait a limited time for client input
  *
  * message-level I/O (and old-style-COPY-OUT cruft):
  *		pq_putmessage	- send a normal message (suppressed in COPY OUT mode)
@@ -91,6 +93,7 @@
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/ipc.h"
+#include "storage/latch.h"
 #include "utils/guc.h"
 #include "utils/memutils.h"
 #include "libpq/pqcomm.h"
@@ -126,6 +129,9 @@ extern GlobalNodeDefinition* global_node_definition;
 #define PQ_RECV_BUFFER_SIZE PQ_BUFFER_SIZE
 #endif
 
+/* pipelines are read in larger chunks, see pq_pipeline_prepare_read() */
+#define PQ_PIPELINE_RECV_BUFFER_SIZE (8 * PQ_BUFFER_SIZE)
+
 #define NAPTIME_PER_SEND_RETRY 100 /* max sleep between two send try (100ms) */
 #define NAPTIME_PER_SEND 10        /* max sleep before sending next batch of data (10ms) */
 
@@ -135,6 +141,7 @@ void pq_close(int code, Datum arg);
 static int internal_putbytes(const char* s, size_t len);
 static int internal_flush(void);
 static void pq_set_nonblocking(bool nonblocking);
+static int pq_pipeline_prepare_read(void);
 static void pq_disk_generate_checking_header(
     const char* src_data, StringInfo dest_data, uint32 data_len, uint32 seq_num);
 static size_t pq_disk_read_data_block(
@@ -750,6 +757,19 @@ int StreamServerPort(int family, char* hostName, unsigned short portNumber, cons
                     goto errhandle;
                 }
             }
+#ifdef SO_REUSEPORT
+            /*
+             * The thread pool listeners bind sockets of their own to the client ports,
+             * see ThreadPoolListener::CreateAcceptSockets.
+             */
+            if (is_create_psql_sock && g_instance.attr.attr_common.enable_thread_pool &&
+                g_instance.attr.attr_common.thread_pool_reuseport) {
+                if ((setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (char*)&one, sizeof(one))) == -1) {
+                    ereport(LOG, (errcode_for_socket_access(), errmsg("setsockopt(SO_REUSEPORT) failed: %m")));
+                    goto errhandle;
+                }
+            }
+#endif
         }
 #endif
 
@@ -1260,7 +1280,7 @@ static int pq_recvbuf(void)
         WaitState oldStatus = pgstat_report_waitstatus(STATE_WAIT_COMM);
         r = secure_read(u_sess->proc_cxt.MyProcPort,
             t_thrd.libpq_cxt.PqRecvBuffer + t_thrd.libpq_cxt.PqRecvLength,
-            PQ_RECV_BUFFER_SIZE - t_thrd.libpq_cxt.PqRecvLength);
+            t_thrd.libpq_cxt.PqRecvBufferSize - t_thrd.libpq_cxt.PqRecvLength);
         (void)pgstat_report_waitstatus(oldStatus);
 
         if (r < 0) {
@@ -1296,6 +1316,9 @@ static int pq_recvbuf(void)
  */
 int pq_getbyte(void)
 {
+    if (u_sess->attr.attr_sql.enable_pipeline_mode && pq_pipeline_prepare_read() == EOF) {
+        return EOF;
+    }
     while (t_thrd.libpq_cxt.PqRecvPointer >= t_thrd.libpq_cxt.PqRecvLength) {
         if (pq_recvbuf()) { /* If nothing in buffer, then recv some */
             return EOF;   /* Failed to recv data */
@@ -1367,6 +1390,93 @@ int pq_getbyte_if_available(unsigned char* c)
     return r;
 }
 
+/* --------------------------------
+ *		pq_has_buffered_message - is a whole message waiting in the input buffer
+ *
+ * Returns true if the next message, type byte and length word included, has
+ * been received completely, so that reading it will not block.
+ * --------------------------------
+ */
+bool pq_has_buffered_message(void)
+{
+    int avail = t_thrd.libpq_cxt.PqRecvLength - t_thrd.libpq_cxt.PqRecvPointer;
+    uint32 len;
+    errno_t rc;
+
+    if (avail < 1 + 4) {
+        return false;
+    }
+
+    rc = memcpy_s(&len, sizeof(len), t_thrd.libpq_cxt.PqRecvBuffer + t_thrd.libpq_cxt.PqRecvPointer + 1, 4);
+    securec_check(rc, "\0", "\0");
+    len = ntohl(len);
+
+    return len >= 4 && len <= (uint32)(avail - 1);
+}
+
+/* --------------------------------
+ *		pq_pipeline_prepare_read - get ready to read the next message of a pipeline
+ *
+ * ReadyForQuery leaves its output in the send buffer if the next message has
+ * arrived already. Send it before the next message can make us wait for the
+ * client, which may want those results before it sends the rest. The receive
+ * buffer is enlarged as well, so that a pipeline is read in a few large chunks
+ * even if it has a single Sync.
+ *
+ * returns 0 if OK, EOF if trouble
+ * --------------------------------
+ */
+static int pq_pipeline_prepare_read(void)
+{
+    if (t_thrd.libpq_cxt.PqRecvBufferSize < PQ_PIPELINE_RECV_BUFFER_SIZE) {
+        /* repalloc keeps the input that has not been read yet */
+        t_thrd.libpq_cxt.PqRecvBuffer =
+            (char*)repalloc(t_thrd.libpq_cxt.PqRecvBuffer, PQ_PIPELINE_RECV_BUFFER_SIZE);
+        t_thrd.libpq_cxt.PqRecvBufferSize = PQ_PIPELINE_RECV_BUFFER_SIZE;
+    }
+
+    if (t_thrd.libpq_cxt.PqSendPointer > t_thrd.libpq_cxt.PqSendStart && !pq_has_buffered_message()) {
+        return pq_flush();
+    }
+    return 0;
+}
+
+/* --------------------------------
+ *		pq_wait_for_input - wait a limited time for client input
+ *
+ * Returns false if no input arrived within timeout ms. Returns true if
+ * there is input to read, or if the wait was cut short by a signal, whose
+ * interrupt the caller handles when it goes on to read as usual.
+ * --------------------------------
+ */
+bool pq_wait_for_input(long timeout)
+{
+    Port* port = u_sess->proc_cxt.MyProcPort;
+    int rc;
+
+    if (t_thrd.libpq_cxt.PqRecvPointer < t_thrd.libpq_cxt.PqRecvLength || port->is_logic_conn) {
+        return true;
+    }
+#ifdef USE_SSL
+    if (port->ssl != NULL && SSL_pending(port->ssl) > 0) {
+        return true;
+    }
+#endif
+
+    /* the client may be waiting for output of ours before it sends anything */
+    if (t_thrd.libpq_cxt.PqSendPointer > t_thrd.libpq_cxt.PqSendStart && pq_flush() == EOF) {
+        return true;
+    }
+
+    rc = WaitLatchOrSocket(
+        &t_thrd.proc->procLatch, WL_LATCH_SET | WL_SOCKET_READABLE | WL_TIMEOUT, port->sock, timeout);
+    if (rc & WL_LATCH_SET) {
+        ResetLatch(&t_thrd.proc->procLatch);
+    }
+
+    return (rc & WL_TIMEOUT) == 0;
+}
+
 /* --------------------------------
  *		pq_getbytes		- get a known number of bytes from connection
  *
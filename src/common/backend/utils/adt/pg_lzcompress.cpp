@@ -174,6 +174,7 @@
 
 #include <limits.h>
 
+#include "access/xact.h"
 #include "utils/pg_lzcompress.h"
 
 /* ----------
@@ -500,6 +501,16 @@ bool pglz_compress(const char* source, int32 slen, PGLZ_Header* dest, const PGLZ
         result_max = (slen * (100 - need_rate)) / 100;
     }
 
+    /*
+     * Most sessions never compress anything, so the history is only allocated
+     * here. knl_session_release_idle() frees it again once it is left unused.
+     */
+    if (u_sess->utils_cxt.hist_start == NULL) {
+        u_sess->utils_cxt.hist_start = (PGLZ_HistEntry**)MemoryContextAlloc(u_sess->top_mem_cxt, HIST_START_LEN);
+        u_sess->utils_cxt.hist_entries = (PGLZ_HistEntry*)MemoryContextAlloc(u_sess->top_mem_cxt, HIST_ENTRIES_LEN);
+    }
+    u_sess->utils_cxt.hist_last_used = GetCurrentStatementStartTimestamp();
+
     /*
      * Initialize the history lists to empty.  We do not need to zero the
      * u_sess->utils_cxt.hist_entries[] array; its entries are initialized as they are used.
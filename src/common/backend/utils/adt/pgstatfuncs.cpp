@@ -12306,9 +12306,9 @@ Datum gs_globalplancache_status(PG_FUNCTION_ARGS)
         */
         old_context = MemoryContextSwitchTo(func_ctx->multi_call_memory_ctx);
 
-#define GPC_TUPLES_ATTR_NUM 7
+#define GPC_TUPLES_ATTR_NUM 11
 
-        /* need a tuple descriptor representing 12 columns */
+        /* need a tuple descriptor representing 11 columns */
         tup_desc = CreateTemplateTupleDesc(GPC_TUPLES_ATTR_NUM, false);
 
         TupleDescInitEntry(tup_desc, (AttrNumber) 1, "nodename",
@@ -12325,6 +12325,14 @@ Datum gs_globalplancache_status(PG_FUNCTION_ARGS)
                            TEXTOID, -1, 0);
         TupleDescInitEntry(tup_desc, (AttrNumber) 7, "params_num",
                            INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 8, "bucket_id",
+                           INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 9, "bucket_hits",
+                           INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 10, "bucket_misses",
+                           INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 11, "bucket_lock_waits",
+                           INT8OID, -1, 0);
 
         /* complete descriptor of the tupledesc */
         func_ctx->tuple_desc = BlessTupleDesc(tup_desc);
@@ -12364,6 +12372,18 @@ Datum gs_globalplancache_status(PG_FUNCTION_ARGS)
         values[4] = DatumGetObjectId(entry->DatabaseID);
         values[5] = CStringGetTextDatum(entry->schema_name);
         values[6] = Int32GetDatum(entry->params_num);
+        /* lookups of the bucket the entry hashes to, none for invalid plansources out of the cache */
+        if (entry->bucket_id >= 0) {
+            values[7] = Int32GetDatum(entry->bucket_id);
+            values[8] = Int64GetDatum(entry->bucket_hits);
+            values[9] = Int64GetDatum(entry->bucket_misses);
+            values[10] = Int64GetDatum(entry->bucket_lock_waits);
+        } else {
+            nulls[7] = true;
+            nulls[8] = true;
+            nulls[9] = true;
+            nulls[10] = true;
+        }
 
         tuple = heap_form_tuple(func_ctx->tuple_desc, values, nulls);
         SRF_RETURN_NEXT(func_ctx, HeapTupleGetDatum(tuple));
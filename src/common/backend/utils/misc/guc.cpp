@@ -523,6 +523,7 @@ static bool analysis_options_check(char** newval, void** extra, GucSource source
 static void analysis_options_guc_assign(const char* newval, void* extra);
 
 static bool check_behavior_compat_options(char** newval, void** extra, GucSource source);
+static bool check_standby_read_lsn(char** newval, void** extra, GucSource source);
 static void assign_behavior_compat_options(const char* newval, void* extra);
 static void assign_use_workload_manager(const bool newval, void* extra);
 static void assign_convert_string_to_digit(bool newval, void* extra);
@@ -777,6 +778,11 @@ static const struct config_enum_entry io_priority_level_options[] = {{"None", IO
     {"High", IOPRIORITY_HIGH, false},
     {NULL, 0, false}};
 
+static const struct config_enum_entry session_latency_class_options[] = {{"auto", LATENCY_CLASS_AUTO, false},
+    {"short", LATENCY_CLASS_SHORT, false},
+    {"long", LATENCY_CLASS_LONG, false},
+    {NULL, 0, false}};
+
 static const struct config_enum_entry track_function_options[] = {
     {"none", TRACK_FUNC_OFF, false}, {"pl", TRACK_FUNC_PL, false}, {"all", TRACK_FUNC_ALL, false}, {NULL, 0, false}};
 
@@ -1820,6 +1826,21 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_pipeline_mode",
+                PGC_USERSET,
+                CLIENT_CONN_OTHER,
+                gettext_noop("Defers the flush at Sync while more pipelined messages are waiting."),
+                gettext_noop("The results of a pipeline are then sent once its messages are all done, "
+                             "or whenever the send buffer is full.")
+            },
+            &u_sess->attr.attr_sql.enable_pipeline_mode,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_force_vector_engine",
@@ -3149,6 +3170,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "report_commit_lsn",
+                PGC_USERSET,
+                REPLICATION_SENDING,
+                gettext_noop("Reports the WAL location of each commit to the client."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.report_commit_lsn,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_stream_replication",
@@ -3163,6 +3198,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_wal_stream_compression",
+                PGC_SIGHUP,
+                REPLICATION_STANDBY,
+                gettext_noop("Requests the WAL streamed to this standby to be compressed."),
+                gettext_noop("Takes effect when the walreceiver reconnects to the primary.")
+            },
+            &u_sess->attr.attr_storage.enable_wal_stream_compression,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "allow_system_table_mods",
@@ -3781,6 +3830,21 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "thread_pool_reuseport",
+                PGC_POSTMASTER,
+                CLIENT_CONN,
+                gettext_noop("Let each thread pool listener accept new connections on a socket of its own."),
+                gettext_noop("The listen sockets are opened with SO_REUSEPORT, so the kernel spreads "
+                             "new connections over the postmaster and the thread pool listeners.")
+            },
+            &g_instance.attr.attr_common.thread_pool_reuseport,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_global_plancache",
@@ -3886,6 +3950,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "comm_shm_mode",
+                PGC_POSTMASTER,
+                CLIENT_CONN,
+                gettext_noop("Whether use shared memory for stream data between instances on the same host"),
+                NULL,
+            },
+            &g_instance.attr.attr_network.comm_shm_mode,
+            true,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "comm_debug_mode",
@@ -4907,6 +4985,23 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "standby_read_lsn_timeout",
+                PGC_USERSET,
+                REPLICATION_STANDBY,
+                gettext_noop("Sets the maximum time to wait for replay of standby_read_lsn."),
+                gettext_noop("Zero waits without limit."),
+                GUC_UNIT_MS
+            },
+            &u_sess->attr.attr_storage.standby_read_lsn_timeout,
+            10 * 1000,
+            0,
+            INT_MAX,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "wal_receiver_status_interval",
@@ -6487,6 +6582,40 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "logical_decoding_work_mem",
+                PGC_USERSET,
+                REPLICATION_SENDING,
+                gettext_noop("Sets the memory a transaction may use in logical decoding before it is streamed."),
+                gettext_noop("Only used if the output plugin streams in-progress transactions."),
+                GUC_UNIT_KB
+            },
+            &u_sess->attr.attr_storage.logical_decoding_work_mem,
+            65536,
+            64,
+            MAX_KILOBYTES,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "logical_decoding_read_ahead",
+                PGC_SIGHUP,
+                REPLICATION_SENDING,
+                gettext_noop("Sets the amount of WAL a logical walsender reads ahead of decoding."),
+                gettext_noop("The WAL is read by a separate thread. Zero disables read-ahead."),
+                GUC_UNIT_XBLOCKS
+            },
+            &u_sess->attr.attr_storage.logical_decoding_read_ahead,
+            256,
+            0,
+            65536,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "replication_type",
@@ -9075,6 +9204,22 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "recovery_prefetch_distance",
+                PGC_POSTMASTER,
+                RESOURCES_RECOVERY,
+                gettext_noop("The max number of blocks prefetched ahead of parallel redo workers."),
+                gettext_noop("Zero disables prefetching of blocks referenced by WAL records.")
+            },
+            &g_instance.attr.attr_storage.recovery_prefetch_distance,
+            0,
+            0,
+            MAX_RECOVERY_PREFETCH_DISTANCE,
+            NULL,
+            NULL,
+            NULL
+        },
         /* End-of-list marker */
         {
             {
@@ -10961,6 +11106,20 @@ static void init_configure_names_string()
             NULL,
             NULL
         },
+        {
+            {
+                "standby_read_lsn",
+                PGC_USERSET,
+                REPLICATION_STANDBY,
+                gettext_noop("Sets the WAL location a hot standby must have replayed before a transaction starts."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.standby_read_lsn,
+            "",
+            check_standby_read_lsn,
+            NULL,
+            NULL
+        },
         /* control for logging backend modules */
         {
             {
@@ -11482,6 +11641,22 @@ static void init_configure_names_enum()
             NULL,
             NULL
         },
+        {
+            {
+                "session_latency_class",
+                PGC_USERSET,
+                RESOURCES_WORKLOAD,
+                gettext_noop("Sets the latency class the thread pool schedules the session in."),
+                gettext_noop("Sessions in the long class wait behind short ones. auto picks the class "
+                             "from the elapsed time unique SQL recorded for the last statement.")
+            },
+            &u_sess->attr.attr_resource.session_latency_class,
+            LATENCY_CLASS_AUTO,
+            session_latency_class_options,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "trace_recovery_messages",
@@ -21549,6 +21724,24 @@ static void assign_instr_unique_sql_count(int newval, void* extra)
     }
 }
 
+/*
+ * check_standby_read_lsn - standby_read_lsn is either empty or a location like 0/3000060
+ */
+static bool check_standby_read_lsn(char** newval, void** extra, GucSource source)
+{
+    uint32 hi = 0;
+    uint32 lo = 0;
+
+    if (*newval == NULL || (*newval)[0] == '\0') {
+        return true;
+    }
+    if (sscanf_s(*newval, "%X/%X", &hi, &lo) != 2) {
+        GUC_check_errdetail("Expected a WAL location like \"0/3000060\".");
+        return false;
+    }
+    return true;
+}
+
 /*
  * callback function for numa_distribute_mode checking.
  */
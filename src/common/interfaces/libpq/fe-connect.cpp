@@ -255,6 +255,8 @@ static const PQconninfoOption PQconninfoOptions[] = {
 #endif
     {"replication", NULL, NULL, NULL, "Replication", "D", 5, 0},
     {"backend_version", NULL, NULL, NULL, "Backend-version", "D", 10, 0},
+    /* ask the server for vectorized results as columnar batches */
+    {"columnar_result", NULL, NULL, NULL, "Columnar-result", "", 5, 0},
     {"prototype", NULL, "1", NULL, "Prototype", "", 2, 0},
 
     /* Connection_info is a json string containing driver_name, driver_version, driver_path and os_user.
@@ -919,6 +921,8 @@ static void fillPGconn(PGconn* conn, PQconninfoOption* connOptions)
     conn->replication = (tmp != NULL) ? strdup(tmp) : NULL;
     tmp = conninfo_getval(connOptions, "backend_version");
     conn->backend_version = (tmp != NULL) ? strdup(tmp) : NULL;
+    tmp = conninfo_getval(connOptions, "columnar_result");
+    conn->columnar_result = (tmp != NULL) ? strdup(tmp) : NULL;
 
     tmp = conninfo_getval(connOptions, "fencedUdfRPCMode");
     conn->fencedUdfRPCMode = (tmp != NULL) ? true : false;
@@ -3211,6 +3215,7 @@ void freePGconn(PGconn* conn)
     libpq_free(conn->dbName);
     libpq_free(conn->replication);
     libpq_free(conn->backend_version);
+    libpq_free(conn->columnar_result);
     libpq_free(conn->pguser);
     if (conn->pgpass != NULL) {
         erase_string(conn->pgpass);
@@ -39,14 +39,17 @@
  * This macro lists the backend message types that could be "long" (more
  * than a couple of kilobytes).
  */
-#define VALID_LONG_MESSAGE_TYPE(id) \
-    ((id) == 'T' || (id) == 'D' || (id) == 'd' || (id) == 'V' || (id) == 'E' || (id) == 'N' || (id) == 'A')
+#define VALID_LONG_MESSAGE_TYPE(id)                                                                            \
+    ((id) == 'T' || (id) == 'D' || (id) == 'b' || (id) == 'd' || (id) == 'V' || (id) == 'E' || (id) == 'N' || \
+        (id) == 'A')
 
 THR_LOCAL uint32 *g_workingVersionNum = NULL;
 static void handleSyncLoss(PGconn* conn, char id, int msgLength);
 static int getRowDescriptions(PGconn* conn, int msgLength);
 static int getParamDescriptions(PGconn* conn);
 static int getAnotherTuple(PGconn* conn, int msgLength);
+static int getColumnarBatch(PGconn* conn, int msgLength);
+static int checkRowBuf(PGconn* conn, int nfields);
 static int getParameterStatus(PGconn* conn);
 static int getNotify(PGconn* conn);
 static int getCopyStart(PGconn* conn, ExecStatusType copytype);
@@ -303,6 +306,27 @@ void pqParseInput3(PGconn* conn)
                         conn->inCursor += msgLength;
                     }
                     break;
+                case 'b': /* Columnar Batch */
+                    if (conn->result != NULL && conn->result->resultStatus == PGRES_TUPLES_OK) {
+                        /* Read the rows of a batch of a normal query response */
+                        if (getColumnarBatch(conn, msgLength))
+                            return;
+                        /* getColumnarBatch() moves inStart itself */
+                        continue;
+                    } else if (conn->result != NULL && conn->result->resultStatus == PGRES_FATAL_ERROR) {
+                        /* Already failed, discard rows till the end of the query */
+                        conn->inCursor += msgLength;
+                    } else {
+                        /* Set up to report error at end of query */
+                        printfPQExpBuffer(&conn->errorMessage,
+                            libpq_gettext("server sent data (\"b\" message) without prior row description"
+                            "(\"T\" message), remote datanode %s, errno: %s\n"),
+                            conn->remote_nodename, strerror(errno));
+                        pqSaveErrorResult(conn);
+                        /* Discard the unexpected message */
+                        conn->inCursor += msgLength;
+                    }
+                    break;
                 case 'G': /* Start Copy In */
                     if (getCopyStart(conn, PGRES_COPY_IN))
                         return;
@@ -638,22 +662,9 @@ static int getAnotherTuple(PGconn* conn, int msgLength)
     }
 
     /* Resize row buffer if needed */
-    if (nfields > conn->rowBufLen) {
-        rowbuf = (PGdataValue*)malloc(nfields * sizeof(PGdataValue));
-
-        if (rowbuf == NULL) {
-            errmsg = NULL; /* means "out of memory", see below */
-            goto advance_and_error;
-        }
-        if (conn->rowBuf != NULL) {
-            // the length > SECUREC_STRING_MAX_LEN
-            errno_t rc = memcpy_s(rowbuf, nfields * sizeof(PGdataValue), 
-                                  conn->rowBuf, conn->rowBufLen * sizeof(PGdataValue));
-            securec_check_c(rc, "\0", "\0");
-            free(conn->rowBuf);
-        }
-        conn->rowBuf = rowbuf;
-        conn->rowBufLen = nfields;
+    if (checkRowBuf(conn, nfields)) {
+        errmsg = NULL; /* means "out of memory", see below */
+        goto advance_and_error;
     }
     rowbuf = conn->rowBuf;
 
@@ -732,6 +743,196 @@ set_error_result:
     return 0;
 }
 
+/*
+ * Make sure conn->rowBuf can hold nfields values. Returns EOF if out of memory.
+ */
+static int checkRowBuf(PGconn* conn, int nfields)
+{
+    PGdataValue* rowbuf = NULL;
+
+    if (nfields <= conn->rowBufLen)
+        return 0;
+
+    rowbuf = (PGdataValue*)malloc(nfields * sizeof(PGdataValue));
+    if (rowbuf == NULL)
+        return EOF;
+
+    if (conn->rowBuf != NULL) {
+        // the length > SECUREC_STRING_MAX_LEN
+        errno_t rc = memcpy_s(rowbuf, nfields * sizeof(PGdataValue), 
+                              conn->rowBuf, conn->rowBufLen * sizeof(PGdataValue));
+        securec_check_c(rc, "\0", "\0");
+        free(conn->rowBuf);
+    }
+    conn->rowBuf = rowbuf;
+    conn->rowBufLen = nfields;
+
+    return 0;
+}
+
+/* a column of a columnar batch being read */
+typedef struct {
+    char kind;          /* 'f' for fixed-length values, 'v' for counted values */
+    int width;          /* length of the values of an 'f' column */
+    const char* bitmap; /* validity bitmap, a set bit is a non-null row */
+    const char* next;   /* value of the next row */
+} ColumnarBatchCol;
+
+/*
+ * parseInput subroutine to read a 'b' (columnar batch) message, which the server
+ * sends instead of DataRow messages for vectorized plans when the connection asked
+ * for columnar_result. The rows of the batch are added to the result one at a time,
+ * so that the application reads them as usual. Only columns requested in binary
+ * format are sent as fixed-length values.
+ * Returns: 0 if processed message successfully, EOF to suspend parsing
+ * (the latter case is not actually used currently).
+ */
+static int getColumnarBatch(PGconn* conn, int msgLength)
+{
+    PGresult* result = conn->result;
+    int nfields = result->numAttributes;
+    const char* errmsg = NULL;
+    ColumnarBatchCol* cols = NULL;
+    PGdataValue* rowbuf = NULL;
+    int batchnfields;
+    int nrows;
+    int bitmaplen;
+    int vlen;
+    int i;
+    int j;
+
+    /* a batch can't be handed out one row per PGresult */
+    if (conn->singleRowMode) {
+        errmsg = libpq_gettext("columnar results are not supported in single-row mode");
+        goto advance_and_error;
+    }
+
+    if (pqGetInt(&batchnfields, 2, conn) || pqGetInt(&nrows, 4, conn)) {
+        errmsg = libpq_gettext("insufficient data in \"b\" message");
+        goto advance_and_error;
+    }
+    if (batchnfields != nfields || nrows < 0) {
+        errmsg = libpq_gettext("unexpected field count in \"b\" message");
+        goto advance_and_error;
+    }
+
+    if (checkRowBuf(conn, nfields)) {
+        errmsg = NULL; /* means "out of memory", see below */
+        goto advance_and_error;
+    }
+    rowbuf = conn->rowBuf;
+
+    cols = (ColumnarBatchCol*)malloc((nfields > 0 ? nfields : 1) * sizeof(ColumnarBatchCol));
+    if (cols == NULL) {
+        errmsg = NULL; /* means "out of memory", see below */
+        goto advance_and_error;
+    }
+
+    /* Locate the data of each column */
+    bitmaplen = (nrows + 7) / 8;
+    for (i = 0; i < nfields; i++) {
+        ColumnarBatchCol* col = cols + i;
+
+        col->width = 0;
+        if (pqGetc(&col->kind, conn) || (col->kind == 'f' && pqGetInt(&col->width, 2, conn))) {
+            errmsg = libpq_gettext("insufficient data in \"b\" message");
+            goto advance_and_error;
+        }
+        if ((col->kind != 'f' && col->kind != 'v') || col->width < 0) {
+            errmsg = libpq_gettext("unexpected column kind in \"b\" message");
+            goto advance_and_error;
+        }
+
+        col->bitmap = conn->inBuffer + conn->inCursor;
+        if (pqSkipnchar(bitmaplen, conn)) {
+            errmsg = libpq_gettext("insufficient data in \"b\" message");
+            goto advance_and_error;
+        }
+
+        col->next = conn->inBuffer + conn->inCursor;
+        if (col->kind == 'f') {
+            if (pqSkipnchar((size_t)col->width * nrows, conn)) {
+                errmsg = libpq_gettext("insufficient data in \"b\" message");
+                goto advance_and_error;
+            }
+            /* fixed-length values are the binary format of the type */
+            if (result->attDescs[i].format != 1) {
+                errmsg = libpq_gettext("unexpected column kind in \"b\" message");
+                goto advance_and_error;
+            }
+            continue;
+        }
+
+        for (j = 0; j < nrows; j++) {
+            if ((col->bitmap[j / 8] & (1 << (j % 8))) == 0)
+                continue;
+            if (pqGetInt(&vlen, 4, conn) || vlen < 0 || pqSkipnchar(vlen, conn)) {
+                errmsg = libpq_gettext("insufficient data in \"b\" message");
+                goto advance_and_error;
+            }
+        }
+    }
+
+    /* Sanity check that we absorbed all the data */
+    if (conn->inCursor != conn->inStart + 5 + msgLength) {
+        errmsg = libpq_gettext("extraneous data in \"b\" message");
+        goto advance_and_error;
+    }
+
+    /* Advance inStart to show that the "b" message has been processed. */
+    conn->inStart = conn->inCursor;
+
+    /* Process the rows of the batch, the data stays in inBuffer meanwhile */
+    for (j = 0; j < nrows; j++) {
+        for (i = 0; i < nfields; i++) {
+            ColumnarBatchCol* col = cols + i;
+            bool isnull = (col->bitmap[j / 8] & (1 << (j % 8))) == 0;
+
+            if (col->kind == 'f') {
+                rowbuf[i].len = isnull ? -1 : col->width;
+                rowbuf[i].value = col->next + (size_t)col->width * j;
+            } else if (isnull) {
+                rowbuf[i].len = -1;
+                rowbuf[i].value = col->next;
+            } else {
+                uint32 nlen;
+                errno_t rc = memcpy_s(&nlen, sizeof(nlen), col->next, sizeof(nlen));
+                securec_check_c(rc, "\0", "\0");
+                rowbuf[i].len = (int)ntohl(nlen);
+                rowbuf[i].value = col->next + sizeof(nlen);
+                col->next += sizeof(nlen) + rowbuf[i].len;
+            }
+        }
+
+        errmsg = NULL;
+        if (!pqRowProcessor(conn, &errmsg)) {
+            free(cols);
+            goto set_error_result;
+        }
+    }
+
+    free(cols);
+    return 0; /* normal, successful exit */
+
+advance_and_error:
+    /* Discard the failed message by pretending we read it */
+    conn->inStart += 5 + msgLength;
+    if (cols != NULL)
+        free(cols);
+
+set_error_result:
+    /* Replace partially constructed result with an error result, like getAnotherTuple */
+    pqClearAsyncResult(conn);
+
+    if (errmsg == NULL)
+        errmsg = libpq_gettext("out of memory for query result");
+
+    printfPQExpBuffer(&conn->errorMessage, "%s\n", errmsg);
+    pqSaveErrorResult(conn);
+
+    return 0;
+}
+
 /*
  * Attempt to read an Error or Notice response message.
  * This is possible in several places, so we break it out as a subroutine.
@@ -1851,6 +2052,7 @@ static bool add_options_to_package(const PGconn* conn, char* packet, int *packet
         !ADD_STARTUP_OPTION("database", conn->dbName, packet, packet_len) ||
         !ADD_STARTUP_OPTION("replication", conn->replication, packet, packet_len) ||
         !ADD_STARTUP_OPTION("backend_version", conn->backend_version, packet, packet_len) ||
+        !ADD_STARTUP_OPTION("columnar_result", conn->columnar_result, packet, packet_len) ||
         !ADD_STARTUP_OPTION("options", conn->pgoptions, packet, packet_len)) {
         return false;
     }
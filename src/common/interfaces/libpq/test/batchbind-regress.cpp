@@ -0,0 +1,169 @@
+/*
+ * batchbind-regress.cpp
+ *		A test program for batch bind-execute messages
+ *
+ * Sends INSERT, UPDATE and DELETE statements with several parameter sets in
+ * one batch bind-execute ('U') message through PQexecParamsBatch, so that the
+ * bypass executor runs the sets after the first one together, and prints the
+ * command tags and the table contents. It also prints how many executions
+ * unique SQL counted for a batch, which must be one per parameter set.
+ *
+ * It takes a single conninfo string as a parameter, the other connection
+ * settings come from the environment as usual.
+ *
+ * IDENTIFICATION
+ *		src/common/interfaces/libpq/test/batchbind-regress.cpp
+ */
+
+#include "postgres_fe.h"
+
+#include "libpq-fe.h"
+
+/* keep notices such as those of DROP TABLE IF EXISTS out of the output */
+static void quiet(void* arg, const char* message)
+{}
+
+static void exit_nicely(PGconn* conn)
+{
+    PQfinish(conn);
+    exit(1);
+}
+
+/* run a statement, print its error if any */
+static void run(PGconn* conn, const char* sql)
+{
+    PGresult* res = PQexec(conn, sql);
+
+    if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK) {
+        printf("%s: ERROR %s\n", sql, PQresultErrorField(res, PG_DIAG_SQLSTATE));
+    }
+    PQclear(res);
+}
+
+/* print the rows of a query, one line per row with the columns separated by '|' */
+static void show(PGconn* conn, const char* sql)
+{
+    PGresult* res = PQexec(conn, sql);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "%s: %s", sql, PQerrorMessage(conn));
+        PQclear(res);
+        exit_nicely(conn);
+    }
+
+    printf("%s\n", sql);
+    for (int i = 0; i < PQntuples(res); i++) {
+        for (int j = 0; j < PQnfields(res); j++) {
+            printf("%s%s", j > 0 ? "|" : "  ", PQgetvalue(res, i, j));
+        }
+        printf("\n");
+    }
+    PQclear(res);
+}
+
+/* the executions unique SQL counted for the statements starting with prefix */
+static long calls(PGconn* conn, const char* prefix)
+{
+    const char* values[1] = {prefix};
+    PGresult* res = PQexecParams(conn,
+        "SELECT coalesce(sum(n_calls), 0) FROM dbe_perf.statement WHERE query LIKE $1 || '%'",
+        1, NULL, values, NULL, NULL, 0);
+    long n = 0;
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "unique sql: %s", PQerrorMessage(conn));
+        PQclear(res);
+        exit_nicely(conn);
+    }
+    n = atol(PQgetvalue(res, 0, 0));
+    PQclear(res);
+    return n;
+}
+
+/* run sql once for each of the nBatch sets of nParams values in one batch bind-execute message */
+static void batch(PGconn* conn, const char* sql, int nParams, int nBatch, const char* const* values)
+{
+    PGresult* res = PQexecParamsBatch(conn, sql, nParams, nBatch, NULL, values, NULL, NULL, 0);
+
+    if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+        printf("%s x %d: %s\n", sql, nBatch, PQcmdStatus(res));
+    } else {
+        printf("%s x %d: ERROR %s\n", sql, nBatch, PQresultErrorField(res, PG_DIAG_SQLSTATE));
+    }
+    PQclear(res);
+}
+
+static void test_table(PGconn* conn, const char* table)
+{
+    char sql[256];
+    char select[256];
+    char prefix[256];
+    long before;
+    const char* const rows[] = {"1", "one", "2", "two", "3", "three", "4", "four", "5", "five"};
+    /* 6 matches nothing, the second update of 2 sees the first one */
+    const char* const updates[] = {"2", "deux", "6", "six", "2", "deux bis", "4", "quatre"};
+    const char* const deletes[] = {"1", "6", "3"};
+    /* 7 is new, 5 is there already, so the whole batch fails */
+    const char* const duplicates[] = {"7", "seven", "5", "cinq"};
+
+    printf("-- %s\n", table);
+    (void)snprintf(select, sizeof(select), "SELECT id, v FROM %s ORDER BY id", table);
+
+    (void)snprintf(sql, sizeof(sql), "INSERT INTO %s VALUES ($1, $2)", table);
+    batch(conn, sql, 2, 5, rows);
+    show(conn, select);
+
+    (void)snprintf(sql, sizeof(sql), "UPDATE %s SET v = $2 WHERE id = $1", table);
+    (void)snprintf(prefix, sizeof(prefix), "UPDATE %s SET", table);
+    before = calls(conn, prefix);
+    batch(conn, sql, 2, 4, updates);
+    printf("unique sql calls: %ld\n", calls(conn, prefix) - before);
+    show(conn, select);
+
+    (void)snprintf(sql, sizeof(sql), "DELETE FROM %s WHERE id = $1", table);
+    batch(conn, sql, 1, 3, deletes);
+    show(conn, select);
+
+    (void)snprintf(sql, sizeof(sql), "INSERT INTO %s VALUES ($1, $2)", table);
+    batch(conn, sql, 2, 2, duplicates);
+    show(conn, select);
+}
+
+int main(int argc, char* argv[])
+{
+    PGconn* conn = NULL;
+    PGresult* res = NULL;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s conninfo\n", argv[0]);
+        return 1;
+    }
+
+    conn = PQconnectdb(argv[1]);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        fprintf(stderr, "connection to database failed: %s", PQerrorMessage(conn));
+        exit_nicely(conn);
+    }
+
+    PQsetNoticeProcessor(conn, quiet, NULL);
+    run(conn, "SET enable_opfusion = on");
+
+    run(conn, "DROP TABLE IF EXISTS batchbind");
+    run(conn, "CREATE TABLE batchbind (id int PRIMARY KEY, v text)");
+    test_table(conn, "batchbind");
+    run(conn, "DROP TABLE batchbind");
+
+    /* hash bucket tables insert row by row, a single node refuses to create them */
+    run(conn, "DROP TABLE IF EXISTS batchbind_bucket");
+    res = PQexec(conn, "CREATE TABLE batchbind_bucket (id int PRIMARY KEY, v text) WITH (hashbucket = on)");
+    if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+        test_table(conn, "batchbind_bucket");
+        run(conn, "DROP TABLE batchbind_bucket");
+    } else {
+        printf("-- batchbind_bucket: no hash bucket tables\n");
+    }
+    PQclear(res);
+
+    PQfinish(conn);
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * columnar-regress.cpp
+ *		A test program for columnar results
+ *
+ * Opens one connection as usual and one with columnar_result=on, which gets
+ * the results of vectorized plans as columnar batch ('b') messages, runs the
+ * same queries on a column store table through both and checks that the
+ * results are the same, value by value, in text and in binary format. The
+ * table has more rows than a batch holds, and null values of every column
+ * type, so that the validity bitmaps and both column kinds are exercised.
+ *
+ * It takes a single conninfo string as a parameter, the other connection
+ * settings come from the environment as usual.
+ *
+ * IDENTIFICATION
+ *		src/common/interfaces/libpq/test/columnar-regress.cpp
+ */
+
+#include "postgres_fe.h"
+
+#include "libpq-fe.h"
+
+static PGconn* conn = NULL;
+static PGconn* columnar_conn = NULL;
+
+/* keep notices such as those of DROP TABLE IF EXISTS out of the output */
+static void quiet(void* arg, const char* message)
+{}
+
+static void exit_nicely(void)
+{
+    PQfinish(conn);
+    PQfinish(columnar_conn);
+    exit(1);
+}
+
+static PGconn* open_conn(const char* conninfo)
+{
+    PGconn* c = PQconnectdb(conninfo);
+
+    if (PQstatus(c) != CONNECTION_OK) {
+        fprintf(stderr, "connection to database failed: %s", PQerrorMessage(c));
+        PQfinish(c);
+        exit_nicely();
+    }
+    PQsetNoticeProcessor(c, quiet, NULL);
+    return c;
+}
+
+static void run(PGconn* c, const char* sql)
+{
+    PGresult* res = PQexec(c, sql);
+
+    if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "%s: %s", sql, PQerrorMessage(c));
+        PQclear(res);
+        exit_nicely();
+    }
+    PQclear(res);
+}
+
+static PGresult* query(PGconn* c, const char* sql, int resultFormat)
+{
+    PGresult* res = PQexecParams(c, sql, 0, NULL, NULL, NULL, NULL, resultFormat);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "%s: %s", sql, PQerrorMessage(c));
+        PQclear(res);
+        exit_nicely();
+    }
+    return res;
+}
+
+/* is the plan of sql vectorized, so that the columnar connection gets batches? */
+static bool vectorized(const char* sql)
+{
+    char explain[512];
+    PGresult* res = NULL;
+    bool found = false;
+
+    (void)snprintf(explain, sizeof(explain), "EXPLAIN (COSTS OFF) %s", sql);
+    res = query(conn, explain, 0);
+    for (int i = 0; i < PQntuples(res); i++) {
+        if (strstr(PQgetvalue(res, i, 0), "Row Adapter") != NULL) {
+            found = true;
+        }
+    }
+    PQclear(res);
+    return found;
+}
+
+/* run sql through both connections and compare the results */
+static void compare(const char* sql, int resultFormat)
+{
+    PGresult* rows = query(conn, sql, resultFormat);
+    PGresult* columns = query(columnar_conn, sql, resultFormat);
+    int differences = 0;
+
+    printf("%s (%s, vectorized: %s)\n", sql, resultFormat == 1 ? "binary" : "text", vectorized(sql) ? "yes" : "no");
+
+    if (PQntuples(rows) != PQntuples(columns) || PQnfields(rows) != PQnfields(columns)) {
+        printf("  %d x %d rows against %d x %d columnar\n",
+            PQntuples(rows), PQnfields(rows), PQntuples(columns), PQnfields(columns));
+        PQclear(rows);
+        PQclear(columns);
+        return;
+    }
+
+    for (int j = 0; j < PQnfields(rows); j++) {
+        if (PQfformat(rows, j) != PQfformat(columns, j) || PQftype(rows, j) != PQftype(columns, j)) {
+            printf("  column %d: format or type differ\n", j);
+            differences++;
+        }
+    }
+    for (int i = 0; i < PQntuples(rows); i++) {
+        for (int j = 0; j < PQnfields(rows); j++) {
+            if (PQgetisnull(rows, i, j) != PQgetisnull(columns, i, j) ||
+                PQgetlength(rows, i, j) != PQgetlength(columns, i, j) ||
+                memcmp(PQgetvalue(rows, i, j), PQgetvalue(columns, i, j), PQgetlength(rows, i, j)) != 0) {
+                if (differences++ < 10) {
+                    printf("  row %d column %d differs\n", i, j);
+                }
+            }
+        }
+    }
+    printf("  %d rows, %d differences\n", PQntuples(rows), differences);
+
+    PQclear(rows);
+    PQclear(columns);
+}
+
+int main(int argc, char* argv[])
+{
+    char conninfo[1024];
+    PGresult* res = NULL;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s conninfo\n", argv[0]);
+        return 1;
+    }
+
+    conn = open_conn(argv[1]);
+    (void)snprintf(conninfo, sizeof(conninfo), "%s columnar_result=on", argv[1]);
+    columnar_conn = open_conn(conninfo);
+
+    run(conn, "DROP TABLE IF EXISTS columnar_result");
+    run(conn,
+        "CREATE TABLE columnar_result (i int, b bigint, f float8, d date, ts timestamp, n numeric, t text) "
+        "WITH (orientation = column)");
+    /* every seventh row is all nulls, 2500 rows span several batches */
+    run(conn,
+        "INSERT INTO columnar_result SELECT "
+        "CASE WHEN g % 7 <> 0 THEN g END, "
+        "CASE WHEN g % 7 <> 0 THEN g * 100000000000 END, "
+        "CASE WHEN g % 7 <> 0 THEN g / 8.0 END, "
+        "CASE WHEN g % 7 <> 0 THEN date '2020-01-01' + g END, "
+        "CASE WHEN g % 7 <> 0 THEN timestamp '2020-01-01 00:00:00' + g * interval '1 minute' END, "
+        "CASE WHEN g % 7 <> 0 THEN g * 1.5 END, "
+        "CASE WHEN g % 7 <> 0 THEN 'row ' || g END "
+        "FROM generate_series(1, 2500) g");
+
+    compare("SELECT * FROM columnar_result ORDER BY i NULLS FIRST, t", 0);
+    compare("SELECT * FROM columnar_result ORDER BY i NULLS FIRST, t", 1);
+    compare("SELECT i, count(*) FROM columnar_result GROUP BY i ORDER BY i LIMIT 5", 0);
+    compare("SELECT * FROM columnar_result WHERE i < 0", 1);
+
+    /* the columnar connection reads row results as usual */
+    res = query(columnar_conn, "SELECT 1 AS one, 'text' AS two", 0);
+    printf("row result on the columnar connection: %s|%s\n", PQgetvalue(res, 0, 0), PQgetvalue(res, 0, 1));
+    PQclear(res);
+
+    run(conn, "DROP TABLE columnar_result");
+
+    PQfinish(conn);
+    PQfinish(columnar_conn);
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * gpc-regress.cpp
+ *		A test program for the global plan cache under concurrent invalidation
+ *
+ * Several sessions prepare and run the same statement round after round while
+ * another session alters the table it reads, so that the datanodes fetch the
+ * shared plan without locks while invalidation drops it. Every statement must
+ * succeed with the right result. In the end plancache_status() of a datanode
+ * must show the valid plans of the statement with the lookups of their bucket.
+ *
+ * The shared plans exist only with enable_thread_pool and
+ * enable_global_plancache on the datanodes, which the expected output assumes.
+ *
+ * It takes a single conninfo string as a parameter, the other connection
+ * settings come from the environment as usual.
+ *
+ * IDENTIFICATION
+ *		src/common/interfaces/libpq/test/gpc-regress.cpp
+ */
+
+#include "postgres_fe.h"
+
+#include "libpq-fe.h"
+
+#define NREADERS 8
+#define ROUNDS 20
+#define ROWS 1000
+#define FETCH_SQL "SELECT count(*), sum(id) FROM gpc_fetch WHERE id <= $1"
+
+static PGconn* control = NULL;
+static PGconn* readers[NREADERS];
+static int errors = 0;
+static int wrong_results = 0;
+
+/* keep notices such as those of DROP TABLE IF EXISTS out of the output */
+static void quiet(void* arg, const char* message)
+{}
+
+static void exit_nicely(void)
+{
+    PQfinish(control);
+    for (int i = 0; i < NREADERS; i++) {
+        PQfinish(readers[i]);
+    }
+    exit(1);
+}
+
+static PGconn* open_conn(const char* conninfo)
+{
+    PGconn* c = PQconnectdb(conninfo);
+
+    if (PQstatus(c) != CONNECTION_OK) {
+        fprintf(stderr, "connection to database failed: %s", PQerrorMessage(c));
+        PQfinish(c);
+        exit_nicely();
+    }
+    PQsetNoticeProcessor(c, quiet, NULL);
+    return c;
+}
+
+static void run(PGconn* c, const char* sql)
+{
+    PGresult* res = PQexec(c, sql);
+
+    if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "%s: %s", sql, PQerrorMessage(c));
+        PQclear(res);
+        exit_nicely();
+    }
+    PQclear(res);
+}
+
+static void check_sent(PGconn* c, int sent)
+{
+    if (!sent) {
+        fprintf(stderr, "could not send: %s", PQerrorMessage(c));
+        exit_nicely();
+    }
+}
+
+/*
+ * Take the results of what was sent on c. If limit is not 0 they are those of
+ * FETCH_SQL run with limit, which counts and sums the ids up to limit.
+ */
+static void finish(PGconn* c, const char* who, int limit)
+{
+    PGresult* res = NULL;
+
+    while ((res = PQgetResult(c)) != NULL) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK) {
+            printf("%s: ERROR %s %s", who, PQresultErrorField(res, PG_DIAG_SQLSTATE), PQresultErrorMessage(res));
+            errors++;
+        } else if (limit != 0 && (PQntuples(res) != 1 || atol(PQgetvalue(res, 0, 0)) != limit ||
+                                     atol(PQgetvalue(res, 0, 1)) != (long)limit * (limit + 1) / 2)) {
+            printf("%s: %s|%s for %d\n", who, PQgetvalue(res, 0, 0), PQgetvalue(res, 0, 1), limit);
+            wrong_results++;
+        }
+        PQclear(res);
+    }
+}
+
+/* prepare FETCH_SQL as name in every reader and run it, with alter running meanwhile if given */
+static void fetch_round(const char* name, int limit, const char* alter)
+{
+    char value[16];
+    const char* values[1] = {value};
+    char who[32];
+
+    (void)snprintf(value, sizeof(value), "%d", limit);
+
+    for (int i = 0; i < NREADERS; i++) {
+        check_sent(readers[i], PQsendPrepare(readers[i], name, FETCH_SQL, 1, NULL));
+    }
+    if (alter != NULL) {
+        check_sent(control, PQsendQuery(control, alter));
+    }
+    for (int i = 0; i < NREADERS; i++) {
+        (void)snprintf(who, sizeof(who), "%s session %d", name, i);
+        finish(readers[i], who, 0);
+    }
+
+    for (int i = 0; i < NREADERS; i++) {
+        check_sent(readers[i], PQsendQueryPrepared(readers[i], name, 1, values, NULL, NULL, 0));
+    }
+    for (int i = 0; i < NREADERS; i++) {
+        (void)snprintf(who, sizeof(who), "%s session %d", name, i);
+        finish(readers[i], who, limit);
+    }
+
+    if (alter != NULL) {
+        finish(control, alter, 0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    char name[32];
+    char alter[128];
+    char sql[512];
+    PGresult* res = NULL;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s conninfo\n", argv[0]);
+        return 1;
+    }
+
+    control = open_conn(argv[1]);
+    for (int i = 0; i < NREADERS; i++) {
+        readers[i] = open_conn(argv[1]);
+    }
+
+    run(control, "DROP TABLE IF EXISTS gpc_fetch");
+    run(control, "CREATE TABLE gpc_fetch (id int, v text)");
+    (void)snprintf(sql, sizeof(sql), "INSERT INTO gpc_fetch SELECT g, 'row ' || g FROM generate_series(1, %d) g", ROWS);
+    run(control, sql);
+
+    printf("-- %d sessions fetch the statement while the table is altered, %d rounds\n", NREADERS, ROUNDS);
+    for (int round = 0; round < ROUNDS; round++) {
+        (void)snprintf(name, sizeof(name), "s%d", round);
+        (void)snprintf(alter, sizeof(alter), "ALTER TABLE gpc_fetch ADD COLUMN c%d int", round);
+        fetch_round(name, ROWS / 2 + round, alter);
+    }
+
+    printf("-- every session plans the statement again after the last change\n");
+    fetch_round("final", ROWS, NULL);
+    printf("errors: %d, wrong results: %d\n", errors, wrong_results);
+
+    /* the shared plans live on the datanodes, plancache_status() shows those of the node it runs on */
+    res = PQexec(control, "SELECT node_name FROM pgxc_node WHERE node_type = 'D' ORDER BY node_name LIMIT 1");
+    if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) == 1) {
+        (void)snprintf(sql, sizeof(sql),
+            "EXECUTE DIRECT ON (%s) 'SELECT count(*) > 0, bool_and(bucket_id IS NOT NULL), "
+            "bool_and(bucket_hits + bucket_misses > 0), bool_or(bucket_hits > 0) "
+            "FROM plancache_status() WHERE valid AND query LIKE ''%%gpc_fetch%%'''",
+            PQgetvalue(res, 0, 0));
+        PQclear(res);
+        res = PQexec(control, sql);
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            fprintf(stderr, "plancache_status: %s", PQerrorMessage(control));
+            PQclear(res);
+            exit_nicely();
+        }
+        printf("valid plans, in a bucket, looked up, shared: %s|%s|%s|%s\n",
+            PQgetvalue(res, 0, 0), PQgetvalue(res, 0, 1), PQgetvalue(res, 0, 2), PQgetvalue(res, 0, 3));
+    } else {
+        printf("-- plancache_status: no datanodes\n");
+    }
+    PQclear(res);
+
+    for (int i = 0; i < NREADERS; i++) {
+        PQfinish(readers[i]);
+    }
+    run(control, "DROP TABLE gpc_fetch");
+
+    PQfinish(control);
+    return 0;
+}
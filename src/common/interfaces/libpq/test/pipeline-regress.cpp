@@ -0,0 +1,371 @@
+/*
+ * pipeline-regress.cpp
+ *		A test program for pipelined extended query messages
+ *
+ * libpq sends one query at a time, so this program connects through libpq
+ * and then writes Parse/Bind/Execute/Sync messages to the socket itself, many
+ * of them in one write, as the pipeline mode of other drivers does. For each
+ * Sync it prints the command tags and errors the server answered with, up to
+ * its ReadyForQuery. The session runs with enable_pipeline_mode, so the server
+ * defers the flush at a Sync while more messages are waiting.
+ *
+ * It takes a single conninfo string as a parameter, the other connection
+ * settings come from the environment as usual. SSL is turned off, since the
+ * messages bypass libpq.
+ *
+ * IDENTIFICATION
+ *		src/common/interfaces/libpq/test/pipeline-regress.cpp
+ */
+
+#include "postgres_fe.h"
+
+#include <poll.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "libpq-fe.h"
+
+#define OUT_SIZE (1024 * 1024)
+#define IN_SIZE (1024 * 1024)
+#define READ_TIMEOUT_MS 10000
+
+static PGconn* conn = NULL;
+static int sock = -1;
+
+/* messages to send */
+static char out[OUT_SIZE];
+static int out_len = 0;
+static int out_msg_start = 0;
+static int out_bind_start = 0; /* where the Bind of the last statement starts */
+
+/* received bytes not yet taken as messages */
+static char in[IN_SIZE];
+static int in_len = 0;
+
+static void exit_nicely(void)
+{
+    PQfinish(conn);
+    exit(1);
+}
+
+static void run(const char* sql)
+{
+    PGresult* res = PQexec(conn, sql);
+
+    if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "%s: %s", sql, PQerrorMessage(conn));
+        PQclear(res);
+        exit_nicely();
+    }
+    PQclear(res);
+}
+
+static void put_bytes(const void* data, int len)
+{
+    if (out_len + len > OUT_SIZE) {
+        fprintf(stderr, "output buffer full\n");
+        exit_nicely();
+    }
+    memcpy(out + out_len, data, len);
+    out_len += len;
+}
+
+static void put_int16(int n)
+{
+    uint16 v = htons((uint16)n);
+
+    put_bytes(&v, 2);
+}
+
+static void put_int32(int n)
+{
+    uint32 v = htonl((uint32)n);
+
+    put_bytes(&v, 4);
+}
+
+static void put_string(const char* s)
+{
+    put_bytes(s, (int)strlen(s) + 1);
+}
+
+static void begin_message(char type)
+{
+    put_bytes(&type, 1);
+    out_msg_start = out_len;
+    put_int32(0); /* length, filled in by end_message */
+}
+
+static void end_message(void)
+{
+    uint32 v = htonl((uint32)(out_len - out_msg_start));
+
+    memcpy(out + out_msg_start, &v, 4);
+}
+
+/* Parse, Bind and Execute sql in the unnamed statement and portal */
+static void put_statement(const char* sql)
+{
+    begin_message('P');
+    put_string("");
+    put_string(sql);
+    put_int16(0);
+    end_message();
+
+    out_bind_start = out_len;
+    begin_message('B');
+    put_string("");
+    put_string("");
+    put_int16(0);
+    put_int16(0);
+    put_int16(0);
+    end_message();
+
+    begin_message('E');
+    put_string("");
+    put_int32(0);
+    end_message();
+}
+
+static void put_sync(void)
+{
+    begin_message('S');
+    end_message();
+}
+
+/* take what the server has sent so far, wait for it at most timeout ms */
+static bool receive(int timeout)
+{
+    struct pollfd pfd = {sock, POLLIN, 0};
+    ssize_t n;
+
+    if (poll(&pfd, 1, timeout) <= 0) {
+        return false;
+    }
+    n = recv(sock, in + in_len, IN_SIZE - in_len, 0);
+    if (n <= 0) {
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+    in_len += (int)n;
+    return true;
+}
+
+/* send out[from, to), taking the answers meanwhile so that neither side blocks */
+static void send_range(int from, int to)
+{
+    while (from < to) {
+        struct pollfd pfd = {sock, POLLIN | POLLOUT, 0};
+        ssize_t n;
+
+        if (poll(&pfd, 1, READ_TIMEOUT_MS) <= 0) {
+            fprintf(stderr, "timeout sending to the server\n");
+            exit_nicely();
+        }
+        if ((pfd.revents & POLLIN) && !receive(0)) {
+            fprintf(stderr, "connection lost\n");
+            exit_nicely();
+        }
+        if (pfd.revents & POLLOUT) {
+            n = send(sock, out + from, to - from, 0);
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "could not send: %s\n", strerror(errno));
+                exit_nicely();
+            }
+            if (n > 0) {
+                from += (int)n;
+            }
+        }
+    }
+}
+
+static void send_all(void)
+{
+    send_range(0, out_len);
+    out_len = 0;
+}
+
+/* the next whole message, false if it did not arrive within READ_TIMEOUT_MS */
+static bool next_message(char* type, char* body, int body_size)
+{
+    uint32 len;
+
+    for (;;) {
+        if (in_len >= 5) {
+            memcpy(&len, in + 1, 4);
+            len = ntohl(len);
+            if (in_len >= (int)len + 1) {
+                break;
+            }
+        }
+        if (!receive(READ_TIMEOUT_MS)) {
+            return false;
+        }
+    }
+
+    *type = in[0];
+    len -= 4;
+    memset(body, 0, body_size);
+    memcpy(body, in + 5, Min((int)len, body_size - 1));
+    memmove(in, in + 5 + len, in_len - 5 - len);
+    in_len -= 5 + (int)len;
+    return true;
+}
+
+/*
+ * Print the answers up to the next ReadyForQuery on one line: command tags,
+ * errors by SQLSTATE and the transaction status, repeated ones counted.
+ */
+static void print_sync(void)
+{
+    char type;
+    char body[8192];
+    char last[1024] = "";
+    char entry[1024];
+    int repeat = 0;
+    bool first = true;
+
+    printf(" ");
+    for (;;) {
+        if (!next_message(&type, body, sizeof(body))) {
+            printf(" (timeout)\n");
+            exit_nicely();
+        }
+
+        entry[0] = '\0';
+        if (type == 'C') {
+            (void)snprintf(entry, sizeof(entry), "%s", body);
+        } else if (type == 'E') {
+            /* fields are a code byte and a string each, C is the SQLSTATE */
+            for (char* field = body; *field != '\0'; field += strlen(field + 1) + 2) {
+                if (*field == 'C') {
+                    (void)snprintf(entry, sizeof(entry), "ERROR %s", field + 1);
+                }
+            }
+        } else if (type == 'Z') {
+            (void)snprintf(entry, sizeof(entry), "ReadyForQuery %c", body[0]);
+        } else {
+            /* ParseComplete, BindComplete, notices and the like */
+            continue;
+        }
+
+        if (strcmp(entry, last) == 0) {
+            repeat++;
+            continue;
+        }
+        if (last[0] != '\0') {
+            printf("%s %s", first ? "" : ",", last);
+            if (repeat > 1) {
+                printf(" x%d", repeat);
+            }
+            first = false;
+        }
+        (void)snprintf(last, sizeof(last), "%s", entry);
+        repeat = 1;
+
+        if (type == 'Z') {
+            break;
+        }
+    }
+    printf("%s %s\n", first ? "" : ",", last);
+}
+
+static void insert(int id)
+{
+    char sql[64];
+
+    (void)snprintf(sql, sizeof(sql), "INSERT INTO pipeline VALUES (%d)", id);
+    put_statement(sql);
+}
+
+int main(int argc, char* argv[])
+{
+    char conninfo[1024];
+    PGresult* res = NULL;
+    int split;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s conninfo\n", argv[0]);
+        return 1;
+    }
+
+    (void)snprintf(conninfo, sizeof(conninfo), "%s sslmode=disable", argv[1]);
+    conn = PQconnectdb(conninfo);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        fprintf(stderr, "connection to database failed: %s", PQerrorMessage(conn));
+        exit_nicely();
+    }
+
+    run("SET client_min_messages = warning");
+    run("SET enable_pipeline_mode = on");
+    run("DROP TABLE IF EXISTS pipeline");
+    run("CREATE TABLE pipeline (id int PRIMARY KEY)");
+    sock = PQsocket(conn);
+
+    printf("-- three statements, one Sync\n");
+    insert(1);
+    insert(2);
+    insert(3);
+    put_sync();
+    send_all();
+    print_sync();
+
+    printf("-- a Sync after each statement, the flushes are deferred\n");
+    for (int id = 4; id <= 6; id++) {
+        insert(id);
+        put_sync();
+    }
+    send_all();
+    print_sync();
+    print_sync();
+    print_sync();
+
+    printf("-- an error skips to the next Sync and rolls back the statements before it\n");
+    insert(7);
+    insert(1);
+    insert(8);
+    put_sync();
+    insert(9);
+    put_sync();
+    send_all();
+    print_sync();
+    print_sync();
+
+    /*
+     * The second statement is sent up to the middle of its Bind. Its Parse is
+     * there, so the first Sync does not flush, but the results must come before
+     * the server waits for the rest of the Bind.
+     */
+    printf("-- results are sent before waiting for the rest of the pipeline\n");
+    insert(10);
+    put_sync();
+    insert(11);
+    split = out_bind_start + 5;
+    put_sync();
+    send_range(0, split);
+    print_sync();
+    send_range(split, out_len);
+    out_len = 0;
+    print_sync();
+
+    printf("-- 2000 statements, more than a receive buffer, one Sync\n");
+    for (int id = 1000; id < 3000; id++) {
+        insert(id);
+    }
+    put_sync();
+    send_all();
+    print_sync();
+
+    res = PQexec(conn, "SELECT count(*), min(id), max(id) FROM pipeline");
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "%s", PQerrorMessage(conn));
+        PQclear(res);
+        exit_nicely();
+    }
+    printf("rows: %s|%s|%s\n", PQgetvalue(res, 0, 0), PQgetvalue(res, 0, 1), PQgetvalue(res, 0, 2));
+    PQclear(res);
+
+    run("DROP TABLE pipeline");
+
+    PQfinish(conn);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#!/bin/bash
+#-------------------------------------------------------------------------
+#
+# server-regress.sh
+#
+# Runs the test programs that talk to a server, each with the conninfo in
+# PQTEST_CONNINFO, and compares their output against expected_<test>.out.
+#
+# IDENTIFICATION
+#    src/common/interfaces/libpq/test/server-regress.sh
+#
+#-------------------------------------------------------------------------
+
+CONNINFO="${PQTEST_CONNINFO:-dbname=postgres}"
+failed=""
+
+rm -f server-regress.diff
+for test in ${SERVER_TESTS}
+do
+	./${test}-regress "$CONNINFO" >${test}.out 2>&1
+	if ! diff -c "${SRCDIR}/${SUBDIR}/"expected_${test}.out ${test}.out >>server-regress.diff; then
+		failed="$failed $test"
+	fi
+done
+
+echo "========================================"
+if [ -z "$failed" ]; then
+	echo "All server tests passed"
+	exit 0
+else
+	echo "FAILED:$failed"
+	echo
+	echo "Review the difference in ${SUBDIR}/server-regress.diff"
+	echo "========================================"
+	exit 1
+fi
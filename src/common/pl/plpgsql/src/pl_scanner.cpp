@@ -508,6 +508,12 @@ int plpgsql_latest_lineno(void)
  */
 void plpgsql_scanner_init(const char* str)
 {
+    /* allocated on first use, most sessions never compile a PL/pgSQL function */
+    if (u_sess->plsql_cxt.core_yy == NULL) {
+        u_sess->plsql_cxt.core_yy =
+            (core_yy_extra_type*)MemoryContextAllocZero(u_sess->top_mem_cxt, sizeof(core_yy_extra_type));
+    }
+
     /* Start up the core scanner */
     u_sess->plsql_cxt.yyscanner =
         scanner_init(str, u_sess->plsql_cxt.core_yy, reserved_keywords, num_reserved_keywords);
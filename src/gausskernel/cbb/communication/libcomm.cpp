@@ -40,6 +40,7 @@
 
 #include "sctp_core/mc_sctp.h"
 #include "sctp_core/mc_tcp.h"
+#include "sctp_core/mc_shm.h"
 #include "sctp_core/mc_poller.h"
 #include "sctp_utils/sctp_platform.h"
 #include "sctp_utils/sctp_thread.h"
@@ -187,7 +188,7 @@ static int gs_s_build_tcp_ctrl_connection(libcommaddrinfo* libcomm_addrinfo, int
 static bool gs_s_check_connection(libcommaddrinfo* libcomm_addrinfo, int node_idx, bool is_reply, int type);
 extern bool executorEarlyStop();
 static void gs_online_change_capacity();
-static int gs_tcp_write_noblock(int node_idx, int sock, const char* msg, int msg_len, int *send_count);
+static int gs_tcp_writev_noblock(int node_idx, int sock, struct iovec* iov, int iovcnt, int total_len, int* send_count);
 static void gs_set_reply_sock(int node_idx);
 static int gs_reload_hba(int fd, sockaddr ctrl_client);
 
@@ -540,6 +541,7 @@ static void gs_receivers_struct_set(int ctrl_port, int data_port)
         g_instance.comm_cxt.g_receivers->receiver_conn[i].assoc_id = 0;
         g_instance.comm_cxt.g_receivers->receiver_conn[i].comm_bytes = 0;
         g_instance.comm_cxt.g_receivers->receiver_conn[i].comm_count = 0;
+        g_instance.comm_cxt.g_receivers->receiver_conn[i].shm_ring = NULL;
 
         g_instance.comm_cxt.g_r_node_sock[i].init();
     }
@@ -800,6 +802,7 @@ static int libcomm_build_sctp_connection(libcommaddrinfo* libcomm_addrinfo, int
     securec_check(ss_rc, "\0", "\0");
     ss_rc = strcpy_s(connect_package.host, HOST_ADDRSTRLEN, g_instance.comm_cxt.localinfo_cxt.g_local_host);
     securec_check(ss_rc, "\0", "\0");
+    connect_package.shm_name[0] = '\0';
     msg_len = sizeof(struct libcomm_connect_package);
 
     // initialize remote sctp address
@@ -1152,15 +1155,104 @@ void libcomm_free_iov_item(struct mc_lqueue_item** iov_item, int size)
 }
 
 /*
- * function name    : gs_tcp_write_noblock
- * description        : loop send msg by tcp with noblock mode
+ * function name    : libcomm_shm_send
+ * description      : put a message into the shared memory ring of a remote on this host,
+ *                    the sender_conn lock must be held.
  * arguments        :   node_idx: sender node id.
- *                        sock: socket
+ *                        msg_head: head of the message.
  *                        msg: send message content
  *                        msg_len: msg length
+ * return value     : msg_len if succeed, -1 if the connection has been closed
+ */
+static int libcomm_shm_send(int node_idx, MsgHead* msg_head, const char* msg, int msg_len)
+{
+    struct node_connection* conn = &g_instance.comm_cxt.g_senders->sender_conn[node_idx];
+    struct sock_id fd_id = {conn->socket, conn->socket_id};
+    uint64 time_enter = mc_timers_ms();
+    uint64 time_now;
+    int close_reason = 0;
+    char doorbell = 'W';
+
+    /* the ring is full, wait for the receiver like we wait for socket buffer of tcp */
+    while (!mc_shm_write(conn->shm_ring, msg_head, sizeof(MsgHead), msg, msg_len)) {
+        if (conn->ip_changed == true) {
+            close_reason = ECOMMSCTPPEERCHANGED;
+            break;
+        }
+
+        time_now = mc_timers_ms();
+        if (((time_now - time_enter) >
+                ((uint64)g_instance.comm_cxt.counters_cxt.g_comm_send_timeout * SEC_TO_MICRO_SEC)) &&
+            (time_now > time_enter)) {
+            close_reason = ECOMMSCTPSENDTIMEOUT;
+            break;
+        }
+
+        /* the receiver does not take anything if it is gone */
+        if (mc_tcp_check_socket(conn->socket) != 0) {
+            close_reason = ECOMMSCTPSCTPDISCONNECT;
+            break;
+        }
+        (void)usleep(100);
+    }
+
+    /*
+     * Ring the doorbell if the receiver waits in its poller. If the socket buffer is
+     * full there are doorbells the receiver has not read yet, so it wakes up anyway.
+     */
+    if (close_reason == 0 && mc_shm_need_wakeup(conn->shm_ring) &&
+        mc_tcp_write_noblock(conn->socket, &doorbell, sizeof(doorbell)) < 0) {
+        close_reason = ECOMMSCTPSCTPDISCONNECT;
+    }
+
+    if (close_reason != 0) {
+        gs_s_close_bad_data_socket(&fd_id, close_reason, node_idx);
+        LIBCOMM_ELOG(WARNING,
+            "(s|send)\tFailed to send to node[%d]:%s through shared memory, msg_len[%d] error[%d:%s].",
+            node_idx,
+            REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx),
+            msg_len,
+            close_reason,
+            mc_strerror(close_reason));
+        errno = close_reason;
+        return -1;
+    }
+
+    conn->comm_bytes += msg_len;
+    conn->comm_count++;
+
+    return msg_len;
+}
+
+/*
+ * A message waiting in the send queue of a data connection. Whoever gets the connection
+ * lock first sends all the queued messages in as few sendmsg calls as it can, so small
+ * messages of different streams going to the same node share the system calls.
+ */
+struct libcomm_send_request {
+    MsgHead msg_head;
+    char* msg;
+    int socket;
+    int socket_id;
+    int result;  /* msg_len, or -1 if the message has not been sent */
+    bool done;
+    struct libcomm_send_request* next;
+};
+
+/* messages sent by one sendmsg, each takes 2 iovecs */
+#define LIBCOMM_SEND_BATCH 64
+
+/*
+ * function name    : gs_tcp_writev_noblock
+ * description        : loop send iovecs by tcp with noblock mode, like gs_tcp_write_noblock
+ * arguments        :   node_idx: sender node id.
+ *                        sock: socket
+ *                        iov: iovecs to send, changed on partial sends
+ *                        iovcnt: number of iovecs
+ *                        total_len: bytes described by iov
  * return value        : length of msg had be sent
  */
-static int gs_tcp_write_noblock(int node_idx, int sock, const char* msg, int msg_len, int *send_count)
+static int gs_tcp_writev_noblock(int node_idx, int sock, struct iovec* iov, int iovcnt, int total_len, int* send_count)
 {
     uint64 time_enter, time_now;
     int send_bytes = 0;
@@ -1169,12 +1261,7 @@ static int gs_tcp_write_noblock(int node_idx, int sock, const char* msg, int msg
     time_enter = mc_timers_ms();
 
     do {
-        /*
-         * we send data in non-block mode,
-         * but we will assure the data will
-         * be sent out if the network is ok
-         */
-        error = mc_tcp_write_noblock(sock, msg + send_bytes, msg_len - send_bytes);
+        error = mc_tcp_writev_noblock(sock, iov, iovcnt);
         if (error < 0) {
             errno = ECOMMSCTPSCTPDISCONNECT;
             break;
@@ -1184,10 +1271,6 @@ static int gs_tcp_write_noblock(int node_idx, int sock, const char* msg, int msg
             (*send_count)++;
         }
 
-        /*
-         * when primary and the standby is switchover,
-         * the old connection is broken
-         */
         if (g_instance.comm_cxt.g_senders->sender_conn[node_idx].ip_changed == true) {
             errno = ECOMMSCTPPEERCHANGED;
             break;
@@ -1202,99 +1285,156 @@ static int gs_tcp_write_noblock(int node_idx, int sock, const char* msg, int msg
         }
 
         send_bytes += error;
-    } while (send_bytes != msg_len);
+
+        /* skip what has been sent */
+        while (iovcnt > 0 && (size_t)error >= iov->iov_len) {
+            error -= (int)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + error;
+            iov->iov_len -= error;
+        }
+    } while (send_bytes != total_len);
 
     return send_bytes;
 }
 
-static int libcomm_tcp_send(LibcommSendInfo* send_info)
+/*
+ * Send the queued messages of node_idx, with the sender_conn lock held.
+ */
+static void libcomm_tcp_send_queue(int node_idx)
 {
-    int sock = send_info->socket;
-    int sock_id = send_info->socket_id;
-    int version = send_info->version;
-    int streamid = send_info->streamid;
-    int node_idx = send_info->node_idx;
-    int msg_len = send_info->msg_len;
-    char* msg = send_info->msg;
-    int error = -1;
-    int send_bytes;
-    int send_count = 0;
+    struct node_connection* conn = &g_instance.comm_cxt.g_senders->sender_conn[node_idx];
+    struct libcomm_send_request* queue = NULL;
+    struct libcomm_send_request* batch[LIBCOMM_SEND_BATCH];
+    struct iovec iov[LIBCOMM_SEND_BATCH * 2];
     struct sock_id fd_id = {0, 0};
-    MsgHead msg_head;
-    msg_head.type = 'D';
-    msg_head.magic_num = MSG_HEAD_MAGIC_NUM;
-    msg_head.version = version;
-    msg_head.logic_id = streamid;
-    msg_head.msg_len = msg_len;
-    msg_head.checksum = MSG_HEAD_TEMP_CHECKSUM;
+    int nbatch;
+    int total_len;
+    int send_bytes;
+    int send_count;
+    int i;
 
-    LIBCOMM_PTHREAD_RWLOCK_WRLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
+    LIBCOMM_PTHREAD_MUTEX_LOCK(&conn->send_queue_lock);
+    queue = conn->send_queue;
+    conn->send_queue = NULL;
+    conn->send_queue_tail = NULL;
+    LIBCOMM_PTHREAD_MUTEX_UNLOCK(&conn->send_queue_lock);
+
+    while (queue != NULL) {
+        nbatch = 0;
+        total_len = 0;
+        while (queue != NULL && nbatch < LIBCOMM_SEND_BATCH) {
+            struct libcomm_send_request* req = queue;
+            queue = queue->next;
+
+            /* check socket version saved before, to prevent send msg to wrong remote node */
+            if ((req->socket != conn->socket) || (req->socket_id != conn->socket_id)) {
+                COMM_DEBUG_LOG("(s|send)\tsocket version of node%d:%s mismatch old[%d,%d], new[%d,%d].",
+                    node_idx,
+                    REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx),
+                    req->socket,
+                    req->socket_id,
+                    conn->socket,
+                    conn->socket_id);
+                req->result = -1;
+                req->done = true;
+                continue;
+            }
 
-    /* check socket version saved before, to prevent send msg to wrong remote node */
-    if ((sock != g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket) ||
-        (sock_id != g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket_id)) {
-        COMM_DEBUG_LOG("(s|send)\tsocket version of node%d:%s mismatch old[%d,%d], new[%d,%d].",
+            /* the remote is on this host, the socket only carries the doorbell */
+            if (conn->shm_ring != NULL) {
+                req->result = libcomm_shm_send(node_idx, &req->msg_head, req->msg, (int)req->msg_head.msg_len);
+                req->done = true;
+                continue;
+            }
+
+            iov[nbatch * 2].iov_base = &req->msg_head;
+            iov[nbatch * 2].iov_len = sizeof(MsgHead);
+            iov[nbatch * 2 + 1].iov_base = req->msg;
+            iov[nbatch * 2 + 1].iov_len = req->msg_head.msg_len;
+            total_len += (int)(sizeof(MsgHead) + req->msg_head.msg_len);
+            batch[nbatch++] = req;
+        }
+
+        if (nbatch == 0) {
+            continue;
+        }
+
+        send_count = 0;
+        send_bytes = gs_tcp_writev_noblock(node_idx, conn->socket, iov, nbatch * 2, total_len, &send_count);
+        if (send_bytes > 0) {
+            conn->comm_bytes += send_bytes - nbatch * (int)sizeof(MsgHead);
+        }
+        conn->comm_count += send_count;
+
+        COMM_DEBUG_LOG("(s|send)\tsend to dn[%d]:%s %d messages[%d, %d] on socket[%d].",
             node_idx,
             REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx),
-            sock,
-            sock_id,
-            g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket,
-            g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket_id);
-        LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
-        return -1;
-    }
-
-    send_bytes = gs_tcp_write_noblock(node_idx, sock, (char*)&msg_head, sizeof(MsgHead), NULL);
-    if (send_bytes != sizeof(MsgHead)) {
-        /* close the bad socket when send failed */
-        fd_id.fd = g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket;
-        fd_id.id = g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket_id;
-        gs_s_close_bad_data_socket(&fd_id, ECOMMSCTPSCTPDISCONNECT, node_idx);
-        LIBCOMM_ELOG(WARNING,
-            "(s|send)\tsend msghead failed send_bytes[%d] errno[%d:%s].",
+            nbatch,
+            total_len,
             send_bytes,
-            errno,
-            mc_strerror(errno));
-        LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
-        return -1;
-    }
+            conn->socket);
 
-    COMM_DEBUG_LOG("(s|send)\tsend to dn[%d]:%s head[%d, %d] on socket[%d].",
-        node_idx,
-        REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx),
-        (int)sizeof(MsgHead),
-        error,
-        g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket);
+        if (send_bytes != total_len) {
+            /* close the bad socket when send failed, the messages after this batch see the new socket version */
+            fd_id.fd = conn->socket;
+            fd_id.id = conn->socket_id;
+            gs_s_close_bad_data_socket(&fd_id, errno, node_idx);
+            LIBCOMM_ELOG(WARNING,
+                "(s|send)\tsend length mismatch send_bytes[%d] msg_len[%d] errno[%d:%s].",
+                send_bytes,
+                total_len,
+                errno,
+                mc_strerror(errno));
+        }
 
-    send_bytes = gs_tcp_write_noblock(node_idx, sock, msg, msg_len, &send_count);
-    if (send_bytes > 0) {
-        g_instance.comm_cxt.g_senders->sender_conn[node_idx].comm_bytes += send_bytes;
+        for (i = 0; i < nbatch; i++) {
+            batch[i]->result = (send_bytes == total_len) ? (int)batch[i]->msg_head.msg_len : -1;
+            batch[i]->done = true;
+        }
     }
-    g_instance.comm_cxt.g_senders->sender_conn[node_idx].comm_count += send_count;
+}
 
-    COMM_DEBUG_LOG("(s|send)\tsend to dn[%d]:%s data[%d, %d] on socket[%d].",
-        node_idx,
-        REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx),
-        msg_len,
-        error,
-        g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket);
+static int libcomm_tcp_send(LibcommSendInfo* send_info)
+{
+    int node_idx = send_info->node_idx;
+    struct node_connection* conn = &g_instance.comm_cxt.g_senders->sender_conn[node_idx];
+    struct libcomm_send_request req;
+
+    req.msg_head.type = 'D';
+    req.msg_head.magic_num = MSG_HEAD_MAGIC_NUM;
+    req.msg_head.version = send_info->version;
+    req.msg_head.logic_id = send_info->streamid;
+    req.msg_head.msg_len = send_info->msg_len;
+    req.msg_head.checksum = MSG_HEAD_TEMP_CHECKSUM;
+    req.msg = send_info->msg;
+    req.socket = send_info->socket;
+    req.socket_id = send_info->socket_id;
+    req.result = -1;
+    req.done = false;
+    req.next = NULL;
+
+    LIBCOMM_PTHREAD_MUTEX_LOCK(&conn->send_queue_lock);
+    if (conn->send_queue_tail != NULL) {
+        conn->send_queue_tail->next = &req;
+    } else {
+        conn->send_queue = &req;
+    }
+    conn->send_queue_tail = &req;
+    LIBCOMM_PTHREAD_MUTEX_UNLOCK(&conn->send_queue_lock);
 
-    if (send_bytes != msg_len) {
-        /* close the bad socket when send failed */
-        fd_id.fd = g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket;
-        fd_id.id = g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket_id;
-        gs_s_close_bad_data_socket(&fd_id, errno, node_idx);
-        LIBCOMM_ELOG(WARNING,
-            "(s|send)\tsend length mismatch send_bytes[%d] msg_len[%d] errno[%d:%s].",
-            send_bytes,
-            msg_len,
-            errno,
-            mc_strerror(errno));
-        send_bytes = -1;
+    LIBCOMM_PTHREAD_RWLOCK_WRLOCK(&conn->rwlock);
+    /* the thread holding the lock before us may have sent our message with its own */
+    if (!req.done) {
+        libcomm_tcp_send_queue(node_idx);
     }
+    LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
 
-    LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
-    return send_bytes;
+    Assert(req.done);
+    return req.result;
 }
 
 static int libcomm_tcp_recv_noidx(LibcommRecvInfo* recv_info)
@@ -2130,10 +2270,14 @@ static void gs_senders_struct_set()
 
         // set g_instance.comm_cxt.g_senders->sender_conn AND g_sender_count
         LIBCOMM_PTHREAD_RWLOCK_INIT(&g_instance.comm_cxt.g_senders->sender_conn[i].rwlock, NULL);
+        LIBCOMM_PTHREAD_MUTEX_INIT(&g_instance.comm_cxt.g_senders->sender_conn[i].send_queue_lock, 0);
+        g_instance.comm_cxt.g_senders->sender_conn[i].send_queue = NULL;
+        g_instance.comm_cxt.g_senders->sender_conn[i].send_queue_tail = NULL;
         g_instance.comm_cxt.g_senders->sender_conn[i].socket = -1;
         g_instance.comm_cxt.g_senders->sender_conn[i].socket_id = -1;
         g_instance.comm_cxt.g_senders->sender_conn[i].comm_bytes = 0;
         g_instance.comm_cxt.g_senders->sender_conn[i].comm_count = 0;
+        g_instance.comm_cxt.g_senders->sender_conn[i].shm_ring = NULL;
     }
 
     return;
@@ -3145,6 +3289,8 @@ static void gs_r_close_bad_data_socket(int node_idx, sock_id fd_id, bool is_lock
             LIBCOMM_PTHREAD_RWLOCK_WRLOCK(&g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].rwlock);
         }
         g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].socket = -1;
+        mc_shm_detach(g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].shm_ring);
+        g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].shm_ring = NULL;
         if (is_lock) {
             LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].rwlock);
         }
@@ -3267,6 +3413,8 @@ static void gs_s_close_bad_data_socket(struct sock_id* fd_id, int close_reason,
             is_addr = true;
 
             mc_tcp_close(g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket);
+            mc_shm_detach(g_instance.comm_cxt.g_senders->sender_conn[node_idx].shm_ring);
+            g_instance.comm_cxt.g_senders->sender_conn[node_idx].shm_ring = NULL;
             g_instance.comm_cxt.g_senders->sender_conn[node_idx].port = -1;
             g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket = -1;
             g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket_id = -1;
@@ -3447,13 +3595,45 @@ static int gs_reload_hba(int fd, const sockaddr ctrl_client)
  *                   -1: net error
  *                   -2: mem error
  */
+/*
+ * Whether the peer of a connected socket is on this host: it connected from a loopback
+ * address or from the very address it connected to.
+ */
+static bool gs_peer_is_local(int fd)
+{
+    struct sockaddr_storage peer;
+    struct sockaddr_storage local;
+    socklen_t peer_len = sizeof(peer);
+    socklen_t local_len = sizeof(local);
+
+    if (getpeername(fd, (struct sockaddr*)&peer, &peer_len) != 0 ||
+        getsockname(fd, (struct sockaddr*)&local, &local_len) != 0 || peer.ss_family != local.ss_family) {
+        return false;
+    }
+
+    if (peer.ss_family == AF_INET) {
+        struct in_addr* peer_addr = &((struct sockaddr_in*)&peer)->sin_addr;
+        struct in_addr* local_addr = &((struct sockaddr_in*)&local)->sin_addr;
+        return (ntohl(peer_addr->s_addr) >> IN_CLASSA_NSHIFT) == IN_LOOPBACKNET ||
+               peer_addr->s_addr == local_addr->s_addr;
+    } else if (peer.ss_family == AF_INET6) {
+        struct in6_addr* peer_addr = &((struct sockaddr_in6*)&peer)->sin6_addr;
+        struct in6_addr* local_addr = &((struct sockaddr_in6*)&local)->sin6_addr;
+        return IN6_IS_ADDR_LOOPBACK(peer_addr) || IN6_ARE_ADDR_EQUAL(peer_addr, local_addr);
+    }
+
+    return false;
+}
+
 static int gs_accept_data_conntion(struct iovec* iov, const sock_id fd_id)
 {
     int node_idx = -1;
     struct sock_id old_fd_id;
+    struct mc_shm_ring* shm_ring = NULL;
     struct libcomm_connect_package* connect_pkg = (struct libcomm_connect_package*)iov->iov_base;
 
-    if (iov->iov_len < sizeof(struct libcomm_connect_package)) {
+    /* senders of older versions don't send shm_name */
+    if (iov->iov_len < offsetof(struct libcomm_connect_package, shm_name)) {
         LIBCOMM_ELOG(WARNING,
             "(r|inner recv)\tIov len[%zu] is less than libcomm_connect_package[%zu].",
             iov->iov_len, sizeof(struct libcomm_connect_package));
@@ -3484,6 +3664,21 @@ static int gs_accept_data_conntion(struct iovec* iov, const sock_id fd_id)
         return RECV_NET_ERROR;
     }
 
+    /*
+     * The sender offers a shared memory ring, take the data from it if the sender really is on
+     * this host. The name is unlinked at once, so nobody else can map the ring after us.
+     */
+    if (iov->iov_len >= sizeof(struct libcomm_connect_package) && is_tcp_mode()) {
+        connect_pkg->shm_name[MC_SHM_NAME_LEN - 1] = '\0';
+        if (connect_pkg->shm_name[0] != '\0' && g_instance.attr.attr_network.comm_shm_mode &&
+            gs_peer_is_local(fd_id.fd)) {
+            shm_ring = mc_shm_attach(connect_pkg->shm_name);
+            if (shm_ring != NULL) {
+                mc_shm_unlink(connect_pkg->shm_name);
+            }
+        }
+    }
+
     LIBCOMM_PTHREAD_RWLOCK_WRLOCK(&g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].rwlock);
     // step6: if the old socket is ok, maybe the primary is changed, we should close the old connection
     if (g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].socket >= 0) {
@@ -3500,6 +3695,7 @@ static int gs_accept_data_conntion(struct iovec* iov, const sock_id fd_id)
 
     g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].socket = fd_id.fd;
     g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].socket_id = fd_id.id;
+    g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].shm_ring = shm_ring;
     g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].msg_head.type = MSG_NULL;
     g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].head_read_cursor = 0;
     if (g_instance.comm_cxt.g_receivers->receiver_conn[node_idx].iov_item) {
@@ -3516,7 +3712,7 @@ static int gs_accept_data_conntion(struct iovec* iov, const sock_id fd_id)
     // step 7: send back ack to tell the sender continue
     struct libcomm_accept_package ack_msg;
     ack_msg.type = SCTP_PKG_TYPE_ACCEPT;
-    ack_msg.result = 1;
+    ack_msg.result = (shm_ring != NULL) ? LIBCOMM_ACCEPT_SHM : LIBCOMM_ACCEPT_OK;
     if (g_libcomm_adapt.send_ack(fd_id.fd, (char*)&ack_msg, sizeof(ack_msg)) < 0) {
         gs_r_close_bad_data_socket(node_idx, fd_id, true);
         return RECV_NET_ERROR;
@@ -3568,11 +3764,12 @@ static int gs_accept_data_conntion(struct iovec* iov, const sock_id fd_id)
 
     LIBCOMM_ELOG(LOG,
         "(r|recv loop)\tAccept data connection for "
-        "node[%d]:%s with socket[%d,%d].",
+        "node[%d]:%s with socket[%d,%d]%s.",
         node_idx,
         g_instance.comm_cxt.g_r_node_sock[node_idx].remote_nodename,
         fd_id.fd,
-        fd_id.id);
+        fd_id.id,
+        (shm_ring != NULL) ? ", data through shared memory" : "");
 
     return 0;
 }
@@ -3605,6 +3802,108 @@ int gs_handle_data_delay_message(int idx, struct mc_lqueue_item* q_item, uint16
     return 0;
 }
 
+/*
+ * function name    : gs_internal_shm_recv
+ * description      : take all the messages a sender on this host has put into the shared
+ *                    memory ring of the data connection, after its doorbell woke us up.
+ * arguments        : fd_id: the data socket, only carrying doorbells
+ *                    node_idx: the node index of the sender
+ * return value     : RECV_NEED_RETRY when the ring is empty, or the error
+ */
+static int gs_internal_shm_recv(const sock_id fd_id, int node_idx)
+{
+    struct node_connection* conn = &g_instance.comm_cxt.g_receivers->receiver_conn[node_idx];
+    struct mc_lqueue_item* iov_item = NULL;
+    struct iovec* iov = NULL;
+    struct c_mailbox* cmailbox = NULL;
+    char doorbell[64];
+    MsgHead msg_head;
+    int error;
+
+    /* take away the doorbells, the socket is closed when the sender is gone */
+    do {
+        error = mc_tcp_read_nonblock(fd_id.fd, doorbell, sizeof(doorbell), 0);
+        if (error < 0) {
+            return RECV_NET_ERROR;
+        }
+    } while (error == (int)sizeof(doorbell));
+
+    for (;;) {
+        LIBCOMM_PTHREAD_RWLOCK_WRLOCK(&conn->rwlock);
+        /* the connection has been closed or replaced meanwhile */
+        if (conn->shm_ring == NULL || conn->socket != fd_id.fd || conn->socket_id != fd_id.id) {
+            LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
+            return RECV_NEED_RETRY;
+        }
+
+        if (mc_shm_used(conn->shm_ring) < sizeof(MsgHead)) {
+            /* go back to the poller, unless a message has come before the sender could see us wait */
+            if (mc_shm_prepare_wait(conn->shm_ring)) {
+                LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
+                return RECV_NEED_RETRY;
+            }
+            LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
+            continue;
+        }
+
+        if (libcomm_malloc_iov_item(&iov_item, IOV_DATA_SIZE) != 0) {
+            /*
+             * The sender rings only when it sees us wait, so no doorbell would bring us back to
+             * the messages left in the ring. Free memory as the poller does for a socket, and
+             * keep draining.
+             */
+            LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
+            LIBCOMM_ELOG(WARNING,
+                "(r|inner recv)\tFailed to malloc for shared memory of node[%d]:%s, begin release memory.",
+                node_idx,
+                REMOTE_NAME(g_instance.comm_cxt.g_r_node_sock, node_idx));
+            gs_r_release_comm_memory();
+            (void)usleep(1000);
+            continue;
+        }
+        iov = iov_item->element.data;
+
+        mc_shm_read(conn->shm_ring, &msg_head, sizeof(MsgHead));
+        if (msg_head.magic_num != MSG_HEAD_MAGIC_NUM || msg_head.checksum != MSG_HEAD_TEMP_CHECKSUM ||
+            msg_head.msg_len > IOV_DATA_SIZE || mc_shm_used(conn->shm_ring) < msg_head.msg_len) {
+            LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
+            LIBCOMM_ELOG(WARNING,
+                "(r|inner recv)\tReceiver error msg head from shared memory of "
+                "node[%d]:%s lid:%d len=%u, magic_num[%d].",
+                node_idx,
+                REMOTE_NAME(g_instance.comm_cxt.g_r_node_sock, node_idx),
+                msg_head.logic_id,
+                msg_head.msg_len,
+                msg_head.magic_num);
+            libcomm_free_iov_item(&iov_item, IOV_DATA_SIZE);
+            return RECV_NET_ERROR;
+        }
+
+        mc_shm_read(conn->shm_ring, iov->iov_base, msg_head.msg_len);
+        iov->iov_len = msg_head.msg_len;
+        conn->comm_bytes += msg_head.msg_len;
+        conn->comm_count += 1;
+        LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&conn->rwlock);
+
+        if (msg_head.logic_id > 0) {
+            cmailbox = &C_MAILBOX(node_idx, msg_head.logic_id);
+            if (gs_push_cmailbox_buffer(cmailbox, iov_item, msg_head.version) < 0) {
+                libcomm_free_iov_item(&iov_item, IOV_DATA_SIZE);
+            }
+            continue;
+        }
+
+        /* only the delay survey comes on stream 0 once the connection is accepted */
+        uint16 msg_type = *(uint16*)iov->iov_base;
+        if ((msg_type == SCTP_PKG_TYPE_DELAY_REQUEST || msg_type == SCTP_PKG_TYPE_DELAY_REPLY) &&
+            gs_handle_data_delay_message(node_idx, iov_item, msg_type) == 0) {
+            /* iov save to cmailbox[idx][0], no need free */
+            continue;
+        }
+        libcomm_free_iov_item(&iov_item, IOV_DATA_SIZE);
+    }
+}
+
 // the broker: receive message from give socket and put it into
 //      the corressponding mailbox in g_c_mailbox, then wake up Consumer of executor to fetch the data
 // sock        : the data socket which has epoll events
@@ -3626,6 +3925,11 @@ static int gs_internal_recv(const sock_id fd_id, int node_idx)
     // Initialize inmessage with enough space for DATA, and control message.
     COMM_TIMER_INIT();
 
+    /* the sender is on this host, the socket only rings the doorbell */
+    if (idx >= 0 && g_instance.comm_cxt.g_receivers->receiver_conn[idx].shm_ring != NULL) {
+        return gs_internal_shm_recv(fd_id, idx);
+    }
+
     for (;;) {
         LibcommRecvInfo recv_info;
         COMM_TIMER_LOG("(r|inner recv)\tInternal receive start.");
@@ -5603,9 +5907,20 @@ static void gs_senders_flow_handle_stop_query_request(FCMSG_T* fcmsgr)
     LIBCOMM_PTHREAD_MUTEX_UNLOCK(&pmailbox->sinfo_lock);
 }
 
+/*
+ * Whether host is an address of this host, the data connection to it can then use shared memory.
+ * If the remote turns out not to be able to map the ring, it just declines it.
+ */
+static bool gs_is_same_host(const char* host)
+{
+    return strcmp(host, g_instance.comm_cxt.localinfo_cxt.g_local_host) == 0 || strcmp(host, "127.0.0.1") == 0 ||
+           strcmp(host, "::1") == 0 || IS_LOCAL_HOST(host);
+}
+
 static int libcomm_build_tcp_connection(libcommaddrinfo* libcomm_addrinfo, int node_idx)
 {
     struct sock_id fd_id = {-1, -1};
+    struct mc_shm_ring* shm_ring = NULL;
     ip_key addr;
     int msg_len = NAMEDATALEN;
     int error = -1;
@@ -5666,6 +5981,20 @@ static int libcomm_build_tcp_connection(libcommaddrinfo* libcomm_addrinfo, int n
     securec_check(ss_rc, "\0", "\0");
     msg_len = sizeof(struct libcomm_connect_package);
 
+    /* offer a shared memory ring to a remote on this host, the name is unlinked once it has answered */
+    connect_package.shm_name[0] = '\0';
+    if (g_instance.attr.attr_network.comm_shm_mode && gs_is_same_host(libcomm_addrinfo->host)) {
+        shm_ring = mc_shm_create(connect_package.shm_name, MC_SHM_NAME_LEN, MC_SHM_RING_SIZE);
+        if (shm_ring == NULL) {
+            LIBCOMM_ELOG(WARNING,
+                "(s|build tcp connection)\tFailed to create shared memory ring for node[%d]:%s, use tcp: %s.",
+                node_idx,
+                g_instance.comm_cxt.g_s_node_sock[node_idx].remote_nodename,
+                mc_strerror(errno));
+            connect_package.shm_name[0] = '\0';
+        }
+    }
+
     MsgHead msg_head;
     msg_head.type = 'C';
     msg_head.magic_num = MSG_HEAD_MAGIC_NUM;
@@ -5689,12 +6018,20 @@ static int libcomm_build_tcp_connection(libcommaddrinfo* libcomm_addrinfo, int n
             g_instance.comm_cxt.g_s_node_sock[node_idx].remote_nodename,
             sock);
         mc_tcp_close(sock);
+        if (shm_ring != NULL) {
+            mc_shm_unlink(connect_package.shm_name);
+            mc_shm_detach(shm_ring);
+        }
         return -1;
     }
 
     if (gs_map_sock_id_to_node_idx(fd_id, node_idx) < 0) {
         LIBCOMM_ELOG(WARNING, "(s|build tcp connection)\tFailed to save sock and sockid.");
         mc_tcp_close(sock);
+        if (shm_ring != NULL) {
+            mc_shm_unlink(connect_package.shm_name);
+            mc_shm_detach(shm_ring);
+        }
         return -1;
     }
 
@@ -5702,7 +6039,8 @@ retry_read:
     struct libcomm_accept_package ack_msg = {0, 0};
     error = mc_tcp_read_block(sock, &ack_msg, sizeof(ack_msg), 0);
     // if failed, we close the bad one and return -1
-    if (error < 0 || ack_msg.result != 1 || ack_msg.type != SCTP_PKG_TYPE_ACCEPT) {
+    if (error < 0 || (ack_msg.result != LIBCOMM_ACCEPT_OK && ack_msg.result != LIBCOMM_ACCEPT_SHM) ||
+        ack_msg.type != SCTP_PKG_TYPE_ACCEPT) {
         LIBCOMM_ELOG(WARNING,
             "(s|build tcp connection)\tFailed to recv assoc id from %s:%d "
             "for node[%d]:%s on socket[%d].",
@@ -5712,12 +6050,25 @@ retry_read:
             g_instance.comm_cxt.g_s_node_sock[node_idx].remote_nodename,
             sock);
         mc_tcp_close(sock);
+        if (shm_ring != NULL) {
+            mc_shm_unlink(connect_package.shm_name);
+            mc_shm_detach(shm_ring);
+        }
         return -1;
     } else if (error == 0) {
         usleep(1000);
         goto retry_read;
     }
 
+    /* the remote has mapped the ring or is not going to */
+    if (shm_ring != NULL) {
+        mc_shm_unlink(connect_package.shm_name);
+        if (ack_msg.result != LIBCOMM_ACCEPT_SHM) {
+            mc_shm_detach(shm_ring);
+            shm_ring = NULL;
+        }
+    }
+
     g_instance.comm_cxt.g_senders->sender_conn[node_idx].ip_changed = true;
     LIBCOMM_PTHREAD_RWLOCK_WRLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
     /*
@@ -5728,6 +6079,7 @@ retry_read:
     if (strcmp(g_instance.comm_cxt.g_s_node_sock[node_idx].remote_host, libcomm_addrinfo->host) != 0) {
         g_instance.comm_cxt.g_senders->sender_conn[node_idx].ip_changed = false;
         LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
+        mc_shm_detach(shm_ring);
         return -1;
     }
 
@@ -5751,6 +6103,7 @@ retry_read:
     g_instance.comm_cxt.g_senders->sender_conn[node_idx].assoc_id = 1;
     g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket = fd_id.fd;
     g_instance.comm_cxt.g_senders->sender_conn[node_idx].socket_id = fd_id.id;
+    g_instance.comm_cxt.g_senders->sender_conn[node_idx].shm_ring = shm_ring;
     g_instance.comm_cxt.g_senders->sender_conn[node_idx].ip_changed = false;
 
     /* set reply socket for g_r_node_sock */
@@ -5769,13 +6122,14 @@ retry_read:
 
     LIBCOMM_PTHREAD_RWLOCK_UNLOCK(&g_instance.comm_cxt.g_senders->sender_conn[node_idx].rwlock);
     LIBCOMM_ELOG(LOG,
-        "(s|build tcp connection)\tSucceed to connect %s:%d with socket[%d:%d] for node[%d]:%s.",
+        "(s|build tcp connection)\tSucceed to connect %s:%d with socket[%d:%d] for node[%d]:%s%s.",
         libcomm_addrinfo->host,
         libcomm_addrinfo->sctp_port,
         fd_id.fd,
         fd_id.id,
         node_idx,
-        REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx));
+        REMOTE_NAME(g_instance.comm_cxt.g_s_node_sock, node_idx),
+        (shm_ring != NULL) ? ", data through shared memory" : "");
 
     return 0;
 }
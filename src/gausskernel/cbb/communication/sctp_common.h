@@ -544,6 +544,11 @@ struct node_connection {
     MsgHead msg_head;
     int head_read_cursor;
     struct mc_lqueue_item* iov_item;
+    struct mc_shm_ring* shm_ring; /* data goes through it if the remote is on this host */
+    /* messages waiting for the rwlock, sent together by its next holder */
+    pthread_mutex_t send_queue_lock;
+    struct libcomm_send_request* send_queue;
+    struct libcomm_send_request* send_queue_tail;
 };
 
 // structure used for keeping control tcp port & socket, sctp port and socket
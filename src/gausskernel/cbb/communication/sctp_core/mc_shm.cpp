@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * mc_shm.cpp
+ *
+ * The ring has one sender and one receiver. The sender only moves tail and the receiver
+ * only moves head, a message is visible to the receiver once tail covers all of it.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/cbb/communication/sctp_core/mc_shm.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sctp_utils/sctp_util.h"
+#include "storage/barrier.h"
+#include "mc_shm.h"
+
+static volatile uint32 mc_shm_counter = 0;
+
+#define MC_SHM_RING_BYTES(size) (offsetof(struct mc_shm_ring, data) + (size))
+
+/*
+ * Create a ring of size bytes for sending, and return the name the receiver maps it by.
+ * Returns NULL if shared memory is not available, the caller then sends over the socket.
+ */
+struct mc_shm_ring* mc_shm_create(char* name, int name_len, uint32 size)
+{
+    struct mc_shm_ring* ring = NULL;
+    int fd;
+    int rc;
+
+    Assert(size > 0 && (size & (size - 1)) == 0);
+
+    rc = snprintf_s(name, name_len, name_len - 1, MC_SHM_NAME_PREFIX "%d_%u", (int)getpid(),
+        atomic_add(&mc_shm_counter, 1));
+    securec_check_ss(rc, "\0", "\0");
+
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (ftruncate(fd, (off_t)MC_SHM_RING_BYTES(size)) != 0) {
+        (void)close(fd);
+        (void)shm_unlink(name);
+        return NULL;
+    }
+
+    ring = (struct mc_shm_ring*)mmap(NULL, MC_SHM_RING_BYTES(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (ring == MAP_FAILED) {
+        (void)shm_unlink(name);
+        return NULL;
+    }
+
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+    /* the receiver is idle until the first message */
+    ring->waiting = 1;
+    pg_write_barrier();
+    ring->magic = MC_SHM_RING_MAGIC;
+
+    return ring;
+}
+
+/*
+ * Map the ring created by a sender on this host. Returns NULL if there is no such ring,
+ * which is the case when the sender runs on another host.
+ */
+struct mc_shm_ring* mc_shm_attach(const char* name)
+{
+    struct mc_shm_ring* ring = NULL;
+    struct stat st;
+    int fd;
+
+    /* the name comes from the network, only look at our own rings */
+    if (strncmp(name, MC_SHM_NAME_PREFIX, strlen(MC_SHM_NAME_PREFIX)) != 0 || strchr(name + 1, '/') != NULL) {
+        return NULL;
+    }
+
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)MC_SHM_RING_BYTES(0)) {
+        (void)close(fd);
+        return NULL;
+    }
+
+    ring = (struct mc_shm_ring*)mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (ring == MAP_FAILED) {
+        return NULL;
+    }
+
+    if (ring->magic != MC_SHM_RING_MAGIC || ring->size == 0 || (ring->size & (ring->size - 1)) != 0 ||
+        (off_t)MC_SHM_RING_BYTES(ring->size) != st.st_size) {
+        (void)munmap(ring, (size_t)st.st_size);
+        return NULL;
+    }
+
+    return ring;
+}
+
+void mc_shm_unlink(const char* name)
+{
+    (void)shm_unlink(name);
+}
+
+void mc_shm_detach(struct mc_shm_ring* ring)
+{
+    if (ring != NULL) {
+        (void)munmap(ring, MC_SHM_RING_BYTES(ring->size));
+    }
+}
+
+/*
+ * Append data1 and data2 as one message. Returns false if there is no room for it yet.
+ */
+bool mc_shm_write(struct mc_shm_ring* ring, const void* data1, uint32 len1, const void* data2, uint32 len2)
+{
+    const void* parts[2] = {data1, data2};
+    uint32 lens[2] = {len1, len2};
+    uint64 tail = ring->tail;
+    errno_t rc;
+
+    if (ring->size - (tail - ring->head) < (uint64)len1 + len2) {
+        return false;
+    }
+    /* read head before overwriting the space it has released */
+    pg_memory_barrier();
+
+    for (int i = 0; i < 2; i++) {
+        uint32 offset = (uint32)(tail & (ring->size - 1));
+        uint32 first = Min(lens[i], ring->size - offset);
+
+        if (first > 0) {
+            rc = memcpy_s(ring->data + offset, ring->size - offset, parts[i], first);
+            securec_check(rc, "\0", "\0");
+        }
+        if (lens[i] > first) {
+            rc = memcpy_s(ring->data, ring->size, (const char*)parts[i] + first, lens[i] - first);
+            securec_check(rc, "\0", "\0");
+        }
+        tail += lens[i];
+    }
+
+    /* the message must be complete before the receiver sees the new tail */
+    pg_write_barrier();
+    ring->tail = tail;
+
+    return true;
+}
+
+/*
+ * Called by the sender after a write: returns true if the receiver is waiting for
+ * a doorbell on the socket. Only one sender sees true for one wait.
+ */
+bool mc_shm_need_wakeup(struct mc_shm_ring* ring)
+{
+    /* pairs with the barrier in mc_shm_prepare_wait, one of both sides sees the other */
+    pg_memory_barrier();
+    if (ring->waiting == 0) {
+        return false;
+    }
+    return COMPARE_AND_SWAP(&ring->waiting, 1, 0);
+}
+
+uint32 mc_shm_used(struct mc_shm_ring* ring)
+{
+    uint64 used = ring->tail - ring->head;
+
+    /* the data up to tail is complete once we have seen tail */
+    pg_read_barrier();
+    return (uint32)used;
+}
+
+/*
+ * Take len bytes, the caller has checked with mc_shm_used that they are there.
+ */
+void mc_shm_read(struct mc_shm_ring* ring, void* data, uint32 len)
+{
+    uint64 head = ring->head;
+    uint32 offset = (uint32)(head & (ring->size - 1));
+    uint32 first = Min(len, ring->size - offset);
+    errno_t rc;
+
+    if (first > 0) {
+        rc = memcpy_s(data, len, ring->data + offset, first);
+        securec_check(rc, "\0", "\0");
+    }
+    if (len > first) {
+        rc = memcpy_s((char*)data + first, len - first, ring->data, len - first);
+        securec_check(rc, "\0", "\0");
+    }
+
+    /* done with the space before the sender may reuse it */
+    pg_memory_barrier();
+    ring->head = head + len;
+}
+
+/*
+ * Called by the receiver when the ring is empty, before it goes back to its poller.
+ * Returns false if a message has arrived meanwhile, the receiver must then read on
+ * rather than wait for a doorbell that may never come.
+ */
+bool mc_shm_prepare_wait(struct mc_shm_ring* ring)
+{
+    ring->waiting = 1;
+    pg_memory_barrier();
+    if (ring->tail == ring->head) {
+        return true;
+    }
+
+    ring->waiting = 0;
+    return false;
+}
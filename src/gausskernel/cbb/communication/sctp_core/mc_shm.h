@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * mc_shm.h
+ *        Shared memory ring used as the data channel between instances on the same host.
+ *
+ * The sender creates the ring and passes its name in the connect package of the tcp
+ * data connection, the receiver maps it and unlinks the name. Both sides then keep the
+ * tcp socket only as doorbell: the sender writes one byte to it when the receiver has
+ * announced that it is going to wait on the socket, so an idle receiver is woken by its
+ * poller as before while a busy one takes the messages without any system call.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/cbb/communication/sctp_core/mc_shm.h
+ *
+ * -------------------------------------------------------------------------
+ */
+#ifndef _CORE_MC_SHM_H_
+#define _CORE_MC_SHM_H_
+
+#define MC_SHM_NAME_PREFIX "/gs_libcomm_"
+#define MC_SHM_NAME_LEN 64
+#define MC_SHM_RING_MAGIC 0x6c637269
+#define MC_SHM_RING_SIZE (4 * 1024 * 1024)
+
+struct mc_shm_ring {
+    uint32 magic;
+    uint32 size;               /* size of data, a power of 2 */
+    volatile uint64 head;      /* bytes consumed, advanced by the receiver */
+    char pad1[PG_CACHE_LINE_SIZE - sizeof(uint64)];
+    volatile uint64 tail;      /* bytes produced, advanced by the sender */
+    volatile uint32 waiting;   /* set by the receiver before it sleeps in its poller */
+    char pad2[PG_CACHE_LINE_SIZE - sizeof(uint64) - sizeof(uint32)];
+    char data[FLEXIBLE_ARRAY_MEMBER];
+};
+
+struct mc_shm_ring* mc_shm_create(char* name, int name_len, uint32 size);
+
+struct mc_shm_ring* mc_shm_attach(const char* name);
+
+void mc_shm_unlink(const char* name);
+
+void mc_shm_detach(struct mc_shm_ring* ring);
+
+bool mc_shm_write(struct mc_shm_ring* ring, const void* data1, uint32 len1, const void* data2, uint32 len2);
+
+bool mc_shm_need_wakeup(struct mc_shm_ring* ring);
+
+uint32 mc_shm_used(struct mc_shm_ring* ring);
+
+void mc_shm_read(struct mc_shm_ring* ring, void* data, uint32 len);
+
+bool mc_shm_prepare_wait(struct mc_shm_ring* ring);
+
+#endif  //_CORE_MC_SHM_H_
@@ -395,6 +395,36 @@ int mc_tcp_write_noblock(int fd, const void* data, int size)
     return (size_t)nbytes;
 }
 
+/*
+ * Same as mc_tcp_write_noblock, for the data described by iovcnt iovecs.
+ */
+int mc_tcp_writev_noblock(int fd, struct iovec* iov, int iovcnt)
+{
+#ifdef LIBCOMM_FAULT_INJECTION_ENABLE
+    if (is_comm_fault_injection(LIBCOMM_FI_MC_TCP_WRITE_NONBLOCK_FAILED)) {
+        LIBCOMM_ELOG(WARNING, "(mc tcp writev noblock)\t[FAULT INJECTION]Failed to writev noblock for %d.", fd);
+        shutdown(fd, SHUT_RDWR);
+        return -1;
+    }
+#endif
+    struct msghdr msg = {0};
+    ssize_t nbytes;
+
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    nbytes = sendmsg(fd, &msg, 0);
+
+    if (nbytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS)) {
+        return 0;
+    }
+
+    if (nbytes <= 0) {
+        return -1;
+    }
+
+    return (size_t)nbytes;
+}
+
 // initialize Socket
 //
 int mc_tcp_socket(int family, int type, int protocol)
@@ -61,6 +61,8 @@ int mc_tcp_write_block(int fd, const void* data, int size);
 
 int mc_tcp_write_noblock(int fd, const void* data, int size);
 
+int mc_tcp_writev_noblock(int fd, struct iovec* iov, int iovcnt);
+
 int mc_tcp_read_block(int fd, void* data, int size, int flags);
 
 int mc_tcp_read_nonblock(int fd, void* data, int size, int flags);
@@ -32,6 +32,7 @@
 #include <pthread.h>
 #include "sctp_message.h"
 #include "sctp_common.h"
+#include "sctp_core/mc_shm.h"
 
 #define MAXSTACKSIZE 1048576
 #define PACKETLEN 8192
@@ -119,6 +120,7 @@ struct libcomm_connect_package {
     uint16 magic_num;
     char node_name[NAMEDATALEN];
     char host[HOST_ADDRSTRLEN];
+    char shm_name[MC_SHM_NAME_LEN]; /* shared memory ring of the sender, empty if none */
 };
 
 // sctp accept package
@@ -127,6 +129,10 @@ struct libcomm_accept_package {
     uint16 result;
 };
 
+// result of accept package
+#define LIBCOMM_ACCEPT_OK 1
+#define LIBCOMM_ACCEPT_SHM 2 /* accepted, and the receiver has mapped the shared memory ring */
+
 // sctp delay survey package
 struct libcomm_delay_package {
     uint16 type;
@@ -326,6 +326,12 @@ static void UpdateUniqueSQLElapseTime(UniqueSQL* unique_sql, int64 elapse_start)
     gs_atomic_add_64(&(unique_sql->elapse_time.total_time), elapse_time);
     updateMaxValueForAtomicType(elapse_time, &(unique_sql->elapse_time.max_time));
     updateMinValueForAtomicType(elapse_time, &(unique_sql->elapse_time.min_time));
+
+    /* the thread pool schedules sessions running slow statements behind the others */
+    uint64 calls = pg_atomic_read_u64(&unique_sql->calls);
+    if (calls > 0) {
+        u_sess->unique_sql_cxt.last_avg_elapse_time = unique_sql->elapse_time.total_time / (int64)calls;
+    }
 }
 
 /*
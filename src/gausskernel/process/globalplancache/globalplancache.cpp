@@ -33,6 +33,8 @@
 #include "optimizer/nodegroups.h"
 #include "pgxc/groupmgr.h"
 #include "pgxc/pgxcnode.h"
+#include "storage/barrier.h"
+#include "storage/proc.h"
 #include "utils/dynahash.h"
 #include "utils/globalplancache.h"
 #include "utils/memutils.h"
@@ -224,11 +226,14 @@ void GlobalPlanCache::GetSchemaName(GPCEnv *env)
     }
 }
 
-void GlobalPlanCache::EnvFill(GPCEnv *env)
+/*
+ * @Description: Fill in the scalar GUC parameters of the environment, everything but
+ * the signatures, the nodegroup names, the database and the schema
+ * @in num: GPCEnv
+ * @return - void
+*/
+static void GPCFillEnvSettings(GPCEnv *env)
 {
-    /* We should only call this function if env is not NULL and it's not filled */
-    Assert(env && !env->filled);
-    GPCFillEnvSignatures(env);
 #ifdef ENABLE_MULTIPLE_NODES
     env->best_agg_plan = u_sess->attr.attr_sql.best_agg_plan;
     env->query_dop_tmp = u_sess->attr.attr_sql.query_dop_tmp;
@@ -239,12 +244,6 @@ void GlobalPlanCache::EnvFill(GPCEnv *env)
     env->rewrite_rule = u_sess->attr.attr_sql.rewrite_rule;
     env->codegen_strategy = u_sess->attr.attr_sql.codegen_strategy;
     env->plan_mode_seed = u_sess->attr.attr_sql.plan_mode_seed;
-
-    MemoryContext old_context = MemoryContextSwitchTo(env->context);
-    env->expected_computing_nodegroup = pstrdup(u_sess->attr.attr_sql.expected_computing_nodegroup);
-    env->default_storage_nodegroup = pstrdup(u_sess->attr.attr_sql.default_storage_nodegroup);
-    MemoryContextSwitchTo(old_context);
-
     env->effective_cache_size = u_sess->attr.attr_sql.effective_cache_size;
     env->codegen_cost_threshold = u_sess->attr.attr_sql.codegen_cost_threshold;
     env->seq_page_cost = u_sess->attr.attr_sql.seq_page_cost;
@@ -275,12 +274,25 @@ void GlobalPlanCache::EnvFill(GPCEnv *env)
     env->behavior_compat_flags = u_sess->utils_cxt.behavior_compat_flags;
     env->datestyle = u_sess->time_cxt.DateStyle;
     env->dateorder = u_sess->time_cxt.DateOrder;
-    env->filled = true;
 
     /* new GUC parameters which affect the plan */
     env->qrw_inlist2join_optmode = u_sess->opt_cxt.qrw_inlist2join_optmode;
     env->skew_strategy_store = u_sess->attr.attr_sql.skew_strategy_store;
+}
+
+void GlobalPlanCache::EnvFill(GPCEnv *env)
+{
+    /* We should only call this function if env is not NULL and it's not filled */
+    Assert(env && !env->filled);
+    GPCFillEnvSignatures(env);
+    GPCFillEnvSettings(env);
+
+    MemoryContext old_context = MemoryContextSwitchTo(env->context);
+    env->expected_computing_nodegroup = pstrdup(u_sess->attr.attr_sql.expected_computing_nodegroup);
+    env->default_storage_nodegroup = pstrdup(u_sess->attr.attr_sql.default_storage_nodegroup);
+    MemoryContextSwitchTo(old_context);
 
+    env->filled = true;
     env->database_id = u_sess->proc_cxt.MyDatabaseId;
     GetSchemaName(env);
 }
@@ -365,6 +377,96 @@ static bool GPCCompareEnvSignature(GPCEnv *env)
     return diff;
 }
 
+#define GPC_FNV_OFFSET_BASIS UINT64CONST(0xcbf29ce484222325)
+#define GPC_FNV_PRIME UINT64CONST(0x100000001b3)
+
+static inline uint64 GPCFingerprintAdd(uint64 fingerprint, const void *data, Size len)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (Size i = 0; i < len; i++) {
+        fingerprint ^= bytes[i];
+        fingerprint *= GPC_FNV_PRIME;
+    }
+    return fingerprint;
+}
+
+#define GPC_FINGERPRINT_FIELD(fp, env, field) \
+    ((fp) = GPCFingerprintAdd((fp), &(env)->field, sizeof((env)->field)))
+
+/*
+ * @Description: 64-bit FNV-1a fingerprint of a query and the compilation environment
+ * compared by GPCCompareEnvSignature. Equal environments always give equal fingerprints,
+ * so a lookup only needs the exact comparison for a node whose fingerprint matches.
+ * @in num: query hash code, number of parameters, environment and schema name
+ * @return - uint64
+*/
+static uint64 GPCEnvFingerprint(uint32 query_hash, int num_params, const GPCEnv *env, const char *schema_name)
+{
+    uint64 fp = GPC_FNV_OFFSET_BASIS;
+
+    fp = GPCFingerprintAdd(fp, &query_hash, sizeof(query_hash));
+    fp = GPCFingerprintAdd(fp, &num_params, sizeof(num_params));
+#ifdef PGXC
+    GPC_FINGERPRINT_FIELD(fp, env, env_signature_pgxc);
+    GPC_FINGERPRINT_FIELD(fp, env, best_agg_plan);
+#endif
+#ifdef DEBUG_BOUNDED_SORT
+    GPC_FINGERPRINT_FIELD(fp, env, optimize_bounded_sort);
+#endif
+    GPC_FINGERPRINT_FIELD(fp, env, env_signature);
+    GPC_FINGERPRINT_FIELD(fp, env, env_signature2);
+    GPC_FINGERPRINT_FIELD(fp, env, database_id);
+    GPC_FINGERPRINT_FIELD(fp, env, query_dop_tmp);
+    GPC_FINGERPRINT_FIELD(fp, env, rewrite_rule);
+    GPC_FINGERPRINT_FIELD(fp, env, codegen_strategy);
+    GPC_FINGERPRINT_FIELD(fp, env, plan_mode_seed);
+    GPC_FINGERPRINT_FIELD(fp, env, effective_cache_size);
+    GPC_FINGERPRINT_FIELD(fp, env, codegen_cost_threshold);
+    GPC_FINGERPRINT_FIELD(fp, env, seq_page_cost);
+    GPC_FINGERPRINT_FIELD(fp, env, random_page_cost);
+    GPC_FINGERPRINT_FIELD(fp, env, cpu_tuple_cost);
+    GPC_FINGERPRINT_FIELD(fp, env, allocate_mem_cost);
+    GPC_FINGERPRINT_FIELD(fp, env, cpu_index_tuple_cost);
+    GPC_FINGERPRINT_FIELD(fp, env, cpu_operator_cost);
+    GPC_FINGERPRINT_FIELD(fp, env, stream_multiple);
+    GPC_FINGERPRINT_FIELD(fp, env, geqo_threshold);
+    GPC_FINGERPRINT_FIELD(fp, env, Geqo_effort);
+    GPC_FINGERPRINT_FIELD(fp, env, Geqo_pool_size);
+    GPC_FINGERPRINT_FIELD(fp, env, Geqo_generations);
+    GPC_FINGERPRINT_FIELD(fp, env, Geqo_selection_bias);
+    GPC_FINGERPRINT_FIELD(fp, env, Geqo_seed);
+    GPC_FINGERPRINT_FIELD(fp, env, default_statistics_target);
+    GPC_FINGERPRINT_FIELD(fp, env, from_collapse_limit);
+    GPC_FINGERPRINT_FIELD(fp, env, join_collapse_limit);
+    GPC_FINGERPRINT_FIELD(fp, env, cost_param);
+    GPC_FINGERPRINT_FIELD(fp, env, schedule_splits_threshold);
+    GPC_FINGERPRINT_FIELD(fp, env, hashagg_table_size);
+    GPC_FINGERPRINT_FIELD(fp, env, cursor_tuple_fraction);
+    GPC_FINGERPRINT_FIELD(fp, env, constraint_exclusion);
+    GPC_FINGERPRINT_FIELD(fp, env, behavior_compat_flags);
+    GPC_FINGERPRINT_FIELD(fp, env, datestyle);
+    GPC_FINGERPRINT_FIELD(fp, env, dateorder);
+    GPC_FINGERPRINT_FIELD(fp, env, qrw_inlist2join_optmode);
+    GPC_FINGERPRINT_FIELD(fp, env, skew_strategy_store);
+    fp = GPCFingerprintAdd(fp, schema_name, strlen(schema_name));
+
+    return fp;
+}
+
+/* Fingerprint of the query under the current session's compilation environment. */
+static uint64 GPCSessionFingerprint(uint32 query_hash, int num_params)
+{
+    GPCEnv sessEnv;
+    errno_t rc = memset_s(&sessEnv, sizeof(sessEnv), 0, sizeof(sessEnv));
+    securec_check(rc, "\0", "\0");
+
+    GPCFillEnvSignatures(&sessEnv);
+    GPCFillEnvSettings(&sessEnv);
+    sessEnv.database_id = u_sess->proc_cxt.MyDatabaseId;
+
+    return GPCEnvFingerprint(query_hash, num_params, &sessEnv, u_sess->attr.attr_common.namespace_current_schema);
+}
+
 DListCell* GPCFetchStmtInList(DList* target, const char* stmt) 
 {
     Assert(target != NULL);
@@ -434,6 +536,12 @@ void GlobalPlanCache::PlanInit()
                                                                    SHARED_CONTEXT);
     }
 
+    m_gpc_bucket_stat_array = (GPCBucketStat*) MemoryContextAllocZero(g_instance.cache_cxt.global_cache_mem,
+                                                                      sizeof(GPCBucketStat) * GPC_NUM_OF_BUCKETS);
+    /* epoch 0 marks a proc which is not reading the lookup lists */
+    m_gpc_epoch = 1;
+    m_gpc_retired_nodes = NULL;
+
     m_gpc_invalid_plansource = NULL;
 }
 
@@ -452,6 +560,157 @@ uint32 GlobalPlanCache::GetBucket(uint32 hashvalue)
     return bucket;
 }
 
+/* Acquire the bucket lock, counting the acquisitions which had to wait. */
+void GlobalPlanCache::BucketLockAcquire(uint32 bucket, LWLockMode mode)
+{
+    LWLock *lock = GetMainLWLockByIndex(FirstGPCMappingLock + bucket);
+
+    if (!LWLockConditionalAcquire(lock, mode)) {
+        (void)pg_atomic_fetch_add_u64(&m_gpc_bucket_stat_array[bucket].lock_waits, 1);
+        (void)LWLockAcquire(lock, mode);
+    }
+}
+
+/*
+ * The lookup counters of the current proc. They stay with the PGPROC when another
+ * thread takes it over, so the sums in the views only grow.
+ */
+GPCProcLookupStat* GlobalPlanCache::ProcLookupStat()
+{
+    if (t_thrd.proc->gpcLookupStat == NULL) {
+        GPCProcLookupStat *stat = (GPCProcLookupStat*) MemoryContextAllocZero(
+            g_instance.cache_cxt.global_cache_mem, sizeof(GPCProcLookupStat));
+
+        /* the views read it without locks, publish it zeroed */
+        pg_write_barrier();
+        t_thrd.proc->gpcLookupStat = stat;
+    }
+
+    return t_thrd.proc->gpcLookupStat;
+}
+
+/*
+ * @Description: Publish the shared plan of plansource in the lookup list of its bucket.
+ * Only environments GPCCompareEnvSignature can ever match are published. The caller
+ * must hold the bucket lock exclusively.
+ * @in num: plansource, bucket index
+ * @return - void
+ */
+void GlobalPlanCache::LookupPublish(CachedPlanSource *plansource, uint32 bucket)
+{
+    GPCEnv *env = plansource->gpc.env;
+    GPCEntry *entry = env->globalplancacheentry;
+
+    if (!env->filled ||
+        strcmp(env->expected_computing_nodegroup, CNG_OPTION_QUERY) != 0 ||
+        strcmp(env->default_storage_nodegroup, INSTALLATION_MODE) != 0) {
+        return;
+    }
+
+    GPCLookupNode *node = (GPCLookupNode *)MemoryContextAllocZero(m_gpc_bucket_info_array[bucket].context,
+        offsetof(GPCLookupNode, query_string) + entry->key.query_length + 1);
+    node->fingerprint = GPCEnvFingerprint(plansource->gpc.query_hash_code, env->num_params, env, env->schema_name);
+    node->env = env;
+    node->num_params = env->num_params;
+    node->query_length = entry->key.query_length;
+    errno_t rc = memcpy_s(node->query_string, entry->key.query_length + 1,
+                          entry->key.query_string, entry->key.query_length);
+    securec_check(rc, "\0", "\0");
+
+    node->next = m_gpc_bucket_info_array[bucket].lookup_head;
+    /* make the node visible only once it is complete */
+    pg_write_barrier();
+    m_gpc_bucket_info_array[bucket].lookup_head = node;
+}
+
+/*
+ * @Description: Unlink the lookup node of env from the bucket's list, if it was published.
+ * Readers may still be walking through the node, so it must go to LookupRetire.
+ * The caller must hold the bucket lock exclusively.
+ * @in num: env, bucket index
+ * @return - the unlinked node or NULL
+ */
+GPCLookupNode* GlobalPlanCache::LookupUnlink(GPCEnv *env, uint32 bucket)
+{
+    GPCLookupNode* volatile *prev = &m_gpc_bucket_info_array[bucket].lookup_head;
+
+    for (GPCLookupNode *node = *prev; node != NULL; node = node->next) {
+        if (node->env == env) {
+            *prev = node->next;
+            return node;
+        }
+        prev = &node->next;
+    }
+    return NULL;
+}
+
+/*
+ * @Description: Queue an unlinked lookup node for reclamation. The epoch is advanced so
+ * that every reader which could still see the node announces an epoch not newer than
+ * the node's retire_epoch. The caller must hold GPCClearLock exclusively.
+ * @in num: node
+ * @return - void
+ */
+void GlobalPlanCache::LookupRetire(GPCLookupNode *node)
+{
+    node->retire_epoch = pg_atomic_fetch_add_u64(&m_gpc_epoch, 1);
+    node->retire_next = m_gpc_retired_nodes;
+    m_gpc_retired_nodes = node;
+}
+
+/*
+ * @Description: Get the oldest epoch any proc is still reading the lookup lists under.
+ * Whatever was retired at an older epoch can no longer be reached by a reader.
+ * @in num: void
+ * @return - uint64
+ */
+uint64 GlobalPlanCache::OldestReadingEpoch()
+{
+    pg_memory_barrier();
+    uint64 oldest = m_gpc_epoch;
+    for (uint32 i = 0; i < g_instance.proc_base->allProcCount; i++) {
+        uint64 epoch = g_instance.proc_base->allProcs[i]->gpcEpoch;
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    /* refcounts read after this see the pins taken by readers which already left */
+    pg_memory_barrier();
+
+    return oldest;
+}
+
+/*
+ * @Description: Free the retired lookup nodes, and the environments they defer, which no
+ * proc can be reading any more. The caller must hold GPCClearLock exclusively.
+ * @in num: void
+ * @return - void
+ */
+void GlobalPlanCache::LookupReclaim()
+{
+    if (m_gpc_retired_nodes == NULL) {
+        return;
+    }
+
+    uint64 oldest = OldestReadingEpoch();
+
+    GPCLookupNode **prev = &m_gpc_retired_nodes;
+    GPCLookupNode *node = m_gpc_retired_nodes;
+    while (node != NULL) {
+        GPCLookupNode *next = node->retire_next;
+        if (node->retire_epoch < oldest) {
+            *prev = next;
+            if (node->drop_env) {
+                MemoryContextDelete(node->env->context);
+            }
+            pfree(node);
+        } else {
+            prev = &node->retire_next;
+        }
+        node = next;
+    }
+}
+
 void GlobalPlanCache::PlanStore(CachedPlanSource *plansource)
 {
     Assert (plansource != NULL);
@@ -469,7 +728,7 @@ void GlobalPlanCache::PlanStore(CachedPlanSource *plansource)
     Assert ((int) partitionLock >= FirstGPCMappingLock);
     Assert ((int) partitionLock < FirstGPCMappingLock + GPC_NUM_OF_BUCKETS);
 
-    LWLockAcquire(GetMainLWLockByIndex(partitionLock), LW_EXCLUSIVE);
+    BucketLockAcquire(gpc_bucket_index, LW_EXCLUSIVE);
     Assert (plansource->gpc.entry == NULL);
 
     bool found = false;
@@ -517,70 +776,91 @@ void GlobalPlanCache::PlanStore(CachedPlanSource *plansource)
     Assert (plansource->gplan->is_share == true);
     Assert (plansource->gplan->context->parent == g_instance.cache_cxt.global_cache_mem);
 
+    LookupPublish(plansource, gpc_bucket_index);
+
     LWLockRelease(GetMainLWLockByIndex(partitionLock));
 }
 
-GPCEnv* GlobalPlanCache::PlanFetch(const char *query_string, uint32 query_len, int num_params)
+/*
+ * @Description: Find a shared plan of the query under the session's compilation environment.
+ * This takes no lock: the bucket's lookup list is walked comparing precomputed fingerprints,
+ * and only a matching node is compared exactly. The proc announces the epoch it reads under
+ * so that writers keep every node it may still reach. The plansource found is pinned before
+ * the epoch is left, since its env may be freed right after; the caller owns the pin.
+ * @in num: query string, query length, number of parameters
+ * @return - pinned shared CachedPlanSource or NULL
+ */
+CachedPlanSource* GlobalPlanCache::PlanFetch(const char *query_string, uint32 query_len, int num_params)
 {
+    Assert(t_thrd.proc != NULL);
+
+    /* GPCCompareEnvSignature never matches without a current schema */
+    if (u_sess->attr.attr_common.namespace_current_schema == NULL) {
+        return NULL;
+    }
+
     GPCKey key;
     key.query_string = query_string;
     key.query_length = query_len;
     uint32 hashCode = GPCHashFunc((const void *) &key, sizeof(key));
-
     uint32 gpc_bucket_index = GetBucket(hashCode);
-    int partitionLock = (int) (FirstGPCMappingLock + gpc_bucket_index);
-    Assert ((int) partitionLock >= FirstGPCMappingLock);
-    Assert ((int) partitionLock < FirstGPCMappingLock + GPC_NUM_OF_BUCKETS);
-
-    LWLockAcquire(GetMainLWLockByIndex(partitionLock), LW_SHARED);
+    uint64 fingerprint = GPCSessionFingerprint(hashCode, num_params);
+    GPCProcLookupStat *stat = ProcLookupStat();
 
-    bool foundCachedEntry = false;
-    GPCEntry *cachedEntry = (GPCEntry *) hash_search_with_hash_value(m_global_plan_cache,
-                                                                     (const void*)(&key),
-                                                                     hashCode,
-                                                                     HASH_FIND,
-                                                                     &foundCachedEntry);
+    CachedPlanSource *shared = NULL;
 
-    if (cachedEntry == NULL || cachedEntry->cachedPlans == NULL) {
-        LWLockRelease(GetMainLWLockByIndex(partitionLock));
-        return NULL;
-    }
+    t_thrd.proc->gpcEpoch = m_gpc_epoch;
+    pg_memory_barrier();
 
-    GPCEnv *gpc_env = NULL;
-    int numCachedPlans = cachedEntry->cachedPlans->length;
-    DListCell *cell = cachedEntry->cachedPlans->head;
+    for (GPCLookupNode *node = m_gpc_bucket_info_array[gpc_bucket_index].lookup_head;
+         node != NULL; node = node->next) {
+        if (node->fingerprint != fingerprint || node->query_length != query_len ||
+            node->num_params != num_params ||
+            memcmp(node->query_string, query_string, query_len) != 0 ||
+            GPCCompareEnvSignature(node->env) == true) {
+            continue;
+        }
 
-    for (int i = 0; i < numCachedPlans; i++) {
-        Assert(cell != NULL);
-
-        gpc_env = (GPCEnv *) cell->data.ptr_value;
-        if (gpc_env != NULL && num_params == gpc_env->num_params &&
-            GPCCompareEnvSignature(gpc_env) == false) {
-            if (gpc_env->plansource->gpc.is_share == true) {
-                Assert (gpc_env->plansource->gplan != NULL);
-                Assert (gpc_env->plansource->gplan->is_share == true);
-                Assert (gpc_env->plansource->gplan->context->parent == g_instance.cache_cxt.global_cache_mem);
-                break;
-            }
+        /*
+         * PlanDrop and PlanClean may be dropping the env concurrently, they no longer
+         * hold off readers with the bucket lock. Pin the plansource and check again that
+         * it is still the valid shared one, the pin keeps InvalidPlanDrop off it.
+         */
+        CachedPlanSource *plansource = node->env->plansource;
+        if (plansource == NULL || !plansource->gpc.is_valid || !plansource->gpc.is_share) {
+            continue;
         }
-        gpc_env = NULL;
-        cell = cell->next;
+        RefcountAdd(plansource);
+        if (node->env->plansource == plansource && plansource->gpc.is_valid) {
+            shared = plansource;
+            break;
+        }
+        RefcountSub(plansource);
     }
 
-    LWLockRelease(GetMainLWLockByIndex(partitionLock));
+    pg_memory_barrier();
+    t_thrd.proc->gpcEpoch = 0;
 
-    return gpc_env;
+    if (shared != NULL) {
+        stat->hits[gpc_bucket_index]++;
+    } else {
+        stat->misses[gpc_bucket_index]++;
+    }
+
+    return shared;
 }
 
 void GlobalPlanCache::InvalidPlanDrop()
 {
     if (m_gpc_invalid_plansource != NULL) {
+        /* a reader still walking past the dropped node may be about to pin the plansource */
+        uint64 oldest = OldestReadingEpoch();
         DListCell *cell = m_gpc_invalid_plansource->head;
 
         while (cell != NULL) {
             CachedPlanSource *curr = (CachedPlanSource *)cell->data.ptr_value;
             
-            if (curr->gpc.refcount == 0) {
+            if (curr->gpc.retire_epoch < oldest && curr->gpc.refcount == 0) {
                 DListCell *next = cell->next;
                 m_gpc_invalid_plansource = dlist_delete_cell(m_gpc_invalid_plansource, cell, false);
 
@@ -609,6 +889,8 @@ void GlobalPlanCache::PlanDrop(GPCEnv *cachedenv)
         return ;
     }
     plansource->gpc.is_valid = false;
+    /* stays 0 if the env was never published, then no reader can reach the plansource */
+    plansource->gpc.retire_epoch = 0;
 
     Assert (plansource->gpc.env == cachedenv);
     GPCEntry *entry = cachedenv->globalplancacheentry;
@@ -624,6 +906,9 @@ void GlobalPlanCache::PlanDrop(GPCEnv *cachedenv)
                 dlist_delete_cell(cachedenv->globalplancacheentry->cachedPlans, cell, false);
             gs_atomic_add_32(&entry->refcount, -1);
 
+            /* the caller holds the bucket lock exclusively */
+            GPCLookupNode *node = LookupUnlink(cachedenv, (uint32)(entry->lockId - FirstGPCMappingLock));
+
             if (entry->refcount == 0) {
                 /* Remove the GPC entry */
                 Assert(entry->cachedPlans == NULL);
@@ -638,13 +923,22 @@ void GlobalPlanCache::PlanDrop(GPCEnv *cachedenv)
                 pfree((void *)entry->key.query_string);
 
                 cachedenv->plansource = NULL;
-                MemoryContextDelete(cachedenv->context);
+                if (node != NULL) {
+                    node->drop_env = true;
+                } else {
+                    MemoryContextDelete(cachedenv->context);
+                }
             }
 
+            if (node != NULL) {
+                LookupRetire(node);
+                plansource->gpc.retire_epoch = node->retire_epoch;
+            }
             break;
         }
         cell = cell->next;
     }
+    LookupReclaim();
     InvalidPlanDrop();
     MemoryContext oldcontext = MemoryContextSwitchTo(g_instance.cache_cxt.global_cache_mem);
     m_gpc_invalid_plansource = dlappend(m_gpc_invalid_plansource, plansource);
@@ -1050,7 +1344,7 @@ void GlobalPlanCache::Commit()
     CachedPlanSource *plansource = NULL;
     CachedPlanSource *prev_plansource = NULL;
     CachedPlanSource *next_plansource = NULL;
-    GPCEnv *env = NULL;
+    CachedPlanSource *shared = NULL;
 
     plansource = u_sess->pcache_cxt.first_saved_plan;
     prev_plansource = u_sess->pcache_cxt.first_saved_plan;
@@ -1065,13 +1359,13 @@ void GlobalPlanCache::Commit()
         }
 
         LWLockAcquire(GPCCommitLock, LW_EXCLUSIVE);
-        env = PlanFetch(plansource->query_string, strlen(plansource->query_string), plansource->num_params);
+        shared = PlanFetch(plansource->query_string, strlen(plansource->query_string), plansource->num_params);
         ereport(DEBUG3, (errmodule(MOD_GPC), errcode(ERRCODE_LOG),
                 errmsg("gpc  <commit>  global_sess_id:%lu  stmt_name:%s  session_id:%lu find:%s",
                        u_sess->global_sess_id, plansource->stmt_name, u_sess->session_id,
-                       env != NULL ? "YES" : "NO")));
+                       shared != NULL ? "YES" : "NO")));
 
-        if (env == NULL) {
+        if (shared == NULL) {
             PlanStore(plansource);
 
             if (prev_plansource == u_sess->pcache_cxt.first_saved_plan) {
@@ -1083,7 +1377,18 @@ void GlobalPlanCache::Commit()
 
             plansource = plansource->next_saved;
         } else {
-            PrepareUpdate(plansource, env->plansource, true);
+            /* the prepared statement takes its own reference, drop the pin of PlanFetch */
+            PG_TRY();
+            {
+                PrepareUpdate(plansource, shared, true);
+            }
+            PG_CATCH();
+            {
+                RefcountSub(shared);
+                PG_RE_THROW();
+            }
+            PG_END_TRY();
+            RefcountSub(shared);
 
             if (prev_plansource == u_sess->pcache_cxt.first_saved_plan) {
                 prev_plansource = plansource->next_saved;
@@ -132,7 +132,7 @@ void GlobalPlanCache::InvalMsg(const SharedInvalidationMessage *msgs, int n)
         
         /* Ok so bucket is not empty. Get the bucket S-lock so we can iterate through it. */
         int partitionLock = (int) (FirstGPCMappingLock + currBucket);
-        (void)LWLockAcquire(GetMainLWLockByIndex(partitionLock), LW_EXCLUSIVE);
+        BucketLockAcquire(currBucket, LW_EXCLUSIVE);
         
         /* Check the number of entries in the bucket again. 
         * GPC Eviction might have removed the last entry while we were waiting for the shared lock. */
@@ -32,12 +32,33 @@
 #include "optimizer/nodegroups.h"
 #include "pgxc/groupmgr.h"
 #include "pgxc/pgxcnode.h"
+#include "storage/proc.h"
 #include "utils/dynahash.h"
 #include "utils/globalplancache.h"
 #include "utils/memutils.h"
 #include "utils/plancache.h"
 #include "utils/syscache.h"
 
+/*
+ * Sum the lookups of all procs per bucket. Each proc bumps only its own counters,
+ * so they are read without locks and the sums are a moment's picture.
+ */
+static void GPCSumLookups(uint64 *hits, uint64 *misses)
+{
+    for (uint32 i = 0; i < g_instance.proc_base->allProcCount; i++) {
+        GPCProcLookupStat *stat = g_instance.proc_base->allProcs[i]->gpcLookupStat;
+
+        if (stat == NULL) {
+            continue;
+        }
+        pg_read_barrier();
+        for (uint32 bucket = 0; bucket < GPC_NUM_OF_BUCKETS; bucket++) {
+            hits[bucket] += stat->hits[bucket];
+            misses[bucket] += stat->misses[bucket];
+        }
+    }
+}
+
 /*
 * @Description: get global plan cache info from hashtable
 * @in num: the number of hash entry
@@ -77,12 +98,17 @@ void *GlobalPlanCache::GetStatus(uint32 *num)
     GPCStatus *stat_array =
         (GPCStatus*) palloc0(*num * sizeof(GPCStatus));
 
+    uint64 hits[GPC_NUM_OF_BUCKETS] = {0};
+    uint64 misses[GPC_NUM_OF_BUCKETS] = {0};
+    GPCSumLookups(hits, misses);
+
     hash_seq_init(&hash_seq, m_global_plan_cache);
 
     uint32 index = 0;
     while ((entry = (GPCEntry*)hash_seq_search(&hash_seq)) != NULL) {
         int numCachedPlans = entry->cachedPlans->length;
         DListCell *cell = entry->cachedPlans->head;
+        uint32 bucket = GetBucket(GPCHashFunc((const void *) &entry->key, sizeof(GPCKey)));
 
         for (int i = 0; i < numCachedPlans; i++) {
             Assert(cell != NULL);
@@ -104,6 +130,10 @@ void *GlobalPlanCache::GetStatus(uint32 *num)
                 rc = memcpy_s(stat_array[index].schema_name, NAMEDATALEN, env->schema_name, NAMEDATALEN);
                 securec_check(rc, "\0", "\0");
                 stat_array[index].params_num = ps->num_params;
+                stat_array[index].bucket_id = (int)bucket;
+                stat_array[index].bucket_hits = (int64)hits[bucket];
+                stat_array[index].bucket_misses = (int64)misses[bucket];
+                stat_array[index].bucket_lock_waits = (int64)m_gpc_bucket_stat_array[bucket].lock_waits;
 
                 index++;
             } else {
@@ -129,6 +159,7 @@ void *GlobalPlanCache::GetStatus(uint32 *num)
             stat_array[index].DatabaseID = 0;
             stat_array[index].schema_name = "";
             stat_array[index].params_num = 0;
+            stat_array[index].bucket_id = -1;
 
             index++;
             cell = cell->next;
@@ -224,6 +255,7 @@ void *GlobalPlanCache::GetPrepareStatus(uint32 *num)
 Datum GlobalPlanCache::PlanClean()
 {
     DListCell *cell = NULL;
+    GPCLookupNode *unlinked_nodes = NULL;
 
     for (uint32 currBucket = 0; currBucket < GPC_NUM_OF_BUCKETS; currBucket++) {
         int bucketEntriesCount = gs_atomic_add_32(&(m_gpc_bucket_info_array[currBucket].entries_count), 0);
@@ -232,7 +264,7 @@ Datum GlobalPlanCache::PlanClean()
         }
         /* Ok so bucket is not empty. Get the bucket S-lock so we can iterate through it. */
         int partitionLock = (int) (FirstGPCMappingLock + currBucket);
-        (void)LWLockAcquire(GetMainLWLockByIndex(partitionLock), LW_EXCLUSIVE);
+        BucketLockAcquire(currBucket, LW_EXCLUSIVE);
         /* Check the number of entries in the bucket again. 
          * GPC Eviction might have removed the last entry while we were waiting for the shared lock. */
         bucketEntriesCount = gs_atomic_add_32(&(m_gpc_bucket_info_array[currBucket].entries_count), 0);
@@ -258,8 +290,16 @@ Datum GlobalPlanCache::PlanClean()
                 if (env->plansource->gpc.refcount == 0) {
                     env->globalplancacheentry->cachedPlans = dlist_delete_cell(env->globalplancacheentry->cachedPlans, 
                                                                                cell, false);
+                    /* a published env may still be read by PlanFetch, leave it to LookupReclaim */
+                    GPCLookupNode *node = LookupUnlink(env, currBucket);
                     env->plansource = NULL;
-                    MemoryContextDelete(env->context);
+                    if (node != NULL) {
+                        node->drop_env = true;
+                        node->retire_next = unlinked_nodes;
+                        unlinked_nodes = node;
+                    } else {
+                        MemoryContextDelete(env->context);
+                    }
                     (void)gs_atomic_add_32(&entry->refcount, -1);
                 }
                 cell = next_cell;
@@ -284,11 +324,18 @@ Datum GlobalPlanCache::PlanClean()
         LWLockRelease(GetMainLWLockByIndex(partitionLock));
     }
     LWLockAcquire(GPCClearLock, LW_EXCLUSIVE);
+    while (unlinked_nodes != NULL) {
+        GPCLookupNode *next = unlinked_nodes->retire_next;
+        LookupRetire(unlinked_nodes);
+        unlinked_nodes = next;
+    }
+    LookupReclaim();
     if (m_gpc_invalid_plansource != NULL) {
+        uint64 oldest = OldestReadingEpoch();
         cell = m_gpc_invalid_plansource->head;
         while (cell != NULL) {
             CachedPlanSource *curr = (CachedPlanSource *)cell->data.ptr_value;
-            if (curr->gpc.refcount == 0) {
+            if (curr->gpc.retire_epoch < oldest && curr->gpc.refcount == 0) {
                 DListCell *next = cell->next;
                 m_gpc_invalid_plansource = dlist_delete_cell(m_gpc_invalid_plansource, cell, false);
                 DropCachedPlanInternal(curr);
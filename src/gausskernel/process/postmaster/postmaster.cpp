@@ -2573,6 +2573,20 @@ static int ServerLoop(void)
     /* Init backend thread pool */
     if (threadPoolActivated) {
         bool enableNumaDistribute = (g_instance.shmem_cxt.numaNodeNum > 1);
+
+        if (g_instance.attr.attr_common.thread_pool_reuseport) {
+            pgsocket clientSockets[MAXLISTEN];
+            int clientSocketNum = 0;
+
+            for (int i = 0; i < MAXLISTEN; i++) {
+                if (t_thrd.postmaster_cxt.ListenSocket[i] != PGINVALID_SOCKET &&
+                    t_thrd.postmaster_cxt.listen_sock_type[i] == PSQL_LISTEN_SOCKET &&
+                    !IS_FD_TO_RECV_GSSOCK(t_thrd.postmaster_cxt.ListenSocket[i])) {
+                    clientSockets[clientSocketNum++] = t_thrd.postmaster_cxt.ListenSocket[i];
+                }
+            }
+            g_threadPoolControler->SetListenSockets(clientSockets, clientSocketNum);
+        }
         g_threadPoolControler->Init(enableNumaDistribute);
     }
     ereport(LOG, (errmsg("create thread end!")));
@@ -3347,6 +3361,16 @@ int ProcessStartupPacket(Port* port, bool SSLdone)
                     ereport(elevel,
                         (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                             errmsg("requested backend version is larger than grand version.")));
+            } else if (strcmp(nameptr, "columnar_result") == 0) {
+                /*
+                 * Only a client which understands the columnar batch message may ask
+                 * for it, so this is a protocol option rather than a GUC.
+                 */
+                if (!parse_bool(valptr, &port->columnar_result))
+                    ereport(elevel,
+                        (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                            errmsg("invalid value for parameter \"columnar_result\""),
+                            errhint("Valid values are: false, 0, true, 1.")));
             } else if (strcmp(nameptr, "connect_timeout") == 0) {
                 errno = 0;
                 u_sess->attr.attr_network.PoolerConnectTimeout = (uint32) strtoul(valptr, NULL, 10);
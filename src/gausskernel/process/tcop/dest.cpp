@@ -31,6 +31,7 @@
 
 #include "access/printtup.h"
 #include "access/xact.h"
+#include "access/xlogdefs.h"
 #include "commands/copy.h"
 #include "commands/createas.h"
 #include "executor/functions.h"
@@ -154,6 +155,38 @@ DestReceiver* CreateDestReceiver(CommandDest dest)
     return &donothingDR;
 }
 
+/*
+ * ReportCommitLSN - tell the client where the commit record of the command ends
+ *
+ * With report_commit_lsn on, a command that committed a transaction is followed by a
+ * ParameterStatus message "commit_lsn" right before its CommandComplete. A transaction
+ * committed at Sync in the extended protocol is reported right before ReadyForQuery.
+ * The client can then set standby_read_lsn to that location to read its own writes on
+ * a standby.
+ */
+static void ReportCommitLSN(void)
+{
+    XLogRecPtr commitLSN = u_sess->xact_cxt.lastCommitLSN;
+    StringInfoData buf;
+    char location[MAXFNAMELEN];
+    errno_t rc;
+
+    if (commitLSN == InvalidXLogRecPtr || !u_sess->attr.attr_storage.report_commit_lsn ||
+        PG_PROTOCOL_MAJOR(FrontendProtocol) < 3) {
+        return;
+    }
+    u_sess->xact_cxt.lastCommitLSN = InvalidXLogRecPtr;
+
+    rc = snprintf_s(location, sizeof(location), sizeof(location) - 1, "%X/%X",
+        (uint32)(commitLSN >> 32), (uint32)commitLSN);
+    securec_check_ss(rc, "\0", "\0");
+
+    pq_beginmessage(&buf, 'S');
+    pq_sendstring(&buf, "commit_lsn");
+    pq_sendstring(&buf, location);
+    pq_endmessage(&buf);
+}
+
 /* ----------------
  *		EndCommand - clean up the destination at end of command
  * ----------------
@@ -168,6 +201,8 @@ void EndCommand(const char* commandTag, CommandDest dest)
         case DestBatchBroadCast:
         case DestBatchLocalBroadCast:
         case DestBatchRedistribute:
+            ReportCommitLSN();
+
             /*
              * We assume the commandTag is plain ASCII and therefore requires
              * no encoding conversion.
@@ -288,14 +323,24 @@ void ReadyForQuery(CommandDest dest)
             if (PG_PROTOCOL_MAJOR(FrontendProtocol) >= 3) {
                 StringInfoData buf;
 
+                ReportCommitLSN();
+
                 pq_beginmessage(&buf, 'Z');
                 pq_sendbyte(&buf, TransactionBlockStatusCode());
                 pq_endmessage(&buf);
             } else if (PG_PROTOCOL_MAJOR(FrontendProtocol) >= 2)
                 pq_putemptymessage('Z');
 
-            /* Flush output at end of cycle in any case. */
-            pq_flush();
+            /*
+             * Flush output at end of cycle, unless the client has pipelined more
+             * messages behind this one. Their results then go out together with
+             * ours when the pipeline is drained, or at the latest when we could
+             * have to wait for more input (see pq_pipeline_prepare_read). The
+             * thread pool worker stays with the session meanwhile as there is
+             * input left to consume.
+             */
+            if (!u_sess->attr.attr_sql.enable_pipeline_mode || !pq_has_buffered_message())
+                pq_flush();
 
             break;
 
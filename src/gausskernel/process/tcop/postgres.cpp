@@ -70,6 +70,7 @@
 #include "replication/datasender.h"
 #include "replication/walsender.h"
 #include "replication/slot.h"
+#include "replication/walreceiver.h"
 #include "rewrite/rewriteHandler.h"
 #include "storage/bufmgr.h"
 #include "storage/ipc.h"
@@ -641,9 +642,18 @@ static int ReadCommand(StringInfo inBuf)
     if (!enable_session_sig_alarm(u_sess->attr.attr_common.SessionTimeout * 1000))
         ereport(FATAL, (errcode(ERRCODE_SYSTEM_ERROR), errmsg("could not set timer for session timeout")));
 
-    if (t_thrd.postgres_cxt.whereToSendOutput == DestRemote)
+    if (t_thrd.postgres_cxt.whereToSendOutput == DestRemote) {
+        /*
+         * Wait for the client no longer than the session keeps its idle state,
+         * and release that state if the client stays quiet. Sessions of the
+         * thread pool are released by their listener instead.
+         */
+        long delay = IS_THREAD_POOL_WORKER ? -1 : knl_session_idle_release_delay(u_sess);
+        if (delay >= 0 && !pq_wait_for_input(delay)) {
+            knl_session_release_idle(u_sess);
+        }
         result = SocketBackend(inBuf);
-    else if (t_thrd.postgres_cxt.whereToSendOutput == DestDebug)
+    } else if (t_thrd.postgres_cxt.whereToSendOutput == DestDebug)
         result = InteractiveBackend(inBuf);
     else
         result = EOF;
@@ -2967,11 +2977,20 @@ static void exec_parse_message(const char* query_string, /* string to execute */
     is_named = (stmt_name[0] != '\0');
     if (is_named) {
         if (ENABLE_DN_GPC) {
-            GPCEnv *env = GPC->PlanFetch(query_string, strlen(query_string), numParams);
+            /* PlanFetch pins the shared plansource, the prepared statement keeps the pin */
+            CachedPlanSource *shared = GPC->PlanFetch(query_string, strlen(query_string), numParams);
 
-            if (env != NULL) {
-                GPC->PrepareStore(stmt_name, env->plansource, false);
-                GPC->RefcountAdd(env->plansource);
+            if (shared != NULL) {
+                PG_TRY();
+                {
+                    GPC->PrepareStore(stmt_name, shared, false);
+                }
+                PG_CATCH();
+                {
+                    GPC->RefcountSub(shared);
+                    PG_RE_THROW();
+                }
+                PG_END_TRY();
                 goto pass_parsing;
             }
         }
@@ -4926,6 +4945,9 @@ void start_xact_command(void)
             t_thrd.storage_cxt.cancel_from_timeout = false;
 
         t_thrd.postgres_cxt.xact_started = true;
+
+        /* on a hot standby, wait for the session's own writes to be replayed */
+        StandbyWaitForReadLSN();
     }
 }
 
@@ -7847,10 +7869,6 @@ int PostgresMain(int argc, char* argv[], const char* dbname, const char* usernam
         t_thrd.codegen_cxt.g_runningInFmgr = false;
         PTFastQueryShippingStore = true;
 
-        MemoryContext oldMemory = MemoryContextSwitchTo(t_thrd.top_mem_cxt);
-        CodeGenThreadInitialize();
-        (void)MemoryContextSwitchTo(oldMemory);
-
         /* Set statement_timestamp */
         SetStatementStartTimestamp(t_thrd.shemem_ptr_cxt.mySessionMemoryEntry->dnStartTime);
 
@@ -10657,6 +10675,20 @@ static void exec_batch_bind_execute(StringInfo input_message)
             int tmp_count = 0;
 
             for (int i = 0; i < batch_count; i++) {
+                /*
+                 * Once the statement is known to run in bypass mode, hand the remaining
+                 * sets to it together instead of executing them one by one.
+                 */
+                if (psrc->opFusionObj != NULL && ((OpFusion*)psrc->opFusionObj)->isBatchable()) {
+                    OpFusion* opfusion = (OpFusion*)psrc->opFusionObj;
+
+                    opfusion->bindClearPosition();
+                    opfusion->setCurrentOpFusionObj(opfusion);
+                    process_count += (int)OpFusion::processBatch(&params_set[i], batch_count - i, true);
+                    CommandCounterIncrement();
+                    break;
+                }
+
                 exec_one_in_batch(
                     psrc, params_set[i], numRFormats, rformats, i == 0 ? send_DP_msg : false, dest, completionTag);
 
@@ -24,6 +24,7 @@
 #include <c.h>
 
 #include "access/parallel_recovery/page_redo.h"
+#include "access/redo_statistic.h"
 #include "access/reloptions.h"
 #include "commands/prepare.h"
 #include "executor/instrument.h"
@@ -172,6 +173,7 @@ static void knl_g_parallel_redo_init(knl_g_parallel_redo_context* predo_cxt)
     predo_cxt->redoPf.recovery_done_ptr = 0;
     predo_cxt->redoPf.speed_according_seg = 0;
     predo_cxt->redoPf.local_max_lsn = 0;
+    redo_stat_reset(&predo_cxt->replayStat);
     knl_g_set_is_local_redo_finish(false);
     predo_cxt->redoType = DEFAULT_REDO;
 }
@@ -266,6 +268,13 @@ static void knl_g_stat_init(knl_g_stat_context* stat_cxt)
     stat_cxt->fileIOStat = (FileIOStat*)palloc0(sizeof(FileIOStat));
     rc = memset_s(stat_cxt->fileIOStat, sizeof(FileIOStat), 0, sizeof(FileIOStat));
     securec_check(rc, "\0", "\0");
+
+    pg_atomic_init_u64(&stat_cxt->xactCSNSingleHits, 0);
+    pg_atomic_init_u64(&stat_cxt->xactCSNCacheLookups, 0);
+    pg_atomic_init_u64(&stat_cxt->xactCSNCacheHits, 0);
+    pg_atomic_init_u64(&stat_cxt->xactStatusSingleHits, 0);
+    pg_atomic_init_u64(&stat_cxt->xactStatusCacheLookups, 0);
+    pg_atomic_init_u64(&stat_cxt->xactStatusCacheHits, 0);
 }
 
 static void knl_g_pid_init(knl_g_pid_context* pid_cxt)
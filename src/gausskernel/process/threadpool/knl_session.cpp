@@ -61,6 +61,9 @@ extern int SysCacheSize;
 
 #define RAND48_SEED_0 0x330e
 
+/* in ms, see knl_session_release_idle() */
+#define SESSION_IDLE_RELEASE_TIME 60000
+
 static void knl_u_analyze_init(knl_u_analyze_context* anl_cxt)
 {
     anl_cxt->is_under_analyze = false;
@@ -281,8 +284,9 @@ static void knl_u_utils_init(knl_u_utils_context* utils_cxt)
     utils_cxt->test_err_type = 0;
     utils_cxt->cur_last_tid = (ItemPointerData*)palloc0(sizeof(ItemPointerData));
     utils_cxt->distribute_test_param = NULL;
-    utils_cxt->hist_start = (PGLZ_HistEntry**)palloc0(sizeof(PGLZ_HistEntry*) * PGLZ_HISTORY_LISTS);
-    utils_cxt->hist_entries = (PGLZ_HistEntry*)palloc0(sizeof(PGLZ_HistEntry) * PGLZ_HISTORY_SIZE);
+    utils_cxt->hist_start = NULL;
+    utils_cxt->hist_entries = NULL;
+    utils_cxt->hist_last_used = 0;
     utils_cxt->analysis_options_configure = (char*)palloc0(sizeof(char) * ANLS_BEMD_BITMAP_SIZE);
     utils_cxt->guc_new_value = NULL;
     utils_cxt->lastFailedLoginTime = 0;
@@ -652,7 +656,7 @@ static void knl_u_plpgsql_init(knl_u_plpgsql_context* plsql_cxt)
     plsql_cxt->plugin_ptr = NULL;
     plsql_cxt->ns_top = NULL;
     plsql_cxt->plpgsql_IdentifierLookup = IDENTIFIER_LOOKUP_NORMAL;
-    plsql_cxt->core_yy = (core_yy_extra_type*)palloc0(sizeof(core_yy_extra_type));
+    plsql_cxt->core_yy = NULL;
     plsql_cxt->yyscanner = NULL;
     plsql_cxt->goto_labels = NIL;
     plsql_cxt->rendezvousHash = NULL;
@@ -790,6 +794,7 @@ static void knl_u_unique_sql_init(knl_u_unique_sql_context* unique_sql_cxt)
     unique_sql_cxt->unique_sql_returned_rows_counter = 0;
     unique_sql_cxt->unique_sql_soft_parse = 0;
     unique_sql_cxt->unique_sql_hard_parse = 0;
+    unique_sql_cxt->last_avg_elapse_time = 0;
     unique_sql_cxt->last_stat_counter = (PgStat_TableCounts*)palloc0(sizeof(PgStat_TableCounts));
     unique_sql_cxt->current_table_counter = (PgStat_TableCounts*)palloc0(sizeof(PgStat_TableCounts));
     unique_sql_cxt->curr_single_unique_sql = NULL;
@@ -978,6 +983,7 @@ static void knl_u_xact_init(knl_u_xact_context* xact_cxt)
     xact_cxt->savePrepareGID = NULL;
 
     xact_cxt->pbe_execute_complete = true;
+    xact_cxt->lastCommitLSN = 0;
 }
 
 static void knl_u_ps_init(knl_u_ps_context* ps_cxt)
@@ -1012,6 +1018,8 @@ void knl_session_init(knl_session_context* sess_cxt)
 {
     sess_cxt->status = KNL_SESS_UNINIT;
     DLInitElem(&sess_cxt->elem, sess_cxt);
+    sess_cxt->ready_time = 0;
+    sess_cxt->release_idle = false;
 
     sess_cxt->top_transaction_mem_cxt = NULL;
     sess_cxt->self_mem_cxt = NULL;
@@ -1076,6 +1084,39 @@ void knl_session_init(knl_session_context* sess_cxt)
     knl_u_mot_init(&sess_cxt->mot_cxt);
 }
 
+/*
+ * Milliseconds until knl_session_release_idle() has something to free if the
+ * session stays idle, 0 if it has right away, or -1 if it never will.
+ */
+long knl_session_idle_release_delay(knl_session_context* sess_cxt)
+{
+    if (sess_cxt->utils_cxt.hist_start == NULL) {
+        return -1;
+    }
+
+    TimestampTz due = TimestampTzPlusMilliseconds(sess_cxt->utils_cxt.hist_last_used, SESSION_IDLE_RELEASE_TIME);
+    long secs;
+    int usecs;
+
+    TimestampDifference(GetCurrentTimestamp(), due, &secs, &usecs);
+    return secs * 1000 + usecs / 1000;
+}
+
+/*
+ * Free the lazily allocated session state that has not been used for
+ * SESSION_IDLE_RELEASE_TIME, so that the many sessions of a connection pool
+ * that sit idle keep only what they need. Called when the session has been
+ * waiting for its client that long: by the backend itself, or for a thread
+ * pool session by an idle worker the listener hands it to, attached as usual.
+ */
+void knl_session_release_idle(knl_session_context* sess_cxt)
+{
+    if (knl_session_idle_release_delay(sess_cxt) == 0) {
+        pfree_ext(sess_cxt->utils_cxt.hist_start);
+        pfree_ext(sess_cxt->utils_cxt.hist_entries);
+    }
+}
+
 knl_session_context* create_session_context(MemoryContext parent, uint64 id)
 {
     knl_session_context *sess, *old_sess;
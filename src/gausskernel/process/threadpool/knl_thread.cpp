@@ -283,6 +283,14 @@ static void knl_t_xact_init(knl_t_xact_context* xact_cxt)
     xact_cxt->cachedFetchXid = InvalidTransactionId;
     xact_cxt->cachedFetchXidStatus = 0;
     xact_cxt->cachedCommitLSN = 0;
+    xact_cxt->csnCache = NULL;
+    xact_cxt->statusCache = NULL;
+    xact_cxt->csnSingleHits = 0;
+    xact_cxt->csnCacheLookups = 0;
+    xact_cxt->csnCacheHits = 0;
+    xact_cxt->statusSingleHits = 0;
+    xact_cxt->statusCacheLookups = 0;
+    xact_cxt->statusCacheHits = 0;
 
     /* init var in multixact.cpp */
     xact_cxt->MXactCache = NULL;
@@ -661,6 +669,12 @@ static void knl_t_basebackup_init(knl_t_basebackup_context* basebackup_cxt)
     int rc = memset_s(basebackup_cxt->g_xlog_location, MAXPGPATH, 0, MAXPGPATH);
     securec_check(rc, "\0", "\0");
     basebackup_cxt->buf_block = NULL;
+    basebackup_cxt->incremental_block_hash = NULL;
+    basebackup_cxt->incremental_spcnode = InvalidOid;
+    basebackup_cxt->stream_compressor = NULL;
+    basebackup_cxt->compressed_message = NULL;
+    basebackup_cxt->compressed_message_size = 0;
+    basebackup_cxt->parallel_backup_id = 0;
 }
 
 static void knl_t_datarcvwriter_init(knl_t_datarcvwriter_context* datarcvwriter_cxt)
@@ -722,6 +736,7 @@ static void knl_t_datasender_init(knl_t_datasender_context* datasender_cxt)
 static void knl_t_walreceiverfuncs_init(knl_t_walreceiverfuncs_context* walreceiverfuncs_cxt)
 {
     walreceiverfuncs_cxt->WalRcv = NULL;
+    walreceiverfuncs_cxt->ReplayWait = NULL;
     walreceiverfuncs_cxt->WalReplIndex = 0;
 }
 
@@ -1112,6 +1127,7 @@ static void knl_t_walreceiver_init(knl_t_walreceiver_context* walreceiver_cxt)
     walreceiver_cxt->AmWalReceiverForFailover = false;
     walreceiver_cxt->AmWalReceiverForStandby = false;
     walreceiver_cxt->control_file_writed = 0;
+    walreceiver_cxt->decompressor = NULL;
 }
 
 static void knl_t_storage_init(knl_t_storage_context* storage_cxt)
@@ -1292,12 +1308,16 @@ static void knl_t_walsender_init(knl_t_walsender_context* walsender_cxt)
     walsender_cxt->CheckCUArray = NULL;
     walsender_cxt->logical_decoding_ctx = NULL;
     walsender_cxt->logical_startptr = InvalidXLogRecPtr;
+    walsender_cxt->logical_read_ahead = NULL;
     walsender_cxt->wsXLogJustSendRegion = (WSXLogJustSendRegion*)palloc0(sizeof(WSXLogJustSendRegion));
     walsender_cxt->wsXLogJustSendRegion->start_ptr = InvalidXLogRecPtr;
     walsender_cxt->wsXLogJustSendRegion->end_ptr = InvalidXLogRecPtr;
     walsender_cxt->reply_message = (StringInfoData*)palloc0(sizeof(StringInfoData));
     walsender_cxt->tmpbuf = (StringInfoData*)palloc0(sizeof(StringInfoData));
     walsender_cxt->remotePort = 0;
+    walsender_cxt->stream_compressor = NULL;
+    walsender_cxt->output_compressed_message = NULL;
+    walsender_cxt->output_compressed_message_size = 0;
 }
 
 static void knl_t_tsearch_init(knl_t_tsearch_context* tsearch_cxt)
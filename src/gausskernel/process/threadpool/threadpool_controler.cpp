@@ -76,6 +76,7 @@ ThreadPoolControler::ThreadPoolControler()
     m_groupNum = 1;
     m_threadNum = 0;
     m_maxPoolSize = 0;
+    m_listenSocketNum = 0;
 }
 
 ThreadPoolControler::~ThreadPoolControler()
@@ -517,6 +518,19 @@ CPUBindType ThreadPoolControler::GetCpuBindType() const
     return m_cpuInfo.bindType;
 }
 
+/*
+ * Remember the client sockets of the postmaster before the listeners start, each
+ * listener binds its own sockets to their addresses.
+ */
+void ThreadPoolControler::SetListenSockets(const pgsocket* sockets, int num)
+{
+    Assert(num <= MAXLISTEN);
+    for (int i = 0; i < num; i++) {
+        m_listenSockets[i] = sockets[i];
+    }
+    m_listenSocketNum = num;
+}
+
 void ThreadPoolControler::ReBindStreamThread(ThreadId tid) const
 {
     int ret = pthread_setaffinity_np(tid, sizeof(cpu_set_t), &m_cpuset);
@@ -624,6 +638,72 @@ void ThreadPoolControler::AddWorkerIfNecessary()
         m_groups[i]->AddWorkerIfNecessary();
 }
 
+/*
+ * Wake up an idle worker of another group to take a session waiting in the overloaded
+ * group. Groups on the same NUMA node are tried first; groups on other nodes only help
+ * once the backlog is long enough to make up for the remote memory accesses.
+ */
+void ThreadPoolControler::LendWaitingSession(ThreadPoolGroup* victim)
+{
+    int victimIdx = victim->GetGroupId();
+
+    if (m_groupNum <= 1) {
+        return;
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        bool remote = (pass == 1);
+
+        if (remote && victim->GetWaitServeSessionCount() < THREAD_STEAL_HIGH_WATERMARK + THREAD_STEAL_NUMA_PENALTY) {
+            return;
+        }
+
+        /* start after the victim, so that not always the same group is asked */
+        for (int i = 1; i < m_groupNum; i++) {
+            ThreadPoolGroup* group = m_groups[(victimIdx + i) % m_groupNum];
+
+            if ((group->GetNumaId() != victim->GetNumaId()) != remote || group->GetIdleWorkerNum() <= 0) {
+                continue;
+            }
+            if (group->GetListener()->WakeUpWorkerToSteal(victim)) {
+                return;
+            }
+        }
+    }
+}
+
+/*
+ * Find a group with sessions waiting that a worker of thief, about to go idle, may take.
+ * The same NUMA rules apply as in LendWaitingSession.
+ */
+ThreadPoolGroup* ThreadPoolControler::FindOverloadedGroup(ThreadPoolGroup* thief)
+{
+    int thiefIdx = thief->GetGroupId();
+
+    if (m_groupNum <= 1) {
+        return NULL;
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        bool remote = (pass == 1);
+
+        for (int i = 1; i < m_groupNum; i++) {
+            ThreadPoolGroup* group = m_groups[(thiefIdx + i) % m_groupNum];
+
+            if ((group->GetNumaId() != thief->GetNumaId()) != remote) {
+                continue;
+            }
+            if (remote && group->GetWaitServeSessionCount() < THREAD_STEAL_HIGH_WATERMARK + THREAD_STEAL_NUMA_PENALTY) {
+                continue;
+            }
+            if (group->IsOverloaded()) {
+                return group;
+            }
+        }
+    }
+    return NULL;
+}
+
 ThreadPoolGroup* ThreadPoolControler::FindThreadGroupWithLeastSession()
 {
     int idx = 0;
@@ -67,7 +67,11 @@ ThreadPoolGroup::ThreadPoolGroup(int maxWorkerNum, int expectWorkerNum,
       m_pendingWorkerNum(0),
       m_sessionCount(0),
       m_waitServeSessionCount(0),
+      m_waitLongSessionCount(0),
       m_processTaskCount(0),
+      m_stealInCount(0),
+      m_stealOutCount(0),
+      m_overloaded(0),
       m_groupId(groupId),
       m_numaId(numaId),
       m_groupCpuNum(cpuNum),
@@ -189,9 +193,9 @@ void ThreadPoolGroup::GetThreadPoolGroupStat(ThreadPoolStat* stat)
     int idle_session_num = m_sessionCount - m_waitServeSessionCount - run_session_num;
     idle_session_num = (idle_session_num < 0) ? 0 : idle_session_num;
     rc = sprintf_s(stat->sessionInfo, STATUS_INFO_SIZE,
-        "total: %d waiting: %d running:%d idle: %d",
-        m_sessionCount, m_waitServeSessionCount,
-        run_session_num, idle_session_num);
+        "total: %d waiting: %d (long: %d) running:%d idle: %d stolen in: %u out: %u",
+        m_sessionCount, m_waitServeSessionCount, m_waitLongSessionCount,
+        run_session_num, idle_session_num, m_stealInCount, m_stealOutCount);
     securec_check_ss(rc, "\0", "\0");
 }
 
@@ -328,6 +332,27 @@ bool ThreadPoolGroup::IsGroupHang()
     return is_hang;
 }
 
+/*
+ * Whether idle workers of other groups may take our waiting sessions. The state only
+ * flips at the watermarks, so a group with a short queue is not raided back and forth.
+ * Our listener and the workers of other groups call this concurrently, so the state
+ * is flipped with a compare-and-swap: if another thread flipped it first, its view wins.
+ */
+bool ThreadPoolGroup::IsOverloaded()
+{
+    int waiting = m_waitServeSessionCount;
+    uint32 overloaded = pg_atomic_read_u32(&m_overloaded);
+
+    if (overloaded != 0) {
+        if (waiting <= THREAD_STEAL_LOW_WATERMARK) {
+            (void)pg_atomic_compare_exchange_u32(&m_overloaded, &overloaded, 0);
+        }
+    } else if (waiting >= THREAD_STEAL_HIGH_WATERMARK) {
+        (void)pg_atomic_compare_exchange_u32(&m_overloaded, &overloaded, 1);
+    }
+    return pg_atomic_read_u32(&m_overloaded) != 0;
+}
+
 void ThreadPoolGroup::AttachThreadToCPU(ThreadId thread, int cpu)
 {
     cpu_set_t cpu_set;
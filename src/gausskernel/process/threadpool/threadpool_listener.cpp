@@ -32,6 +32,7 @@
 
 #include "access/xact.h"
 #include "gssignal/gs_signal.h"
+#include "libpq/ip.h"
 #include "libpq/libpq.h"
 #include "libpq/pqsignal.h"
 #include "miscadmin.h"
@@ -43,14 +44,19 @@
 #include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/guc.h"
+#include "utils/timestamp.h"
 
 #include <poll.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <openssl/rand.h>
 
 #define INVALID_FD (-1)
 
 static void t_pool_listener_loop(ThreadPoolListener* listener);
+static bool IsLongSession(knl_session_context* session);
+static bool SessionWaitedLong(Dlelem* elem, void* arg);
 
 static void listener_sigusrl_handler(SIGNAL_ARGS)
 {
@@ -100,19 +106,26 @@ ThreadPoolListener::ThreadPoolListener(ThreadPoolGroup* group)
     m_tid = InvalidTid;
     m_epollFd = INVALID_FD;
     m_epollEvents = NULL;
+    m_acceptSocketNum = 0;
+    m_lastIdleRelease = 0;
     m_reaperAllSession = false;
     m_freeWorkerList = New(CurrentMemoryContext) DllistWithLock();
     m_readySessionList = New(CurrentMemoryContext) DllistWithLock();
+    m_longSessionList = New(CurrentMemoryContext) DllistWithLock();
     m_idleSessionList = New(CurrentMemoryContext) DllistWithLock();
 }
 
 ThreadPoolListener::~ThreadPoolListener()
 {
+    for (int i = 0; i < m_acceptSocketNum; i++) {
+        closesocket(m_acceptSockets[i]);
+    }
     close(m_epollFd);
     m_group = NULL;
     m_epollEvents = NULL;
     m_freeWorkerList = NULL;
     m_readySessionList = NULL;
+    m_longSessionList = NULL;
     m_idleSessionList = NULL;
 }
 
@@ -144,12 +157,74 @@ void ThreadPoolListener::CreateEpoll()
         elog(LOG, "Not enough memory for listener epoll");
         proc_exit(0);
     }
+
+    if (g_instance.attr.attr_common.thread_pool_reuseport) {
+        CreateAcceptSockets();
+    }
+}
+
+/*
+ * Bind a socket of our own to each client address of the postmaster. The kernel spreads
+ * the new connections to a port over all the sockets bound to it with SO_REUSEPORT, so
+ * the listeners take most of them off the postmaster and make them sessions of their own
+ * group. If we cannot open a socket, the postmaster just keeps our share.
+ */
+void ThreadPoolListener::CreateAcceptSockets()
+{
+    const pgsocket* listenSockets = NULL;
+    int listenSocketNum = g_threadPoolControler->GetListenSockets(&listenSockets);
+    int one = 1;
+    int backlog = g_instance.attr.attr_network.MaxConnections * 6;
+
+    backlog = Max(backlog, PG_SOMINCONN);
+    backlog = Min(backlog, PG_SOMAXCONN);
+
+    for (int i = 0; i < listenSocketNum; i++) {
+        struct sockaddr_storage addr;
+        socklen_t addrlen = sizeof(addr);
+        struct epoll_event ev = {0};
+        pgsocket sock;
+
+        if (getsockname(listenSockets[i], (struct sockaddr*)&addr, &addrlen) < 0 || IS_AF_UNIX(addr.ss_family)) {
+            continue;
+        }
+
+        sock = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock == PGINVALID_SOCKET) {
+            ereport(LOG, (errcode_for_socket_access(), errmsg("thread pool listener could not create socket: %m")));
+            continue;
+        }
+
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (char*)&one, sizeof(one)) < 0 ||
+            setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (char*)&one, sizeof(one)) < 0 ||
+            (addr.ss_family == AF_INET6 &&
+                setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (char*)&one, sizeof(one)) < 0) ||
+            bind(sock, (struct sockaddr*)&addr, addrlen) < 0 || listen(sock, backlog) < 0) {
+            ereport(LOG,
+                (errcode_for_socket_access(), errmsg("thread pool listener could not listen on client port: %m")));
+            closesocket(sock);
+            continue;
+        }
+
+        /* level triggered, we accept one connection per event */
+        ev.events = EPOLLIN;
+        ev.data.ptr = (void*)&m_acceptSockets[m_acceptSocketNum];
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, sock, &ev) < 0) {
+            ereport(LOG, (errmsg("thread pool listener could not add client port to epoll: %m")));
+            closesocket(sock);
+            continue;
+        }
+        m_acceptSockets[m_acceptSocketNum++] = sock;
+    }
 }
 
 void ThreadPoolListener::AddEpoll(knl_session_context* session)
 {
     struct epoll_event ev = {0};
+    /* a session back from releasing its idle state was taken off the epoll */
+    bool isNew = (session->status == KNL_SESS_UNINIT || session->release_idle);
 
+    session->release_idle = false;
     m_idleSessionList->AddTail(&session->elem);
 
     /*
@@ -158,7 +233,7 @@ void ThreadPoolListener::AddEpoll(knl_session_context* session)
      */
     ev.events = EPOLLRDHUP | EPOLLIN | EPOLLET | EPOLLONESHOT;
     ev.data.ptr = (void*)session;
-    if (session->status != KNL_SESS_UNINIT) {
+    if (!isNew) {
         epoll_ctl(m_epollFd, EPOLL_CTL_MOD, session->proc_cxt.MyProcPort->sock, &ev);
     } else {
         epoll_ctl(m_epollFd, EPOLL_CTL_ADD, session->proc_cxt.MyProcPort->sock, &ev);
@@ -167,11 +242,11 @@ void ThreadPoolListener::AddEpoll(knl_session_context* session)
 
 bool ThreadPoolListener::TryFeedWorker(ThreadPoolWorker* worker)
 {
-    Dlelem* sc = m_readySessionList->RemoveHead();
-    if (sc != NULL) {
-        worker->SetSession((knl_session_context*)sc->dle_val);
-        pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
-        pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
+    /* the worker asking is not idle, so it may take a long session if enough others are */
+    knl_session_context* session =
+        GetReadySession(m_group->m_idleWorkerNum >= m_group->GetShortReservedWorkerNum());
+    if (session != NULL) {
+        worker->SetSession(session);
         return true;
     } else {
         m_freeWorkerList->AddTail(&worker->m_elem);
@@ -180,6 +255,41 @@ bool ThreadPoolListener::TryFeedWorker(ThreadPoolWorker* worker)
     }
 }
 
+/*
+ * Hand one of our idle workers to an overloaded group, it will take a session
+ * waiting there. Returns false if we have no idle worker.
+ */
+bool ThreadPoolListener::WakeUpWorkerToSteal(ThreadPoolGroup* victim)
+{
+    while (true) {
+        Dlelem* sc = m_freeWorkerList->RemoveHead();
+        if (sc == NULL) {
+            return false;
+        }
+        if (((ThreadPoolWorker*)DLE_VAL(sc))->WakeUpToSteal(victim)) {
+            return true;
+        }
+    }
+}
+
+/*
+ * Give a waiting session to a worker of another group, if we are still overloaded.
+ * The session stays ours: the worker returns it to our epoll when it is done.
+ */
+knl_session_context* ThreadPoolListener::StealSession()
+{
+    if (!m_group->IsOverloaded()) {
+        return NULL;
+    }
+
+    /* our reserved workers are not involved, so long sessions may go as well */
+    knl_session_context* session = GetReadySession(true);
+    if (session != NULL) {
+        pg_atomic_fetch_add_u32(&m_group->m_stealOutCount, 1);
+    }
+    return session;
+}
+
 void ThreadPoolListener::AddNewSession(knl_session_context* session)
 {
     AddEpoll(session);
@@ -233,19 +343,18 @@ void ThreadPoolListener::WaitTask()
             ReaperAllSession();
         }
 
-        /* as we specify timeout -1, so 0 will not be return, either > 0 or < 0 */
-        nevents = epoll_wait(m_epollFd, m_epollEvents, GLOBAL_MAX_SESSION_NUM, -1);
+        /* wake up now and then to release the idle state of our sessions, 0 means no event */
+        nevents = epoll_wait(m_epollFd, m_epollEvents, GLOBAL_MAX_SESSION_NUM, THREAD_IDLE_RELEASE_CHECK_MS);
         if (nevents > 0 && nevents <= GLOBAL_MAX_SESSION_NUM) {
             HandleConnEvent(nevents);
-            continue;
         } else if (nevents > GLOBAL_MAX_SESSION_NUM) {
             ereport(PANIC,
                 (errmsg("epoll receive %d events which exceed the limitation %d", nevents, GLOBAL_MAX_SESSION_NUM)));
-        } else if (nevents == -1 && errno == EINTR) {
-            continue;
-        } else {
+        } else if (nevents == -1 && errno != EINTR) {
             ereport(LOG, (errmsg("listener wait event encounter some error :%d", errno)));
         }
+
+        ReleaseIdleSessions();
     }
 }
 
@@ -256,6 +365,12 @@ void ThreadPoolListener::HandleConnEvent(int nevets)
 
     for (int i = 0; i < nevets; i++) {
         tmp_event = &m_epollEvents[i];
+        if (tmp_event->data.ptr >= (void*)m_acceptSockets &&
+            tmp_event->data.ptr < (void*)(m_acceptSockets + m_acceptSocketNum)) {
+            AcceptSession(*(pgsocket*)tmp_event->data.ptr);
+            continue;
+        }
+
         session = GetSessionBaseOnEvent(tmp_event);
         if (session == NULL) {
             continue;
@@ -265,6 +380,42 @@ void ThreadPoolListener::HandleConnEvent(int nevets)
     }
 }
 
+/*
+ * Accept a connection on one of our client sockets, as ConnCreate does in the postmaster,
+ * and add it to our group. The authentication is done by our workers as usual.
+ */
+void ThreadPoolListener::AcceptSession(pgsocket sock)
+{
+    knl_session_context* session = NULL;
+    Port port;
+    errno_t rc;
+
+    rc = memset_s(&port, sizeof(Port), 0, sizeof(Port));
+    securec_check(rc, "\0", "\0");
+    port.sock = PGINVALID_SOCKET;
+    port.gs_sock = GS_INVALID_GSOCK;
+
+    if (StreamConnection(sock, &port) != STATUS_OK) {
+        if (port.sock >= 0) {
+            StreamClose(port.sock);
+        }
+        return;
+    }
+
+    RAND_bytes((unsigned char*)port.md5Salt, sizeof(port.md5Salt));
+    port.is_logic_conn = false;
+    port.gs_sock.type = GSOCK_INVALID;
+
+    /* the session keeps a copy of the port */
+    session = g_threadPoolControler->GetSessionCtrl()->CreateSession(&port);
+    if (session == NULL) {
+        closesocket(port.sock);
+        return;
+    }
+
+    AddNewSession(session);
+}
+
 knl_session_context* ThreadPoolListener::GetSessionBaseOnEvent(struct epoll_event* ev)
 {
     knl_session_context* session = (knl_session_context*)ev->data.ptr;
@@ -283,22 +434,185 @@ knl_session_context* ThreadPoolListener::GetSessionBaseOnEvent(struct epoll_even
     return NULL;
 }
 
+/*
+ * Sessions are scheduled in two latency classes, so that a burst of slow statements
+ * cannot hold up point queries. A session in the long class queues behind the short
+ * ones and may not take the last reserved idle workers, unless it has waited for
+ * THREAD_LONG_MAX_WAIT_MS.
+ */
 void ThreadPoolListener::DispatchSession(knl_session_context* session)
 {
+    bool isLong = IsLongSession(session);
+
     m_idleSessionList->Remove(&session->elem);
+    if (!isLong || m_group->m_idleWorkerNum > m_group->GetShortReservedWorkerNum()) {
+        if (HandToFreeWorker(session)) {
+            return;
+        }
+    }
+    ReadySession(session, isLong);
+}
+
+bool ThreadPoolListener::HandToFreeWorker(knl_session_context* session)
+{
     while (true) {
         Dlelem* sc = m_freeWorkerList->RemoveHead();
-        if (sc != NULL) {
-            if (((ThreadPoolWorker*)DLE_VAL(sc))->WakeUpToWork(session)) {
-                pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
-                break;
-            }
-        } else {
-            m_readySessionList->AddTail(&session->elem);
-            pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+        if (sc == NULL) {
+            return false;
+        }
+        if (((ThreadPoolWorker*)DLE_VAL(sc))->WakeUpToWork(session)) {
+            pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
+            return true;
+        }
+    }
+}
+
+/* Queue a session until a worker is free. */
+void ThreadPoolListener::ReadySession(knl_session_context* session, bool isLong)
+{
+    if (isLong) {
+        session->ready_time = GetCurrentTimestamp();
+        m_longSessionList->AddTail(&session->elem);
+        pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_waitLongSessionCount, 1);
+    } else {
+        m_readySessionList->AddTail(&session->elem);
+    }
+    pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+
+    if (m_group->IsOverloaded()) {
+        g_threadPoolControler->LendWaitingSession(m_group);
+    }
+}
+
+/*
+ * Take the next session to serve: a long one that waited too long, else a short one,
+ * else a long one if takeLong.
+ */
+knl_session_context* ThreadPoolListener::GetReadySession(bool takeLong)
+{
+    Dlelem* sc = NULL;
+    bool isLong = false;
+
+    if (m_group->m_waitLongSessionCount > 0) {
+        TimestampTz deadline = TimestampTzPlusMilliseconds(GetCurrentTimestamp(), -THREAD_LONG_MAX_WAIT_MS);
+        sc = m_longSessionList->RemoveHeadIf(SessionWaitedLong, &deadline);
+        isLong = (sc != NULL);
+    }
+    if (sc == NULL) {
+        sc = m_readySessionList->RemoveHead();
+    }
+    if (sc == NULL && takeLong) {
+        sc = m_longSessionList->RemoveHead();
+        isLong = (sc != NULL);
+    }
+    if (sc == NULL) {
+        return NULL;
+    }
+
+    if (isLong) {
+        pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitLongSessionCount, 1);
+    }
+    pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+    pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
+    return (knl_session_context*)DLE_VAL(sc);
+}
+
+/*
+ * Called by the scheduler: idle workers kept for short sessions serve the long ones
+ * that have waited too long, so those are not starved.
+ */
+void ThreadPoolListener::ServeAgedSessions()
+{
+    while (m_group->m_waitLongSessionCount > 0 && m_group->m_idleWorkerNum > 0) {
+        TimestampTz deadline = TimestampTzPlusMilliseconds(GetCurrentTimestamp(), -THREAD_LONG_MAX_WAIT_MS);
+        Dlelem* sc = m_longSessionList->RemoveHeadIf(SessionWaitedLong, &deadline);
+        if (sc == NULL) {
+            return;
+        }
+
+        if (!HandToFreeWorker((knl_session_context*)DLE_VAL(sc))) {
+            /* the idle workers were taken meanwhile, keep its place */
+            m_longSessionList->AddHead(sc);
+            return;
+        }
+        pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitLongSessionCount, 1);
+        pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+    }
+}
+
+/*
+ * Latency class of a session: set by session_latency_class, or else long if the last
+ * statement it ran takes THREAD_LONG_LATENCY_US or more on average, as recorded by
+ * unique SQL.
+ */
+static bool IsLongSession(knl_session_context* session)
+{
+    /* new and closing sessions are quickly done with */
+    if (session->status != KNL_SESS_DETACH) {
+        return false;
+    }
+
+    switch (session->attr.attr_resource.session_latency_class) {
+        case LATENCY_CLASS_SHORT:
+            return false;
+        case LATENCY_CLASS_LONG:
+            return true;
+        default:
+            return session->unique_sql_cxt.last_avg_elapse_time >= THREAD_LONG_LATENCY_US;
+    }
+}
+
+static bool SessionWaitedLong(Dlelem* elem, void* arg)
+{
+    knl_session_context* session = (knl_session_context*)DLE_VAL(elem);
+
+    return session->ready_time <= *(TimestampTz*)arg;
+}
+
+static bool SessionIdleReleasable(Dlelem* elem, void* arg)
+{
+    return knl_session_idle_release_delay((knl_session_context*)DLE_VAL(elem)) == 0;
+}
+
+/*
+ * Hand the sessions that have been idle long enough to our idle workers, which
+ * attach them as usual, release their idle state and return them to our epoll.
+ * We never touch the state of a session ourselves. A session is taken off the
+ * epoll meanwhile, so that input from its client cannot dispatch it a second
+ * time, and AddEpoll adds it back. Busy workers are left alone: the sessions
+ * not handed over wait for the next round.
+ */
+void ThreadPoolListener::ReleaseIdleSessions()
+{
+    TimestampTz now = GetCurrentTimestamp();
+    Dllist sessions;
+    Dlelem* elem = NULL;
+
+    if (!TimestampDifferenceExceeds(m_lastIdleRelease, now, THREAD_IDLE_RELEASE_CHECK_MS)) {
+        return;
+    }
+    m_lastIdleRelease = now;
+
+    if (m_group->m_idleWorkerNum == 0) {
+        return;
+    }
+
+    DLInitList(&sessions);
+    m_idleSessionList->RemoveAllIf(SessionIdleReleasable, NULL, &sessions);
+    while ((elem = DLRemHead(&sessions)) != NULL) {
+        knl_session_context* session = (knl_session_context*)DLE_VAL(elem);
+
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, session->proc_cxt.MyProcPort->sock, NULL);
+        session->release_idle = true;
+        if (!HandToFreeWorker(session)) {
+            /* AddEpoll puts it back on the epoll, input that came meanwhile is reported */
+            AddEpoll(session);
             break;
         }
     }
+    while ((elem = DLRemHead(&sessions)) != NULL) {
+        m_idleSessionList->AddTail(elem);
+    }
 }
 
 void ThreadPoolListener::DelSessionFromEpoll(knl_session_context* session)
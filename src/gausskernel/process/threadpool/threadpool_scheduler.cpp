@@ -79,6 +79,8 @@ void ThreadPoolScheduler::DynamicAdjustThreadPool()
         group = m_groups[i];
 
         if (pmState == PM_RUN) {
+            group->GetListener()->ServeAgedSessions();
+
             /* When no idle worker and no task has been processed, the system may hang. */
             if (group->IsGroupHang()) {
                 m_hangTestCount[i]++;
@@ -81,9 +81,12 @@ knl_session_context* ThreadPoolSessControl::CreateSession(Port* port)
 {
     knl_session_context* sc = NULL;
 
-    /* We use u_sess->session_id to mark memory context. */
-    m_sessionId++;
-    sc = create_session_context(m_context, m_sessionId);
+    /*
+     * We use u_sess->session_id to mark memory context. Listeners create sessions
+     * as well as the postmaster with thread_pool_reuseport.
+     */
+    uint64 sessionId = pg_atomic_add_fetch_u64(&m_sessionId, 1);
+    sc = create_session_context(m_context, sessionId);
     if (sc == NULL) {
         ereport(WARNING, (errmsg("can't allocate memory for session")));
         return NULL;
@@ -77,6 +77,8 @@ ThreadPoolWorker::ThreadPoolWorker(uint idx, ThreadPoolGroup* group, pthread_mut
 {
     m_idx = idx;
     m_group = group;
+    m_sessionGroup = group;
+    m_stealFrom = NULL;
     m_tid = InvalidTid;
     m_threadStatus = THREAD_UNINIT;
     m_currentSession = NULL;
@@ -90,6 +92,8 @@ ThreadPoolWorker::~ThreadPoolWorker()
 {
     m_currentSession = NULL;
     m_group = NULL;
+    m_sessionGroup = NULL;
+    m_stealFrom = NULL;
     m_mutex = NULL;
     m_cond = NULL;
 }
@@ -184,6 +188,11 @@ void ThreadPoolWorker::WaitMission()
                 Assert(t_thrd.libpq_cxt.PqRecvPointer == t_thrd.libpq_cxt.PqRecvLength);
                 continue;
             }
+            /* handed to us only to release its idle state, CleanThread returns it to the listener */
+            if (m_currentSession->release_idle) {
+                knl_session_release_idle(m_currentSession);
+                continue;
+            }
             Assert(m_currentSession != NULL);
             Assert(u_sess != NULL);
             break;
@@ -209,6 +218,21 @@ bool ThreadPoolWorker::WakeUpToWork(knl_session_context* session)
     return succ;
 }
 
+/* Wake up an idle worker to take a session waiting in another group. */
+bool ThreadPoolWorker::WakeUpToSteal(ThreadPoolGroup* victim)
+{
+    bool succ = true;
+    pthread_mutex_lock(m_mutex);
+    if (likely(m_threadStatus != THREAD_EXIT)) {
+        m_stealFrom = victim;
+        pthread_cond_signal(m_cond);
+    } else {
+        succ = false;
+    }
+    pthread_mutex_unlock(m_mutex);
+    return succ;
+}
+
 void ThreadPoolWorker::WakeUpToUpdate(ThreadStatus status)
 {
     pthread_mutex_lock(m_mutex);
@@ -326,6 +350,7 @@ void ThreadPoolWorker::WaitNextSession()
     ThreadPoolListener* lsn = m_group->GetListener();
     Assert(lsn != NULL);
 
+    m_sessionGroup = m_group;
     while (true) {
         /* Wait if the thread was turned into pending mode. */
         if (unlikely(m_threadStatus == THREAD_PENDING)) {
@@ -334,6 +359,22 @@ void ThreadPoolWorker::WaitNextSession()
             ShutDownIfNecessary();
         } else if (m_currentSession != NULL) {
             break;
+        } else if (m_stealFrom != NULL) {
+            /* We are off the free worker list, nobody else touches m_stealFrom now. */
+            ThreadPoolGroup* victim = m_stealFrom;
+            m_stealFrom = NULL;
+            if (StealSessionFrom(victim)) {
+                break;
+            }
+        } else if (m_group->GetWaitServeSessionCount() == 0) {
+            /*
+             * Nothing waits here. A backlog elsewhere that built up while no worker was
+             * idle was never lent out, so look for it before going idle ourselves.
+             */
+            ThreadPoolGroup* victim = g_threadPoolControler->FindOverloadedGroup(m_group);
+            if (victim != NULL && StealSessionFrom(victim)) {
+                break;
+            }
         }
     
         /* Wait for listener dispatch. */
@@ -343,7 +384,7 @@ void ThreadPoolWorker::WaitNextSession()
             WaitState oldStatus = pgstat_report_waitstatus(STATE_WAIT_COMM);
 
             pthread_mutex_lock(m_mutex);
-            while (!m_currentSession) {
+            while (m_currentSession == NULL && m_stealFrom == NULL) {
                 if (unlikely(m_threadStatus == THREAD_PENDING || m_threadStatus == THREAD_EXIT)) {
                     break;
                 }
@@ -357,6 +398,18 @@ void ThreadPoolWorker::WaitNextSession()
     }
 }
 
+/* Take a session waiting in an overloaded group, it is returned to that group when done. */
+bool ThreadPoolWorker::StealSessionFrom(ThreadPoolGroup* victim)
+{
+    m_currentSession = victim->GetListener()->StealSession();
+    if (m_currentSession == NULL) {
+        return false;
+    }
+    m_sessionGroup = victim;
+    pg_atomic_fetch_add_u32(&m_group->m_stealInCount, 1);
+    return true;
+}
+
 void ThreadPoolWorker::Pending()
 {
     pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_workerNum, 1);
@@ -449,7 +502,7 @@ void ThreadPoolWorker::DetachSessionFromThread()
     m_currentSession->attachPid = (ThreadId)-1;
 
     /* should restore the data before return to listener. */
-    m_group->GetListener()->AddEpoll(m_currentSession);
+    m_sessionGroup->GetListener()->AddEpoll(m_currentSession);
     m_currentSession = NULL;
     u_sess = NULL;
 }
@@ -561,7 +614,7 @@ void ThreadPoolWorker::CleanUpSession(bool threadexit)
         }
 
         /* Close Session. */
-        m_group->GetListener()->DelSessionFromEpoll(m_currentSession);
+        m_sessionGroup->GetListener()->DelSessionFromEpoll(m_currentSession);
 
         /*
          * Record this state in case we reenter this function because
@@ -998,6 +998,16 @@ bool CodeGenThreadObjectReady()
  */
 void CodeGenThreadRuntimeSetup()
 {
+    /*
+     * The object is created by the first query that may use it rather than before
+     * each command, so a thread waiting for its client holds no LLVM context.
+     */
+    if (t_thrd.codegen_cxt.thr_codegen_obj == NULL && !t_thrd.codegen_cxt.g_runningInFmgr) {
+        MemoryContext oldMemory = MemoryContextSwitchTo(t_thrd.top_mem_cxt);
+        CodeGenThreadInitialize();
+        (void)MemoryContextSwitchTo(oldMemory);
+    }
+
     if (CodeGenThreadObjectReady()) {
         /* Do some initialization for the codegen Object */
         ((dorado::GsCodeGen*)t_thrd.codegen_cxt.thr_codegen_obj)->initialize();
@@ -110,6 +110,7 @@ static void ExecutePlan(EState *estate, PlanState *planstate, CmdType operation,
     ScanDirection direction, DestReceiver *dest, JitExec::JitContext* mot_jit_context);
 static void ExecuteVectorizedPlan(EState *estate, PlanState *planstate, CmdType operation, bool sendTuples,
     long numberTuples, ScanDirection direction, DestReceiver *dest);
+static bool ExecSendColumnarResult(QueryDesc *queryDesc, bool sendTuples, long count);
 static bool ExecCheckRTEPerms(RangeTblEntry *rte);
 static bool ExecCheckRTEPermsModified(Oid relOid, Oid userid, Bitmapset *modifiedCols, AclMode requiredPerms);
 void ExecCheckXactReadOnly(PlannedStmt *plannedstmt);
@@ -570,6 +571,10 @@ void standard_ExecutorRun(QueryDesc *queryDesc, ScanDirection direction, long co
     if (!ScanDirectionIsNoMovement(direction)) {
         if (queryDesc->planstate->vectorized) {
             ExecuteVectorizedPlan(estate, queryDesc->planstate, operation, send_tuples, count, direction, dest);
+        } else if (ExecSendColumnarResult(queryDesc, send_tuples, count)) {
+            /* skip the top VecToRow, the batches go to the client as they are */
+            ExecuteVectorizedPlan(
+                estate, outerPlanState(queryDesc->planstate), operation, send_tuples, count, direction, dest);
         } else {
             ExecutePlan(estate, queryDesc->planstate, operation, send_tuples,
                 count, direction, dest, queryDesc->mot_jit_context);
@@ -2085,6 +2090,25 @@ static void ExecutePlan(EState *estate, PlanState *planstate, CmdType operation,
     }
 }
 
+/*
+ * Can the batches of a vectorized plan be sent to the client without turning them
+ * into rows? Only if the client asked for it with the columnar_result startup option
+ * and all of the result goes to it.
+ */
+static bool ExecSendColumnarResult(QueryDesc *queryDesc, bool sendTuples, long count)
+{
+    CommandDest mydest = queryDesc->dest->mydest;
+    Port *port = u_sess->proc_cxt.MyProcPort;
+
+    if (port == NULL || !port->columnar_result || !sendTuples || count != 0 ||
+        queryDesc->operation != CMD_SELECT || !IsA(queryDesc->planstate, VecToRowState)) {
+        return false;
+    }
+
+    return (mydest == DestRemote || mydest == DestRemoteExecute) && PG_PROTOCOL_MAJOR(FrontendProtocol) >= 3 &&
+           !IsConnFromCoord() && !StreamTopConsumerAmI();
+}
+
 /* ----------------------------------------------------------------
  * 		ExecutePlan
  *
@@ -268,12 +268,17 @@ void OpFusion::executeEnd()
         m_isCompleted = false;
     }
     m_isFirst = false;
+    reportExecution();
+}
+
+/* audit and count one execution of the statement */
+void OpFusion::reportExecution()
+{
     auditRecord();
     if (u_sess->attr.attr_common.pgstat_track_activities && u_sess->attr.attr_common.pgstat_track_sql_count) {
         report_qps_type(m_planstmt->commandType);
         report_qps_type(CMD_DML);
     }
-
 }
 
 bool OpFusion::process(int op, StringInfo msg, char* completionTag, bool isTopLevel)
@@ -318,6 +323,36 @@ bool OpFusion::process(int op, StringInfo msg, char* completionTag, bool isTopLe
     }
 }
 
+/*
+ * Run all the parameter sets of a batch bind-execute message through the current
+ * bypass object at once. Returns the number of rows processed.
+ *
+ * Audit, query counts and unique SQL statistics still see one execution per set,
+ * as if the sets had been executed one by one.
+ */
+unsigned long OpFusion::processBatch(ParamListInfo* params_set, int batch_count, bool isTopLevel)
+{
+    OpFusion* opfusion = u_sess->exec_cxt.CurrentOpFusionObj;
+    unsigned long nprocessed = 0;
+
+    Assert(opfusion != NULL && opfusion->isBatchable());
+
+    opfusion->executeInit();
+    gstrace_entry(GS_TRC_ID_BypassExecutor);
+    nprocessed = opfusion->executeBatch(params_set, batch_count);
+    gstrace_exit(GS_TRC_ID_BypassExecutor);
+    opfusion->executeEnd();
+    UpdateSingleNodeByPassUniqueSQLStat(isTopLevel);
+
+    /* executeEnd reported the first set */
+    for (int i = 1; i < batch_count; i++) {
+        opfusion->reportExecution();
+        UpdateSingleNodeByPassUniqueSQLStat(isTopLevel);
+    }
+
+    return nprocessed;
+}
+
 void OpFusion::CopyFormats(int16* formats, int numRFormats)
 {
     MemoryContext old_context = MemoryContextSwitchTo(m_tmpContext);
@@ -1157,6 +1192,106 @@ bool InsertFusion::execute(long max_rows, char* completionTag)
     return success;
 }
 
+/*
+ * Insert one row for each parameter set. The relation and its indexes are opened
+ * once, and the rows are written with heap_multi_insert so that rows landing on the
+ * same page share one buffer lock and one WAL record.
+ */
+unsigned long InsertFusion::executeBatch(ParamListInfo* params_set, int batch_count)
+{
+    MemoryContext old_context = MemoryContextSwitchTo(m_tmpContext);
+
+    /*******************
+     * step 1: prepare *
+     *******************/
+    Relation rel = heap_open(m_reloid, RowExclusiveLock);
+    Relation bucket_rel = NULL;
+    int2 bucketid = InvalidBktId;
+
+    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
+    InitResultRelInfo(result_rel_info, rel, 1, 0);
+    m_estate->es_result_relation_info = result_rel_info;
+
+    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
+        ExecOpenIndices(result_rel_info);
+    }
+
+    CommandId mycid = GetCurrentCommandId(true);
+    HeapTuple* tuples = (HeapTuple*)palloc(batch_count * sizeof(HeapTuple));
+
+    /*************************
+     * step 2: form the rows *
+     *************************/
+    for (int i = 0; i < batch_count; i++) {
+        CHECK_FOR_INTERRUPTS();
+
+        m_outParams = params_set[i];
+        refreshParameterIfNecessary();
+
+        tuples[i] = heap_form_tuple(m_tupDesc, m_values, m_isnull);
+        Assert(tuples[i] != NULL);
+
+        if (rel->rd_att->constr) {
+            (void)ExecStoreTuple(tuples[i], m_reslot, InvalidBuffer, false);
+            ExecConstraints(result_rel_info, m_reslot, m_estate);
+        }
+    }
+
+    /************************
+     * step 3: begin insert *
+     ************************/
+    if (!m_is_bucket_rel) {
+        /* keep the WAL of the rows, page replication is only for bulk loads */
+        HeapMultiInsertExtraArgs args = {NULL, 0, true};
+        (void)heap_multi_insert(rel, rel, tuples, batch_count, mycid, 0, NULL, &args);
+    }
+
+    for (int i = 0; i < batch_count; i++) {
+        if (m_is_bucket_rel) {
+            /* the rows may belong to different buckets, insert them one by one */
+            bucketid = computeTupleBucketId(result_rel_info->ri_RelationDesc, tuples[i]);
+            if (bucketid == InvalidBktId) {
+                ereport(ERROR,
+                        (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                         errmsg("Invaild Oid when open hash bucket relation.")));
+            }
+            bucket_rel = bucketGetRelation(rel, NULL, bucketid);
+            (void)heap_insert(bucket_rel, tuples[i], mycid, 0, NULL);
+        }
+
+        /* insert index entries for tuple */
+        if (result_rel_info->ri_NumIndices > 0) {
+            (void)ExecStoreTuple(tuples[i], m_reslot, InvalidBuffer, false);
+            List* recheck_indexes =
+                ExecInsertIndexTuples(m_reslot, &(tuples[i]->t_self), m_estate, NULL, NULL, bucketid);
+            list_free_ext(recheck_indexes);
+        }
+
+        if (bucket_rel != NULL) {
+            bucketCloseRelation(bucket_rel);
+            bucket_rel = NULL;
+        }
+    }
+
+    (void)ExecClearTuple(m_reslot);
+    m_isCompleted = true;
+
+    /****************
+     * step 4: done *
+     ****************/
+    ExecCloseIndices(result_rel_info);
+
+    heap_close(rel, RowExclusiveLock);
+
+    if (m_estate->esfRelations) {
+        FakeRelationCacheDestroy(m_estate->esfRelations);
+    }
+
+    MemoryContextSwitchTo(old_context);
+
+    return (unsigned long)batch_count;
+}
+
 MotJitModifyFusion::MotJitModifyFusion(MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params)
     : OpFusion(context, psrc, plantree_list, MOT_JIT_MODIFY_FUSION)
 {
@@ -1406,38 +1541,18 @@ void UpdateFusion::refreshTargetParameterIfNecessary()
     }
 }
 
-bool UpdateFusion::execute(long max_rows, char* completionTag)
+/*
+ * Update the tuples returned by the scan opened by the caller, and return how many were updated.
+ */
+unsigned long UpdateFusion::updateScanTuples(ResultRelInfo* result_rel_info)
 {
-    bool success = false;
-
-    /*******************
-     * step 1: prepare *
-     *******************/
-    m_scan->refreshParameter(m_outParams == NULL ? m_params : m_outParams);
-
-    m_scan->Init(max_rows);
-
     Relation rel = m_scan->m_rel;
     Relation bucket_rel = NULL;
     int2 bucketid = InvalidBktId;
-
-    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
-    InitResultRelInfo(result_rel_info, rel, 1, 0);
-    m_estate->es_result_relation_info = result_rel_info;
-    m_estate->es_output_cid = GetCurrentCommandId(true);
-
-    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
-        ExecOpenIndices(result_rel_info);
-    }
-
-    /*********************************
-     * step 2: begin scan and update *
-     *********************************/
     HeapTuple oldtup = NULL;
     HeapTuple tup = NULL;
     unsigned long nprocessed = 0;
     List* recheck_indexes = NIL;
-    m_tupDesc = RelationGetDescr(rel);
 
 
     while ((oldtup = m_scan->getTuple()) != NULL) {
@@ -1535,6 +1650,41 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
 
     heap_freetuple_ext(tup);
 
+    if (bucket_rel != NULL) {
+        bucketCloseRelation(bucket_rel);
+    }
+
+    return nprocessed;
+}
+
+bool UpdateFusion::execute(long max_rows, char* completionTag)
+{
+    bool success = false;
+
+    /*******************
+     * step 1: prepare *
+     *******************/
+    m_scan->refreshParameter(m_outParams == NULL ? m_params : m_outParams);
+
+    m_scan->Init(max_rows);
+
+    Relation rel = m_scan->m_rel;
+
+    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
+    InitResultRelInfo(result_rel_info, rel, 1, 0);
+    m_estate->es_result_relation_info = result_rel_info;
+    m_estate->es_output_cid = GetCurrentCommandId(true);
+
+    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
+        ExecOpenIndices(result_rel_info);
+    }
+
+    /*********************************
+     * step 2: begin scan and update *
+     *********************************/
+    m_tupDesc = RelationGetDescr(rel);
+    unsigned long nprocessed = updateScanTuples(result_rel_info);
+
     (void)ExecClearTuple(m_reslot);
     success = true;
 
@@ -1547,9 +1697,6 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
     if (m_estate->esfRelations) {
         FakeRelationCacheDestroy(m_estate->esfRelations);
     }
-    if (bucket_rel != NULL) {
-        bucketCloseRelation(bucket_rel);
-    }
     errno_t errorno =
         snprintf_s(completionTag, COMPLETION_TAG_BUFSIZE, COMPLETION_TAG_BUFSIZE - 1, "UPDATE %lu", nprocessed);
     securec_check_ss(errorno, "\0", "\0");
@@ -1557,6 +1704,68 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
     return success;
 }
 
+/*
+ * Run the UPDATE once for each parameter set. The relation and its indexes stay open
+ * over the whole batch, the index scan restarts with the next set's keys.
+ */
+unsigned long UpdateFusion::executeBatch(ParamListInfo* params_set, int batch_count)
+{
+    unsigned long nprocessed = 0;
+
+    /*******************
+     * step 1: prepare *
+     *******************/
+    m_scan->refreshParameter(params_set[0]);
+
+    m_scan->Init(FETCH_ALL);
+
+    Relation rel = m_scan->m_rel;
+
+    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
+    InitResultRelInfo(result_rel_info, rel, 1, 0);
+    m_estate->es_result_relation_info = result_rel_info;
+
+    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
+        ExecOpenIndices(result_rel_info);
+    }
+
+    /****************************************
+     * step 2: scan and update for each set *
+     ****************************************/
+    m_tupDesc = RelationGetDescr(rel);
+
+    for (int i = 0; i < batch_count; i++) {
+        if (i > 0) {
+            /*
+             * Like a set executed on its own, the set sees the rows changed by the
+             * previous ones and takes a new snapshot, which the rescan picks up.
+             */
+            CommandCounterIncrement();
+            PopActiveSnapshot();
+            PushActiveSnapshot(GetTransactionSnapshot());
+            m_scan->Rescan(params_set[i]);
+        }
+
+        m_outParams = params_set[i];
+        m_estate->es_output_cid = GetCurrentCommandId(true);
+        nprocessed += updateScanTuples(result_rel_info);
+    }
+
+    (void)ExecClearTuple(m_reslot);
+
+    /****************
+     * step 3: done *
+     ****************/
+    ExecCloseIndices(result_rel_info);
+    m_isCompleted = true;
+    m_scan->End(true);
+    if (m_estate->esfRelations) {
+        FakeRelationCacheDestroy(m_estate->esfRelations);
+    }
+
+    return nprocessed;
+}
+
 DeleteFusion::DeleteFusion(MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params)
     : OpFusion(context, psrc, plantree_list, DELETE_FUSION)
 {
@@ -1592,36 +1801,16 @@ DeleteFusion::DeleteFusion(MemoryContext context, CachedPlanSource* psrc, List*
     MemoryContextSwitchTo(old_context);
 }
 
-bool DeleteFusion::execute(long max_rows, char* completionTag)
+/*
+ * Delete the tuples returned by the scan opened by the caller, and return how many were deleted.
+ */
+unsigned long DeleteFusion::deleteScanTuples(ResultRelInfo* result_rel_info)
 {
-    bool success = false;
-
-    /*******************
-     * step 1: prepare *
-     *******************/
-    m_scan->refreshParameter(m_outParams == NULL ? m_params : m_outParams);
-
-    m_scan->Init(max_rows);
-
     Relation rel = m_scan->m_rel;
     Relation bucket_rel = NULL;
     int2 bucketid = InvalidBktId;
-
-    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
-    InitResultRelInfo(result_rel_info, rel, 1, 0);
-    m_estate->es_result_relation_info = result_rel_info;
-    m_estate->es_output_cid = GetCurrentCommandId(true);
-
-    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
-        ExecOpenIndices(result_rel_info);
-    }
-
-    /********************************
-     * step 2: begin scan and delete*
-     ********************************/
     HeapTuple oldtup = NULL;
     unsigned long nprocessed = 0;
-    m_tupDesc = RelationGetDescr(rel);
 
     while ((oldtup = m_scan->getTuple()) != NULL) {
         HTSU_Result result;
@@ -1696,6 +1885,41 @@ bool DeleteFusion::execute(long max_rows, char* completionTag)
         }
     }
 
+    if (bucket_rel != NULL) {
+        bucketCloseRelation(bucket_rel);
+    }
+
+    return nprocessed;
+}
+
+bool DeleteFusion::execute(long max_rows, char* completionTag)
+{
+    bool success = false;
+
+    /*******************
+     * step 1: prepare *
+     *******************/
+    m_scan->refreshParameter(m_outParams == NULL ? m_params : m_outParams);
+
+    m_scan->Init(max_rows);
+
+    Relation rel = m_scan->m_rel;
+
+    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
+    InitResultRelInfo(result_rel_info, rel, 1, 0);
+    m_estate->es_result_relation_info = result_rel_info;
+    m_estate->es_output_cid = GetCurrentCommandId(true);
+
+    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
+        ExecOpenIndices(result_rel_info);
+    }
+
+    /********************************
+     * step 2: begin scan and delete*
+     ********************************/
+    m_tupDesc = RelationGetDescr(rel);
+    unsigned long nprocessed = deleteScanTuples(result_rel_info);
+
     (void)ExecClearTuple(m_reslot);
     success = true;
 
@@ -1707,10 +1931,6 @@ bool DeleteFusion::execute(long max_rows, char* completionTag)
     m_isCompleted = true;
     m_scan->End(true);
 
-    if (bucket_rel != NULL) {
-        bucketCloseRelation(bucket_rel);
-    }
-
     errno_t errorno =
         snprintf_s(completionTag, COMPLETION_TAG_BUFSIZE, COMPLETION_TAG_BUFSIZE - 1, "DELETE %lu", nprocessed);
     securec_check_ss(errorno, "\0", "\0");
@@ -1718,6 +1938,68 @@ bool DeleteFusion::execute(long max_rows, char* completionTag)
     return success;
 }
 
+/*
+ * Run the DELETE once for each parameter set. The relation and its indexes stay open
+ * over the whole batch, the index scan restarts with the next set's keys.
+ */
+unsigned long DeleteFusion::executeBatch(ParamListInfo* params_set, int batch_count)
+{
+    unsigned long nprocessed = 0;
+
+    /*******************
+     * step 1: prepare *
+     *******************/
+    m_scan->refreshParameter(params_set[0]);
+
+    m_scan->Init(FETCH_ALL);
+
+    Relation rel = m_scan->m_rel;
+
+    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
+    InitResultRelInfo(result_rel_info, rel, 1, 0);
+    m_estate->es_result_relation_info = result_rel_info;
+
+    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
+        ExecOpenIndices(result_rel_info);
+    }
+
+    /****************************************
+     * step 2: scan and delete for each set *
+     ****************************************/
+    m_tupDesc = RelationGetDescr(rel);
+
+    for (int i = 0; i < batch_count; i++) {
+        if (i > 0) {
+            /*
+             * Like a set executed on its own, the set sees the rows changed by the
+             * previous ones and takes a new snapshot, which the rescan picks up.
+             */
+            CommandCounterIncrement();
+            PopActiveSnapshot();
+            PushActiveSnapshot(GetTransactionSnapshot());
+            m_scan->Rescan(params_set[i]);
+        }
+
+        m_outParams = params_set[i];
+        m_estate->es_output_cid = GetCurrentCommandId(true);
+        nprocessed += deleteScanTuples(result_rel_info);
+    }
+
+    (void)ExecClearTuple(m_reslot);
+
+    /****************
+     * step 3: done *
+     ****************/
+    ExecCloseIndices(result_rel_info);
+    m_isCompleted = true;
+    m_scan->End(true);
+    if (m_estate->esfRelations) {
+        FakeRelationCacheDestroy(m_estate->esfRelations);
+    }
+
+    return nprocessed;
+}
+
 SelectForUpdateFusion::SelectForUpdateFusion(
     MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params)
     : OpFusion(context, psrc, plantree_list, SELECT_FOR_UPDATE_FUSION)
@@ -97,10 +97,28 @@ void IndexFusion::refreshParameterIfNecessary()
 
         if (m_params->params[m_paramLoc[i].paramId - 1].isnull) {
             m_scanKeys[m_paramLoc[i].scanKeyIndx].sk_flags |= SK_ISNULL;
+        } else {
+            m_scanKeys[m_paramLoc[i].scanKeyIndx].sk_flags &= ~SK_ISNULL;
         }
     }
 }
 
+/*
+ * Restart the scan opened by Init with the keys taken from another parameter list,
+ * keeping the relation and index open. The new scan sees the active snapshot, which
+ * the caller may have replaced since Init.
+ */
+void IndexFusion::Rescan(ParamListInfo params)
+{
+    m_params = params;
+    if (m_params != NULL) {
+        refreshParameterIfNecessary();
+    }
+
+    abs_idx_endscan(m_scandesc);
+    BeginScan();
+}
+
 void IndexFusion::BuildNullTestScanKey(Expr* clause, Expr* leftop, ScanKey this_scan_key)
 {
     /* indexkey IS NULL or indexkey IS NOT NULL */
@@ -400,13 +418,18 @@ void IndexScanFusion::Init(long max_rows)
     }
 
     m_rel = heap_open(m_reloid, AccessShareLock);
+    BeginScan();
+    m_epq_indexqual = m_node->indexqualorig;
+    m_reslot = MakeSingleTupleTableSlot(m_tupDesc);
+}
+
+void IndexScanFusion::BeginScan()
+{
     ScanState* scanstate = makeNode(ScanState); // need release
     scanstate->ps.plan =  (Plan *)m_node;
     m_scandesc = (AbsIdxScanDesc)abs_idx_beginscan(m_rel, m_index, GetActiveSnapshot(), m_keyNum, 0, scanstate); // add scanstate pointer ?
     
     abs_idx_rescan_local(m_scandesc, m_keyNum > 0 ? m_scanKeys : NULL, m_keyNum, NULL, 0);
-    m_epq_indexqual = m_node->indexqualorig;
-    m_reslot = MakeSingleTupleTableSlot(m_tupDesc);
 }
 
 HeapTuple IndexScanFusion::getTuple()
@@ -560,6 +583,13 @@ void IndexOnlyScanFusion::Init(long max_rows)
     }
 
     m_rel = heap_open(m_reloid, AccessShareLock);
+    BeginScan();
+
+    m_epq_indexqual = m_node->indexqual;
+}
+
+void IndexOnlyScanFusion::BeginScan()
+{
     ScanState* scanstate = makeNode(ScanState); // need release
     scanstate->ps.plan =  (Plan *)m_node;
 
@@ -575,8 +605,6 @@ void IndexOnlyScanFusion::Init(long max_rows)
     }
 
     abs_idx_rescan_local(m_scandesc, m_keyNum > 0 ? m_scanKeys : NULL, m_keyNum, NULL, 0);
-
-    m_epq_indexqual = m_node->indexqual;
 }
 
 HeapTuple IndexOnlyScanFusion::getTuple()
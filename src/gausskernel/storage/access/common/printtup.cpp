@@ -19,6 +19,7 @@
 
 #include "access/printtup.h"
 #include "access/transam.h"
+#include "catalog/pg_type.h"
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
 #include "tcop/pquery.h"
@@ -33,6 +34,7 @@
 #include "distributelayer/streamProducer.h"
 #include "executor/execStream.h"
 #include "utils/tqual.h"
+#include "vecexecutor/vectorbatch.h"
 
 extern bool StreamTopConsumerAmI();
 extern bool StreamThreadAmI();
@@ -41,6 +43,7 @@ static void printtup_20(TupleTableSlot* slot, DestReceiver* self);
 static void printtup_internal_20(TupleTableSlot* slot, DestReceiver* self);
 static void printtup_shutdown(DestReceiver* self);
 static void printtup_destroy(DestReceiver* self);
+static void printColumnarBatch(VectorBatch* batch, DestReceiver* self);
 
 static void SendRowDescriptionCols_2(StringInfo buf, TupleDesc typeinfo, List* targetlist, int16* formats);
 static void SendRowDescriptionCols_3(StringInfo buf, TupleDesc typeinfo, List* targetlist, int16* formats);
@@ -392,7 +395,15 @@ DestReceiver* printtup_create_DR(CommandDest dest)
     else
         self->pub.receiveSlot = printtup; /* might get changed later */
 
-    self->pub.sendBatch = printBatch;
+    /*
+     * datanodes send whole batches to the coordinator, clients which asked for
+     * columnar results get them column by column
+     */
+    if (!IsConnFromCoord() && u_sess->proc_cxt.MyProcPort != NULL &&
+        u_sess->proc_cxt.MyProcPort->columnar_result)
+        self->pub.sendBatch = printColumnarBatch;
+    else
+        self->pub.sendBatch = printBatch;
     self->pub.rStartup = printtup_startup;
     self->pub.rShutdown = printtup_shutdown;
     self->pub.rDestroy = printtup_destroy;
@@ -409,6 +420,7 @@ DestReceiver* printtup_create_DR(CommandDest dest)
     self->nattrs = 0;
     self->myinfo = NULL;
     self->formats = NULL;
+    self->batchinfo = NULL;
 
     return (DestReceiver*)self;
 }
@@ -445,6 +457,9 @@ static void printtup_startup(DestReceiver* self, int operation, TupleDesc typein
     /* create buffer to be used for all messages */
     initStringInfo(&my_state->buf);
 
+    /* batches don't carry a descriptor, remember it for printColumnarBatch */
+    my_state->batchinfo = typeinfo;
+
     if (PG_PROTOCOL_MAJOR(FrontendProtocol) < 3) {
         /*
          * Send portal name to frontend (obsolete cruft, gone in proto 3.0)
@@ -915,6 +930,186 @@ void printBatch(VectorBatch* batch, DestReceiver* self)
     pq_endmessage_reuse(buf);
 }
 
+/*
+ * Can a column be sent as fixed-length values in a columnar batch? The raw datum of
+ * these types in network byte order is the same as their binary output format, so
+ * this only applies to columns the client asked for in binary.
+ */
+static bool ColumnarBatchFixedType(Form_pg_attribute attr)
+{
+    if (!attr->attbyval || COL_IS_ENCODE(attr->atttypid))
+        return false;
+
+    switch (attr->atttypid) {
+        case BOOLOID:
+        case INT2OID:
+        case INT4OID:
+        case INT8OID:
+        case OIDOID:
+        case FLOAT4OID:
+        case FLOAT8OID:
+        case CASHOID:
+        case DATEOID:
+        case TIMEOID:
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Get the datum of a row of a batch column, the way VecToRow hands it to the row
+ * executor.
+ */
+static Datum ColumnarBatchGetDatum(ScalarVector* column, int row, Oid typid)
+{
+    ScalarValue val = column->m_vals[row];
+    char* data = NULL;
+
+    if (!COL_IS_ENCODE(typid))
+        return (typid == TIDOID) ? PointerGetDatum(column->m_vals + row) : (Datum)val;
+
+    switch (typid) {
+        case TIMETZOID:
+        case TINTERVALOID:
+        case INTERVALOID:
+        case NAMEOID:
+        case MACADDROID:
+        case UUIDOID:
+            data = (char*)DatumGetPointer(ScalarVector::Decode(val));
+            return PointerGetDatum(data + VARHDRSZ_SHORT);
+        case UNKNOWNOID:
+        case CSTRINGOID:
+            data = (char*)DatumGetPointer(ScalarVector::Decode(val));
+            return PointerGetDatum(VARATT_IS_1B(data) ? data + VARHDRSZ_SHORT : data + VARHDRSZ);
+        default:
+            return ScalarVector::Decode(val);
+    }
+}
+
+/* ----------------
+ *		printColumnarBatch --- send a batch of a vectorized plan column by column
+ *
+ * Used when the client asked for columnar results at startup, so that the rows of
+ * the batch are not formed and converted one datum at a time. The 'b' message holds the number of
+ * columns (int16) and rows (int32), then for each column:
+ *
+ *	kind (byte)		'f' for fixed-length values, followed by their length (int16),
+ *					only for columns requested in binary format, or 'v' for
+ *					counted values
+ *	validity		(rows + 7) / 8 bytes, bit (row % 8) of byte (row / 8) set
+ *					if the row is not null
+ *	values			'f': one value of the type's length per row in network byte
+ *					order, the binary format of the type, zeroes for null rows;
+ *					'v': int32 length and bytes of each non-null row, in the
+ *					format requested for the column, like in a DataRow
+ * ----------------
+ */
+static void printColumnarBatch(VectorBatch* batch, DestReceiver* self)
+{
+    DR_printtup* my_state = (DR_printtup*)self;
+    TupleDesc typeinfo = my_state->batchinfo;
+    StringInfo buf = &my_state->buf;
+    int natts = typeinfo->natts;
+    int rows = batch->m_rows;
+    int bitmaplen = (rows + 7) / 8;
+
+    Assert(batch->m_cols >= natts);
+
+    /* Set or update my derived attribute info, if needed */
+    if (my_state->attrinfo != typeinfo || my_state->nattrs != natts)
+        printtup_prepare_info(my_state, typeinfo, natts);
+
+    StreamTimeSerilizeStart(t_thrd.pgxc_cxt.GlobalNetInstr);
+
+    pq_beginmessage_reuse(buf, 'b');
+    pq_sendint16(buf, natts);
+    pq_sendint32(buf, rows);
+
+    for (int i = 0; i < natts; i++) {
+        Form_pg_attribute attr = typeinfo->attrs[i];
+        PrinttupAttrInfo* thisState = my_state->myinfo + i;
+        ScalarVector* column = &batch->m_arr[i];
+        bool fixed = thisState->format == 1 && ColumnarBatchFixedType(attr);
+        int offset;
+
+        pq_sendbyte(buf, fixed ? 'f' : 'v');
+        if (fixed)
+            pq_sendint16(buf, attr->attlen);
+
+        /* validity bitmap */
+        offset = buf->len;
+        enlargeStringInfo(buf, bitmaplen);
+        errno_t rc = memset_s(buf->data + offset, bitmaplen, 0, bitmaplen);
+        securec_check(rc, "\0", "\0");
+        for (int j = 0; j < rows; j++) {
+            if (!IS_NULL(column->m_flag[j]))
+                buf->data[offset + j / 8] |= (char)(1 << (j % 8));
+        }
+        buf->len += bitmaplen;
+        buf->data[buf->len] = '\0';
+
+        if (fixed) {
+            for (int j = 0; j < rows; j++) {
+                Datum value = IS_NULL(column->m_flag[j]) ? (Datum)0 : (Datum)column->m_vals[j];
+
+                switch (attr->attlen) {
+                    case 1:
+                        pq_sendbyte(buf, DatumGetChar(value));
+                        break;
+                    case 2:
+                        pq_sendint16(buf, (uint16)DatumGetInt16(value));
+                        break;
+                    case 4:
+                        pq_sendint32(buf, (uint32)DatumGetInt32(value));
+                        break;
+                    default:
+                        Assert(attr->attlen == 8);
+                        pq_sendint64(buf, (uint64)DatumGetInt64(value));
+                        break;
+                }
+            }
+            continue;
+        }
+
+        for (int j = 0; j < rows; j++) {
+            if (IS_NULL(column->m_flag[j]))
+                continue;
+
+            Datum value = ColumnarBatchGetDatum(column, j, attr->atttypid);
+
+            if (thisState->format == 0 &&
+                (attr->atttypid == TEXTOID || attr->atttypid == VARCHAROID || attr->atttypid == BPCHAROID)) {
+                /* the text output of these is the string itself */
+                text* txt = DatumGetTextPP(value);
+
+                pq_sendcountedtext(buf, VARDATA_ANY(txt), VARSIZE_ANY_EXHDR(txt), false);
+                if ((Pointer)txt != DatumGetPointer(value))
+                    pfree(txt);
+            } else if (thisState->format == 0) {
+                /* Text output */
+                char* outputstr = OutputFunctionCall(&thisState->finfo, value);
+
+                pq_sendcountedtext(buf, outputstr, strlen(outputstr), false);
+                pfree(outputstr);
+            } else {
+                /* Binary output */
+                bytea* outputbytes = SendFunctionCall(&thisState->finfo, value);
+
+                pq_sendint32(buf, VARSIZE(outputbytes) - VARHDRSZ);
+                pq_sendbytes(buf, VARDATA(outputbytes), VARSIZE(outputbytes) - VARHDRSZ);
+                pfree(outputbytes);
+            }
+        }
+    }
+
+    StreamTimeSerilizeEnd(t_thrd.pgxc_cxt.GlobalNetInstr);
+
+    pq_endmessage_reuse(buf);
+}
+
 /* ----------------
  *		printtup --- print a tuple in protocol 3.0
  * ----------------
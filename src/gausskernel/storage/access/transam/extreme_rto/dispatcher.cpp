@@ -1797,6 +1797,24 @@ void DiagLogRedoRecord(XLogReaderState* record, const char* funcName)
     pfree_ext(buf.data);
 }
 
+void redo_get_wroker_statistic(uint32* realNum, RedoWorkerStatsData* worker, uint32 workerLen)
+{
+    PageRedoWorker* redoWorker = NULL;
+    Assert(workerLen == MAX_RECOVERY_THREAD_NUM);
+    if (g_dispatcher == NULL) {
+        *realNum = 0;
+        return;
+    }
+    *realNum = g_dispatcher->allWorkersCnt;
+    for (uint32 i = 0; i < g_dispatcher->allWorkersCnt; i++) {
+        redoWorker = g_dispatcher->allWorkers[i];
+        worker[i].id = redoWorker->id;
+        worker[i].queue_usage = SPSCGetQueueCount(redoWorker->queue);
+        worker[i].queue_max_usage = (uint32)(pg_atomic_read_u32(&((redoWorker->queue)->maxUsage)));
+        worker[i].redo_rec_count = pg_atomic_read_u64(&((redoWorker->queue)->totalCnt));
+    }
+}
+
 XLogRecPtr GetSafeMinCheckPoint()
 {
     XLogRecPtr minSafeCheckPoint = MAX_XLOG_REC_PTR;
@@ -63,6 +63,7 @@
 #include "pgstat.h"
 #include "access/extreme_rto/batch_redo.h"
 #include "access/multi_redo_api.h"
+#include "access/redo_statistic.h"
 #include "replication/walreceiver.h"
 #include "storage/mot/mot_fdw.h"
 
@@ -358,7 +359,12 @@ void DereferenceRedoItem(void* item)
 void DoRelCreate(XLogRecParseState* recordblockstate)
 {
     RedoBufferInfo bufferinfo = {0};
+    instr_time startTime;
+    bool sampled = redo_stat_sample_begin(&startTime);
     XLogBlockRedoForExtremeRTO(recordblockstate, &bufferinfo, false);
+    if (sampled) {
+        redo_stat_sample_block_end(&recordblockstate->blockparse.blockhead, &startTime);
+    }
 
     recordblockstate->nextrecord = NULL;
     XLogBlockParseStateRelease(recordblockstate);
@@ -1021,9 +1027,15 @@ void RedoPageWorkerMain()
             switch (XLogBlockHeadGetValidInfo(&redoblockstate->blockparse.blockhead)) {
                 case BLOCK_DATA_HEAP_TYPE:
                 case BLOCK_DATA_VM_TYPE:
-                case BLOCK_DATA_FSM_TYPE:
+                case BLOCK_DATA_FSM_TYPE: {
+                    instr_time startTime;
+                    bool sampled = redo_stat_sample_begin(&startTime);
                     notfound = XLogBlockRedoForExtremeRTO(redoblockstate, &bufferinfo, notfound);
+                    if (sampled) {
+                        redo_stat_sample_block_end(&redoblockstate->blockparse.blockhead, &startTime);
+                    }
                     break;
+                }
                 case BLOCK_DATA_XLOG_COMMON_TYPE:
                     RedoPageWorkerCheckPoint(redoblockstate);
                     break;
@@ -161,6 +161,7 @@ void ApplyRedoRecord(XLogReaderState* record, bool bOld)
 {
     t_thrd.xlog_cxt.redo_oldversion_xlog = bOld;
     ErrorContextCallback errContext;
+    instr_time startTime;
     errContext.callback = rm_redo_error_callback;
     errContext.arg = (void*)record;
     errContext.previous = t_thrd.log_cxt.error_context_stack;
@@ -168,7 +169,11 @@ void ApplyRedoRecord(XLogReaderState* record, bool bOld)
     if (module_logging_is_on(MOD_REDO)) {
         DiagLogRedoRecord(record, "ApplyRedoRecord");
     }
+    bool sampled = redo_stat_sample_begin(&startTime);
     RmgrTable[XLogRecGetRmid(record)].rm_redo(record);
+    if (sampled) {
+        redo_stat_sample_end(record, &startTime);
+    }
 
     t_thrd.log_cxt.error_context_stack = errContext.previous;
     t_thrd.xlog_cxt.redo_oldversion_xlog = false;
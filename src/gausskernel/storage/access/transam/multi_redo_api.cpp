@@ -35,6 +35,9 @@
 #include "access/parallel_recovery/dispatcher.h"
 #include "access/extreme_rto/page_redo.h"
 #include "access/parallel_recovery/page_redo.h"
+#include "storage/buf_internals.h"
+#include "storage/bufmgr.h"
+#include "storage/smgr.h"
 
 void StartUpMultiRedo(XLogReaderState* xlogreader, uint32 privateLen)
 {
@@ -70,8 +73,123 @@ bool IsExtremeRtoReadWorkerRunning()
     return true;
 }
 
+/* blocks looked up by the dedup check of the redo prefetcher */
+static const uint32 REDO_PREFETCH_RECENT_BLOCKS = 8;
+
+/* a block prefetched by the dispatcher that redo workers may not have replayed yet */
+typedef struct RedoPrefetchBlock {
+    BufferTag tag;
+    XLogRecPtr endPtr; /* end of the record referencing the block */
+} RedoPrefetchBlock;
+
+typedef struct RedoPrefetchState {
+    RedoPrefetchBlock* blocks; /* ring of in-flight prefetches, oldest at head */
+    uint32 capacity;
+    uint32 head;
+    uint32 count;
+    bool smgrOpened; /* relations were opened by prefetch since the last close */
+} RedoPrefetchState;
+
+static THR_LOCAL RedoPrefetchState* t_redoPrefetch = NULL;
+
+static RedoPrefetchState* GetRedoPrefetchState()
+{
+    if (t_redoPrefetch == NULL) {
+        uint32 capacity = (uint32)g_instance.attr.attr_storage.recovery_prefetch_distance;
+        RedoPrefetchState* state =
+            (RedoPrefetchState*)MemoryContextAllocZero(t_thrd.top_mem_cxt, sizeof(RedoPrefetchState));
+        state->blocks =
+            (RedoPrefetchBlock*)MemoryContextAllocZero(t_thrd.top_mem_cxt, sizeof(RedoPrefetchBlock) * capacity);
+        state->capacity = capacity;
+        t_redoPrefetch = state;
+    }
+    return t_redoPrefetch;
+}
+
+/* Drop in-flight prefetches of records that redo workers have already replayed. */
+static void RetireRedoPrefetches(RedoPrefetchState* state)
+{
+    XLogRecPtr replayedPtr = GetXLogReplayRecPtr(NULL);
+    while (state->count > 0 && XLByteLE(state->blocks[state->head].endPtr, replayedPtr)) {
+        state->head = (state->head + 1) % state->capacity;
+        state->count--;
+    }
+}
+
+static bool IsRecentlyPrefetched(const RedoPrefetchState* state, const BufferTag* tag)
+{
+    uint32 recent = Min(state->count, REDO_PREFETCH_RECENT_BLOCKS);
+    for (uint32 i = 1; i <= recent; i++) {
+        const RedoPrefetchBlock* block = &state->blocks[(state->head + state->count - i) % state->capacity];
+        if (BUFFERTAGS_PTR_EQUAL(&block->tag, tag)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Run from the dispatcher thread, before the record is handed over to the redo workers.
+ *
+ * Issues asynchronous reads for the blocks referenced by the record that are not in shared buffers, so the
+ * I/O overlaps the queueing of earlier records instead of stalling the redo worker that replays this one.
+ * The number of prefetched blocks ahead of the replay position is bounded by recovery_prefetch_distance.
+ */
+static void PrefetchRedoRecordBlocks(XLogReaderState* record)
+{
+    RedoPrefetchState* state = GetRedoPrefetchState();
+
+    /*
+     * Don't keep files open that redo workers are about to remove, since the
+     * space of unlinked files is not released while we hold them open.
+     */
+    RmgrId rmid = XLogRecGetRmid(record);
+    if (state->smgrOpened && (rmid == RM_SMGR_ID || rmid == RM_DBASE_ID || rmid == RM_TBLSPC_ID ||
+        extreme_rto::XactWillRemoveRelFiles(record))) {
+        smgrcloseall();
+        state->smgrOpened = false;
+    }
+
+    for (int blockId = 0; blockId <= record->max_block_id; blockId++) {
+        DecodedBkpBlock* blockRef = &record->blocks[blockId];
+        BufferTag tag;
+
+        /* nothing to read if the page is restored from an image or re-initialized */
+        if (!blockRef->in_use || blockRef->has_image || (blockRef->flags & BKPBLOCK_WILL_INIT) ||
+            blockRef->forknum < 0 || blockRef->forknum > MAX_FORKNUM) {
+            continue;
+        }
+
+        INIT_BUFFERTAG(tag, blockRef->rnode, blockRef->forknum, blockRef->blkno);
+        if (IsRecentlyPrefetched(state, &tag)) {
+            continue;
+        }
+
+        if (state->count == state->capacity) {
+            RetireRedoPrefetches(state);
+            if (state->count == state->capacity) {
+                /* far enough ahead of the redo workers already */
+                return;
+            }
+        }
+
+        SMgrRelation smgr = smgropen(blockRef->rnode, InvalidBackendId);
+        state->smgrOpened = true;
+        if (PrefetchSharedBuffer(smgr, blockRef->forknum, blockRef->blkno)) {
+            RedoPrefetchBlock* block = &state->blocks[(state->head + state->count) % state->capacity];
+            block->tag = tag;
+            block->endPtr = record->EndRecPtr;
+            state->count++;
+        }
+    }
+}
+
 void DispatchRedoRecord(XLogReaderState* record, List* expectedTLIs, TimestampTz recordXTime)
 {
+    if (g_instance.attr.attr_storage.recovery_prefetch_distance > 0 && IsMultiThreadRedo()) {
+        PrefetchRedoRecordBlocks(record);
+    }
+
     if (IsExtremeRedo()) {
         extreme_rto::DispatchRedoRecordToFile(record, expectedTLIs, recordXTime);
     } else if (IsParallelRedo()) {
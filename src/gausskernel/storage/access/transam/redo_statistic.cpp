@@ -32,9 +32,23 @@
 #include "access/parallel_recovery/dispatcher.h"
 #include "instruments/instr_waitevent.h"
 #include "access/parallel_recovery/spsc_blocking_queue.h"
+#include "access/extreme_rto/dispatcher.h"
+#include "access/hash.h"
+#include "access/multi_redo_api.h"
+#include "access/xlog_internal.h"
+#include "replication/walsender.h"
+#include "utils/timestamp.h"
 
 extern char redo_stats_file[MAXPGPATH];
 static const uint32 MAX_REALPATH_LEN = 4096;
+/* the startup thread looks at the clock for a queue depth sample once every this many records */
+static const uint32 REDO_STAT_QUEUE_CHECK_INTERVAL = 1024;
+static const uint32 REDO_STAT_COLS = 7;
+
+static THR_LOCAL uint32 redo_stat_record_count = 0;
+static THR_LOCAL uint32 redo_stat_dispatch_count = 0;
+static THR_LOCAL TimestampTz redo_stat_last_queue_sample = 0;
+
 Datum redo_get_node_name()
 {
     return CStringGetTextDatum(g_instance.attr.attr_common.PGXCNodeName);
@@ -189,12 +203,21 @@ char* redo_get_name_by_wait_type(uint32 type)
     }
 }
 
+static void redo_get_all_worker_statistic(uint32* worker_num, RedoWorkerStatsData* worker)
+{
+    if (IsExtremeRedo()) {
+        extreme_rto::redo_get_wroker_statistic(worker_num, worker, MAX_RECOVERY_THREAD_NUM);
+    } else {
+        parallel_recovery::redo_get_wroker_statistic(worker_num, worker, MAX_RECOVERY_THREAD_NUM);
+    }
+}
+
 void redo_get_worker_info_text(char* info, uint32 max_info_len)
 {
     RedoWorkerStatsData worker[MAX_RECOVERY_THREAD_NUM] = {0};
     uint32 worker_num = 0;
     errno_t errorno = EOK;
-    parallel_recovery::redo_get_wroker_statistic(&worker_num, worker, MAX_RECOVERY_THREAD_NUM);
+    redo_get_all_worker_statistic(&worker_num, worker);
 
     if (worker_num == 0) {
         errorno = snprintf_s(info, max_info_len, max_info_len - 1, "%-16s", "no redo worker");
@@ -424,3 +447,270 @@ void redo_fill_redo_event()
             parallel_recovery::redo_get_io_event(redo_get_event_type_by_wait_type(type));
     }
 }
+
+void redo_stat_reset(RedoReplayStat* stat)
+{
+    errno_t rc = memset_s(stat, sizeof(RedoReplayStat), 0, sizeof(RedoReplayStat));
+    securec_check(rc, "\0", "\0");
+    SpinLockInit(&stat->rel_lock);
+    SpinLockInit(&stat->queue_lock);
+}
+
+/*
+ * Called by a redo thread before applying a record. Returns true if the record is
+ * sampled, in which case start is set and redo_stat_sample_end must be called after.
+ */
+bool redo_stat_sample_begin(instr_time* start)
+{
+    if (++redo_stat_record_count < REDO_STAT_SAMPLE_INTERVAL) {
+        return false;
+    }
+    redo_stat_record_count = 0;
+    INSTR_TIME_SET_CURRENT(*start);
+    return true;
+}
+
+static uint32 redo_stat_latency_bucket(uint64 us)
+{
+    uint32 bucket = 0;
+    while (us > 0 && bucket < REDO_STAT_LATENCY_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void redo_stat_add_rel_heat(RedoReplayStat* stat, const RelFileNode* rnode, uint64 us)
+{
+    uint32 slot = DatumGetUInt32(hash_any((const unsigned char*)rnode, sizeof(RelFileNode))) % REDO_STAT_REL_SLOTS;
+
+    SpinLockAcquire(&stat->rel_lock);
+    for (uint32 i = 0; i < REDO_STAT_REL_PROBES; i++) {
+        RedoRelHeat* heat = &stat->rel_heat[(slot + i) % REDO_STAT_REL_SLOTS];
+        if (heat->count == 0) {
+            heat->rnode = *rnode;
+        } else if (!RelFileNodeEquals(heat->rnode, *rnode)) {
+            continue;
+        }
+        heat->count++;
+        heat->total_us += us;
+        SpinLockRelease(&stat->rel_lock);
+        return;
+    }
+    stat->rel_overflow_count++;
+    stat->rel_overflow_us += us;
+    SpinLockRelease(&stat->rel_lock);
+}
+
+static void redo_stat_add_sample(RmgrId rmid, uint8 info, const RelFileNode* rnode, const instr_time* start)
+{
+    RedoReplayStat* stat = &g_instance.comm_cxt.predo_cxt.replayStat;
+    uint32 type = (info & ~XLR_INFO_MASK) >> 4;
+    instr_time duration;
+    uint64 us;
+
+    INSTR_TIME_SET_CURRENT(duration);
+    INSTR_TIME_SUBTRACT(duration, *start);
+    us = INSTR_TIME_GET_MICROSEC(duration);
+
+    if (rmid <= RM_MAX_ID) {
+        RedoLatencyBucket* bucket = &stat->latency[rmid][type][redo_stat_latency_bucket(us)];
+        (void)pg_atomic_fetch_add_u64(&bucket->count, 1);
+        (void)pg_atomic_fetch_add_u64(&bucket->total_us, us);
+    }
+
+    if (rnode != NULL) {
+        redo_stat_add_rel_heat(stat, rnode, us);
+    }
+}
+
+void redo_stat_sample_end(XLogReaderState* record, const instr_time* start)
+{
+    RelFileNode rnode;
+    bool hasBlock = XLogRecGetBlockTag(record, 0, &rnode, NULL, NULL);
+
+    redo_stat_add_sample(XLogRecGetRmid(record), XLogRecGetInfo(record), hasBlock ? &rnode : NULL, start);
+}
+
+/*
+ * Same as redo_stat_sample_end, for the extreme RTO page workers which apply one
+ * parsed block of a record at a time.
+ */
+void redo_stat_sample_block_end(XLogBlockHead* blockhead, const instr_time* start)
+{
+    RelFileNode rnode;
+
+    rnode.spcNode = XLogBlockHeadGetSpcNode(blockhead);
+    rnode.dbNode = XLogBlockHeadGetDbNode(blockhead);
+    rnode.relNode = XLogBlockHeadGetRelNode(blockhead);
+    rnode.bucketNode = XLogBlockHeadGetBucketId(blockhead);
+    redo_stat_add_sample(XLogBlockHeadGetRmid(blockhead), XLogBlockHeadGetInfo(blockhead), &rnode, start);
+}
+
+/*
+ * Called by the startup thread for every record it dispatches. Records the queue depth
+ * of each redo worker about once every REDO_STAT_QUEUE_SAMPLE_MS, as long as records
+ * keep coming; there is nothing queued when they don't.
+ */
+void redo_stat_sample_queues()
+{
+    RedoReplayStat* stat = &g_instance.comm_cxt.predo_cxt.replayStat;
+    RedoWorkerStatsData worker[MAX_RECOVERY_THREAD_NUM] = {0};
+    uint32 worker_num = 0;
+    TimestampTz now;
+
+    if (++redo_stat_dispatch_count < REDO_STAT_QUEUE_CHECK_INTERVAL) {
+        return;
+    }
+    redo_stat_dispatch_count = 0;
+
+    now = GetCurrentTimestamp();
+    if (!TimestampDifferenceExceeds(redo_stat_last_queue_sample, now, REDO_STAT_QUEUE_SAMPLE_MS)) {
+        return;
+    }
+    redo_stat_last_queue_sample = now;
+
+    redo_get_all_worker_statistic(&worker_num, worker);
+    if (worker_num == 0) {
+        return;
+    }
+
+    SpinLockAcquire(&stat->queue_lock);
+    RedoQueueSample* sample = &stat->queue_samples[stat->queue_next];
+    sample->sample_time = now;
+    sample->worker_num = worker_num;
+    for (uint32 i = 0; i < worker_num; i++) {
+        sample->depth[i] = worker[i].queue_usage;
+    }
+    stat->queue_next = (stat->queue_next + 1) % REDO_STAT_QUEUE_SAMPLES;
+    if (stat->queue_num < REDO_STAT_QUEUE_SAMPLES) {
+        stat->queue_num++;
+    }
+    SpinLockRelease(&stat->queue_lock);
+}
+
+static void redo_stat_put_row(Tuplestorestate* tupstore, TupleDesc tupdesc, const char* stat_type, const char* name,
+    const char* detail, int64 bucket_us, TimestampTz sample_time, uint64 count, int64 total_us)
+{
+    Datum values[REDO_STAT_COLS];
+    bool nulls[REDO_STAT_COLS] = {false};
+
+    values[0] = CStringGetTextDatum(stat_type);
+    values[1] = CStringGetTextDatum(name);
+    if (detail != NULL) {
+        values[2] = CStringGetTextDatum(detail);
+    } else {
+        nulls[2] = true;
+    }
+    if (bucket_us >= 0) {
+        values[3] = Int64GetDatum(bucket_us);
+    } else {
+        nulls[3] = true;
+    }
+    if (sample_time != 0) {
+        values[4] = TimestampTzGetDatum(sample_time);
+    } else {
+        nulls[4] = true;
+    }
+    values[5] = Int64GetDatum((int64)count);
+    if (total_us >= 0) {
+        values[6] = Int64GetDatum(total_us);
+    } else {
+        nulls[6] = true;
+    }
+    tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+}
+
+/*
+ * gs_redo_stat
+ *        Dump the sampled replay statistics.
+ *
+ * Returns one row per non-empty latency histogram bucket of each resource manager and
+ * record type ("record_latency"), per relation of the replay heat map ("relation_heat"),
+ * and per redo worker of each queue depth sample ("worker_queue"). Counts are of
+ * sampled records, one out of every REDO_STAT_SAMPLE_INTERVAL.
+ */
+Datum gs_redo_stat(PG_FUNCTION_ARGS)
+{
+    RedoReplayStat* stat = &g_instance.comm_cxt.predo_cxt.replayStat;
+    TupleDesc tupdesc;
+    Tuplestorestate* tupstore = BuildTupleResult(fcinfo, &tupdesc);
+    char name[NAMEDATALEN];
+    char detail[NAMEDATALEN];
+    errno_t rc;
+
+    for (uint32 rmid = 0; rmid <= RM_MAX_ID; rmid++) {
+        for (uint32 type = 0; type < REDO_STAT_RECORD_TYPES; type++) {
+            rc = snprintf_s(detail, sizeof(detail), sizeof(detail) - 1, "0x%02X", type << 4);
+            securec_check_ss(rc, "\0", "\0");
+            for (uint32 i = 0; i < REDO_STAT_LATENCY_BUCKETS; i++) {
+                RedoLatencyBucket* bucket = &stat->latency[rmid][type][i];
+                uint64 count = pg_atomic_read_u64(&bucket->count);
+                if (count == 0) {
+                    continue;
+                }
+                redo_stat_put_row(tupstore, tupdesc, "record_latency", RmgrTable[rmid].rm_name, detail,
+                    (i < REDO_STAT_LATENCY_BUCKETS - 1) ? (int64)(UINT64CONST(1) << i) : -1, 0, count,
+                    (int64)pg_atomic_read_u64(&bucket->total_us));
+            }
+        }
+    }
+
+    RedoRelHeat* heat = (RedoRelHeat*)palloc(sizeof(RedoRelHeat) * REDO_STAT_REL_SLOTS);
+    uint64 overflow_count;
+    uint64 overflow_us;
+    SpinLockAcquire(&stat->rel_lock);
+    rc = memcpy_s(heat, sizeof(RedoRelHeat) * REDO_STAT_REL_SLOTS, stat->rel_heat, sizeof(stat->rel_heat));
+    securec_check(rc, "\0", "\0");
+    overflow_count = stat->rel_overflow_count;
+    overflow_us = stat->rel_overflow_us;
+    SpinLockRelease(&stat->rel_lock);
+
+    for (uint32 i = 0; i < REDO_STAT_REL_SLOTS; i++) {
+        if (heat[i].count == 0) {
+            continue;
+        }
+        rc = snprintf_s(name, sizeof(name), sizeof(name) - 1, "%u/%u/%u",
+            heat[i].rnode.spcNode, heat[i].rnode.dbNode, heat[i].rnode.relNode);
+        securec_check_ss(rc, "\0", "\0");
+        if (heat[i].rnode.bucketNode != InvalidBktId) {
+            rc = snprintf_s(detail, sizeof(detail), sizeof(detail) - 1, "%d", heat[i].rnode.bucketNode);
+            securec_check_ss(rc, "\0", "\0");
+        }
+        redo_stat_put_row(tupstore, tupdesc, "relation_heat", name,
+            (heat[i].rnode.bucketNode != InvalidBktId) ? detail : NULL, -1, 0, heat[i].count,
+            (int64)heat[i].total_us);
+    }
+    if (overflow_count > 0) {
+        redo_stat_put_row(tupstore, tupdesc, "relation_heat", "other", NULL, -1, 0, overflow_count,
+            (int64)overflow_us);
+    }
+    pfree_ext(heat);
+
+    RedoQueueSample* samples = (RedoQueueSample*)palloc(sizeof(RedoQueueSample) * REDO_STAT_QUEUE_SAMPLES);
+    uint32 sample_num;
+    uint32 sample_next;
+    SpinLockAcquire(&stat->queue_lock);
+    rc = memcpy_s(samples, sizeof(RedoQueueSample) * REDO_STAT_QUEUE_SAMPLES, stat->queue_samples,
+        sizeof(stat->queue_samples));
+    securec_check(rc, "\0", "\0");
+    sample_num = stat->queue_num;
+    sample_next = stat->queue_next;
+    SpinLockRelease(&stat->queue_lock);
+
+    /* oldest sample first */
+    for (uint32 n = 0; n < sample_num; n++) {
+        RedoQueueSample* sample =
+            &samples[(sample_next + REDO_STAT_QUEUE_SAMPLES - sample_num + n) % REDO_STAT_QUEUE_SAMPLES];
+        for (uint32 i = 0; i < sample->worker_num; i++) {
+            rc = snprintf_s(name, sizeof(name), sizeof(name) - 1, "%u", i);
+            securec_check_ss(rc, "\0", "\0");
+            redo_stat_put_row(tupstore, tupdesc, "worker_queue", name, NULL, -1, sample->sample_time,
+                sample->depth[i], -1);
+        }
+    }
+    pfree_ext(samples);
+
+    tuplestore_donestoring(tupstore);
+    return (Datum)0;
+}
@@ -25,19 +25,49 @@
 #include "access/gtm.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
+#include "funcapi.h"
 #include "miscadmin.h"
 #include "pgxc/pgxc.h"
 #include "storage/procarray.h"
+#include "utils/builtins.h"
 #include "utils/guc.h"
 #include "utils/snapmgr.h"
 
-#ifdef PGXC
-#include "utils/builtins.h"
-#endif
-
 extern bool IsPostmasterEnvironment;
 
+/*
+ * Per-thread caches of finished transactions, consulted when the single-item
+ * caches miss and before going to the CSN log or clog, whose SLRU pages are
+ * guarded by partition LWLocks. Each cache is an array indexed by the low bits
+ * of the xid; a new entry simply replaces whatever was in its slot. Nothing is
+ * ever invalidated: only statuses that are guaranteed not to change are
+ * stored, and xids are never reused.
+ */
+#define XACT_STATUS_CACHE_SIZE 1024
+#define XACT_STATUS_CACHE_SLOT(xid) ((xid) & (XACT_STATUS_CACHE_SIZE - 1))
+
+/* add the lookups and hits of a thread to g_instance.stat_cxt this often */
+#define XACT_STATUS_CACHE_FLUSH_INTERVAL 1024
+
+typedef struct XidCSNCacheEntry {
+    TransactionId xid;
+    CommitSeqNo csn;
+} XidCSNCacheEntry;
+
+typedef struct XidStatusCacheEntry {
+    TransactionId xid;
+    CLogXidStatus status;
+    XLogRecPtr lsn;
+} XidStatusCacheEntry;
+
 static CLogXidStatus TransactionLogFetch(TransactionId transactionId);
+static XidCSNCacheEntry* CSNCacheLookup(TransactionId transactionId);
+static void CSNCacheInsert(TransactionId transactionId, CommitSeqNo csn);
+static XidStatusCacheEntry* StatusCacheLookup(TransactionId transactionId);
+static void StatusCacheInsert(TransactionId transactionId, CLogXidStatus status, XLogRecPtr lsn);
+static void CountXactSingleHit(uint32* singleHits);
+static void CountXactCacheLookup(uint32* lookups, uint32* hits, bool hit);
+static void FlushXactCacheStat(void);
 
 #ifdef PGXC
 /* It is not really necessary to make it appear in header file */
@@ -46,6 +76,115 @@ Datum pgxc_get_csn(PG_FUNCTION_ARGS);
 
 #endif
 
+/*
+ * Look up a finished transaction in the CSN cache, returns NULL on a miss.
+ */
+static XidCSNCacheEntry* CSNCacheLookup(TransactionId transactionId)
+{
+    XidCSNCacheEntry* entry = NULL;
+
+    if (t_thrd.xact_cxt.csnCache == NULL)
+        return NULL;
+
+    entry = &t_thrd.xact_cxt.csnCache[XACT_STATUS_CACHE_SLOT(transactionId)];
+    return TransactionIdEquals(entry->xid, transactionId) ? entry : NULL;
+}
+
+static void CSNCacheInsert(TransactionId transactionId, CommitSeqNo csn)
+{
+    XidCSNCacheEntry* entry = NULL;
+
+    if (t_thrd.xact_cxt.csnCache == NULL) {
+        /* not worth risking an out-of-memory PANIC for */
+        if (t_thrd.int_cxt.CritSectionCount > 0 || t_thrd.top_mem_cxt == NULL)
+            return;
+        t_thrd.xact_cxt.csnCache = (XidCSNCacheEntry*)MemoryContextAllocZero(
+            t_thrd.top_mem_cxt, XACT_STATUS_CACHE_SIZE * sizeof(XidCSNCacheEntry));
+    }
+
+    entry = &t_thrd.xact_cxt.csnCache[XACT_STATUS_CACHE_SLOT(transactionId)];
+    entry->xid = transactionId;
+    entry->csn = csn;
+}
+
+/*
+ * Look up a finished transaction in the clog status cache, returns NULL on a miss.
+ */
+static XidStatusCacheEntry* StatusCacheLookup(TransactionId transactionId)
+{
+    XidStatusCacheEntry* entry = NULL;
+
+    if (t_thrd.xact_cxt.statusCache == NULL)
+        return NULL;
+
+    entry = &t_thrd.xact_cxt.statusCache[XACT_STATUS_CACHE_SLOT(transactionId)];
+    return TransactionIdEquals(entry->xid, transactionId) ? entry : NULL;
+}
+
+static void StatusCacheInsert(TransactionId transactionId, CLogXidStatus status, XLogRecPtr lsn)
+{
+    XidStatusCacheEntry* entry = NULL;
+
+    if (t_thrd.xact_cxt.statusCache == NULL) {
+        /* not worth risking an out-of-memory PANIC for */
+        if (t_thrd.int_cxt.CritSectionCount > 0 || t_thrd.top_mem_cxt == NULL)
+            return;
+        t_thrd.xact_cxt.statusCache = (XidStatusCacheEntry*)MemoryContextAllocZero(
+            t_thrd.top_mem_cxt, XACT_STATUS_CACHE_SIZE * sizeof(XidStatusCacheEntry));
+    }
+
+    entry = &t_thrd.xact_cxt.statusCache[XACT_STATUS_CACHE_SLOT(transactionId)];
+    entry->xid = transactionId;
+    entry->status = status;
+    entry->lsn = lsn;
+}
+
+/*
+ * The single-item caches are counted apart, so that the hit ratio of the caches
+ * behind them only covers the lookups that reach them.
+ */
+static void CountXactSingleHit(uint32* singleHits)
+{
+    (*singleHits)++;
+    if (*singleHits >= XACT_STATUS_CACHE_FLUSH_INTERVAL)
+        FlushXactCacheStat();
+}
+
+static void CountXactCacheLookup(uint32* lookups, uint32* hits, bool hit)
+{
+    (*lookups)++;
+    if (hit)
+        (*hits)++;
+    if (*lookups >= XACT_STATUS_CACHE_FLUSH_INTERVAL)
+        FlushXactCacheStat();
+}
+
+static void FlushXactCacheStat(void)
+{
+    knl_t_xact_context* xact_cxt = &t_thrd.xact_cxt;
+
+    if (xact_cxt->csnSingleHits > 0) {
+        (void)pg_atomic_fetch_add_u64(&g_instance.stat_cxt.xactCSNSingleHits, xact_cxt->csnSingleHits);
+        xact_cxt->csnSingleHits = 0;
+    }
+    if (xact_cxt->csnCacheLookups > 0) {
+        (void)pg_atomic_fetch_add_u64(&g_instance.stat_cxt.xactCSNCacheLookups, xact_cxt->csnCacheLookups);
+        (void)pg_atomic_fetch_add_u64(&g_instance.stat_cxt.xactCSNCacheHits, xact_cxt->csnCacheHits);
+        xact_cxt->csnCacheLookups = 0;
+        xact_cxt->csnCacheHits = 0;
+    }
+    if (xact_cxt->statusSingleHits > 0) {
+        (void)pg_atomic_fetch_add_u64(&g_instance.stat_cxt.xactStatusSingleHits, xact_cxt->statusSingleHits);
+        xact_cxt->statusSingleHits = 0;
+    }
+    if (xact_cxt->statusCacheLookups > 0) {
+        (void)pg_atomic_fetch_add_u64(&g_instance.stat_cxt.xactStatusCacheLookups, xact_cxt->statusCacheLookups);
+        (void)pg_atomic_fetch_add_u64(&g_instance.stat_cxt.xactStatusCacheHits, xact_cxt->statusCacheHits);
+        xact_cxt->statusCacheLookups = 0;
+        xact_cxt->statusCacheHits = 0;
+    }
+}
+
 /* ----------------------------------------------------------------
  *		Postgres log access method interface
  *
@@ -66,12 +205,15 @@ CommitSeqNo TransactionIdGetCommitSeqNo(TransactionId transactionId, bool isComm
     XLogRecPtr lsn;
     CommitSeqNo result;
     TransactionId xid = InvalidTransactionId;
+    XidCSNCacheEntry* entry = NULL;
+    bool cacheable = false;
 
     /*
      * Before going to the commit log manager, check our single item cache to
      * see if we didn't just check the transaction status a moment ago.
      */
     if (TransactionIdEquals(transactionId, t_thrd.xact_cxt.cachedFetchCSNXid)) {
+        CountXactSingleHit(&t_thrd.xact_cxt.csnSingleHits);
         t_thrd.xact_cxt.latestFetchCSNXid = t_thrd.xact_cxt.cachedFetchCSNXid;
         t_thrd.xact_cxt.latestFetchCSN = t_thrd.xact_cxt.cachedFetchCSN;
         return t_thrd.xact_cxt.cachedFetchCSN;
@@ -91,6 +233,17 @@ CommitSeqNo TransactionIdGetCommitSeqNo(TransactionId transactionId, bool isComm
         return COMMITSEQNO_ABORTED;
     }
 
+    /* Then the cache of the transactions we have seen finished lately. */
+    entry = CSNCacheLookup(transactionId);
+    CountXactCacheLookup(&t_thrd.xact_cxt.csnCacheLookups, &t_thrd.xact_cxt.csnCacheHits, entry != NULL);
+    if (entry != NULL) {
+        t_thrd.xact_cxt.cachedFetchCSNXid = transactionId;
+        t_thrd.xact_cxt.cachedFetchCSN = entry->csn;
+        t_thrd.xact_cxt.latestFetchCSNXid = transactionId;
+        t_thrd.xact_cxt.latestFetchCSN = entry->csn;
+        return entry->csn;
+    }
+
     /*
      * If the XID is older than RecentGlobalXmin, check the clog. Otherwise
      * check the csnlog.
@@ -113,8 +266,11 @@ CommitSeqNo TransactionIdGetCommitSeqNo(TransactionId transactionId, bool isComm
         } else {
             if (CLogGetStatus(transactionId, &lsn) == CLOG_XID_STATUS_COMMITTED) {
                 result = COMMITSEQNO_FROZEN;
+                /* frozen is only true for everyone below the global xmin, not below our own */
+                cacheable = (!isMvcc || GTM_LITE_MODE);
             } else {
                 result = COMMITSEQNO_ABORTED;
+                cacheable = true;
             }
         }
     } else {
@@ -123,6 +279,7 @@ CommitSeqNo TransactionIdGetCommitSeqNo(TransactionId transactionId, bool isComm
         } else {
             result = CSNLogGetCommitSeqNo(transactionId);
         }
+        cacheable = true;
     }
 
     ereport(DEBUG1,
@@ -144,6 +301,8 @@ CommitSeqNo TransactionIdGetCommitSeqNo(TransactionId transactionId, bool isComm
     if (COMMITSEQNO_IS_COMMITTED(result) || COMMITSEQNO_IS_ABORTED(result)) {
         t_thrd.xact_cxt.cachedFetchCSNXid = transactionId;
         t_thrd.xact_cxt.cachedFetchCSN = result;
+        if (cacheable)
+            CSNCacheInsert(transactionId, result);
     }
 
     t_thrd.xact_cxt.latestFetchCSNXid = transactionId;
@@ -297,12 +456,14 @@ static CLogXidStatus TransactionLogFetch(TransactionId transactionId)
 {
     CLogXidStatus xidstatus;
     XLogRecPtr xidlsn;
+    XidStatusCacheEntry* entry = NULL;
 
     /*
      * Before going to the commit log manager, check our single item cache to
      * see if we didn't just check the transaction status a moment ago.
      */
     if (TransactionIdEquals(transactionId, t_thrd.xact_cxt.cachedFetchXid)) {
+        CountXactSingleHit(&t_thrd.xact_cxt.statusSingleHits);
         t_thrd.xact_cxt.latestFetchXid = t_thrd.xact_cxt.cachedFetchXid;
         t_thrd.xact_cxt.latestFetchXidStatus = t_thrd.xact_cxt.cachedFetchXidStatus;
         return t_thrd.xact_cxt.cachedFetchXidStatus;
@@ -320,6 +481,18 @@ static CLogXidStatus TransactionLogFetch(TransactionId transactionId)
         return CLOG_XID_STATUS_ABORTED;
     }
 
+    /* Then the cache of the transactions we have seen finished lately. */
+    entry = StatusCacheLookup(transactionId);
+    CountXactCacheLookup(&t_thrd.xact_cxt.statusCacheLookups, &t_thrd.xact_cxt.statusCacheHits, entry != NULL);
+    if (entry != NULL) {
+        t_thrd.xact_cxt.cachedFetchXid = transactionId;
+        t_thrd.xact_cxt.cachedFetchXidStatus = entry->status;
+        t_thrd.xact_cxt.cachedCommitLSN = entry->lsn;
+        t_thrd.xact_cxt.latestFetchXid = transactionId;
+        t_thrd.xact_cxt.latestFetchXidStatus = entry->status;
+        return entry->status;
+    }
+
     /*
      * Get the transaction status.
      */
@@ -332,6 +505,7 @@ static CLogXidStatus TransactionLogFetch(TransactionId transactionId)
         t_thrd.xact_cxt.cachedFetchXid = transactionId;
         t_thrd.xact_cxt.cachedFetchXidStatus = xidstatus;
         t_thrd.xact_cxt.cachedCommitLSN = xidlsn;
+        StatusCacheInsert(transactionId, xidstatus, xidlsn);
     }
 
     t_thrd.xact_cxt.latestFetchXid = transactionId;
@@ -381,6 +555,35 @@ Datum pgxc_get_csn(PG_FUNCTION_ARGS)
 
 #endif
 
+/*
+ * Report the hits of the single-item caches and the lookups and hits of the
+ * caches behind them, of all threads since startup. Threads add theirs every
+ * XACT_STATUS_CACHE_FLUSH_INTERVAL lookups, so the last few of each thread are
+ * not included yet.
+ */
+Datum gs_xact_status_cache_stat(PG_FUNCTION_ARGS)
+{
+    TupleDesc tupdesc;
+    Datum values[6];
+    bool nulls[6] = {false, false, false, false, false, false};
+    HeapTuple tuple;
+
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("return type must be a row type")));
+
+    FlushXactCacheStat();
+
+    values[0] = Int64GetDatum((int64)pg_atomic_read_u64(&g_instance.stat_cxt.xactCSNSingleHits));
+    values[1] = Int64GetDatum((int64)pg_atomic_read_u64(&g_instance.stat_cxt.xactCSNCacheLookups));
+    values[2] = Int64GetDatum((int64)pg_atomic_read_u64(&g_instance.stat_cxt.xactCSNCacheHits));
+    values[3] = Int64GetDatum((int64)pg_atomic_read_u64(&g_instance.stat_cxt.xactStatusSingleHits));
+    values[4] = Int64GetDatum((int64)pg_atomic_read_u64(&g_instance.stat_cxt.xactStatusCacheLookups));
+    values[5] = Int64GetDatum((int64)pg_atomic_read_u64(&g_instance.stat_cxt.xactStatusCacheHits));
+
+    tuple = heap_form_tuple(BlessTupleDesc(tupdesc), values, nulls);
+    PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
 /* ----------------------------------------------------------------
  *						Interface functions
  *
@@ -593,6 +796,11 @@ bool TransactionIdIsKnownCompleted(TransactionId transactionId)
         return true;
     }
 
+    /* Same for the caches behind them, which are just an array probe each. */
+    if (TransactionIdIsNormal(transactionId) &&
+        (StatusCacheLookup(transactionId) != NULL || CSNCacheLookup(transactionId) != NULL))
+        return true;
+
     return false;
 }
 
@@ -702,6 +910,7 @@ void TransactionIdAbortTree(TransactionId xid, int nxids, TransactionId* xids)
 XLogRecPtr TransactionIdGetCommitLSN(TransactionId xid)
 {
     XLogRecPtr result;
+    XidStatusCacheEntry* entry = NULL;
 
     /*
      * Currently, all uses of this function are for xids that were just
@@ -716,6 +925,10 @@ XLogRecPtr TransactionIdGetCommitLSN(TransactionId xid)
     if (!TransactionIdIsNormal(xid))
         return InvalidXLogRecPtr;
 
+    entry = StatusCacheLookup(xid);
+    if (entry != NULL)
+        return entry->lsn;
+
     /*
      * Get the transaction status.
      */
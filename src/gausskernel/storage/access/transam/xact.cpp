@@ -745,15 +745,14 @@ static void AssignTransactionId(TransactionState s)
     }
     /*
      * When wal_level=logical, guarantee that a subtransaction's xid can only
-     * be seen in the WAL stream if its toplevel xid has been logged
-     * before. If necessary we log a xact_assignment record with fewer than
-     * PGPROC_MAX_CACHED_SUBXIDS. Note that it is fine if didLogXid isn't set
-     * for a transaction even though it appears in a WAL record, we just might
-     * superfluously log something. That can happen when an xid is included
-     * somewhere inside a wal record, but not in XLogRecord->xl_xid, like in
-     * xl_standby_locks.
-     */
-    if (isSubXact && XLogLogicalInfoActive() && !TopTransactionStateData.didLogXid)
+     * be seen in the WAL stream if its assignment to the toplevel xid has been
+     * logged before, so logical decoding knows which transaction each change
+     * belongs to before the commit and can stream large transactions while
+     * they are in progress. That means logging a xact_assignment record with
+     * fewer than PGPROC_MAX_CACHED_SUBXIDS entries for every subtransaction
+     * that gets an xid.
+     */
+    if (isSubXact && XLogLogicalInfoActive())
         log_unknown_top = true;
 
         /*
@@ -1676,6 +1675,11 @@ static TransactionId RecordTransactionCommit(void)
         g_instance.comm_cxt.localinfo_cxt.set_term = true;
     }
 
+    /* Remember where the commit record ends for the client, see report_commit_lsn */
+    if (wrote_xlog && markXidCommitted) {
+        u_sess->xact_cxt.lastCommitLSN = t_thrd.xlog_cxt.XactLastRecEnd;
+    }
+
     /* Reset XactLastRecEnd until the next transaction writes something */
     t_thrd.xlog_cxt.XactLastRecEnd = 0;
 
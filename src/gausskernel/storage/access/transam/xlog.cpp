@@ -8772,6 +8772,7 @@ void StartupXLOG(void)
                     newXlogReader = parallel_recovery::NewReaderState(xlogreader);
                 }
                 DispatchRedoRecord(xlogreader, t_thrd.xlog_cxt.expectedTLIs, xtime);
+                redo_stat_sample_queues();
 
                 /* Remember this record as the last-applied one */
                 t_thrd.xlog_cxt.LastRec = t_thrd.xlog_cxt.ReadRecPtr;
@@ -13328,6 +13329,9 @@ void SetXLogReplayRecPtr(XLogRecPtr readRecPtr, XLogRecPtr endRecPtr)
         isUpdated = true;
     }
     SpinLockRelease(&xlogctl->info_lck);
+    if (isUpdated) {
+        WakeupReplayWaiters(endRecPtr);
+    }
     if (isUpdated && !IsExtremeRedo()) {
         RedoSpeedDiag(readRecPtr, endRecPtr);
     }
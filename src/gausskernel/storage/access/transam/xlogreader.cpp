@@ -37,13 +37,9 @@ typedef struct XLogPageReadPrivate {
     TimeLineID tli;
 } XLogPageReadPrivate;
 
-#ifdef FRONTEND
-static int xlogreadfd = -1;
-static XLogSegNo xlogreadsegno = 0;
-#else
+/* thread-local in frontends too, gs_rewind reads WAL in several threads */
 static THR_LOCAL int xlogreadfd = -1;
 static THR_LOCAL XLogSegNo xlogreadsegno = 0;
-#endif
 
 bool ValidXLogPageHeader(XLogReaderState* state, XLogRecPtr recptr, XLogPageHeader hdr, bool readoldversion);
 static int ReadPageInternal(XLogReaderState* state, XLogRecPtr pageptr, int reqLen, bool readoldversion);
@@ -385,13 +385,28 @@ void PrefetchBuffer(Relation reln, ForkNumber forkNum, BlockNumber blockNum)
         }
     }
 
+    (void)PrefetchSharedBuffer(reln->rd_smgr, forkNum, blockNum);
+#endif /* USE_PREFETCH && USE_POSIX_FADVISE */
+}
+
+/*
+ * PrefetchSharedBuffer -- initiate asynchronous read of a block of a relation
+ *      into the OS cache, if it isn't already in shared buffers.
+ *
+ * This works on the smgr level so it can be used without a relcache entry,
+ * e.g. by the recovery dispatcher prefetching blocks referenced by WAL records
+ * ahead of the redo workers. Returns true if a prefetch was issued.
+ */
+bool PrefetchSharedBuffer(SMgrRelation smgr, ForkNumber forkNum, BlockNumber blockNum)
+{
+#if defined(USE_PREFETCH) && defined(USE_POSIX_FADVISE)
     BufferTag new_tag;         /* identity of requested block */
     uint32 new_hash;           /* hash value for newTag */
     LWLock* new_partition_lock; /* buffer partition lock for it */
     int buf_id;
 
     /* create a tag so we can lookup the buffer */
-    INIT_BUFFERTAG(new_tag, reln->rd_smgr->smgr_rnode.node, forkNum, blockNum);
+    INIT_BUFFERTAG(new_tag, smgr->smgr_rnode.node, forkNum, blockNum);
 
     /* determine its hash code and partition lock ID */
     new_hash = BufTableHashCode(&new_tag);
@@ -404,21 +419,23 @@ void PrefetchBuffer(Relation reln, ForkNumber forkNum, BlockNumber blockNum)
 
     /* If not in buffers, initiate prefetch */
     if (buf_id < 0) {
-        smgrprefetch(reln->rd_smgr, forkNum, blockNum);
+        smgrprefetch(smgr, forkNum, blockNum);
+        return true;
     }
 
-        /*
-         * If the block *is* in buffers, we do nothing.  This is not really
-         * ideal: the block might be just about to be evicted, which would be
-         * stupid since we know we are going to need it soon.  But the only
-         * easy answer is to bump the usage_count, which does not seem like a
-         * great solution: when the caller does ultimately touch the block,
-         * usage_count would get bumped again, resulting in too much
-         * favoritism for blocks that are involved in a prefetch sequence. A
-         * real fix would involve some additional per-buffer state, and it's
-         * not clear that there's enough of a problem to justify that.
-         */
+    /*
+     * If the block *is* in buffers, we do nothing.  This is not really
+     * ideal: the block might be just about to be evicted, which would be
+     * stupid since we know we are going to need it soon.  But the only
+     * easy answer is to bump the usage_count, which does not seem like a
+     * great solution: when the caller does ultimately touch the block,
+     * usage_count would get bumped again, resulting in too much
+     * favoritism for blocks that are involved in a prefetch sequence. A
+     * real fix would involve some additional per-buffer state, and it's
+     * not clear that there's enough of a problem to justify that.
+     */
 #endif /* USE_PREFETCH && USE_POSIX_FADVISE */
+    return false;
 }
 
 /*
@@ -150,6 +150,7 @@ void CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
         size = add_size(size, AutoVacuumShmemSize());
         size = add_size(size, WalSndShmemSize());
         size = add_size(size, WalRcvShmemSize());
+        size = add_size(size, ReplayWaitShmemSize());
         size = add_size(size, DataSndShmemSize());
         size = add_size(size, DataRcvShmemSize());
         /* DataSenderQueue, DataWriterQueue has the same size, WalDataWriterQueue is deleted */
@@ -291,6 +292,7 @@ void CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
     ReplicationSlotsShmemInit();
     WalSndShmemInit();
     WalRcvShmemInit();
+    ReplayWaitShmemInit();
     DataSndShmemInit();
     DataRcvShmemInit();
     DataSenderQueueShmemInit();
@@ -624,6 +624,9 @@ void InitProcess(void)
     t_thrd.proc->clogGroupMemberLsn = InvalidXLogRecPtr;
     pg_atomic_init_u32(&t_thrd.proc->clogGroupNext, INVALID_PGPROCNO);
 
+    /* Not reading the global plan cache lookup lists. */
+    t_thrd.proc->gpcEpoch = 0;
+
 #ifdef __aarch64__
     /* Initialize fields for group xlog insert. */
     t_thrd.proc->xlogGroupMember = false;
@@ -28,6 +28,7 @@
 #include "mot_engine.h"
 #include "row.h"
 #include "row_header.h"
+#include "table.h"
 #include "txn.h"
 #include "txn_access.h"
 #include "checkpoint_manager.h"
@@ -48,7 +49,9 @@ OccTransactionManager::OccTransactionManager()
       m_dynamicSleep(100),
       m_rowsLocked(false),
       m_preAbort(true),
-      m_validationNoWait(true)
+      m_validationNoWait(true),
+      m_tableEpochValidation(false),
+      m_modifiedTableCount(0)
 {}
 
 OccTransactionManager::~OccTransactionManager()
@@ -92,6 +95,63 @@ bool OccTransactionManager::QuickHeaderValidation(const Access* access)
     return true;
 }
 
+bool OccTransactionManager::IsTableUnmodified(const Access* access) const
+{
+    return m_tableEpochValidation && access->GetRowFromHeader()->GetTable()->IsUnmodifiedSince(access->m_tableEpoch);
+}
+
+void OccTransactionManager::UpdateTableModifications(TxnManager* txMan, bool begin)
+{
+    TxnOrderedSet_t& orderedSet = txMan->m_accessMgr->GetOrderedRowSet();
+    if (begin) {
+        m_modifiedTableCount = 0;
+    }
+    for (const auto& raPair : orderedSet) {
+        const Access* ac = raPair.second;
+        if (ac->m_type == RD || !ac->m_params.IsPrimarySentinel()) {
+            continue;
+        }
+        Table* table = ac->GetTxnRow()->GetTable();
+        bool tracked = false;
+        for (uint32_t i = 0; i < m_modifiedTableCount; ++i) {
+            if (m_modifiedTables[i] == table) {
+                tracked = true;
+                break;
+            }
+        }
+        if (tracked) {
+            continue;
+        }
+        if (begin && m_modifiedTableCount < MAX_MODIFIED_TABLES) {
+            m_modifiedTables[m_modifiedTableCount++] = table;
+            table->BeginModification();
+        } else if (m_modifiedTableCount == MAX_MODIFIED_TABLES) {
+            // too many tables, count each row separately (begin and end are balanced since the set is not changed)
+            if (begin) {
+                table->BeginModification();
+            } else {
+                table->EndModification();
+            }
+        }
+    }
+}
+
+void OccTransactionManager::BeginTableModifications(TxnManager* txMan)
+{
+    UpdateTableModifications(txMan, true);
+}
+
+void OccTransactionManager::EndTableModifications(TxnManager* txMan)
+{
+    if (m_modifiedTableCount == MAX_MODIFIED_TABLES) {
+        UpdateTableModifications(txMan, false);
+    }
+    for (uint32_t i = 0; i < m_modifiedTableCount; ++i) {
+        m_modifiedTables[i]->EndModification();
+    }
+    m_modifiedTableCount = 0;
+}
+
 bool OccTransactionManager::ValidateReadSet(TxnManager* txMan)
 {
     TxnOrderedSet_t& orderedSet = txMan->m_accessMgr->GetOrderedRowSet();
@@ -100,6 +160,9 @@ bool OccTransactionManager::ValidateReadSet(TxnManager* txMan)
         if (ac->m_type != RD) {
             continue;
         }
+        if (IsTableUnmodified(ac)) {
+            continue;
+        }
         if (!ac->GetRowFromHeader()->m_rowHeader.ValidateRead(ac->m_tid)) {
             return false;
         }
@@ -266,7 +329,7 @@ RC OccTransactionManager::ValidateOcc(TxnManager* txMan)
             case RD:
                 if (txMan->GetTxnIsoLevel() > READ_COMMITED) {
                     readSetSize++;
-                    if (m_preAbort && !QuickVersionCheck(ac)) {
+                    if (m_preAbort && !IsTableUnmodified(ac) && !QuickVersionCheck(ac)) {
                         rc = RC_ABORT;
                         goto final;
                     }
@@ -276,7 +339,7 @@ RC OccTransactionManager::ValidateOcc(TxnManager* txMan)
                 break;
         }
 
-        if (m_preAbort) {
+        if (m_preAbort && (ac->m_type != RD || !IsTableUnmodified(ac))) {
             if (!QuickHeaderValidation(ac)) {
                 rc = RC_ABORT;
                 goto final;
@@ -325,6 +388,10 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
     if (m_writeSetSize == 0 && m_insertSetSize == 0) {
         return true;
     }
+    // concurrent readers of the written tables must validate their reads from this point on
+    if (m_tableEpochValidation) {
+        BeginTableModifications(txMan);
+    }
     LockRows(txMan, m_rowsSetSize);
     MOTConfiguration& cfg = GetGlobalConfiguration();
 
@@ -352,7 +419,9 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
                     // Current state: row is set to absent,sentinel is locked and not dirty
                     // Readers will not see the row
                     access->GetTxnRow()->GetTable()->UpdateRowCount(1);
+                    access->m_origSentinel->GetIndex()->UpdateRowCount(1);
                 } else {
+                    access->m_origSentinel->GetIndex()->UpdateRowCount(1);
                     // We only set the in the secondary sentinel!
                     access->m_origSentinel->SetNextPtr(access->GetRowFromHeader()->GetPrimarySentinel());
                 }
@@ -393,6 +462,9 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
             }
             if (access->m_params.IsPrimarySentinel()) {
                 if (!GetCheckpointManager()->ApplyWrite(txMan, access->GetTxnRow(), access->m_type)) {
+                    if (m_tableEpochValidation) {
+                        EndTableModifications(txMan);
+                    }
                     return false;
                 }
             }
@@ -410,6 +482,10 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
         }
     }
 
+    if (m_tableEpochValidation) {
+        EndTableModifications(txMan);
+    }
+
     if (cfg.m_enableCheckpoint) {
         GetCheckpointManager()->CommitTransaction(txMan, m_rowsSetSize);
     }
@@ -431,7 +507,11 @@ void OccTransactionManager::CleanRowsFromIndexes(TxnManager* txMan)
         const Access* access = raPair.second;
         if (access->m_type == DEL) {
             numOfDeletes--;
-            access->GetTxnRow()->GetTable()->UpdateRowCount(-1);
+            // every index sentinel of the row carries its own delete access
+            if (access->m_params.IsPrimarySentinel()) {
+                access->GetTxnRow()->GetTable()->UpdateRowCount(-1);
+            }
+            access->m_origSentinel->GetIndex()->UpdateRowCount(-1);
             MOT_ASSERT(access->m_params.IsUpgradeInsert() == false);
             // Use Txn Row as row may change INSERT after DELETE leaves residue
             txMan->RemoveKeyFromIndex(access->GetTxnRow(), access->m_origSentinel);
@@ -30,6 +30,7 @@
 namespace MOT {
 // forward declaration
 class Access;
+class Table;
 
 constexpr uint64_t LOCK_TIME_OUT = 1 << 16;
 /**
@@ -72,6 +73,19 @@ public:
         m_validationNoWait = b;
     }
 
+    /**
+     * @brief Sets or clears the table epoch validation flag.
+     * @detail Determines whether read set items of tables that were not
+     * modified since the items were read are skipped during validation.
+     * Committing transactions advance the modification epoch of the tables
+     * they write to.
+     * @param b The new table epoch validation flag state.
+     */
+    void SetTableEpochValidation(bool b)
+    {
+        m_tableEpochValidation = b;
+    }
+
     /**
      * @brief Performs OCC validation for a transaction commit.
      * @param tx The committed transaction.
@@ -162,6 +176,22 @@ private:
     /** @brief Validate Header for insert   */
     bool QuickHeaderValidation(const Access* access);
 
+    /**
+     * @brief Checks whether the table of a read access was not modified
+     * since the row was read, in which case the row itself need not be
+     * validated.
+     */
+    bool IsTableUnmodified(const Access* access) const;
+
+    /** @brief Advances the modification epoch of all tables in the write set. */
+    void BeginTableModifications(TxnManager* txMan);
+
+    /** @brief Marks the end of modifications to all tables in the write set. */
+    void EndTableModifications(TxnManager* txMan);
+
+    /** @brief Begins or ends modification of the tables in the write set. */
+    void UpdateTableModifications(TxnManager* txMan, bool begin);
+
     void ReleaseHeaderLocks(TxnManager* txMan, uint32_t numOfLocks);
     /** release all the locked rows    */
     void ReleaseRowsLocks(TxnManager* txMan, uint32_t numOfLocks);
@@ -199,6 +229,18 @@ private:
 
     /** @var Validate-no-wait configuration. */
     bool m_validationNoWait;
+
+    /** @var Table epoch validation configuration. */
+    bool m_tableEpochValidation;
+
+    /** @brief Maximum number of distinct tables tracked per commit (further tables are updated per row). */
+    static constexpr uint32_t MAX_MODIFIED_TABLES = 16;
+
+    /** @var Tables whose modification epoch was advanced by the current commit. */
+    Table* m_modifiedTables[MAX_MODIFIED_TABLES];
+
+    /** @var Number of entries used in the modified tables array. */
+    uint32_t m_modifiedTableCount;
 };
 }  // namespace MOT
 
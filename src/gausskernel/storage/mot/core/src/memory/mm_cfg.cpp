@@ -90,6 +90,7 @@ extern int MemCfgInit()
         g_memGlobalCfg.m_maxConnectionCount);
 
     g_memGlobalCfg.m_chunkAllocPolicy = motCfg.m_chunkAllocPolicy;
+    g_memGlobalCfg.m_chunkHugePageMode = motCfg.m_chunkHugePageMode;
     g_memGlobalCfg.m_chunkPreallocWorkerCount = motCfg.m_chunkPreallocWorkerCount;
     g_memGlobalCfg.m_highRedMarkPercent = motCfg.m_highRedMarkPercent;
 
@@ -175,6 +176,11 @@ extern void MemCfgToString(int indent, const char* name, StringBuffer* stringBuf
         indent,
         "",
         MemAllocPolicyToString(g_memGlobalCfg.m_chunkAllocPolicy));
+    StringBufferAppend(stringBuffer,
+        "%*sChunk Huge Page Mode: %s\n",
+        indent,
+        "",
+        MemHugePageModeToString(g_memGlobalCfg.m_chunkHugePageMode));
     StringBufferAppend(stringBuffer,
         "%*sChunk pre-allocation Worker Count: %u\n",
         indent,
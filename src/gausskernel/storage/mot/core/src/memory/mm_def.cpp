@@ -146,4 +146,38 @@ extern const char* MemAllocPolicyToString(MemAllocPolicy allocPolicy)
     }
 }
 
+#define MEM_HUGE_PAGE_NONE_STR "none"
+#define MEM_HUGE_PAGE_TRANSPARENT_STR "transparent"
+#define MEM_HUGE_PAGE_EXPLICIT_STR "explicit"
+
+extern MemHugePageMode MemHugePageModeFromString(const char* hugePageModeStr)
+{
+    MemHugePageMode result = MEM_HUGE_PAGE_INVALID;
+    if (strcmp(hugePageModeStr, MEM_HUGE_PAGE_NONE_STR) == 0) {
+        result = MEM_HUGE_PAGE_NONE;
+    } else if (strcmp(hugePageModeStr, MEM_HUGE_PAGE_TRANSPARENT_STR) == 0) {
+        result = MEM_HUGE_PAGE_TRANSPARENT;
+    } else if (strcmp(hugePageModeStr, MEM_HUGE_PAGE_EXPLICIT_STR) == 0) {
+        result = MEM_HUGE_PAGE_EXPLICIT;
+    }
+    return result;
+}
+
+extern const char* MemHugePageModeToString(MemHugePageMode hugePageMode)
+{
+    switch (hugePageMode) {
+        case MEM_HUGE_PAGE_NONE:
+            return MEM_HUGE_PAGE_NONE_STR;
+
+        case MEM_HUGE_PAGE_TRANSPARENT:
+            return MEM_HUGE_PAGE_TRANSPARENT_STR;
+
+        case MEM_HUGE_PAGE_EXPLICIT:
+            return MEM_HUGE_PAGE_EXPLICIT_STR;
+
+        default:
+            return "N/A";
+    }
+}
+
 }  // namespace MOT
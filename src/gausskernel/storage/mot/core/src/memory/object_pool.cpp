@@ -69,6 +69,27 @@ ObjAllocInterface* ObjAllocInterface::GetObjPool(uint16_t size, bool local, uint
     return result;
 }
 
+ObjAllocInterface* ObjAllocInterface::GetObjPoolOnNode(uint16_t size, int node, uint8_t align)
+{
+    if (node < 0) {
+        return GetObjPool(size, false, align);
+    }
+
+    ObjAllocInterface* result = new (std::nothrow) GlobalObjPool(size, align, node);
+    if (result == NULL) {
+        MOT_REPORT_ERROR(
+            MOT_ERROR_OOM, "Allocate Object Pool", "Failed to allocate memory for global object pool on node %d", node);
+    } else if (!result->Initialize()) {
+        MOT_REPORT_ERROR(MOT_ERROR_INTERNAL,
+            "Allocate Object Pool",
+            "Failed to pre-allocate memory for global object pool on node %d",
+            node);
+        delete result;
+        result = NULL;
+    }
+    return result;
+}
+
 void ObjAllocInterface::FreeObjPool(ObjAllocInterface** pool)
 {
     if (pool != NULL && *pool != NULL) {
@@ -312,11 +312,13 @@ public:
     uint16_t m_oixOffset;
     MemBufferClass m_type;
     bool m_global;
+    int m_node;
 
     static ObjAllocInterface* GetObjPool(uint16_t size, bool local, uint8_t align = 8);
+    static ObjAllocInterface* GetObjPoolOnNode(uint16_t size, int node, uint8_t align = 8);
     static void FreeObjPool(ObjAllocInterface** pool);
 
-    explicit ObjAllocInterface(bool isGlobal) : m_global(isGlobal)
+    explicit ObjAllocInterface(bool isGlobal, int node = MEM_INTERLEAVE_NODE) : m_global(isGlobal), m_node(node)
     {}
 
     virtual ~ObjAllocInterface();
@@ -466,9 +468,14 @@ public:
 #else
         void* p;
 
-        if (global == true)
-            p = MemBufferAllocGlobal(type);
-        else
+        if (global == true) {
+            // global pools pinned to a NUMA node take their buffers from the global allocator of that node
+            if (app->m_node >= 0) {
+                p = MemBufferAllocGlobalOnNode(type, app->m_node);
+            } else {
+                p = MemBufferAllocGlobal(type);
+            }
+        } else
 #ifdef MEM_SESSION_ACTIVE
         {
             uint32_t buffer_size = 1024 * MemBufferClassToSizeKb(type);
@@ -640,7 +647,7 @@ class GlobalObjPool : public ObjAllocInterface {
 public:
     ThreadAOP m_threadAOP[MAX_THR_NUM];
 
-    GlobalObjPool(uint16_t sz, uint8_t align) : ObjAllocInterface(true)
+    GlobalObjPool(uint16_t sz, uint8_t align, int node = MEM_INTERLEAVE_NODE) : ObjAllocInterface(true, node)
     {
         m_objList = nullptr;
         m_nextFree = nullptr;
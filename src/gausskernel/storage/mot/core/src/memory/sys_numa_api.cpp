@@ -25,6 +25,7 @@
 #include "sys_numa_api.h"
 #include "utilities.h"
 #include "mot_configuration.h"
+#include "mm_cfg.h"
 #include "global.h"
 #include "string_buffer.h"
 
@@ -56,6 +57,20 @@
 #define MPOL_MF_MOVE (1 << 1)     /* Move pages owned by this process to conform to mapping */
 #define MPOL_MF_MOVE_ALL (1 << 2) /* Move every page to conform to mapping */
 
+/* Flags for explicit huge page mappings (adapted from /usr/include/linux/mman.h) */
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+// huge pages are used only for mappings that are made of whole 2 MB pages
+#define HUGE_PAGE_SIZE (2 * MEGA_BYTE)
+
 // some required utility macros
 #define ROUND_UP(x, y) (((x) + (y)-1) & ~((y)-1))
 #define CPU_BYTES(x) (ROUND_UP(x, sizeof(long)))
@@ -162,6 +177,7 @@ static BitMaskSt* g_allCpusBm = nullptr;
 static BitMaskSt* g_nodesBm = nullptr;
 static BitMaskSt* g_memNodeBm = nullptr;
 static BitMaskSt** g_nodeCpuBm = nullptr;
+static volatile bool g_hugePageFallbackReported = false;
 
 void MotSysNumaInit()
 {
@@ -263,12 +279,59 @@ void* MotSysNumaAllocLocal(size_t size)
     return mem;
 }
 
+static MemHugePageMode MotSysNumaGetHugePageMode(size_t size, size_t align)
+{
+    MemHugePageMode hugePageMode = g_memGlobalCfg.m_chunkHugePageMode;
+    if ((size % HUGE_PAGE_SIZE != 0) || (align % HUGE_PAGE_SIZE != 0)) {
+        hugePageMode = MEM_HUGE_PAGE_NONE;
+    } else if ((hugePageMode == MEM_HUGE_PAGE_EXPLICIT) && (align != HUGE_PAGE_SIZE)) {
+        // explicit huge page mappings are aligned only to the huge page size
+        hugePageMode = MEM_HUGE_PAGE_TRANSPARENT;
+    }
+    return hugePageMode;
+}
+
+static void* MotSysNumaMapHugePages(size_t size)
+{
+    // do not use MOTSysNumaMmap(), since failure here is expected when the huge page pool is depleted
+    void* mem = mmap(
+        0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+    if ((mem == MAP_FAILED) && !g_hugePageFallbackReported) {
+        g_hugePageFallbackReported = true;
+        MOT_LOG_WARN("Failed to map %" PRIu64 " bytes from the kernel huge page pool (error: %d), falling back to "
+                     "transparent huge pages (check vm.nr_hugepages)",
+            (uint64_t)size,
+            errno);
+    }
+    return mem;
+}
+
+static void MotSysNumaAdviseHugePages(void* mem, size_t size)
+{
+    // failure is not fatal, it only means transparent huge pages are disabled in the kernel
+    if (madvise(mem, size, MADV_HUGEPAGE) != 0) {
+        MOT_LOG_TRACE("Failed to advise transparent huge pages for %" PRIu64 " bytes at %p (error: %d)",
+            (uint64_t)size,
+            mem,
+            errno);
+    }
+}
+
 static void* MotSysNumaMapAligned(size_t size, size_t align)
 {
     if (size == 0 || align == 0) {
         return MAP_FAILED;
     }
 
+    MemHugePageMode hugePageMode = MotSysNumaGetHugePageMode(size, align);
+    if (hugePageMode == MEM_HUGE_PAGE_EXPLICIT) {
+        void* hugeMem = MotSysNumaMapHugePages(size);
+        if (hugeMem != MAP_FAILED) {
+            return hugeMem;
+        }
+        hugePageMode = MEM_HUGE_PAGE_TRANSPARENT;
+    }
+
     // try fast allocation first
     void* mem = MOTSysNumaMmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
     if (mem == MAP_FAILED) {
@@ -295,6 +358,10 @@ static void* MotSysNumaMapAligned(size_t size, size_t align)
         }
     }
 
+    if (hugePageMode == MEM_HUGE_PAGE_TRANSPARENT) {
+        MotSysNumaAdviseHugePages(mem, size);
+    }
+
     return mem;
 }
 
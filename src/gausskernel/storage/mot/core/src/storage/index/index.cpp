@@ -35,8 +35,28 @@ std::atomic<uint32_t> Index::m_indexCounter(0);
 
 uint64_t Index::GetSize() const
 {
-    // by default not implemented
-    return 0;
+    // concurrent commits may drive the relaxed counter transiently below zero
+    int64_t rowCount = m_rowCount.load(std::memory_order_relaxed);
+    return (rowCount > 0) ? (uint64_t)rowCount : 0;
+}
+
+double Index::GetDistinctKeys() const
+{
+    uint64_t rowCount = GetSize();
+    if (m_unique) {
+        return (double)rowCount;
+    }
+
+    if (m_distinctKeys <= 0 || m_analyzedRowCount == 0) {
+        return m_distinctKeys;
+    }
+
+    // assume the key distribution did not change since the last analysis
+    double distinctKeys = m_distinctKeys * ((double)rowCount / (double)m_analyzedRowCount);
+    if (distinctKeys < 1) {
+        distinctKeys = 1;
+    }
+    return distinctKeys;
 }
 
 IndexIterator* Index::ReverseBegin(uint32_t pid) const
@@ -311,6 +331,7 @@ Sentinel* Index::IndexInsert(const Key* key, Row* row, uint32_t pid)
             sentinel->SetNextPtr(row->GetPrimarySentinel());
         }
         MOT_ASSERT(sentinel->IsCommited() == true);
+        UpdateRowCount(1);
         return sentinel;
     }
 }
@@ -57,7 +57,10 @@ protected:
           m_indexExtId(0),
           m_keyPool(nullptr),
           m_sentinelPool(nullptr),
-          m_table(nullptr)
+          m_table(nullptr),
+          m_rowCount(0),
+          m_analyzedRowCount(0),
+          m_distinctKeys(0)
     {}
 
 public:
@@ -207,6 +210,33 @@ public:
      */
     virtual uint64_t GetSize() const;
 
+    /**
+     * @brief Updates the number of committed keys stored in the index.
+     * @param diff The number to change the key count (maybe negative).
+     */
+    inline void UpdateRowCount(int64_t diff)
+    {
+        (void)m_rowCount.fetch_add(diff, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records the number of distinct key values (excluding the non-unique suffix) as estimated by the
+     * most recent table analysis.
+     * @param distinctKeys The estimated number of distinct keys.
+     */
+    inline void SetDistinctKeys(double distinctKeys)
+    {
+        m_analyzedRowCount = GetSize();
+        m_distinctKeys = distinctKeys;
+    }
+
+    /**
+     * @brief Retrieves the estimated number of distinct key values in the index. The value recorded during the
+     * last analysis is scaled by the growth of the index since then.
+     * @return The estimated number of distinct keys, or zero if the index was never analyzed.
+     */
+    double GetDistinctKeys() const;
+
     /**
      * @brief Re-initialize index back to empty and compacted one.
      */
@@ -686,6 +716,15 @@ protected:
 
     Table* m_table;
 
+    /** @var Number of committed keys in the index. Used for execution planning. */
+    std::atomic<int64_t> m_rowCount;
+
+    /** @var Number of keys in the index when the distinct keys estimation was taken. */
+    uint64_t m_analyzedRowCount;
+
+    /** @var Estimated number of distinct keys, as computed by the last table analysis. */
+    double m_distinctKeys;
+
     /**
      * @brief Inserts a single row into the actual data structure that implements the index.
      * @param key Pointer to the key.
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * index_builder.cpp
+ *    Builds a secondary index over a populated table using parallel workers.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/storage/index/index_builder.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <thread>
+#include <vector>
+
+#include "index_builder.h"
+#include "table.h"
+#include "mot_engine.h"
+
+namespace MOT {
+IMPLEMENT_CLASS_LOGGER(IndexBuilder, Storage);
+
+IndexBuilder::IndexBuilder(Table* table, Index* index, uint32_t workerCount)
+    : m_table(table),
+      m_index(index),
+      m_workerCount(workerCount),
+      m_activeWorkers(0),
+      m_stop(false),
+      m_scanDone(false),
+      m_result(RC_OK),
+      m_errorRow(nullptr)
+{}
+
+IndexBuilder::~IndexBuilder()
+{
+    // batches are left in the queue only if the build failed
+    while (!m_batchQueue.empty()) {
+        delete m_batchQueue.front();
+        m_batchQueue.pop();
+    }
+}
+
+RC IndexBuilder::Build(uint32_t tid)
+{
+    IndexIterator* it = m_table->GetPrimaryIndex()->Begin(tid);
+    if (it == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Build Index", "Failed to begin iterating over primary index");
+        return RC_MEMORY_ALLOCATION_ERROR;
+    }
+
+    MOT_LOG_TRACE("Building index %s of table %s with %u workers",
+        m_index->GetName().c_str(),
+        m_table->GetLongTableName().c_str(),
+        m_workerCount);
+    m_activeWorkers = m_workerCount;
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < m_workerCount; ++i) {
+        workers.push_back(std::thread(&IndexBuilder::WorkerFunc, this));
+    }
+
+    // scan the primary index and hand over batches of rows to the workers
+    MaxKey key;
+    RowBatch* batch = nullptr;
+    while (it->IsValid() && !m_stop) {
+        Sentinel* sentinel = it->GetPrimarySentinel();
+        Row* row = sentinel->IsCommited() ? sentinel->GetData() : nullptr;
+        if (row != nullptr) {
+            if (batch == nullptr) {
+                batch = new (std::nothrow) RowBatch();
+                if (batch == nullptr) {
+                    MOT_REPORT_ERROR(MOT_ERROR_OOM, "Build Index", "Failed to allocate row batch");
+                    SetError(RC_MEMORY_ALLOCATION_ERROR, nullptr);
+                    break;
+                }
+                batch->m_count = 0;
+            }
+            batch->m_rows[batch->m_count++] = row;
+            if (batch->m_count == BATCH_SIZE) {
+                (void)PushBatch(batch, key, tid);
+                batch = nullptr;
+            }
+        }
+        it->Next();
+    }
+    delete it;
+
+    if (batch != nullptr) {
+        if (m_stop) {
+            delete batch;
+        } else {
+            (void)PushBatch(batch, key, tid);
+        }
+    }
+
+    SetScanDone();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // check again for a batch that was left behind by the last worker that failed to start
+    while (!m_stop && !m_batchQueue.empty()) {
+        batch = m_batchQueue.front();
+        m_batchQueue.pop();
+        (void)InsertBatch(batch, key, tid);
+        delete batch;
+    }
+
+    if (m_result != RC_OK) {
+        MOT_LOG_TRACE("Failed to build index %s of table %s: %s",
+            m_index->GetName().c_str(),
+            m_table->GetLongTableName().c_str(),
+            RcToString(m_result));
+    }
+    return m_result;
+}
+
+void IndexBuilder::WorkerFunc()
+{
+    // since this is a non-kernel thread we must set-up our own u_sess struct for the current thread
+    MOT_DECLARE_NON_KERNEL_THREAD();
+
+    SessionContext* sessionContext = GetSessionManager()->CreateSessionContext();
+    if (sessionContext == nullptr) {
+        // not fatal, the remaining workers (or the scanning thread) take over
+        MOT_LOG_WARN("Failed to create session context for index build worker, index build performance may be affected");
+        --m_activeWorkers;
+        m_queueNotFull.notify_all();
+        MOTEngine::GetInstance()->OnCurrentThreadEnding();
+        return;
+    }
+
+    MaxKey key;
+    uint32_t tid = MOTCurrThreadId;
+    RowBatch* batch = PopBatch();
+    while (batch != nullptr) {
+        bool result = InsertBatch(batch, key, tid);
+        delete batch;
+        if (!result) {
+            break;
+        }
+        batch = PopBatch();
+    }
+
+    --m_activeWorkers;
+    m_queueNotFull.notify_all();
+    m_index->ClearThreadMemoryCache();
+    GetSessionManager()->DestroySessionContext(sessionContext);
+    MOTEngine::GetInstance()->OnCurrentThreadEnding();
+}
+
+bool IndexBuilder::InsertBatch(RowBatch* batch, MaxKey& key, uint32_t tid)
+{
+    for (uint32_t i = 0; i < batch->m_count; ++i) {
+        if (m_stop) {
+            return false;
+        }
+        Row* row = batch->m_rows[i];
+        key.InitKey(m_index->GetKeyLength());
+        m_index->BuildKey(m_table, row, &key);
+        if (m_index->IndexInsert(&key, row, tid) == nullptr) {
+            SetError(MOT_GET_LAST_ERROR_RC(), row);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IndexBuilder::PushBatch(RowBatch* batch, MaxKey& key, uint32_t tid)
+{
+    std::unique_lock<std::mutex> lock(m_queueLock);
+    uint32_t maxPendingBatches = m_workerCount * MAX_PENDING_BATCHES_PER_WORKER;
+    m_queueNotFull.wait(lock, [this, maxPendingBatches] {
+        return m_stop || (m_activeWorkers == 0) || (m_batchQueue.size() < maxPendingBatches);
+    });
+    if (m_stop) {
+        delete batch;
+        return false;
+    }
+
+    if (m_activeWorkers == 0) {
+        // no worker is available, so insert rows directly
+        lock.unlock();
+        bool result = InsertBatch(batch, key, tid);
+        delete batch;
+        return result;
+    }
+
+    m_batchQueue.push(batch);
+    lock.unlock();
+    m_queueNotEmpty.notify_one();
+    return true;
+}
+
+IndexBuilder::RowBatch* IndexBuilder::PopBatch()
+{
+    RowBatch* batch = nullptr;
+    std::unique_lock<std::mutex> lock(m_queueLock);
+    m_queueNotEmpty.wait(lock, [this] { return m_stop || m_scanDone || !m_batchQueue.empty(); });
+    if (!m_stop && !m_batchQueue.empty()) {
+        batch = m_batchQueue.front();
+        m_batchQueue.pop();
+        lock.unlock();
+        m_queueNotFull.notify_one();
+    }
+    return batch;
+}
+
+void IndexBuilder::SetError(RC rc, Row* row)
+{
+    std::unique_lock<std::mutex> lock(m_queueLock);
+    if (m_result == RC_OK) {
+        m_result = (rc != RC_OK) ? rc : RC_ERROR;
+        m_errorRow = row;
+    }
+    m_stop = true;
+    lock.unlock();
+    m_queueNotEmpty.notify_all();
+    m_queueNotFull.notify_all();
+}
+
+void IndexBuilder::SetScanDone()
+{
+    std::unique_lock<std::mutex> lock(m_queueLock);
+    m_scanDone = true;
+    lock.unlock();
+    m_queueNotEmpty.notify_all();
+}
+}  // namespace MOT
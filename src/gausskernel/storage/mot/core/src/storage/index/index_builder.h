@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * index_builder.h
+ *    Builds a secondary index over a populated table using parallel workers.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/storage/index/index_builder.h
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef INDEX_BUILDER_H
+#define INDEX_BUILDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+#include "index.h"
+
+namespace MOT {
+class Table;
+class Row;
+
+/**
+ * @class IndexBuilder
+ * @brief Builds a secondary index over a populated table. The calling thread scans the primary index and hands over
+ * batches of rows to worker threads, which build the secondary keys and insert them directly into the new index.
+ * @note The index is built non-transactionally, so the caller must ensure no concurrent changes are made to the table,
+ * and that the new index is not visible to any other transaction until the build is complete.
+ */
+class IndexBuilder {
+public:
+    /**
+     * @brief Constructor.
+     * @param table The table whose rows are indexed.
+     * @param index The secondary index to build.
+     * @param workerCount The number of worker threads.
+     */
+    IndexBuilder(Table* table, Index* index, uint32_t workerCount);
+
+    /** @brief Destructor. */
+    ~IndexBuilder();
+
+    /**
+     * @brief Builds the index.
+     * @param tid The logical identifier of the calling thread.
+     * @return The operation result.
+     */
+    RC Build(uint32_t tid);
+
+    /** @brief Retrieves the row that violated a unique index (valid only if build failed with unique violation). */
+    inline Row* GetErrorRow() const
+    {
+        return m_errorRow;
+    }
+
+    /** @brief The minimum number of table rows for which a parallel index build is worthwhile. */
+    static constexpr uint32_t MIN_PARALLEL_BUILD_ROWS = 100000;
+
+private:
+    /** @brief The number of rows handed over to a worker at a time. */
+    static constexpr uint32_t BATCH_SIZE = 4096;
+
+    /** @brief The maximum number of pending batches per worker (limits memory consumption of the scan). */
+    static constexpr uint32_t MAX_PENDING_BATCHES_PER_WORKER = 4;
+
+    /** @struct A batch of rows to insert into the index. */
+    struct RowBatch {
+        /** @var The number of rows in the batch. */
+        uint32_t m_count;
+
+        /** @var The rows in the batch. */
+        Row* m_rows[BATCH_SIZE];
+    };
+
+    /** @brief Worker thread function. */
+    void WorkerFunc();
+
+    /** @brief Inserts all the rows in a batch into the index. */
+    bool InsertBatch(RowBatch* batch, MaxKey& key, uint32_t tid);
+
+    /** @brief Hands over a batch to the workers, or inserts it directly if no worker is available. */
+    bool PushBatch(RowBatch* batch, MaxKey& key, uint32_t tid);
+
+    /** @brief Waits for the next batch to insert. Returns null if scan is done or the build failed. */
+    RowBatch* PopBatch();
+
+    /** @brief Records the first failure of the build and signals all threads to stop. */
+    void SetError(RC rc, Row* row);
+
+    /** @brief Notifies all workers that no more batches will be handed over. */
+    void SetScanDone();
+
+    /** @var The table whose rows are indexed. */
+    Table* m_table;
+
+    /** @var The secondary index being built. */
+    Index* m_index;
+
+    /** @var The number of worker threads. */
+    uint32_t m_workerCount;
+
+    /** @var The number of workers that are still taking batches. */
+    std::atomic<uint32_t> m_activeWorkers;
+
+    /** @var Specifies whether the build failed and all threads should stop. */
+    std::atomic<bool> m_stop;
+
+    /** @var Synchronizes access to the batch queue. */
+    std::mutex m_queueLock;
+
+    /** @var Signaled when a batch is pushed, or when the scan is done. */
+    std::condition_variable m_queueNotEmpty;
+
+    /** @var Signaled when a batch is popped. */
+    std::condition_variable m_queueNotFull;
+
+    /** @var Batches pending for insertion. */
+    std::queue<RowBatch*> m_batchQueue;
+
+    /** @var Specifies whether the primary index scan is done. */
+    bool m_scanDone;
+
+    /** @var The first failure of the build. */
+    RC m_result;
+
+    /** @var The row that caused the build failure. */
+    Row* m_errorRow;
+
+    DECLARE_CLASS_LOGGER()
+};
+}  // namespace MOT
+
+#endif /* INDEX_BUILDER_H */
@@ -233,16 +233,6 @@ public:
      */
     virtual uint64_t GetIndexSize() override;
 
-    /**
-     * @brief Retrieves the number of rows stored in the index. This may be an estimation.
-     * @detail Not implemented.
-     * @return The number of rows stored in the index.
-     */
-    virtual uint64_t GetSize() const
-    {
-        return 0;
-    }
-
     /**
      * @brief Init Masstree memory pools.
      * @return True if succeeded otherwise false.
@@ -32,11 +32,13 @@
 #include "txn_insert_action.h"
 #include "redo_log_writer.h"
 #include "recovery_manager.h"
+#include "index_builder.h"
 
 namespace MOT {
 IMPLEMENT_CLASS_LOGGER(Table, Storage);
 
 std::atomic<uint32_t> Table::tableCounter(0);
+constexpr uint64_t Table::INVALID_MODIFICATION_EPOCH;
 
 Table::~Table()
 {
@@ -104,7 +106,14 @@ bool Table::Init(const char* tableName, const char* longName, unsigned int field
 bool Table::InitRowPool(bool local)
 {
     bool result = true;
-    m_rowPool = ObjAllocInterface::GetObjPool(sizeof(Row) + m_tupleSize, local);
+    if (local) {
+        m_rowPool = ObjAllocInterface::GetObjPool(sizeof(Row) + m_tupleSize, local);
+    } else {
+        m_rowPoolNode =
+            GetGlobalConfiguration().GetTablePlacementNode(m_longTableName.c_str(), m_tableName.c_str());
+        MOT_LOG_DEBUG("Placing rows of table %s on node %d", m_longTableName.c_str(), m_rowPoolNode);
+        m_rowPool = ObjAllocInterface::GetObjPoolOnNode(sizeof(Row) + m_tupleSize, m_rowPoolNode);
+    }
     if (!m_rowPool) {
         MOT_REPORT_ERROR(
             MOT_ERROR_OOM, "Initialize Table", "Failed to allocate row pool for table %s", m_longTableName.c_str());
@@ -196,10 +205,22 @@ bool Table::AddSecondaryIndex(const string& indexName, Index* index, TxnManager*
     return true;
 }
 
+bool Table::IsParallelIndexBuildApplicable() const
+{
+    return (GetGlobalConfiguration().m_parallelIndexBuildWorkers > 1) &&
+           (GetRowCount() >= IndexBuilder::MIN_PARALLEL_BUILD_ROWS);
+}
+
 bool Table::CreateSecondaryIndexDataNonTransactional(Index* index, uint32_t tid)
 {
     MaxKey key;
     bool ret = true;
+
+    if (IsParallelIndexBuildApplicable()) {
+        IndexBuilder builder(this, index, GetGlobalConfiguration().m_parallelIndexBuildWorkers);
+        return (builder.Build(tid) == RC_OK);
+    }
+
     IndexIterator* it = m_indexes[0]->Begin(tid);
 
     // report error if failed to allocate
@@ -241,6 +262,23 @@ bool Table::CreateSecondaryIndexData(Index* index, TxnManager* txn)
     bool error = false;
     Key* key = nullptr;
     bool ret = true;
+
+    // when the transaction has no pending changes all visible rows are committed, so they can be indexed directly
+    if ((txn->m_accessMgr->m_rowCnt == 0) && IsParallelIndexBuildApplicable()) {
+        IndexBuilder builder(this, index, GetGlobalConfiguration().m_parallelIndexBuildWorkers);
+        status = builder.Build(txn->GetThdId());
+        if (status != RC_OK) {
+            GcManager::ClearIndexElements(index->GetIndexId());
+            txn->m_err = (status == RC_UNIQUE_VIOLATION) ? RC_UNIQUE_VIOLATION : RC_MEMORY_ALLOCATION_ERROR;
+            txn->m_errIx = nullptr;
+            if (builder.GetErrorRow() != nullptr) {
+                index->BuildErrorMsg(this, builder.GetErrorRow(), txn->m_errMsgBuf, sizeof(txn->m_errMsgBuf));
+            }
+            return false;
+        }
+        return true;
+    }
+
     IndexIterator* it = m_indexes[0]->Begin(txn->GetThdId());
 
     // report error if failed to allocate
@@ -391,6 +429,7 @@ RC Table::InsertRowNonTransactional(Row* row, uint64_t tid, Key* k, bool isInter
         }
     }
 
+    UpdateRowCount(1);
     return rc;
 }
 
@@ -427,6 +466,81 @@ RC Table::InsertRow(Row* row, TxnManager* txn)
     return txn->InsertRow(row);
 }
 
+RC Table::InsertRowBulk(Row* row, TxnManager* txn)
+{
+    MaxKey primaryKey;
+    MaxKey key;
+    uint64_t surrogateprimaryKey = 0;
+    MOT::Index* ix = GetPrimaryIndex();
+    uint32_t numIndexes = GetNumIndexes();
+    uint32_t tid = txn->GetThdId();
+
+    row->SetRowId(txn->GetSurrogateKey());
+    primaryKey.InitKey(ix->GetKeyLength());
+    if (ix->IsFakePrimary()) {
+        surrogateprimaryKey = htobe64(row->GetRowId());
+        row->SetSurrogateKey(surrogateprimaryKey);
+        primaryKey.CpKey((uint8_t*)&surrogateprimaryKey, sizeof(uint64_t));
+    } else {
+        ix->BuildKey(this, row, &primaryKey);
+    }
+
+    Sentinel* sentinel = ix->IndexInsert(&primaryKey, row, tid);
+    if (sentinel == nullptr) {
+        RC rc = MOT_GET_LAST_ERROR_RC();
+        if (rc == RC_UNIQUE_VIOLATION) {
+            txn->m_errIx = ix;
+            ix->BuildErrorMsg(this, row, txn->m_errMsgBuf, sizeof(txn->m_errMsgBuf));
+        }
+        DestroyRow(row);
+        return rc;
+    }
+    row->SetPrimarySentinel(sentinel);
+    m_bulkLoaded = true;
+
+    for (uint16_t i = 1; i < numIndexes; i++) {
+        ix = GetSecondaryIndex(i);
+        key.InitKey(ix->GetKeyLength());
+        ix->BuildKey(this, row, &key);
+        if (ix->IndexInsert(&key, row, tid) == nullptr) {
+            RC rc = MOT_GET_LAST_ERROR_RC();
+            if (rc == RC_UNIQUE_VIOLATION) {
+                txn->m_errIx = ix;
+                ix->BuildErrorMsg(this, row, txn->m_errMsgBuf, sizeof(txn->m_errMsgBuf));
+            }
+            // the row never reached the access set, so unlink it from every index it was already added to
+            RemoveRowBulk(row, &primaryKey, i, txn);
+            return rc;
+        }
+    }
+
+    UpdateRowCount(1);
+    return RC_OK;
+}
+
+void Table::RemoveRowBulk(Row* row, const Key* primaryKey, uint16_t numInserted, TxnManager* txn)
+{
+    MaxKey key;
+    Sentinel* sentinel = nullptr;
+    MOT::Index* ix = nullptr;
+    uint32_t tid = txn->GetThdId();
+
+    for (uint16_t i = numInserted - 1; i > 0; i--) {
+        ix = GetSecondaryIndex(i);
+        key.InitKey(ix->GetKeyLength());
+        ix->BuildKey(this, row, &key);
+        sentinel = ix->IndexRemove(&key, tid);
+        ix->UpdateRowCount(-1);
+        txn->GcSessionRecordRcu(ix->GetIndexId(), sentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
+    }
+
+    ix = GetPrimaryIndex();
+    sentinel = ix->IndexRemove(primaryKey, tid);
+    ix->UpdateRowCount(-1);
+    txn->GcSessionRecordRcu(ix->GetIndexId(), sentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
+    txn->GcSessionRecordRcu(ix->GetIndexId(), row, nullptr, row->RowDtor, ROW_SIZE_FROM_POOL(this));
+}
+
 Row* Table::RemoveRow(Row* row, uint64_t tid, GcManager* gc)
 {
     MaxKey key;
@@ -446,6 +560,8 @@ Row* Table::RemoveRow(Row* row, uint64_t tid, GcManager* gc)
                 RC rc = currSentinel->RefCountUpdate(DEC, tid);
                 if (rc == RC::RC_INDEX_DELETE) {
                     currSentinel = ix->IndexRemove(&key, tid);
+                    ix->UpdateRowCount(-1);
+                    UpdateRowCount(-1);
                     if (likely(gc != nullptr)) {
                         gc->GcRecordObject(ix->GetIndexId(), currSentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
                         gc->GcRecordObject(ix->GetIndexId(), row, nullptr, row->RowDtor, ROW_SIZE_FROM_POOL(this));
@@ -468,6 +584,7 @@ Row* Table::RemoveRow(Row* row, uint64_t tid, GcManager* gc)
                 RC rc = currSentinel->RefCountUpdate(DEC, tid);
                 if (rc == RC::RC_INDEX_DELETE) {
                     currSentinel = ix->IndexRemove(&key, tid);
+                    ix->UpdateRowCount(-1);
                     if (likely(gc != nullptr)) {
                         gc->GcRecordObject(ix->GetIndexId(), currSentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
                     } else {
@@ -688,7 +805,7 @@ void Table::Truncate(TxnManager* txn)
     GcManager::ClearIndexElements(m_indexes[0]->GetIndexId());
     m_indexes[0]->Truncate(false);
     ObjAllocInterface::FreeObjPool(&m_rowPool);
-    m_rowPool = ObjAllocInterface::GetObjPool(sizeof(Row) + m_tupleSize, false);
+    m_rowPool = ObjAllocInterface::GetObjPoolOnNode(sizeof(Row) + m_tupleSize, m_rowPoolNode);
     if (!m_rowPool) {
         MOT_REPORT_ERROR(MOT_ERROR_OOM,
             "Truncate Table",
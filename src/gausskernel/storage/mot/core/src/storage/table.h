@@ -504,6 +504,12 @@ public:
      */
     bool CreateSecondaryIndexDataNonTransactional(Index* index, uint32_t tid);
 
+    /**
+     * @brief Queries whether a secondary index over the table should be built by parallel workers.
+     * @return True if parallel index build is enabled and the table is large enough.
+     */
+    bool IsParallelIndexBuildApplicable() const;
+
     /**
      * @brief Inserts a new row into transactional storage.
      * @param row. New row to be inserted
@@ -512,6 +518,25 @@ public:
      */
     RC InsertRow(Row* row, TxnManager* txn);
 
+    /**
+     * @brief Inserts a new row directly into the indexes of a table that was created by the given transaction, by-passing
+     * the transaction access set. The rows are written to the redo log together with the table creation, and are
+     * reclaimed together with the table if the transaction aborts.
+     * @param row. New row to be inserted
+     * @param txn The txn manager object that created the table.
+     * @return Status of the operation.
+     */
+    RC InsertRowBulk(Row* row, TxnManager* txn);
+
+    /**
+     * @brief Queries whether rows were inserted into the table through bulk load.
+     * @return True if the table was bulk loaded.
+     */
+    inline bool IsBulkLoaded() const
+    {
+        return m_bulkLoaded;
+    }
+
     /**
      * @brief Create new row placeholder
      * @return The newly created row.
@@ -684,6 +709,44 @@ public:
         return m_rowCount;
     }
 
+    /**
+     * @brief Retrieves the current modification epoch of the table. The epoch advances whenever a committing
+     * transaction starts writing changes to rows of the table.
+     * @return The modification epoch, or @ref INVALID_MODIFICATION_EPOCH if some transaction is currently
+     * writing changes to the table.
+     */
+    inline uint64_t GetModificationEpoch() const
+    {
+        // started count must be read first, so that a commit in progress is never missed
+        uint64_t epoch = m_modificationsStarted.load();
+        return (m_modificationsEnded.load() == epoch) ? epoch : INVALID_MODIFICATION_EPOCH;
+    }
+
+    /**
+     * @brief Queries whether the table was modified since the given epoch was retrieved.
+     * @param epoch The epoch previously retrieved by @ref GetModificationEpoch().
+     * @return True if no transaction started writing changes to the table since the epoch was retrieved.
+     */
+    inline bool IsUnmodifiedSince(uint64_t epoch) const
+    {
+        return (epoch != INVALID_MODIFICATION_EPOCH) && (m_modificationsStarted.load() == epoch);
+    }
+
+    /** @brief Marks the start of writing committed changes to rows of the table. */
+    inline void BeginModification()
+    {
+        ++m_modificationsStarted;
+    }
+
+    /** @brief Marks the end of writing committed changes to rows of the table. */
+    inline void EndModification()
+    {
+        ++m_modificationsEnded;
+    }
+
+    /** @var Denotes a table modification epoch that cannot be used for validation. */
+    static constexpr uint64_t INVALID_MODIFICATION_EPOCH = (uint64_t)-1;
+
     /**
      * @brief Returns table size in memory
      */
@@ -747,6 +810,12 @@ private:
     /** @var row_pool personal row allocator object pool */
     ObjAllocInterface* m_rowPool;
 
+    /** @var The NUMA node on which table rows are placed (interleaved if not pinned to any node). */
+    int m_rowPoolNode = MEM_INTERLEAVE_NODE;
+
+    /** @var Specifies whether rows were inserted into the table through bulk load. */
+    bool m_bulkLoaded = false;
+
     // we have only index-organized-tables (IOT) so this is the pointer to the index
     // representing the table
     /** @var The primary index holding all rows. */
@@ -805,6 +874,12 @@ private:
 
     uint32_t m_rowCount = 0;
 
+    /** @var Number of commits that started writing changes to the table. */
+    std::atomic<uint64_t> m_modificationsStarted{0};
+
+    /** @var Number of commits that finished writing changes to the table. */
+    std::atomic<uint64_t> m_modificationsEnded{0};
+
     DECLARE_CLASS_LOGGER();
 
 public:
@@ -909,6 +984,15 @@ public:
      */
     RC CreateIndexFromMeta(CommonIndexMeta& meta, bool primary, uint32_t tid);
 
+    /**
+     * @brief Unlinks a partially bulk inserted row from the primary index and from the first secondary indexes.
+     * @param row The row to remove.
+     * @param primaryKey The primary key of the row.
+     * @param numInserted The number of indexes (including the primary index) the row was inserted into.
+     * @param txn The txn manager object that inserted the row.
+     */
+    void RemoveRowBulk(Row* row, const Key* primaryKey, uint16_t numInserted, TxnManager* txn);
+
     /**
      * @brief returns the serialized size of a table
      * @param Size_t the size
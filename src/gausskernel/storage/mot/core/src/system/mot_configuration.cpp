@@ -28,6 +28,7 @@
 #include "log_level_formatter.h"
 #include "mm_cfg.h"
 #include "sys_numa_api.h"
+#include "session_context.h"
 
 namespace MOT {
 IMPLEMENT_CLASS_LOGGER(MOTConfiguration, Configuration)
@@ -43,6 +44,9 @@ constexpr bool MOTConfiguration::DEFAULT_ENABLE_GROUP_COMMIT;
 constexpr uint64_t MOTConfiguration::DEFAULT_GROUP_COMMIT_SIZE;
 constexpr const char* MOTConfiguration::DEFAULT_GROUP_COMMIT_TIMEOUT;
 constexpr uint64_t MOTConfiguration::DEFAULT_GROUP_COMMIT_TIMEOUT_USEC;
+constexpr uint32_t MOTConfiguration::DEFAULT_GROUP_COMMIT_LANES;
+constexpr bool MOTConfiguration::DEFAULT_ENABLE_TABLE_EPOCH_VALIDATION;
+constexpr bool MOTConfiguration::DEFAULT_ENABLE_ADAPTIVE_GROUP_COMMIT;
 // checkpoint configuration members
 constexpr bool MOTConfiguration::DEFAULT_ENABLE_CHECKPOINT;
 constexpr bool MOTConfiguration::DEFAULT_ENABLE_INCREMENTAL_CHECKPOINT;
@@ -98,6 +102,8 @@ constexpr uint32_t MOTConfiguration::DEFAULT_MIN_MOT_SESSION_MEMORY_KB;
 constexpr MemReserveMode MOTConfiguration::DEFAULT_RESERVE_MEMORY_MODE;
 constexpr MemStorePolicy MOTConfiguration::DEFAULT_STORE_MEMORY_POLICY;
 constexpr MemAllocPolicy MOTConfiguration::DEFAULT_CHUNK_ALLOC_POLICY;
+constexpr MemHugePageMode MOTConfiguration::DEFAULT_CHUNK_HUGE_PAGE_MODE;
+constexpr const char* MOTConfiguration::DEFAULT_TABLE_PLACEMENT_POLICY;
 constexpr uint32_t MOTConfiguration::DEFAULT_CHUNK_PREALLOC_WORKER_COUNT;
 constexpr uint32_t MOTConfiguration::DEFAULT_HIGH_RED_MARK_PERCENT;
 constexpr const char* MOTConfiguration::DEFAULT_SESSION_LARGE_BUFFER_STORE_SIZE;
@@ -121,6 +127,8 @@ constexpr uint32_t MOTConfiguration::DEFAULT_MOT_CODEGEN_LIMIT;
 // storage configuration
 constexpr bool MOTConfiguration::DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN;
 constexpr IndexTreeFlavor MOTConfiguration::DEFAULT_INDEX_TREE_FLAVOR;
+constexpr uint32_t MOTConfiguration::DEFAULT_PARALLEL_INDEX_BUILD_WORKERS;
+constexpr bool MOTConfiguration::DEFAULT_ENABLE_BULK_LOAD;
 // general configuration members
 constexpr const char* MOTConfiguration::DEFAULT_CFG_MONITOR_PERIOD;
 constexpr uint64_t MOTConfiguration::DEFAULT_CFG_MONITOR_PERIOD_SECONDS;
@@ -293,6 +301,16 @@ static bool ParseChunkAllocPolicy(const std::string& cfgName, const std::string&
     return result;
 }
 
+static bool ParseChunkHugePageMode(const std::string& cfgName, const std::string& variableName,
+    const std::string& newValue, MemHugePageMode* variableValue)
+{
+    bool result = (cfgName == variableName);
+    if (result) {
+        *variableValue = MemHugePageModeFromString(newValue.c_str());
+    }
+    return result;
+}
+
 bool MOTConfiguration::FindNumaNodes(int* maxNodes)
 {
     int error = MotSysNumaAvailable();
@@ -385,6 +403,8 @@ MOTConfiguration::MOTConfiguration()
       m_enableGroupCommit(DEFAULT_ENABLE_GROUP_COMMIT),
       m_groupCommitSize(DEFAULT_GROUP_COMMIT_SIZE),
       m_groupCommitTimeoutUSec(DEFAULT_GROUP_COMMIT_TIMEOUT_USEC),
+      m_groupCommitLanes(DEFAULT_GROUP_COMMIT_LANES),
+      m_enableAdaptiveGroupCommit(DEFAULT_ENABLE_ADAPTIVE_GROUP_COMMIT),
       m_enableCheckpoint(DEFAULT_ENABLE_CHECKPOINT),
       m_enableIncrementalCheckpoint(DEFAULT_ENABLE_INCREMENTAL_CHECKPOINT),
       m_checkpointDir(DEFAULT_CHECKPOINT_DIR),
@@ -395,6 +415,7 @@ MOTConfiguration::MOTConfiguration()
       m_abortBufferEnable(true),
       m_preAbort(true),
       m_validationLock(TxnValidation::TXN_VALIDATION_NO_WAIT),
+      m_enableTableEpochValidation(DEFAULT_ENABLE_TABLE_EPOCH_VALIDATION),
       m_numaNodes(DEFAULT_NUMA_NODES),
       m_coresPerCpu(DEFAULT_CORES_PER_CPU),
       m_dataNodeId(DEFAULT_DATA_NODE_ID),
@@ -429,6 +450,8 @@ MOTConfiguration::MOTConfiguration()
       m_reserveMemoryMode(DEFAULT_RESERVE_MEMORY_MODE),
       m_storeMemoryPolicy(DEFAULT_STORE_MEMORY_POLICY),
       m_chunkAllocPolicy(DEFAULT_CHUNK_ALLOC_POLICY),
+      m_chunkHugePageMode(DEFAULT_CHUNK_HUGE_PAGE_MODE),
+      m_tablePlacementPolicy(DEFAULT_TABLE_PLACEMENT_POLICY),
       m_chunkPreallocWorkerCount(DEFAULT_CHUNK_PREALLOC_WORKER_COUNT),
       m_highRedMarkPercent(DEFAULT_HIGH_RED_MARK_PERCENT),
       m_sessionLargeBufferStoreSizeMB(DEFAULT_SESSION_LARGE_BUFFER_STORE_SIZE_MB),
@@ -444,6 +467,8 @@ MOTConfiguration::MOTConfiguration()
       m_codegenLimit(DEFAULT_MOT_CODEGEN_LIMIT),
       m_allowIndexOnNullableColumn(DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN),
       m_indexTreeFlavor(DEFAULT_INDEX_TREE_FLAVOR),
+      m_parallelIndexBuildWorkers(DEFAULT_PARALLEL_INDEX_BUILD_WORKERS),
+      m_enableBulkLoad(DEFAULT_ENABLE_BULK_LOAD),
       m_configMonitorPeriodSeconds(DEFAULT_CFG_MONITOR_PERIOD_SECONDS),
       m_runInternalConsistencyValidation(DEFAULT_RUN_INTERNAL_CONSISTENCY_VALIDATION),
       m_totalMemoryMb(DEFAULT_TOTAL_MEMORY_MB)
@@ -480,6 +505,8 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseBool(name, "enable_group_commit", value, &m_enableGroupCommit)) {
     } else if (ParseUint64(name, "group_commit_size", value, &m_groupCommitSize)) {
     } else if (ParseUint64(name, "group_commit_timeout_usec", value, &m_groupCommitTimeoutUSec)) {
+    } else if (ParseUint32(name, "group_commit_lanes", value, &m_groupCommitLanes)) {
+    } else if (ParseBool(name, "enable_adaptive_group_commit", value, &m_enableAdaptiveGroupCommit)) {
     } else if (ParseBool(name, "enable_checkpoint", value, &m_enableCheckpoint)) {
     } else if (ParseBool(name, "enable_incremental_checkpoint", value, &m_enableIncrementalCheckpoint)) {
     } else if (ParseString(name, "checkpoint_dir", value, &m_checkpointDir)) {
@@ -490,6 +517,7 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseBool(name, "abort_buffer_enable", value, &m_abortBufferEnable)) {
     } else if (ParseBool(name, "pre_abort", value, &m_preAbort)) {
     } else if (ParseValidation(name, "validation_lock", value, &m_validationLock)) {
+    } else if (ParseBool(name, "enable_table_epoch_validation", value, &m_enableTableEpochValidation)) {
     } else if (ParseBool(name, "enable_stats", value, &m_enableStats)) {
     } else if (ParseUint32(name, "stats_period_seconds", value, &m_statPrintPeriodSeconds)) {
     } else if (ParseUint32(name, "full_stats_period_seconds", value, &m_statPrintFullPeriodSeconds)) {
@@ -519,6 +547,8 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseMemoryReserveMode(name, "reserve_memory_mode", value, &m_reserveMemoryMode)) {
     } else if (ParseMemoryStorePolicy(name, "store_memory_policy", value, &m_storeMemoryPolicy)) {
     } else if (ParseChunkAllocPolicy(name, "chunk_alloc_policy", value, &m_chunkAllocPolicy)) {
+    } else if (ParseChunkHugePageMode(name, "chunk_huge_page_mode", value, &m_chunkHugePageMode)) {
+    } else if (ParseString(name, "table_placement_policy", value, &m_tablePlacementPolicy)) {
     } else if (ParseUint32(name, "chunk_prealloc_worker_count", value, &m_chunkPreallocWorkerCount)) {
     } else if (ParseUint32(name, "high_red_mark_percent", value, &m_highRedMarkPercent)) {
     } else if (ParseUint32(name, "session_large_buffer_store_size_mb", value, &m_sessionLargeBufferStoreSizeMB)) {
@@ -533,6 +563,8 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseUint32(name, "mot_codegen_limit", value, &m_codegenLimit)) {
     } else if (ParseBool(name, "allow_index_on_nullable_column", value, &m_allowIndexOnNullableColumn)) {
     } else if (ParseIndexTreeFlavor(name, "index_tree_flavor", value, &m_indexTreeFlavor)) {
+    } else if (ParseUint32(name, "parallel_index_build_workers", value, &m_parallelIndexBuildWorkers)) {
+    } else if (ParseBool(name, "enable_bulk_load", value, &m_enableBulkLoad)) {
     } else if (ParseUint64(name, "config_monitor_period_seconds", value, &m_configMonitorPeriodSeconds)) {
     } else if (ParseBool(name, "run_internal_consistency_validation", value, &m_runInternalConsistencyValidation)) {
     } else {
@@ -594,6 +626,53 @@ int MOTConfiguration::GetMappedCore(int logicId) const
     return -1;
 }
 
+int MOTConfiguration::GetTablePlacementNode(const char* longTableName, const char* tableName) const
+{
+    const char* policy = m_tablePlacementPolicy.c_str();
+    const LayeredConfigTree* cfg = ConfigManager::GetInstance().GetLayeredConfigTree();
+    const ConfigSection* cfgSection = (cfg != nullptr) ? cfg->GetConfigSection("TablePlacement") : nullptr;
+    if (cfgSection != nullptr) {
+        // table specific placement is configured as TablePlacement/<table name>=<policy>
+        const TypedConfigValue<mot_string>* cfgValue = cfgSection->GetConfigValue<mot_string>(longTableName);
+        if (cfgValue == nullptr) {
+            cfgValue = cfgSection->GetConfigValue<mot_string>(tableName);
+        }
+        if (cfgValue != nullptr) {
+            policy = cfgValue->GetValue().c_str();
+        }
+    }
+
+    int node = MEM_INTERLEAVE_NODE;
+    if (strcmp(policy, "local") == 0) {
+        if (MOTCurrentNumaNodeId >= 0) {
+            node = MOTCurrentNumaNodeId;
+        }
+    } else if (strncmp(policy, "node:", strlen("node:")) == 0) {
+        char* endptr = nullptr;
+        long pinnedNode = strtol(policy + strlen("node:"), &endptr, 0);
+        if ((endptr != nullptr) && (*endptr == 0) && (pinnedNode >= 0) && (pinnedNode < (long)m_numaNodes)) {
+            node = (int)pinnedNode;
+        } else {
+            MOT_LOG_WARN("Invalid NUMA node in placement policy '%s' of table %s, using interleaved placement",
+                policy,
+                longTableName);
+        }
+    } else if (strcmp(policy, "interleaved") != 0) {
+        MOT_LOG_WARN("Invalid placement policy '%s' for table %s, using interleaved placement", policy, longTableName);
+    }
+
+    // global chunks come from the pinned node only when each chunk is allocated on the node of its pool
+    if ((node != MEM_INTERLEAVE_NODE) && (g_memGlobalCfg.m_chunkAllocPolicy != MEM_ALLOC_POLICY_LOCAL)) {
+        MOT_LOG_WARN("Placement policy '%s' of table %s has no effect with chunk_alloc_policy '%s', using "
+                     "interleaved placement",
+            policy,
+            longTableName,
+            MemAllocPolicyToString(g_memGlobalCfg.m_chunkAllocPolicy));
+        node = MEM_INTERLEAVE_NODE;
+    }
+    return node;
+}
+
 #define UPDATE_CFG(var, cfgPath, defaultValue) \
     UpdateConfigItem(var, cfg->GetConfigValue(cfgPath, defaultValue), cfgPath)
 
@@ -641,6 +720,8 @@ void MOTConfiguration::LoadConfig()
     UPDATE_CFG(m_enableGroupCommit, "enable_group_commit", DEFAULT_ENABLE_GROUP_COMMIT);
     UPDATE_INT_CFG(m_groupCommitSize, "group_commit_size", DEFAULT_GROUP_COMMIT_SIZE);
     UPDATE_TIME_CFG(m_groupCommitTimeoutUSec, "group_commit_timeout", DEFAULT_GROUP_COMMIT_TIMEOUT, 1);
+    UPDATE_INT_CFG(m_groupCommitLanes, "group_commit_lanes", DEFAULT_GROUP_COMMIT_LANES);
+    UPDATE_CFG(m_enableAdaptiveGroupCommit, "enable_adaptive_group_commit", DEFAULT_ENABLE_ADAPTIVE_GROUP_COMMIT);
 
     // Checkpoint configuration
     UPDATE_CFG(m_enableCheckpoint, "enable_checkpoint", DEFAULT_ENABLE_CHECKPOINT);
@@ -656,6 +737,8 @@ void MOTConfiguration::LoadConfig()
     UPDATE_CFG(m_abortBufferEnable, "tx_abort_buffers_enable", true);
     UPDATE_CFG(m_preAbort, "tx_pre_abort", true);
     m_validationLock = TxnValidation::TXN_VALIDATION_NO_WAIT;
+    UPDATE_CFG(
+        m_enableTableEpochValidation, "enable_table_epoch_validation", DEFAULT_ENABLE_TABLE_EPOCH_VALIDATION);
 
     // statistics configuration
     UPDATE_CFG(m_enableStats, "enable_stats", DEFAULT_ENABLE_STATS);
@@ -697,6 +780,8 @@ void MOTConfiguration::LoadConfig()
     UPDATE_USER_CFG(m_reserveMemoryMode, "reserve_memory_mode", DEFAULT_RESERVE_MEMORY_MODE);
     UPDATE_USER_CFG(m_storeMemoryPolicy, "store_memory_policy", DEFAULT_STORE_MEMORY_POLICY);
     UPDATE_USER_CFG(m_chunkAllocPolicy, "chunk_alloc_policy", DEFAULT_CHUNK_ALLOC_POLICY);
+    UPDATE_USER_CFG(m_chunkHugePageMode, "chunk_huge_page_mode", DEFAULT_CHUNK_HUGE_PAGE_MODE);
+    UPDATE_STRING_CFG(m_tablePlacementPolicy, "table_placement_policy", DEFAULT_TABLE_PLACEMENT_POLICY);
     UPDATE_INT_CFG(m_chunkPreallocWorkerCount, "chunk_prealloc_worker_count", DEFAULT_CHUNK_PREALLOC_WORKER_COUNT);
     UPDATE_INT_CFG(m_highRedMarkPercent, "high_red_mark_percent", DEFAULT_HIGH_RED_MARK_PERCENT);
     UPDATE_ABS_MEM_CFG(m_sessionLargeBufferStoreSizeMB,
@@ -725,6 +810,8 @@ void MOTConfiguration::LoadConfig()
     // storage configuration
     UPDATE_CFG(m_allowIndexOnNullableColumn, "allow_index_on_nullable_column", DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN);
     UPDATE_USER_CFG(m_indexTreeFlavor, "index_tree_flavor", DEFAULT_INDEX_TREE_FLAVOR);
+    UPDATE_INT_CFG(m_parallelIndexBuildWorkers, "parallel_index_build_workers", DEFAULT_PARALLEL_INDEX_BUILD_WORKERS);
+    UPDATE_CFG(m_enableBulkLoad, "enable_bulk_load", DEFAULT_ENABLE_BULK_LOAD);
 
     // general configuration
     UPDATE_TIME_CFG(m_configMonitorPeriodSeconds, "config_update_period", DEFAULT_CFG_MONITOR_PERIOD, 1000000);
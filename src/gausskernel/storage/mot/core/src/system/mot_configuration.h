@@ -135,6 +135,12 @@ public:
     /** @var Timeout in micro-seconds of timed group commit flush policies. */
     uint64_t m_groupCommitTimeoutUSec;
 
+    /** @var Number of parallel group commit lanes per NUMA node. */
+    uint32_t m_groupCommitLanes;
+
+    /** @var Enables adapting the group commit size to the observed commit latency. */
+    bool m_enableAdaptiveGroupCommit;
+
     /**********************************************************************/
     // Checkpoint configuration
     /**********************************************************************/
@@ -171,6 +177,9 @@ public:
     bool m_preAbort;
     TxnValidation m_validationLock;
 
+    /** @var Enables skipping read-set validation of rows in tables not modified since they were read. */
+    bool m_enableTableEpochValidation;
+
     /**********************************************************************/
     // Machine configuration (not configurable, but loaded from system info)
     /**********************************************************************/
@@ -285,6 +294,12 @@ public:
     /** @var Specifies the chunk allocation policy for the global chunk pools. */
     MemAllocPolicy m_chunkAllocPolicy;
 
+    /** @var Specifies whether chunks allocated from kernel are backed by huge pages. */
+    MemHugePageMode m_chunkHugePageMode;
+
+    /** @var The default placement policy for table rows (interleaved, local or node:<id>). */
+    std::string m_tablePlacementPolicy;
+
     /** @var The number of worker threads used to allocate memory chunks for initial memory reservation. */
     uint32_t m_chunkPreallocWorkerCount;
 
@@ -339,6 +354,12 @@ public:
     /** @var Specifies the tree flavor for tree indexes. */
     IndexTreeFlavor m_indexTreeFlavor;
 
+    /** @var The number of worker threads used to build a secondary index over a populated table. */
+    uint32_t m_parallelIndexBuildWorkers;
+
+    /** @var Specifies whether COPY into a table created by the same transaction bypasses the access set. */
+    bool m_enableBulkLoad;
+
     /**********************************************************************/
     // General configuration
     /**********************************************************************/
@@ -364,6 +385,16 @@ public:
 
     int GetMappedCore(int logicId) const;
 
+    /**
+     * @brief Retrieves the NUMA node on which the rows of a table should be placed. The table is first looked up by
+     * its long name and then by its short name in the TablePlacement configuration section, and if not found there
+     * the default table placement policy applies.
+     * @param longTableName The long name of the table.
+     * @param tableName The short name of the table.
+     * @return The NUMA node identifier, or @ref MEM_INTERLEAVE_NODE if table rows should not be pinned to any node.
+     */
+    int GetTablePlacementNode(const char* longTableName, const char* tableName) const;
+
     void SetMaskToAllCoresinNumaSocket(cpu_set_t& mask, uint64_t threadId);
 
     void SetMaskToAllCoresinNumaSocket2(cpu_set_t& mask, int nodeId);
@@ -413,6 +444,15 @@ private:
     /** @var Default group commit timeout in micro-seconds. */
     static constexpr uint64_t DEFAULT_GROUP_COMMIT_TIMEOUT_USEC = 10000;
 
+    /** @var Default enable table epoch validation. */
+    static constexpr bool DEFAULT_ENABLE_TABLE_EPOCH_VALIDATION = true;
+
+    /** @var Default number of parallel group commit lanes per NUMA node. */
+    static constexpr uint32_t DEFAULT_GROUP_COMMIT_LANES = 1;
+
+    /** @var Default enable adaptive group commit size. */
+    static constexpr bool DEFAULT_ENABLE_ADAPTIVE_GROUP_COMMIT = false;
+
     // default checkpoint configuration
     /** @var Default enable checkpoint. */
     static constexpr bool DEFAULT_ENABLE_CHECKPOINT = true;
@@ -549,6 +589,12 @@ private:
     /** @var Default chunk allocation policy for global chunk pools. */
     static constexpr MemAllocPolicy DEFAULT_CHUNK_ALLOC_POLICY = MEM_ALLOC_POLICY_AUTO;
 
+    /** @var Default huge page backing mode for chunks. */
+    static constexpr MemHugePageMode DEFAULT_CHUNK_HUGE_PAGE_MODE = MEM_HUGE_PAGE_NONE;
+
+    /** @var Default placement policy for table rows. */
+    static constexpr const char* DEFAULT_TABLE_PLACEMENT_POLICY = "interleaved";
+
     /** @var Default number of workers used to pre-allocate initial memory.  */
     static constexpr uint32_t DEFAULT_CHUNK_PREALLOC_WORKER_COUNT = 8;
 
@@ -602,6 +648,12 @@ private:
     /** @var The default tree flavor for tree indexes. */
     static constexpr IndexTreeFlavor DEFAULT_INDEX_TREE_FLAVOR = IndexTreeFlavor::INDEX_TREE_FLAVOR_MASSTREE;
 
+    /** @var The default number of secondary index build workers. */
+    static constexpr uint32_t DEFAULT_PARALLEL_INDEX_BUILD_WORKERS = 4;
+
+    /** @var The default bulk load mode for COPY into new tables. */
+    static constexpr bool DEFAULT_ENABLE_BULK_LOAD = true;
+
     // default general configuration
     /** @var Default configuration monitor period in seconds. */
     static constexpr const char* DEFAULT_CFG_MONITOR_PERIOD = "5 seconds";
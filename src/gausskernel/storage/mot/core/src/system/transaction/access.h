@@ -134,6 +134,9 @@ public:
     /** @var OCC transaction identifier. */
     TransactionId m_tid = 0;
 
+    /** @var Modification epoch of the row's table when the row was read (invalid if not recorded). */
+    uint64_t m_tableEpoch = (uint64_t)-1;
+
     /** @var Local access parameters */
     AccessParams<uint8_t> m_params;
 
@@ -742,6 +742,7 @@ bool TxnManager::Init(uint64_t _thread_id, uint64_t connection_id, bool isLightT
     }
 
     m_occManager.SetPreAbort(GetGlobalConfiguration().m_preAbort);
+    m_occManager.SetTableEpochValidation(GetGlobalConfiguration().m_enableTableEpochValidation);
     if (validation_lock == TxnValidation::TXN_VALIDATION_NO_WAIT)
         m_occManager.SetValidationNoWait(true);
     else if (validation_lock == TxnValidation::TXN_VALIDATION_WAITING) {
@@ -1068,6 +1069,12 @@ RC TxnManager::CreateTable(Table* table)
     return RC_OK;
 }
 
+bool TxnManager::IsTableCreated(Table* table)
+{
+    TxnDDLAccess::DDLAccess* ddl_access = m_txnDdlAccess->GetByOid(table->GetTableExId());
+    return ((ddl_access != nullptr) && (ddl_access->GetDDLAccessType() == DDL_ACCESS_CREATE_TABLE));
+}
+
 RC TxnManager::DropTable(Table* table)
 {
     RC res = RC_OK;
@@ -506,6 +506,14 @@ public:
     Index* GetIndex(Table* table, uint16_t position);
     RC CreateTable(Table* table);
     RC DropTable(Table* table);
+
+    /**
+     * @brief Queries whether a table was created by this transaction (and is therefore not visible to any other
+     * transaction until commit).
+     * @param table The table to check.
+     * @return True if the table was created by this transaction.
+     */
+    bool IsTableCreated(Table* table);
     RC CreateIndex(Table* table, Index* index, bool is_primary);
     RC DropIndex(Index* index);
     RC TruncateTable(Table* table);
@@ -321,6 +321,10 @@ Access* TxnAccess::GetNewRowAccess(const Row* row, AccessType type, RC& rc)
             ac->m_modifiedColumns.Reset(fieldCount);
         }
 
+        // the table epoch must be recorded before the row is read, so that any later commit to the row is detected
+        ac->m_tableEpoch = GetGlobalConfiguration().m_enableTableEpochValidation
+                               ? row->GetTable()->GetModificationEpoch()
+                               : Table::INVALID_MODIFICATION_EPOCH;
         rc = row->GetRow(type, this, ac->m_localRow, last_tid);
         if (__builtin_expect(rc != RC_OK, 0)) {
             if (rc != RC_ABORT) {  // do not log error if aborted due to cc conflict
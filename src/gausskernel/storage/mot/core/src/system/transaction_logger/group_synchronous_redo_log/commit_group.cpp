@@ -40,6 +40,9 @@ CommitGroup::CommitGroup(RedoLogBuffer* buffer, GroupSyncRedoLogHandler* handler
       m_numWaiters(0),
       m_commited(false),
       m_closed(false),
+      m_timedOut(false),
+      m_startTime(std::chrono::steady_clock::now()),
+      m_fillTime(0),
       m_groupCommitedCV(),
       m_commitMutex(),
       m_fullGroupCV(),
@@ -96,11 +99,13 @@ void CommitGroup::WaitLeader(std::shared_ptr<CommitGroup> groupRef)
 {
     m_numWaiters.fetch_add(1);
     std::unique_lock<std::mutex> lock(m_fullGroupMutex);
-    m_fullGroupCV.wait_for(lock, m_groupTimeout, [this] { return m_groupSize >= m_maxGroupCommitSize; });
+    m_timedOut =
+        !m_fullGroupCV.wait_for(lock, m_groupTimeout, [this] { return m_groupSize >= m_maxGroupCommitSize; });
     m_rwlock.WrLock();
     m_closed = true;
     m_handler->CloseGroup(groupRef);
     m_rwlock.WrUnlock();
+    m_fillTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTime);
 }
 
 void CommitGroup::WaitMember()
@@ -121,8 +126,12 @@ void CommitGroup::WaitMember()
 void CommitGroup::CommitInternal()
 {
     std::unique_lock<std::mutex> lock(m_commitMutex);
+    std::chrono::steady_clock::time_point flushStart = std::chrono::steady_clock::now();
     LogGroup();
     lock.unlock();
     m_groupCommitedCV.notify_all();
+    std::chrono::microseconds flushTime =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - flushStart);
+    m_handler->OnGroupCommitted(m_groupSize, m_fillTime, flushTime, m_timedOut);
 }
 }  // namespace MOT
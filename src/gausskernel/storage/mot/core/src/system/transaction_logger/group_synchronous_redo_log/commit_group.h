@@ -81,6 +81,9 @@ private:
     volatile std::atomic<uint32_t> m_numWaiters;
     volatile bool m_commited;
     volatile bool m_closed;
+    bool m_timedOut;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::chrono::microseconds m_fillTime;
     RedoLogBuffer* m_groupData[MAX_GROUP_SIZE];
     std::condition_variable m_groupCommitedCV;
     std::mutex m_commitMutex;
@@ -23,6 +23,8 @@
  * -------------------------------------------------------------------------
  */
 
+#include <algorithm>
+
 #include "group_synchronous_redo_log_handler.h"
 #include "utilities.h"
 #include "mot_configuration.h"
@@ -30,7 +32,17 @@
 namespace MOT {
 DECLARE_LOGGER(GroupSyncRedoLogHandler, RedoLog)
 
-GroupSyncRedoLogHandler::GroupSyncRedoLogHandler(const uint8_t socketId) : m_id(socketId), m_currentGroup(nullptr)
+constexpr uint32_t GroupSyncRedoLogHandler::MIN_GROW_HOLDOFF;
+constexpr uint32_t GroupSyncRedoLogHandler::MAX_GROW_HOLDOFF;
+
+GroupSyncRedoLogHandler::GroupSyncRedoLogHandler(const uint8_t socketId)
+    : m_id(socketId),
+      m_currentGroup(nullptr),
+      m_adaptive(false),
+      m_maxGroupCommitSize(0),
+      m_growHoldoff(MIN_GROW_HOLDOFF),
+      m_fastGroups(0),
+      m_lastGrown(false)
 {
     m_groupCommitSize = GetGlobalConfiguration().m_groupCommitSize;
     m_groupTimeout = std::chrono::microseconds(GetGlobalConfiguration().m_groupCommitTimeoutUSec);
@@ -68,7 +80,14 @@ void GroupSyncRedoLogHandler::CloseGroup(std::shared_ptr<CommitGroup> group)
     uint64_t curGroupCommitSize = GetGlobalConfiguration().m_groupCommitSize;
     std::chrono::microseconds curGroupCommitTimeoutUSec =
         std::chrono::microseconds(GetGlobalConfiguration().m_groupCommitTimeoutUSec);
-    if (curGroupCommitSize != m_groupCommitSize) {
+    if (m_adaptive) {
+        // in adaptive mode the configured size only bounds the group size
+        std::lock_guard<std::mutex> lock(m_adaptiveLock);
+        m_maxGroupCommitSize = std::min(curGroupCommitSize, (uint64_t)MAX_GROUP_SIZE);
+        if (m_groupCommitSize > m_maxGroupCommitSize) {
+            m_groupCommitSize = m_maxGroupCommitSize;
+        }
+    } else if (curGroupCommitSize != m_groupCommitSize) {
         m_groupCommitSize = curGroupCommitSize;
         MOT_LOG_DEBUG("closeGroup: group commit size changed to %lu", m_groupCommitSize);
     }
@@ -79,6 +98,61 @@ void GroupSyncRedoLogHandler::CloseGroup(std::shared_ptr<CommitGroup> group)
     }
 }
 
+void GroupSyncRedoLogHandler::EnableAdaptiveGroupSize()
+{
+    std::lock_guard<std::mutex> lock(m_adaptiveLock);
+    m_adaptive = true;
+    m_maxGroupCommitSize = std::min(m_groupCommitSize, (uint64_t)MAX_GROUP_SIZE);
+    m_groupCommitSize = 1;  // start small, grow according to load
+}
+
+void GroupSyncRedoLogHandler::OnGroupCommitted(
+    uint32_t groupSize, std::chrono::microseconds fillTime, std::chrono::microseconds flushTime, bool timedOut)
+{
+    if (!m_adaptive) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_adaptiveLock);
+    uint64_t prevGroupCommitSize = m_groupCommitSize;
+    if (timedOut) {
+        // not enough concurrent committers to fill the group within the timeout, so shrink to the observed size
+        m_groupCommitSize = std::max((uint64_t)groupSize, (uint64_t)1);
+        m_fastGroups = 0;
+        if (m_lastGrown) {
+            // last growth was premature, so wait longer before trying again
+            m_growHoldoff = std::min(m_growHoldoff * 2, MAX_GROW_HOLDOFF);
+            m_lastGrown = false;
+        }
+    } else if ((fillTime + flushTime) * 2 < m_groupTimeout) {
+        // group filled up well within the latency budget, so more committers can be batched together
+        m_lastGrown = false;
+        if ((++m_fastGroups >= m_growHoldoff) && (m_groupCommitSize < m_maxGroupCommitSize)) {
+            m_groupCommitSize = std::min(m_groupCommitSize + (m_groupCommitSize + 1) / 2, m_maxGroupCommitSize);
+            m_fastGroups = 0;
+            m_lastGrown = true;
+        }
+    } else {
+        // group is full but the latency budget is exhausted, so stay at current size
+        m_fastGroups = 0;
+        if (m_lastGrown) {
+            m_growHoldoff = MIN_GROW_HOLDOFF;
+            m_lastGrown = false;
+        }
+    }
+
+    if (m_groupCommitSize != prevGroupCommitSize) {
+        MOT_LOG_DEBUG("Handler %u: group commit size changed from %lu to %lu (group size %u, fill time %lu us, "
+                      "flush time %lu us)",
+            (unsigned)m_id,
+            prevGroupCommitSize,
+            m_groupCommitSize,
+            groupSize,
+            (uint64_t)fillTime.count(),
+            (uint64_t)flushTime.count());
+    }
+}
+
 RedoLogBuffer* GroupSyncRedoLogHandler::WriteToLog(RedoLogBuffer* buffer)
 {
     // CAS requires and actual shared_ptr
@@ -29,6 +29,7 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include "redo_log_handler.h"
 #include "commit_group.h"
 
@@ -82,11 +83,41 @@ public:
         m_id = handlerId;
     }
 
+    /**
+     * @brief Enables adapting the group size to the observed commit latency. The configured group commit size
+     * serves as the maximum group size.
+     */
+    void EnableAdaptiveGroupSize();
+
+    /**
+     * @brief Reports the outcome of a committed group (called by the group leader).
+     * @param groupSize The number of transactions in the group.
+     * @param fillTime The time passed since the group was opened until it was closed.
+     * @param flushTime The time it took to write the group to the log.
+     * @param timedOut Specifies whether the group was closed due to timeout before it was full.
+     */
+    void OnGroupCommitted(uint32_t groupSize, std::chrono::microseconds fillTime, std::chrono::microseconds flushTime,
+        bool timedOut);
+
 private:
+    /** @brief Number of consecutive quickly-filled groups required before growing the group size. */
+    static constexpr uint32_t MIN_GROW_HOLDOFF = 8;
+
+    /** @brief Maximum number of groups to wait before trying to grow the group size again. */
+    static constexpr uint32_t MAX_GROW_HOLDOFF = 1024;
+
     uint8_t m_id;  // in segmented group handler, represents the socket id, otherwise 0
     std::shared_ptr<CommitGroup> m_currentGroup;
     uint64_t m_groupCommitSize;
     std::chrono::microseconds m_groupTimeout;
+
+    // adaptive group size state (protected by m_adaptiveLock)
+    bool m_adaptive;
+    uint64_t m_maxGroupCommitSize;
+    uint32_t m_growHoldoff;
+    uint32_t m_fastGroups;
+    bool m_lastGrown;
+    std::mutex m_adaptiveLock;
 };
 } /* namespace MOT */
 
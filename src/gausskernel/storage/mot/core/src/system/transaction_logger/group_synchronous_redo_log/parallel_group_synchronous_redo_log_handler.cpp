@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * parallel_group_synchronous_redo_log_handler.cpp
+ *    Implements a group commit redo log with several parallel lanes per numa node.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/system/transaction_logger/
+ *        group_synchronous_redo_log/parallel_group_synchronous_redo_log_handler.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "parallel_group_synchronous_redo_log_handler.h"
+#include "utilities.h"
+#include "mot_configuration.h"
+#include "session_context.h"
+
+namespace MOT {
+DECLARE_LOGGER(ParallelGroupSyncRedoLogHandler, redolog);
+
+ParallelGroupSyncRedoLogHandler::ParallelGroupSyncRedoLogHandler()
+    : m_numaNodes(GetGlobalConfiguration().m_numaNodes),
+      m_lanesPerNode(GetGlobalConfiguration().m_groupCommitLanes),
+      m_laneArray(nullptr)
+{}
+
+bool ParallelGroupSyncRedoLogHandler::Init()
+{
+    if (m_lanesPerNode == 0) {
+        m_lanesPerNode = 1;
+    } else if (m_lanesPerNode * m_numaNodes > MAX_LANES) {
+        m_lanesPerNode = MAX_LANES / m_numaNodes;
+        MOT_LOG_WARN("Number of group commit lanes per NUMA node truncated to %u", m_lanesPerNode);
+    }
+
+    unsigned int laneCount = m_numaNodes * m_lanesPerNode;
+    m_laneArray = new (std::nothrow) GroupSyncRedoLogHandler[laneCount];
+    if (m_laneArray == nullptr) {
+        MOT_LOG_ERROR("Error allocating group commit lane array");
+        return false;
+    }
+
+    bool adaptive = GetGlobalConfiguration().m_enableAdaptiveGroupCommit;
+    for (unsigned int i = 0; i < laneCount; i++) {
+        m_laneArray[i].SetId(i);
+        if (adaptive) {
+            m_laneArray[i].EnableAdaptiveGroupSize();
+        }
+    }
+    MOT_LOG_INFO("Parallel group commit initialized with %u lanes per NUMA node (adaptive group size: %s)",
+        m_lanesPerNode,
+        adaptive ? "true" : "false");
+    return true;
+}
+
+ParallelGroupSyncRedoLogHandler::~ParallelGroupSyncRedoLogHandler()
+{
+    if (m_laneArray != nullptr) {
+        delete[] m_laneArray;
+        m_laneArray = nullptr;
+    }
+}
+
+inline GroupSyncRedoLogHandler& ParallelGroupSyncRedoLogHandler::GetCurrentLane()
+{
+    // threads of the same NUMA node are spread across the lanes of the node
+    unsigned int lane = MOTCurrentNumaNodeId * m_lanesPerNode;
+    if (m_lanesPerNode > 1) {
+        lane += MOTCurrThreadId % m_lanesPerNode;
+    }
+    return m_laneArray[lane];
+}
+
+RedoLogBuffer* ParallelGroupSyncRedoLogHandler::CreateBuffer()
+{
+    return GetCurrentLane().CreateBuffer();
+}
+
+void ParallelGroupSyncRedoLogHandler::DestroyBuffer(RedoLogBuffer* buffer)
+{
+    GetCurrentLane().DestroyBuffer(buffer);
+}
+
+RedoLogBuffer* ParallelGroupSyncRedoLogHandler::WriteToLog(RedoLogBuffer* buffer)
+{
+    return GetCurrentLane().WriteToLog(buffer);
+}
+
+void ParallelGroupSyncRedoLogHandler::SetLogger(ILogger* logger)
+{
+    RedoLogHandler::SetLogger(logger);
+    unsigned int laneCount = m_numaNodes * m_lanesPerNode;
+    for (unsigned int i = 0; i < laneCount; i++) {
+        m_laneArray[i].SetLogger(logger);
+    }
+}
+}  // namespace MOT
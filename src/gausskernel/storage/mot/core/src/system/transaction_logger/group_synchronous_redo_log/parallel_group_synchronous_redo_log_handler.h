@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * parallel_group_synchronous_redo_log_handler.h
+ *    Implements a group commit redo log with several parallel lanes per numa node.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/system/transaction_logger/
+ *        group_synchronous_redo_log/parallel_group_synchronous_redo_log_handler.h
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef PARALLEL_GROUP_SYNCHRONOUS_REDO_LOG_HANDLER_H
+#define PARALLEL_GROUP_SYNCHRONOUS_REDO_LOG_HANDLER_H
+
+#include "redo_log_handler.h"
+#include "group_synchronous_redo_log_handler.h"
+
+namespace MOT {
+/**
+ * @class ParallelGroupSyncRedoLogHandler
+ * @brief Group commit redo log handler with several commit lanes per NUMA node. Each lane forms its own commit groups
+ * and writes each group as a single combined log record, so groups of different lanes are written concurrently.
+ */
+class ParallelGroupSyncRedoLogHandler : public RedoLogHandler {
+public:
+    ParallelGroupSyncRedoLogHandler();
+    ParallelGroupSyncRedoLogHandler(const ParallelGroupSyncRedoLogHandler& orig) = delete;
+    ParallelGroupSyncRedoLogHandler& operator=(const ParallelGroupSyncRedoLogHandler& orig) = delete;
+    virtual ~ParallelGroupSyncRedoLogHandler();
+
+    bool Init();
+
+    /**
+     * @brief creates a new Buffer object
+     * @return a Buffer
+     */
+    RedoLogBuffer* CreateBuffer();
+
+    /**
+     * @brief destroys a Buffer object
+     * @param buffer pointer to be destroyed and de-allocated
+     */
+    void DestroyBuffer(RedoLogBuffer* buffer);
+
+    /**
+     * @brief Forwards and commits the transaction in the lane of the current thread.
+     * @param buffer The buffer to write to the log.
+     * @return The next buffer to write to, or null in case of failure.
+     */
+    virtual RedoLogBuffer* WriteToLog(RedoLogBuffer* buffer);
+    virtual void SetLogger(ILogger* logger);
+
+private:
+    /** @brief Maximum total number of lanes (limited by the group handler identifier). */
+    static constexpr uint32_t MAX_LANES = 256;
+
+    /** @brief Retrieves the lane of the current thread. */
+    inline GroupSyncRedoLogHandler& GetCurrentLane();
+
+    /** @var Number of NUMA nodes. */
+    const unsigned int m_numaNodes;
+
+    /** @var Number of lanes per NUMA node. */
+    unsigned int m_lanesPerNode;
+
+    /** @var Group commit handler per lane. */
+    GroupSyncRedoLogHandler* m_laneArray;
+};
+}  // namespace MOT
+
+#endif /* PARALLEL_GROUP_SYNCHRONOUS_REDO_LOG_HANDLER_H */
@@ -207,6 +207,29 @@ RC RedoLog::CreateTable(Table* table)
     return (success == true) ? RC_OK : RC_ERROR;
 }
 
+RC RedoLog::InsertBulkRows(Table* table)
+{
+    if (!m_configuration.m_enableRedoLog)
+        return RC_OK;
+    IndexIterator* it = table->GetPrimaryIndex()->Begin(m_txn->GetThdId());
+    if (it == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Redo Log", "Failed to begin iterating over primary index");
+        return RC_MEMORY_ALLOCATION_ERROR;
+    }
+
+    // rows inserted through the transaction access set are not committed yet, and are serialized separately
+    RC status = RC_OK;
+    while (it->IsValid() && status == RC_OK) {
+        Sentinel* sentinel = it->GetPrimarySentinel();
+        if (sentinel->IsCommited() && sentinel->GetData() != nullptr) {
+            status = InsertRow(sentinel->GetData());
+        }
+        it->Next();
+    }
+    delete it;
+    return status;
+}
+
 RC RedoLog::DropTable(Table* table)
 {
     if (!m_configuration.m_enableRedoLog)
@@ -292,6 +315,9 @@ RC RedoLog::SerializeTransaction()
             switch (accessType) {
                 case DDL_ACCESS_CREATE_TABLE:
                     status = CreateTable((Table*)DDLAccess->GetEntry());
+                    if (status == RC_OK && ((Table*)DDLAccess->GetEntry())->IsBulkLoaded()) {
+                        status = InsertBulkRows((Table*)DDLAccess->GetEntry());
+                    }
                     break;
 
                 case DDL_ACCESS_DROP_TABLE:
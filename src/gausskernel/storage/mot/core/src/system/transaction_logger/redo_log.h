@@ -192,6 +192,13 @@ private:
      */
     void ResetBuffer();
 
+    /**
+     * @brief Inserts the rows that were bulk loaded into a newly created table to the redo log buffer
+     * @param table The bulk loaded table.
+     * @return The status of the operation.
+     */
+    RC InsertBulkRows(Table* table);
+
     /* Member variables */
     RedoLogHandler* m_redoLogHandler;
     RedoLogBuffer* m_redoBuffer;
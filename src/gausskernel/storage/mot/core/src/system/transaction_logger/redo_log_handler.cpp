@@ -33,6 +33,7 @@
 #include "asynchronous_redo_log_handler.h"
 #include "group_synchronous_redo_log_handler.h"
 #include "segmented_group_synchronous_redo_log_handler.h"
+#include "parallel_group_synchronous_redo_log_handler.h"
 #include "mot_error.h"
 
 namespace MOT {
@@ -66,6 +67,9 @@ RedoLogHandler* RedoLogHandlerFactory::CreateRedoLogHandler()
         case RedoLogHandlerType::ASYNC_REDO_LOG_HANDLER:
             handler = new (std::nothrow) AsyncRedoLogHandler();
             break;
+        case RedoLogHandlerType::PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER:
+            handler = new (std::nothrow) ParallelGroupSyncRedoLogHandler();
+            break;
         default:
             MOT_REPORT_PANIC(MOT_ERROR_INTERNAL,
                 "Redo Log Handler Initialization",
@@ -35,13 +35,15 @@ static const char* SYNC_REDO_LOG_HANDLER_STR = "synchronous";
 static const char* GROUP_SYNC_REDO_LOG_HANDLER_STR = "group_synchronous";
 static const char* SEGMENTED_GROUP_SYNC_REDO_LOG_HANDLER_STR = "segmented_group_synchronous";
 static const char* ASYNC_REDO_LOG_HANDLER_STR = "asynchronous";
+static const char* PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER_STR = "parallel_group_synchronous";
 static const char* INVALID_REDO_LOG_HANDLER_STR = "INVALID";
 
 static const char* redoLogHandlerTypeNames[] = {NONE_STR,
     SYNC_REDO_LOG_HANDLER_STR,
     GROUP_SYNC_REDO_LOG_HANDLER_STR,
     SEGMENTED_GROUP_SYNC_REDO_LOG_HANDLER_STR,
-    ASYNC_REDO_LOG_HANDLER_STR};
+    ASYNC_REDO_LOG_HANDLER_STR,
+    PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER_STR};
 
 RedoLogHandlerType RedoLogHandlerTypeFromString(const char* redoLogHandlerType)
 {
@@ -57,6 +59,8 @@ RedoLogHandlerType RedoLogHandlerTypeFromString(const char* redoLogHandlerType)
         handlerType = RedoLogHandlerType::SEGMENTED_GROUP_SYNC_REDO_LOG_HANDLER;
     } else if (strcmp(redoLogHandlerType, ASYNC_REDO_LOG_HANDLER_STR) == 0) {
         handlerType = RedoLogHandlerType::ASYNC_REDO_LOG_HANDLER;
+    } else if (strcmp(redoLogHandlerType, PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER_STR) == 0) {
+        handlerType = RedoLogHandlerType::PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER;
     } else {
         MOT_LOG_ERROR("Invalid redo log handler type: %s", redoLogHandlerType);
     }
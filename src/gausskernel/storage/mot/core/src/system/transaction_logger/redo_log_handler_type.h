@@ -45,6 +45,9 @@ enum class RedoLogHandlerType : uint32_t {
     /** @var Denotes AsyncRedoLogHandler. */
     ASYNC_REDO_LOG_HANDLER,
 
+    /** @var Denotes ParallelGroupSyncRedoLogHandler. */
+    PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER,
+
     /** @var Denotes invalid handler type. */
     INVALID_REDO_LOG_HANDLER
 };
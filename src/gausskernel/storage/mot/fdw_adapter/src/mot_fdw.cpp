@@ -25,10 +25,13 @@
 
 #include <ostream>
 #include <istream>
+#include <math.h>
 #include "global.h"
 #include "mot_error.h"
 #include "funcapi.h"
 #include "access/reloptions.h"
+#include "access/hash.h"
+#include "access/xact.h"
 #include "postgres.h"
 
 #include "catalog/pg_foreign_table.h"
@@ -39,6 +42,7 @@
 #include "commands/tablecmds.h"
 #include "foreign/fdwapi.h"
 #include "foreign/foreign.h"
+#include "lib/hyperloglog.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
 #include "nodes/nodes.h"
@@ -445,6 +449,49 @@ static void MemoryEreportRrror()
     }
 }
 
+/*
+ * Estimate the number of heap-equivalent pages the table occupies, so that
+ * relpages and the planner page based costs stay consistent with heap tables
+ */
+static BlockNumber MOTEstimatePages(MOT::Table* table, double tuples)
+{
+    double pages = ceil((tuples * table->GetTupleSize()) / BLCKSZ);
+
+    if (pages < 1)
+        return 1;
+    if (pages > (double)MaxBlockNumber)
+        return MaxBlockNumber;
+    return (BlockNumber)pages;
+}
+
+/*
+ * Estimate the number of rows fetched through the matched index. An exact match
+ * on the full key of a non-unique index returns on average keys/distinct keys rows,
+ * as maintained by the engine and the last ANALYZE, otherwise fall back to the
+ * selectivity of the clauses used by the index.
+ */
+static double MOTEstimateIndexRows(
+    PlannerInfo* root, RelOptInfo* baserel, MatchIndex* best, List* clauses, int varRelid)
+{
+    MOT::Index* ix = best->m_ix;
+    bool exactFullKey = (best->m_start >= 0);
+
+    for (int i = 0; exactFullKey && i < ix->GetNumFields(); i++) {
+        exactFullKey = (best->m_opers[best->m_start][i] == KEY_OPER::READ_KEY_EXACT);
+    }
+
+    if (exactFullKey) {
+        if (ix->GetUnique())
+            return 1;
+
+        double distinctKeys = ix->GetDistinctKeys();
+        if (distinctKeys >= 1)
+            return clamp_row_est(ix->GetSize() / distinctKeys);
+    }
+
+    return clamp_row_est(baserel->tuples * clauselist_selectivity(root, clauses, varRelid, JOIN_INNER, nullptr));
+}
+
 /*
  *
  */
@@ -502,12 +549,14 @@ static void MOTGetForeignRelSize(PlannerInfo* root, RelOptInfo* baserel, Oid for
         }
     }
 
-    baserel->rows = planstate->m_table->GetRowCount();
     baserel->tuples = planstate->m_table->GetRowCount();
-    if (baserel->rows == 0)
-        baserel->rows = baserel->tuples = 100000;
+    if (baserel->tuples == 0)
+        baserel->tuples = 100000;
+    baserel->pages = MOTEstimatePages(planstate->m_table, baserel->tuples);
+    baserel->rows = clamp_row_est(
+        baserel->tuples * clauselist_selectivity(root, baserel->baserestrictinfo, baserel->relid, JOIN_INNER, nullptr));
     planstate->m_startupCost = 0.1;
-    planstate->m_totalCost = baserel->rows * planstate->m_startupCost;
+    planstate->m_totalCost = baserel->tuples * planstate->m_startupCost;
 
     RelationClose(rel);
 }
@@ -590,12 +639,9 @@ static void MOTGetForeignPaths(PlannerInfo* root, RelOptInfo* baserel, Oid forei
     if (best != nullptr) {
         OrderSt ord;
         ord.init();
-        double ntuples = best->m_cost;
-        ntuples = ntuples * clauselist_selectivity(root, bestClause, 0, JOIN_INNER, nullptr);
-        ntuples = clamp_row_est(ntuples);
-        baserel->rows = baserel->tuples = ntuples;
+        double ntuples = MOTEstimateIndexRows(root, baserel, best, best->m_remoteCondsOrig, baserel->relid);
         planstate->m_startupCost = 0.001;
-        planstate->m_totalCost = best->m_cost;
+        planstate->m_totalCost = planstate->m_startupCost + ntuples * 0.1;
         planstate->m_bestIx = best;
 
         foreach (lc, root->query_pathkeys) {
@@ -688,13 +734,10 @@ static void MOTGetForeignPaths(PlannerInfo* root, RelOptInfo* baserel, Oid forei
         if (best != nullptr) {
             OrderSt ord;
             ord.init();
-            double ntuples = best->m_cost;
-            ntuples = ntuples * clauselist_selectivity(root, bestClause, 0, JOIN_INNER, nullptr);
-            ntuples = clamp_row_est(ntuples);
-            baserel->rows = baserel->tuples = ntuples;
+            double ntuples = MOTEstimateIndexRows(root, baserel, best, bestClause, 0);
             planstate->m_paramBestIx = best;
             planstate->m_startupCost = 0.001;
-            planstate->m_totalCost = best->m_cost;
+            planstate->m_totalCost = planstate->m_startupCost + ntuples * 0.1;
 
             foreach (lc, root->query_pathkeys) {
                 PathKey* pathkey = (PathKey*)lfirst(lc);
@@ -721,6 +764,7 @@ static void MOTGetForeignPaths(PlannerInfo* root, RelOptInfo* baserel, Oid forei
                 0);
 
             fpIx->param_info = bestPath->param_info;
+            fpIx->rows = ntuples;
         }
     }
 
@@ -1166,6 +1210,28 @@ static void MOTAddForeignUpdateTargets(Query* parsetree, RangeTblEntry* targetRt
     parsetree->targetList = lappend(parsetree->targetList, tle);
 }
 
+/* register width of the distinct keys estimators, 2^10 registers give ~3% standard error */
+#define MOT_DISTINCT_KEYS_HLL_WIDTH 10
+
+/*
+ * Feed the key of the row in every non-unique index to the index distinct keys
+ * estimator. The non-unique suffix (row id) is excluded from the hashed key.
+ */
+static void MOTAddIndexKeysToDistinct(MOT::Table* table, MOT::Row* row, hyperLogLogState* ixDistinct)
+{
+    MOT::MaxKey key;
+
+    for (uint16_t i = 0; i < table->GetNumIndexes(); i++) {
+        MOT::Index* ix = table->GetIndex(i);
+        if (ix->GetUnique())
+            continue;
+
+        key.InitKey(ix->GetKeyLength());
+        ix->BuildKey(table, row, &key);
+        addHyperLogLog(&ixDistinct[i], DatumGetUInt32(hash_any(key.GetKeyBuf(), ix->GetKeySizeNoSuffix())));
+    }
+}
+
 static int MOTAcquireSampleRowsFunc(Relation relation, int elevel, HeapTuple* rows, int targrows, double* totalrows,
     double* totaldeadrows, void* additionalData, bool estimateTableRowNum)
 {
@@ -1188,6 +1254,14 @@ static int MOTAcquireSampleRowsFunc(Relation relation, int elevel, HeapTuple* ro
     uint8_t attrsUsed[8];
     int pos = 0;
     MOT::Row* row = nullptr;
+    uint16_t numIndexes = table->GetNumIndexes();
+    hyperLogLogState* ixDistinct = (hyperLogLogState*)palloc0(sizeof(hyperLogLogState) * numIndexes);
+
+    for (uint16_t i = 0; i < numIndexes; i++) {
+        if (!table->GetIndex(i)->GetUnique()) {
+            initHyperLogLog(&ixDistinct[i], MOT_DISTINCT_KEYS_HLL_WIDTH);
+        }
+    }
 
     for (int i = 0; i < desc->natts; i++) {
         if (!desc->attrs[i]->attisdropped) {
@@ -1209,6 +1283,9 @@ static int MOTAcquireSampleRowsFunc(Relation relation, int elevel, HeapTuple* ro
         /* Always increment sample row counter. */
         samplerows += 1;
 
+        /* Every visible row contributes to the distinct keys estimation */
+        MOTAddIndexKeysToDistinct(table, row, ixDistinct);
+
         /*
          * Determine the slot where this sample row should be stored.  Set pos to
          * negative value to indicate the row should be skipped.
@@ -1250,6 +1327,17 @@ static int MOTAcquireSampleRowsFunc(Relation relation, int elevel, HeapTuple* ro
         }
     }
 
+    /* Publish the distinct keys estimation to the engine, unique indexes are always fully distinct */
+    for (uint16_t i = 0; i < numIndexes; i++) {
+        MOT::Index* ix = table->GetIndex(i);
+        if (!ix->GetUnique()) {
+            double distinctKeys = estimateHyperLogLog(&ixDistinct[i]);
+            ix->SetDistinctKeys((distinctKeys > samplerows) ? samplerows : distinctKeys);
+            pfree(ixDistinct[i].hashesArr);
+        }
+    }
+    pfree(ixDistinct);
+
     /* clean up */
     ExecDropSingleTupleTableSlot(slot);
 
@@ -1283,9 +1371,12 @@ static int MOTAcquireSampleRowsFunc(Relation relation, int elevel, HeapTuple* ro
 static bool MOTAnalyzeForeignTable(Relation relation, AcquireSampleRowsFunc* func, BlockNumber* totalpages,
     void* additionalData, bool estimateTableRowNum)
 {
+    MOT::TxnManager* currTxn = GetSafeTxn();
+    MOT::Table* table = currTxn->GetTableByExternalId(RelationGetRelid(relation));
+
     /* Return the row-analysis function pointer */
     *func = MOTAcquireSampleRowsFunc;
-    *totalpages = 1;
+    *totalpages = (table != nullptr) ? MOTEstimatePages(table, table->GetRowCount()) : 1;
 
     return true;
 }
@@ -1392,6 +1483,12 @@ static TupleTableSlot* MOTExecForeignInsert(
         fdwState->m_attrsModified = (uint8_t*)palloc0(len);
         errno_t erc = memset_s(fdwState->m_attrsUsed, len, 0xff, len);
         securec_check(erc, "\0", "\0");
+        // COPY (which runs without a plan) into a table created in the current transaction by-passes the transaction
+        // access set. Bulk rows can only be undone by aborting the whole transaction, not by ROLLBACK TO SAVEPOINT or
+        // by an exception block, so bulk mode is not used inside a subtransaction
+        fdwState->m_bulkInsert = MOT::GetGlobalConfiguration().m_enableBulkLoad && estate->es_plannedstmt == nullptr &&
+                                 GetCurrentTransactionNestLevel() == 1 &&
+                                 fdwState->m_currTxn->IsTableCreated(fdwState->m_table);
         resultRelInfo->ri_FdwState = fdwState;
     }
 
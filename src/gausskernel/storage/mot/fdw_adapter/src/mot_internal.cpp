@@ -303,6 +303,12 @@ private:
             MOT_LOG_INFO("Configuring asynchronous redo-log handler due to synchronous_commit=off");
             result = AddExtTypedConfigItem<MOT::RedoLogHandlerType>(
                 "", "redo_log_handler_type", MOT::RedoLogHandlerType::ASYNC_REDO_LOG_HANDLER);
+        } else if (MOT::GetGlobalConfiguration().m_enableGroupCommit &&
+                   (MOT::GetGlobalConfiguration().m_groupCommitLanes > 1 ||
+                       MOT::GetGlobalConfiguration().m_enableAdaptiveGroupCommit)) {
+            MOT_LOG_INFO("Configuring parallel-group redo-log handler");
+            result = AddExtTypedConfigItem<MOT::RedoLogHandlerType>(
+                "", "redo_log_handler_type", MOT::RedoLogHandlerType::PARALLEL_GROUP_SYNC_REDO_LOG_HANDLER);
         } else if (MOT::GetGlobalConfiguration().m_enableGroupCommit) {
             MOT_LOG_INFO("Configuring segmented-group redo-log handler");
             result = AddExtTypedConfigItem<MOT::RedoLogHandlerType>(
@@ -1098,7 +1104,8 @@ MOT::RC MOTAdaptor::InsertRow(MOTFdwStateSt* fdwState, TupleTableSlot* slot)
     newRowData = const_cast<uint8_t*>(row->GetData());
     PackRow(slot, table, fdwState->m_attrsUsed, newRowData);
 
-    MOT::RC res = table->InsertRow(row, fdwState->m_currTxn);
+    MOT::RC res = fdwState->m_bulkInsert ? table->InsertRowBulk(row, fdwState->m_currTxn)
+                                         : table->InsertRow(row, fdwState->m_currTxn);
     if ((res != MOT::RC_OK) && (res != MOT::RC_UNIQUE_VIOLATION)) {
         MOT_REPORT_ERROR(
             MOT_ERROR_OOM, "Insert Row", "Failed to insert new row for table %s", table->GetLongTableName().c_str());
@@ -280,6 +280,7 @@ struct MOTFdwState_St {
     MOT::MaxKey m_stateKey[2];
     bool m_forwardDirectionScan;
     MOT::AccessType m_internalCmdOper;
+    bool m_bulkInsert = false;
 };
 
 class MOTAdaptor {
@@ -18,15 +18,20 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <time.h>
+#include <arpa/inet.h>
 
+#include "access/cbmparsexlog.h"
 #include "access/xlog_internal.h" /* for pg_start/stop_backup */
 #include "catalog/catalog.h"
+#include "catalog/pg_tablespace.h"
 #include "catalog/pg_type.h"
 #include "lib/stringinfo.h"
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
 #include "nodes/pg_list.h"
 #include "replication/basebackup.h"
+#include "replication/incrbackup.h"
+#include "replication/walcompress.h"
 #include "replication/walsender.h"
 #include "replication/walsender_private.h"
 #include "replication/slot.h"
@@ -53,8 +58,18 @@ typedef struct {
     bool fastcheckpoint;
     bool nowait;
     bool includewal;
+    XLogRecPtr incremental_lsn; /* send only the blocks changed since this, if valid */
+    bool parallel;              /* hand over relation segments to worker connections */
+    uint64 worker_id;           /* send the files of this parallel base backup, if not 0 */
+    const char* compression;    /* compression method of the tar stream, NULL if none */
 } basebackup_options;
 
+/* changed blocks of a relation fork, keyed like the CBM pages */
+typedef struct IncrementalBlockEntry {
+    CBMPageTag tag;
+    CBMArrayEntry* cbmEntry;
+} IncrementalBlockEntry;
+
 #define BUILD_PATH_LEN 2560 /* (MAXPGPATH*2 + 512) */
 const int FILE_NAME_MAX_LEN = 1024;
 const int MATCH_ONE = 1;
@@ -63,16 +78,55 @@ const int MATCH_THREE = 3;
 const int MATCH_FOUR = 4;
 const int MATCH_FIVE = 5;
 const int MATCH_SIX = 6;
+const int MAX_RETRY_LIMIT = 60;
+/* how long to wait for the CBM writer to track the WAL up to the backup start, in milliseconds */
+const int INCREMENTAL_CBM_TRACK_TIMEOUT = 600000;
 /*
  * Size of each block sent into the tar stream for larger files.
  */
 #define TAR_SEND_SIZE (32 * 1024) /* data send unit 32KB */
 
+/* relation segments at least this large are handed over to the workers of a parallel base backup */
+#define PARALLEL_BACKUP_MIN_FILE_SIZE (1024 * 1024)
+#define PARALLEL_BACKUP_QUEUE_SIZE 64
+/* how long the leader and the workers of a parallel base backup sleep waiting for each other, in microseconds */
+#define PARALLEL_BACKUP_WAIT_INTERVAL 10000L
+
+typedef struct ParallelBackupFile {
+    char readfilename[MAXPGPATH];
+    char tarfilename[MAXPGPATH];
+} ParallelBackupFile;
+
+/*
+ * State of the parallel base backup in progress. The leader walks the directories as usual
+ * but queues the large relation segments, which the workers pull from the queue and send over
+ * their own connections, so the segments spread over the connections by size. The walsenders
+ * are threads of the same process, so the state is a plain global protected by a mutex. Only
+ * one base backup at a time runs in parallel, the others are sent by the leader alone.
+ */
+typedef struct ParallelBackupState {
+    uint64 id;          /* 0 if no parallel base backup is in progress */
+    int activeWorkers;  /* workers attached and not finished yet */
+    bool producerDone;  /* the leader queued all the segments */
+    bool workerFailed;  /* a worker failed, so some queued segments may not have been sent */
+    int head;
+    int count;
+    ParallelBackupFile queue[PARALLEL_BACKUP_QUEUE_SIZE];
+} ParallelBackupState;
+
+static pthread_mutex_t ParallelBackupLock = PTHREAD_MUTEX_INITIALIZER;
+static ParallelBackupState ParallelBackup;
+static uint64 ParallelBackupNextId = 1;
+
 XLogRecPtr XlogCopyStartPtr = InvalidXLogRecPtr;
 
 static int64 sendDir(const char* path, int basepathlen, bool sizeonly, List* tablespaces, bool skipmot = true);
 static int64 sendTablespace(const char* path, bool sizeonly);
 static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf, bool missing_ok);
+static void sendIncrementalFile(
+    FILE* fp, const char* readfilename, const char* tarfilename, struct stat* statbuf, CBMArrayEntry* changed, int segNo);
+static void PrepareIncrementalBackup(XLogRecPtr incrementalLsn, XLogRecPtr backupStartPtr);
+static bool GetIncrementalBlocks(const char* readfilename, CBMArrayEntry** changed);
 static void sendFileWithContent(const char* filename, const char* content);
 static void _tarWriteHeader(const char* filename, const char* linktarget, struct stat* statbuf);
 static void send_int8_string(StringInfoData* buf, int64 intval);
@@ -82,6 +136,14 @@ static void base_backup_cleanup(int code, Datum arg);
 static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir);
 static void parse_basebackup_options(List* options, basebackup_options* opt);
 static void SendXlogRecPtrResult(XLogRecPtr ptr);
+static void SendTextResult(const char* fieldname, const char* value);
+static int SendBackupData(const char* data, size_t len);
+static void InitBackupStreamCompression(const char* method);
+static void ParallelBackupStart(void);
+static bool ParallelBackupPushFile(const char* readfilename, const char* tarfilename, const struct stat* statbuf);
+static void ParallelBackupFinish(void);
+static void ParallelBackupEnd(void);
+static void SendParallelBackupFiles(uint64 id);
 static void send_xlog_location();
 static void send_xlog_header(const char* linkpath);
 static void save_xlogloc(const char* xloglocation);
@@ -203,6 +265,8 @@ static void send_xlog_location()
  */
 static void base_backup_cleanup(int code, Datum arg)
 {
+    t_thrd.basebackup_cxt.incremental_block_hash = NULL;
+    ParallelBackupEnd();
     do_pg_abort_backup();
 }
 
@@ -215,6 +279,7 @@ static void base_backup_cleanup(int code, Datum arg)
 static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
 {
     XLogRecPtr startptr;
+    XLogRecPtr backupStartPtr;
     XLogRecPtr endptr;
     XLogRecPtr minlsn;
     char* labelfile = NULL;
@@ -223,6 +288,7 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
     datadirpathlen = strlen(t_thrd.proc_cxt.DataDir);
 
     startptr = do_pg_start_backup(opt->label, opt->fastcheckpoint, &labelfile);
+    backupStartPtr = startptr;
     /* Get the slot minimum LSN */
     ReplicationSlotsComputeRequiredXmin(false);
     ReplicationSlotsComputeRequiredLSN(NULL);
@@ -252,6 +318,22 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
         struct dirent* de;
         tablespaceinfo* ti = NULL;
 
+        if (!XLogRecPtrIsInvalid(opt->incremental_lsn)) {
+            PrepareIncrementalBackup(opt->incremental_lsn, backupStartPtr);
+        }
+
+        /* the workers attach with the backup id, 0 tells the client to take the backup alone */
+        if (opt->parallel) {
+            char idstr[MAXFNAMELEN];
+            int nRet;
+
+            ParallelBackupStart();
+            nRet = snprintf_s(idstr, sizeof(idstr), sizeof(idstr) - 1, UINT64_FORMAT,
+                t_thrd.basebackup_cxt.parallel_backup_id);
+            securec_check_ss(nRet, "", "");
+            SendTextResult("backupid", idstr);
+        }
+
         /* Collect information about all tablespaces */
         while ((de = ReadDir(tblspcdir, "pg_tblspc")) != NULL) {
             char fullpath[MAXPGPATH];
@@ -332,9 +414,22 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
             pq_endmessage_noblock(&buf);
 
             /* In the main tar, include the backup_label first. */
-            if (iterti->path == NULL)
+            if (iterti->path == NULL) {
                 sendFileWithContent(BACKUP_LABEL_FILE, labelfile);
 
+                if (!XLogRecPtrIsInvalid(opt->incremental_lsn)) {
+                    char incrlabel[MAXPGPATH];
+                    int nRet = snprintf_s(incrlabel, sizeof(incrlabel), sizeof(incrlabel) - 1,
+                        INCREMENTAL_LABEL_FORMAT, (uint32)(opt->incremental_lsn >> 32), (uint32)opt->incremental_lsn);
+                    securec_check_ss(nRet, "", "");
+                    sendFileWithContent(INCREMENTAL_LABEL_FILE, incrlabel);
+                }
+            }
+
+            /* relation files of the tablespace are looked up in the changed blocks with its oid */
+            t_thrd.basebackup_cxt.incremental_spcnode =
+                (iterti->path != NULL) ? atooid(iterti->oid) : DEFAULTTABLESPACE_OID;
+
             /*
              * if the tblspc created in datadir , the files under tblspc do not send,
              * and send them as normal under datadir,
@@ -346,6 +441,9 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
             } else {
                 /* data dir */
                 sendDir(".", 1, false, tablespaces);
+
+                /* pg_control must not be sent before the segments the workers are sending */
+                ParallelBackupFinish();
             }
 
             /* In the main tar, include pg_control last. */
@@ -389,6 +487,10 @@ static void perform_base_backup(basebackup_options* opt, DIR* tblspcdir)
     }
     PG_END_ENSURE_ERROR_CLEANUP(base_backup_cleanup, (Datum)0);
 
+    /* the changed blocks go away with the backup memory context */
+    t_thrd.basebackup_cxt.incremental_block_hash = NULL;
+    ParallelBackupEnd();
+
     endptr = do_pg_stop_backup(labelfile, !opt->nowait);
 
     SendXlogRecPtrResult(endptr);
@@ -510,6 +612,10 @@ static void parse_basebackup_options(List* options, basebackup_options* opt)
     bool o_fast = false;
     bool o_nowait = false;
     bool o_wal = false;
+    bool o_incremental = false;
+    bool o_parallel = false;
+    bool o_worker = false;
+    bool o_compression = false;
     errno_t rc = 0;
 
     rc = memset_s(opt, sizeof(*opt), 0, sizeof(*opt));
@@ -542,11 +648,53 @@ static void parse_basebackup_options(List* options, basebackup_options* opt)
                 ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
             opt->includewal = true;
             o_wal = true;
+        } else if (strcmp(defel->defname, "incremental") == 0) {
+            uint32 hi = 0;
+            uint32 lo = 0;
+
+            if (o_incremental)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            if (sscanf_s(strVal(defel->arg), "%X/%X", &hi, &lo) != 2 || (hi == 0 && lo == 0))
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("invalid incremental backup start location \"%s\"", strVal(defel->arg))));
+            opt->incremental_lsn = (((XLogRecPtr)hi) << 32) | lo;
+            o_incremental = true;
+        } else if (strcmp(defel->defname, "parallel") == 0) {
+            if (o_parallel)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            opt->parallel = true;
+            o_parallel = true;
+        } else if (strcmp(defel->defname, "worker") == 0) {
+            char* endptr = NULL;
+
+            if (o_worker)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            errno = 0;
+            opt->worker_id = strtoul(strVal(defel->arg), &endptr, 10);
+            if (errno != 0 || *endptr != '\0' || opt->worker_id == 0)
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("invalid parallel base backup id \"%s\"", strVal(defel->arg))));
+            o_worker = true;
+        } else if (strcmp(defel->defname, "compression") == 0) {
+            if (o_compression)
+                ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("duplicate option \"%s\"", defel->defname)));
+            if (!WalStreamCompressionIsSupported(strVal(defel->arg)))
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("unsupported base backup compression method \"%s\"", strVal(defel->arg))));
+            opt->compression = strVal(defel->arg);
+            o_compression = true;
         } else
             ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR), errmsg("option \"%s\" not recognized", defel->defname)));
     }
     if (opt->label == NULL)
         opt->label = "base backup";
+    if (opt->parallel && !XLogRecPtrIsInvalid(opt->incremental_lsn))
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmsg("an incremental base backup cannot be taken in parallel")));
 }
 
 /*
@@ -564,6 +712,17 @@ void SendBaseBackup(BaseBackupCmd* cmd)
     basebackup_options opt;
 
     parse_basebackup_options(cmd->options, &opt);
+    InitBackupStreamCompression(opt.compression);
+
+    /* a worker of a parallel base backup only sends the segments the leader hands over */
+    if (opt.worker_id != 0) {
+        WalSndSetState(WALSNDSTATE_BACKUP);
+        if (u_sess->attr.attr_common.update_process_title)
+            set_ps_display("sending parallel backup files", false);
+        SendParallelBackupFiles(opt.worker_id);
+        InitBackupStreamCompression(NULL);
+        return;
+    }
 
     backup_context = AllocSetContextCreate(CurrentMemoryContext,
         "Streaming base backup context",
@@ -597,11 +756,308 @@ void SendBaseBackup(BaseBackupCmd* cmd)
     perform_base_backup(&opt, dir);
 
     FreeDir(dir);
+    InitBackupStreamCompression(NULL);
 
     MemoryContextSwitchTo(old_context);
     MemoryContextDelete(backup_context);
 }
 
+/*
+ * Set up the compression of the tar stream asked for by BASE_BACKUP, or stop compressing if
+ * method is NULL.
+ */
+static void InitBackupStreamCompression(const char* method)
+{
+    if (t_thrd.basebackup_cxt.stream_compressor != NULL) {
+        pfree(t_thrd.basebackup_cxt.stream_compressor);
+        t_thrd.basebackup_cxt.stream_compressor = NULL;
+    }
+
+    if (method == NULL)
+        return;
+
+    t_thrd.basebackup_cxt.stream_compressor =
+        (WalStreamCompressor*)MemoryContextAlloc(t_thrd.top_mem_cxt, sizeof(WalStreamCompressor));
+    WalStreamCompressorReset(t_thrd.basebackup_cxt.stream_compressor);
+}
+
+/*
+ * Send a CopyData message of the tar stream. If the stream is compressed, the message holds
+ * the length of the uncompressed data in network byte order and the compressed data, which
+ * references the data of the previous messages. The client relies on the boundaries of the
+ * messages to parse the tar stream, so every message is compressed on its own.
+ *
+ * Returns 0 if OK, EOF if trouble, like pq_putmessage_noblock().
+ */
+static int SendBackupData(const char* data, size_t len)
+{
+    int bound;
+    Size msgSize;
+    uint32 rawLen;
+    int compressedLen;
+    errno_t rc;
+
+    if (t_thrd.basebackup_cxt.stream_compressor == NULL)
+        return pq_putmessage_noblock('d', data, len);
+
+    bound = WalStreamCompressBound((int)len);
+    msgSize = sizeof(uint32) + (Size)bound;
+    if (t_thrd.basebackup_cxt.compressed_message_size < msgSize) {
+        if (t_thrd.basebackup_cxt.compressed_message != NULL)
+            pfree(t_thrd.basebackup_cxt.compressed_message);
+        t_thrd.basebackup_cxt.compressed_message = (char*)MemoryContextAlloc(t_thrd.top_mem_cxt, msgSize);
+        t_thrd.basebackup_cxt.compressed_message_size = (uint32)msgSize;
+    }
+
+    rawLen = htonl((uint32)len);
+    rc = memcpy_s(t_thrd.basebackup_cxt.compressed_message, msgSize, &rawLen, sizeof(uint32));
+    securec_check(rc, "\0", "\0");
+
+    compressedLen = WalStreamCompress(t_thrd.basebackup_cxt.stream_compressor, data, (int)len,
+        t_thrd.basebackup_cxt.compressed_message + sizeof(uint32), bound);
+    if (compressedLen <= 0)
+        ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR), errmsg("could not compress base backup data")));
+
+    return pq_putmessage_noblock('d', t_thrd.basebackup_cxt.compressed_message, sizeof(uint32) + compressedLen);
+}
+
+/*
+ * Make this walsender the leader of a parallel base backup, unless another base backup is
+ * already running in parallel.
+ */
+static void ParallelBackupStart(void)
+{
+    errno_t rc = EOK;
+
+    /* nothing may throw while the mutex is held, it would stay locked */
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    if (ParallelBackup.id == 0) {
+        rc = memset_s(&ParallelBackup, sizeof(ParallelBackup), 0, sizeof(ParallelBackup));
+        ParallelBackup.id = ParallelBackupNextId++;
+        t_thrd.basebackup_cxt.parallel_backup_id = ParallelBackup.id;
+    }
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+    securec_check(rc, "", "");
+
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0)
+        ereport(LOG, (errmsg("another base backup is running in parallel, sending this one over a single connection")));
+}
+
+/*
+ * Queue a relation segment for the workers of the parallel base backup led by this walsender.
+ * Returns false if the segment is to be sent by the leader: it is small, no worker is attached
+ * or the workers are busy enough already.
+ */
+static bool ParallelBackupPushFile(const char* readfilename, const char* tarfilename, const struct stat* statbuf)
+{
+    ParallelBackupFile file;
+    int segNo = 0;
+    bool pushed = false;
+    int rc;
+
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0 || statbuf->st_size < PARALLEL_BACKUP_MIN_FILE_SIZE ||
+        !is_row_data_file(readfilename, &segNo))
+        return false;
+
+    /* fill in the entry before taking the mutex, so that nothing throws while it is held */
+    rc = strcpy_s(file.readfilename, MAXPGPATH, readfilename);
+    securec_check(rc, "", "");
+
+    /* the names in the workers' streams tell the tablespace apart, the names in the tablespace tars don't */
+    if (t_thrd.basebackup_cxt.incremental_spcnode != DEFAULTTABLESPACE_OID) {
+        rc = snprintf_s(file.tarfilename, MAXPGPATH, MAXPGPATH - 1, "pg_tblspc/%u/%s",
+            t_thrd.basebackup_cxt.incremental_spcnode, tarfilename);
+        securec_check_ss(rc, "", "");
+    } else {
+        rc = strcpy_s(file.tarfilename, MAXPGPATH, tarfilename);
+        securec_check(rc, "", "");
+    }
+
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    if (ParallelBackup.activeWorkers > 0 && ParallelBackup.count < PARALLEL_BACKUP_QUEUE_SIZE) {
+        ParallelBackup.queue[(ParallelBackup.head + ParallelBackup.count) % PARALLEL_BACKUP_QUEUE_SIZE] = file;
+        ParallelBackup.count++;
+        pushed = true;
+    }
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+
+    return pushed;
+}
+
+/*
+ * Pop the next queued segment of the parallel base backup into file. Returns false if the
+ * queue is empty.
+ */
+static bool ParallelBackupPopFile(uint64 id, ParallelBackupFile* file, bool* finished)
+{
+    bool popped = false;
+
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    if (ParallelBackup.id != id) {
+        /* the leader is gone, it reports the failure if any to the client */
+        *finished = true;
+    } else if (ParallelBackup.count > 0) {
+        *file = ParallelBackup.queue[ParallelBackup.head];
+        ParallelBackup.head = (ParallelBackup.head + 1) % PARALLEL_BACKUP_QUEUE_SIZE;
+        ParallelBackup.count--;
+        popped = true;
+    } else {
+        *finished = ParallelBackup.producerDone;
+    }
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+
+    return popped;
+}
+
+static void SendParallelBackupFile(ParallelBackupFile* file)
+{
+    struct stat statbuf;
+
+    if (lstat(file->readfilename, &statbuf) != 0) {
+        if (errno != ENOENT)
+            ereport(ERROR,
+                (errcode_for_file_access(), errmsg("could not stat file \"%s\": %m", file->readfilename)));
+
+        /* If the file went away while queued, it's no error. */
+        return;
+    }
+    (void)sendFile(file->readfilename, file->tarfilename, &statbuf, true);
+}
+
+/*
+ * Wait for the workers of the parallel base backup led by this walsender to send all the
+ * queued segments, sending the segments no worker has picked up yet along the way.
+ */
+static void ParallelBackupFinish(void)
+{
+    uint64 id = t_thrd.basebackup_cxt.parallel_backup_id;
+    ParallelBackupFile file;
+    bool finished = false;
+
+    if (id == 0)
+        return;
+
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    ParallelBackup.producerDone = true;
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+
+    for (;;) {
+        bool workerFailed = false;
+        int activeWorkers = 0;
+
+        if (ParallelBackupPopFile(id, &file, &finished)) {
+            SendParallelBackupFile(&file);
+            continue;
+        }
+
+        (void)pthread_mutex_lock(&ParallelBackupLock);
+        workerFailed = ParallelBackup.workerFailed;
+        activeWorkers = ParallelBackup.activeWorkers;
+        (void)pthread_mutex_unlock(&ParallelBackupLock);
+
+        if (workerFailed)
+            ereport(ERROR,
+                (errcode(ERRCODE_CONNECTION_FAILURE), errmsg("a worker of the parallel base backup failed")));
+        if (activeWorkers == 0)
+            break;
+
+        if (!PostmasterIsAlive())
+            ereport(ERROR, (errcode_for_file_access(), errmsg("Postmaster exited, aborting active base backup")));
+        if (t_thrd.walsender_cxt.walsender_shutdown_requested || t_thrd.walsender_cxt.walsender_ready_to_stop)
+            ereport(ERROR, (errcode_for_file_access(), errmsg("shutdown requested, aborting active base backup")));
+        pg_usleep(PARALLEL_BACKUP_WAIT_INTERVAL);
+    }
+}
+
+/*
+ * Release the parallel base backup led by this walsender. The workers still attached notice
+ * it and stop.
+ */
+static void ParallelBackupEnd(void)
+{
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0)
+        return;
+
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    if (ParallelBackup.id == t_thrd.basebackup_cxt.parallel_backup_id)
+        ParallelBackup.id = 0;
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+    t_thrd.basebackup_cxt.parallel_backup_id = 0;
+}
+
+static void ParallelBackupDetach(bool failed)
+{
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    if (ParallelBackup.id == t_thrd.basebackup_cxt.parallel_backup_id) {
+        ParallelBackup.activeWorkers--;
+        if (failed)
+            ParallelBackup.workerFailed = true;
+    }
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+    t_thrd.basebackup_cxt.parallel_backup_id = 0;
+}
+
+/*
+ * Called when ERROR or FATAL happens in SendParallelBackupFiles(), the segment being sent is
+ * lost so the leader must fail.
+ */
+static void parallel_backup_worker_cleanup(int code, Datum arg)
+{
+    ParallelBackupDetach(true);
+}
+
+/*
+ * Send the segments queued by the leader of a parallel base backup as a single tar stream,
+ * until the leader has walked all the directories.
+ */
+static void SendParallelBackupFiles(uint64 id)
+{
+    StringInfoData buf;
+    ParallelBackupFile file;
+    bool finished = false;
+
+    (void)pthread_mutex_lock(&ParallelBackupLock);
+    if (ParallelBackup.id == id) {
+        ParallelBackup.activeWorkers++;
+        t_thrd.basebackup_cxt.parallel_backup_id = id;
+    }
+    (void)pthread_mutex_unlock(&ParallelBackupLock);
+
+    /* Send CopyOutResponse message */
+    pq_beginmessage(&buf, 'H');
+    pq_sendbyte(&buf, 0);  /* overall format */
+    pq_sendint16(&buf, 0); /* natts */
+    pq_endmessage_noblock(&buf);
+
+    /* a worker attaching too late finds the backup done, or sent by the leader alone */
+    if (t_thrd.basebackup_cxt.parallel_backup_id == 0) {
+        ereport(LOG, (errmsg("parallel base backup " UINT64_FORMAT " is not in progress", id)));
+        pq_putemptymessage_noblock('c'); /* CopyDone */
+        return;
+    }
+
+    PG_ENSURE_ERROR_CLEANUP(parallel_backup_worker_cleanup, (Datum)0);
+    {
+        while (!finished) {
+            if (!PostmasterIsAlive())
+                ereport(
+                    ERROR, (errcode_for_file_access(), errmsg("Postmaster exited, aborting active base backup")));
+            if (t_thrd.walsender_cxt.walsender_shutdown_requested || t_thrd.walsender_cxt.walsender_ready_to_stop)
+                ereport(
+                    ERROR, (errcode_for_file_access(), errmsg("shutdown requested, aborting active base backup")));
+
+            if (ParallelBackupPopFile(id, &file, &finished))
+                SendParallelBackupFile(&file);
+            else if (!finished)
+                pg_usleep(PARALLEL_BACKUP_WAIT_INTERVAL);
+        }
+
+        pq_putemptymessage_noblock('c'); /* CopyDone */
+    }
+    PG_END_ENSURE_ERROR_CLEANUP(parallel_backup_worker_cleanup, (Datum)0);
+    ParallelBackupDetach(false);
+}
+
 static void send_int8_string(StringInfoData* buf, int64 intval)
 {
     char is[32];
@@ -738,18 +1194,27 @@ static void SendMotCheckpointHeader(const char* path)
  */
 static void SendXlogRecPtrResult(XLogRecPtr ptr)
 {
-    StringInfoData buf;
     char str[MAXFNAMELEN];
     int nRet = 0;
 
     nRet = snprintf_s(str, MAXFNAMELEN, MAXFNAMELEN - 1, "%X/%X", (uint32)(ptr >> 32), (uint32)ptr);
     securec_check_ss(nRet, "", "");
 
+    SendTextResult("recptr", str);
+}
+
+/*
+ * Send a single resultset containing just a single text field
+ */
+static void SendTextResult(const char* fieldname, const char* value)
+{
+    StringInfoData buf;
+
     pq_beginmessage(&buf, 'T'); /* RowDescription */
     pq_sendint16(&buf, 1);      /* 1 field */
 
     /* Field header */
-    pq_sendstring(&buf, "recptr");
+    pq_sendstring(&buf, fieldname);
     pq_sendint32(&buf, 0);       /* table oid */
     pq_sendint16(&buf, 0);       /* attnum */
     pq_sendint32(&buf, TEXTOID); /* type oid */
@@ -760,9 +1225,9 @@ static void SendXlogRecPtrResult(XLogRecPtr ptr)
 
     /* Data row */
     pq_beginmessage(&buf, 'D');
-    pq_sendint16(&buf, 1);           /* number of columns */
-    pq_sendint32(&buf, strlen(str)); /* length */
-    pq_sendbytes(&buf, str, strlen(str));
+    pq_sendint16(&buf, 1);             /* number of columns */
+    pq_sendint32(&buf, strlen(value)); /* length */
+    pq_sendbytes(&buf, value, strlen(value));
     pq_endmessage_noblock(&buf);
 
     /* Send a CommandComplete message */
@@ -797,7 +1262,7 @@ static void sendFileWithContent(const char* filename, const char* content)
 
     _tarWriteHeader(filename, NULL, &statbuf);
     /* Send the contents as a CopyData message */
-    (void)pq_putmessage_noblock('d', content, len);
+    (void)SendBackupData(content, len);
 
     /* Pad to 512 byte boundary, per tar format requirements */
     pad = ((len + 511) & ~511) - len;
@@ -807,7 +1272,7 @@ static void sendFileWithContent(const char* filename, const char* content)
 
         rc = memset_s(buf, sizeof(buf), 0, pad);
         securec_check(rc, "", "");
-        (void)pq_putmessage_noblock('d', buf, pad);
+        (void)SendBackupData(buf, pad);
     }
 }
 
@@ -1142,8 +1607,10 @@ static int64 sendDir(const char* path, int basepathlen, bool sizeonly, List* tab
         } else if (S_ISREG(statbuf.st_mode)) {
             bool sent = false;
 
-            if (!sizeonly)
-                sent = sendFile(pathbuf, pathbuf + basepathlen + 1, &statbuf, true);
+            if (!sizeonly) {
+                sent = ParallelBackupPushFile(pathbuf, pathbuf + basepathlen + 1, &statbuf) ||
+                    sendFile(pathbuf, pathbuf + basepathlen + 1, &statbuf, true);
+            }
 
             if (sent || sizeonly) {
                 /* Add size, rounded up to 512byte block */
@@ -1409,7 +1876,6 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
     uint16 checksum = 0;
     bool isNeedCheck = false;
     int segNo = 0;
-    const int MAX_RETRY_LIMIT = 60;
     int retryCnt = 0;
 
     if (t_thrd.basebackup_cxt.buf_block == NULL) {
@@ -1449,6 +1915,16 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
     isNeedCheck = is_row_data_file(readfilename, &segNo);
     ereport(DEBUG1, (errmsg("sendFile, filename is %s, isNeedCheck is %d", readfilename, isNeedCheck)));
 
+    if (isNeedCheck && t_thrd.basebackup_cxt.incremental_block_hash != NULL) {
+        CBMArrayEntry* changed = NULL;
+
+        if (GetIncrementalBlocks(readfilename, &changed)) {
+            sendIncrementalFile(fp, readfilename, tarfilename, statbuf, changed, segNo);
+            (void)FreeFile(fp);
+            return true;
+        }
+    }
+
     /* make sure data file size is integer multiple of BLCKSZ and change statbuf if needed */
     if(isNeedCheck) {
         statbuf->st_size = statbuf->st_size - (statbuf->st_size % BLCKSZ);
@@ -1509,7 +1985,7 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
         }
 
         /* Send the chunk as a CopyData message */
-        if (pq_putmessage_noblock('d', t_thrd.basebackup_cxt.buf_block, cnt))
+        if (SendBackupData(t_thrd.basebackup_cxt.buf_block, cnt))
             ereport(ERROR, (errcode_for_file_access(), errmsg("base backup could not send data, aborting backup")));
 
         len += cnt;
@@ -1530,7 +2006,7 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
         securec_check(rc, "", "");
         while (len < statbuf->st_size) {
             cnt = Min(TAR_SEND_SIZE, statbuf->st_size - len);
-            (void)pq_putmessage_noblock('d', t_thrd.basebackup_cxt.buf_block, cnt);
+            (void)SendBackupData(t_thrd.basebackup_cxt.buf_block, cnt);
             len += cnt;
         }
     }
@@ -1540,13 +2016,320 @@ static bool sendFile(char* readfilename, char* tarfilename, struct stat* statbuf
     if (pad > 0) {
         rc = memset_s(t_thrd.basebackup_cxt.buf_block, pad, 0, pad);
         securec_check(rc, "", "");
-        (void)pq_putmessage_noblock('d', t_thrd.basebackup_cxt.buf_block, pad);
+        (void)SendBackupData(t_thrd.basebackup_cxt.buf_block, pad);
     }
 
     (void)FreeFile(fp);
     return true;
 }
 
+/*
+ * Look up the blocks changed since the start of the previous backup in the CBM files, so that
+ * sendFile() sends only those of the relation data files.
+ */
+static void PrepareIncrementalBackup(XLogRecPtr incrementalLsn, XLogRecPtr backupStartPtr)
+{
+    CBMArray* cbmArray = NULL;
+    XLogRecPtr trackedLsn;
+    HASHCTL ctl;
+    HTAB* blockHash = NULL;
+    errno_t rc;
+
+    /* At present, CBM files are only merged on master */
+    if (RecoveryInProgress())
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("incremental base backup cannot be taken during recovery")));
+
+    if (!u_sess->attr.attr_storage.enable_cbm_tracking)
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("incremental base backup requires enable_cbm_tracking to be on")));
+
+    if (!XLByteLT(incrementalLsn, backupStartPtr))
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("incremental backup start location %X/%X is not before the backup start location %X/%X",
+                    (uint32)(incrementalLsn >> 32),
+                    (uint32)incrementalLsn,
+                    (uint32)(backupStartPtr >> 32),
+                    (uint32)backupStartPtr)));
+
+    /*
+     * Blocks changed after the backup checkpoint need not be tracked, WAL replay restores them
+     * from their first full-page image after it.
+     */
+    trackedLsn = ForceTrackCBMOnce(backupStartPtr, INCREMENTAL_CBM_TRACK_TIMEOUT, true, false);
+    if (XLogRecPtrIsInvalid(trackedLsn))
+        ereport(ERROR,
+            (errcode(ERRCODE_CONNECTION_TIMED_OUT),
+                errmsg("timeout while waiting for CBM tracking to reach %X/%X",
+                    (uint32)(backupStartPtr >> 32),
+                    (uint32)backupStartPtr)));
+
+    (void)LWLockAcquire(CBMParseXlogLock, LW_SHARED);
+    cbmArray = CBMGetMergedArray(incrementalLsn, trackedLsn);
+    LWLockRelease(CBMParseXlogLock);
+
+    if (XLByteLT(incrementalLsn, cbmArray->startLSN) || XLByteLT(cbmArray->endLSN, backupStartPtr))
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("CBM files only cover %X/%X to %X/%X, which does not include %X/%X to %X/%X",
+                    (uint32)(cbmArray->startLSN >> 32),
+                    (uint32)cbmArray->startLSN,
+                    (uint32)(cbmArray->endLSN >> 32),
+                    (uint32)cbmArray->endLSN,
+                    (uint32)(incrementalLsn >> 32),
+                    (uint32)incrementalLsn,
+                    (uint32)(backupStartPtr >> 32),
+                    (uint32)backupStartPtr)));
+
+    rc = memset_s(&ctl, sizeof(ctl), 0, sizeof(ctl));
+    securec_check(rc, "", "");
+    ctl.keysize = sizeof(CBMPageTag);
+    ctl.entrysize = sizeof(IncrementalBlockEntry);
+    ctl.hash = tag_hash;
+    ctl.hcxt = CurrentMemoryContext;
+    blockHash = hash_create("incremental base backup changed blocks",
+        Max(cbmArray->arrayLength, 16),
+        &ctl,
+        HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+    for (long i = 0; i < cbmArray->arrayLength; i++) {
+        CBMArrayEntry* cbmEntry = &cbmArray->arrayEntry[i];
+        IncrementalBlockEntry* entry =
+            (IncrementalBlockEntry*)hash_search(blockHash, (void*)&cbmEntry->cbmTag, HASH_ENTER, NULL);
+        entry->cbmEntry = cbmEntry;
+    }
+
+    t_thrd.basebackup_cxt.incremental_block_hash = blockHash;
+
+    ereport(LOG,
+        (errmsg("incremental base backup from %X/%X, %ld relation forks changed up to %X/%X",
+            (uint32)(incrementalLsn >> 32),
+            (uint32)incrementalLsn,
+            cbmArray->arrayLength,
+            (uint32)(cbmArray->endLSN >> 32),
+            (uint32)cbmArray->endLSN)));
+}
+
+/*
+ * Extract the relation and fork of a row data file from its path. The tablespace of the files
+ * under a database directory is the one being sent.
+ */
+static bool parse_rel_file_name(const char* path, RelFileNode* rnode, ForkNumber* forknum)
+{
+    const char* fname = strrchr(path, '/');
+    const char* dname = NULL;
+    char* end = NULL;
+
+    if (fname == NULL || fname == path)
+        return false;
+    dname = fname - 1;
+    while (dname > path && *(dname - 1) != '/')
+        dname--;
+    fname++;
+
+    if (strncmp(dname, "global/", strlen("global/")) == 0) {
+        rnode->spcNode = GLOBALTABLESPACE_OID;
+        rnode->dbNode = InvalidOid;
+    } else {
+        rnode->spcNode = t_thrd.basebackup_cxt.incremental_spcnode;
+        rnode->dbNode = (Oid)strtoul(dname, &end, 10);
+        if (end != fname - 1 || rnode->dbNode == InvalidOid)
+            return false;
+    }
+
+    if (!isdigit((unsigned char)*fname))
+        return false;
+    rnode->relNode = (Oid)strtoul(fname, &end, 10);
+    rnode->bucketNode = InvalidBktId;
+    if (end[0] == '_' && end[1] == 'b' && isdigit((unsigned char)end[2]))
+        rnode->bucketNode = (int4)strtol(end + 2, &end, 10);
+
+    *forknum = MAIN_FORKNUM;
+    if (*end == '_') {
+        int forkchar = forkname_chars(end + 1, forknum);
+        if (forkchar == 0)
+            return false;
+        end += forkchar + 1;
+    }
+    if (*end == '.' && isdigit((unsigned char)end[1]))
+        (void)strtoul(end + 1, &end, 10);
+
+    return *end == '\0';
+}
+
+static bool search_incremental_block_hash(const RelFileNode& rnode, ForkNumber forknum, CBMArrayEntry** changed)
+{
+    CBMPageTag tag;
+    IncrementalBlockEntry* entry = NULL;
+
+    INIT_CBMPAGETAG(tag, rnode, forknum);
+    entry = (IncrementalBlockEntry*)hash_search(
+        t_thrd.basebackup_cxt.incremental_block_hash, (void*)&tag, HASH_FIND, NULL);
+    *changed = (entry != NULL) ? entry->cbmEntry : NULL;
+    return entry != NULL;
+}
+
+/*
+ * Find the blocks of a row data file changed since the start of the previous backup. Returns
+ * false if the whole file must be sent, *changed is set to NULL if no block changed.
+ */
+static bool GetIncrementalBlocks(const char* readfilename, CBMArrayEntry** changed)
+{
+    RelFileNode rnode;
+    RelFileNode parent = InvalidRelFileNode;
+    ForkNumber forknum;
+
+    if (!parse_rel_file_name(readfilename, &rnode, &forknum))
+        return false;
+
+    /*
+     * Changes of the free space map are not WAL-logged, and the other forks except the
+     * visibility map are too small to be worth it.
+     */
+    if (forknum != MAIN_FORKNUM && forknum != VISIBILITYMAP_FORKNUM)
+        return false;
+
+    /* the files of a tablespace or database created meanwhile were copied without WAL */
+    parent.spcNode = rnode.spcNode;
+    if (search_incremental_block_hash(parent, MAIN_FORKNUM, changed))
+        return false;
+    parent.dbNode = rnode.dbNode;
+    if (search_incremental_block_hash(parent, MAIN_FORKNUM, changed))
+        return false;
+
+    /* a relation file created meanwhile may reuse the file node of a dropped one */
+    if (search_incremental_block_hash(rnode, forknum, changed) &&
+        ((*changed)->changeType & (PAGETYPE_CREATE | PAGETYPE_DROP)) != 0)
+        return false;
+
+    return true;
+}
+
+static int block_number_cmp(const void* a, const void* b)
+{
+    BlockNumber blkA = *(const BlockNumber*)a;
+    BlockNumber blkB = *(const BlockNumber*)b;
+
+    return (blkA < blkB) ? -1 : ((blkA > blkB) ? 1 : 0);
+}
+
+/*
+ * Read one block of a relation data file segment. Like sendFile(), retry while the checksum
+ * doesn't match, the page may be written concurrently. A block past the end of a file that was
+ * truncated meanwhile is sent as zeros, WAL replay truncates it again.
+ */
+static void read_incremental_block(FILE* fp, const char* readfilename, BlockNumber blkno, BlockNumber segStart)
+{
+    char* page = t_thrd.basebackup_cxt.buf_block;
+    int retryCnt = 0;
+    errno_t rc;
+
+    for (;;) {
+        if (fseeko(fp, (off_t)blkno * BLCKSZ, SEEK_SET) != 0)
+            ereport(ERROR, (errcode_for_file_access(), errmsg("could not seek in file \"%s\": %m", readfilename)));
+
+        if (fread(page, 1, BLCKSZ, fp) != BLCKSZ) {
+            if (ferror(fp))
+                ereport(ERROR, (errcode_for_file_access(), errmsg("could not read file \"%s\": %m", readfilename)));
+            rc = memset_s(page, BLCKSZ, 0, BLCKSZ);
+            securec_check(rc, "", "");
+            return;
+        }
+
+        PageHeader phdr = PageHeader(page);
+        if (!g_instance.attr.attr_storage.enableIncrementalCheckpoint || PageIsNew(phdr))
+            return;
+
+        uint16 checksum = pg_checksum_page(page, segStart + blkno);
+        if (phdr->pd_checksum == checksum)
+            return;
+
+        if (retryCnt++ == MAX_RETRY_LIMIT)
+            ereport(ERROR,
+                (errcode_for_file_access(),
+                    errmsg("base backup cheksum failed in file \"%s\"(computed: %d, recorded: %d), aborting backup",
+                        readfilename, checksum, phdr->pd_checksum)));
+        pg_usleep(100000);
+    }
+}
+
+/*
+ * Send one segment of a row data file as an incremental file, which holds only the blocks
+ * changed since the start of the previous backup. See replication/incrbackup.h for the format.
+ */
+static void sendIncrementalFile(
+    FILE* fp, const char* readfilename, const char* tarfilename, struct stat* statbuf, CBMArrayEntry* changed, int segNo)
+{
+    IncrementalFileHeader header;
+    BlockNumber segStart = (BlockNumber)segNo * ((BlockNumber)RELSEG_SIZE);
+    BlockNumber segBlocks = (BlockNumber)(statbuf->st_size / BLCKSZ);
+    BlockNumber* blocks = NULL;
+    uint32 blockCount = 0;
+    char incrfilename[MAXPGPATH];
+    struct stat incrstatbuf = *statbuf;
+    const char* fname = strrchr(tarfilename, '/');
+    pgoff_t len;
+    size_t pad;
+    errno_t rc;
+
+    header.magic = INCREMENTAL_FILE_MAGIC;
+    header.fileBlockLength = segBlocks;
+    header.truncateBlockLength = segBlocks;
+
+    if (changed != NULL) {
+        /* blocks past a truncation are not in the previous backup, even if the file grew again */
+        if (BlockNumberIsValid(changed->truncBlockNum)) {
+            BlockNumber truncBlocks = (changed->truncBlockNum > segStart) ? changed->truncBlockNum - segStart : 0;
+            header.truncateBlockLength = Min(truncBlocks, segBlocks);
+        }
+
+        blocks = (BlockNumber*)palloc(Max(changed->totalBlockNum, 1) * sizeof(BlockNumber));
+        for (uint32 i = 0; i < changed->totalBlockNum; i++) {
+            BlockNumber blkno = changed->changedBlock[i];
+            if (blkno >= segStart && blkno - segStart < segBlocks)
+                blocks[blockCount++] = blkno - segStart;
+        }
+        qsort(blocks, blockCount, sizeof(BlockNumber), block_number_cmp);
+    }
+    header.blockCount = blockCount;
+
+    rc = snprintf_s(incrfilename, sizeof(incrfilename), sizeof(incrfilename) - 1, "%.*s%s%s",
+        (fname == NULL) ? 0 : (int)(fname - tarfilename + 1), tarfilename, INCREMENTAL_FILE_PREFIX,
+        (fname == NULL) ? tarfilename : fname + 1);
+    securec_check_ss(rc, "", "");
+
+    len = sizeof(IncrementalFileHeader) + (pgoff_t)blockCount * (sizeof(BlockNumber) + BLCKSZ);
+    incrstatbuf.st_size = len;
+    _tarWriteHeader(incrfilename, NULL, &incrstatbuf);
+
+    if (SendBackupData((char*)&header, sizeof(IncrementalFileHeader)) ||
+        (blockCount > 0 && SendBackupData((char*)blocks, blockCount * sizeof(BlockNumber))))
+        ereport(ERROR, (errcode_for_file_access(), errmsg("base backup could not send data, aborting backup")));
+
+    for (uint32 i = 0; i < blockCount; i++) {
+        if (t_thrd.walsender_cxt.walsender_ready_to_stop)
+            ereport(ERROR, (errcode_for_file_access(), errmsg("base backup receive stop message, aborting backup")));
+
+        read_incremental_block(fp, readfilename, blocks[i], segStart);
+        if (SendBackupData(t_thrd.basebackup_cxt.buf_block, BLCKSZ))
+            ereport(ERROR, (errcode_for_file_access(), errmsg("base backup could not send data, aborting backup")));
+    }
+
+    /* Pad to 512 byte boundary, per tar format requirements */
+    pad = ((len + 511) & ~511) - len;
+    if (pad > 0) {
+        rc = memset_s(t_thrd.basebackup_cxt.buf_block, pad, 0, pad);
+        securec_check(rc, "", "");
+        (void)SendBackupData(t_thrd.basebackup_cxt.buf_block, pad);
+    }
+
+    if (blocks != NULL)
+        pfree(blocks);
+}
+
 static void _tarWriteHeader(const char* filename, const char* linktarget, struct stat* statbuf)
 {
     char h[BUILD_PATH_LEN];
@@ -1615,7 +2398,7 @@ static void _tarWriteHeader(const char* filename, const char* linktarget, struct
 
     /* Link tag 100 (NULL) */
     /* Now send the completed header. */
-    (void)pq_putmessage_noblock('d', h, BUILD_PATH_LEN);
+    (void)SendBackupData(h, BUILD_PATH_LEN);
 }
 
 void ut_save_xlogloc(const char* xloglocation)
@@ -26,6 +26,7 @@
 #include "miscadmin.h"
 #include "replication/walreceiver.h"
 #include "replication/libpqwalreceiver.h"
+#include "replication/walcompress.h"
 #include "storage/pmsignal.h"
 #include "storage/proc.h"
 #include "utils/guc.h"
@@ -155,6 +156,20 @@ bool libpqrcv_connect_for_TLI(TimeLineID* timeLineID, char* conninfo)
     return true;
 }
 
+/*
+ * Whether START_REPLICATION failed because the primary does not know its COMPRESSION
+ * option, or the method given with it.
+ */
+static bool libpqrcv_compression_rejected(PGresult* res)
+{
+    const char* sqlstate = NULL;
+
+    if (PQresultStatus(res) != PGRES_FATAL_ERROR)
+        return false;
+    sqlstate = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+    return sqlstate != NULL && (strcmp(sqlstate, "42601") == 0 || strcmp(sqlstate, "0A000") == 0);
+}
+
 /*
  * Establish the connection to the primary server for XLOG streaming
  */
@@ -167,6 +182,7 @@ bool libpqrcv_connect(char* conninfo, XLogRecPtr* startpoint, char* slotname, in
     TimeLineID localTli;
     PGresult* res = NULL;
     char cmd[1024];
+    const char* compression = NULL;
     char* remoteRecCrc = NULL;
     pg_crc32 recCrc = 0;
     XLogRecPtr localRec;
@@ -803,24 +819,52 @@ retry:
     }
 
     /* Start streaming from the point requested by startup process */
-    if (!t_thrd.walreceiver_cxt.AmWalReceiverForFailover && slotname != NULL)
-        nRet = snprintf_s(cmd,
-            sizeof(cmd),
-            sizeof(cmd) - 1,
-            "START_REPLICATION SLOT \"%s\" %X/%X",
-            slotname,
-            (uint32)(*startpoint >> 32),
-            (uint32)(*startpoint));
-    else
-        nRet = snprintf_s(cmd,
-            sizeof(cmd),
-            sizeof(cmd) - 1,
-            "START_REPLICATION %X/%X",
-            (uint32)(*startpoint >> 32),
-            (uint32)(*startpoint));
-    securec_check_ss(nRet, "", "");
+    compression = u_sess->attr.attr_storage.enable_wal_stream_compression ?
+        " COMPRESSION " WAL_STREAM_COMPRESSION_LZ4 : "";
+    for (;;) {
+        if (!t_thrd.walreceiver_cxt.AmWalReceiverForFailover && slotname != NULL)
+            nRet = snprintf_s(cmd,
+                sizeof(cmd),
+                sizeof(cmd) - 1,
+                "START_REPLICATION SLOT \"%s\" %X/%X%s",
+                slotname,
+                (uint32)(*startpoint >> 32),
+                (uint32)(*startpoint),
+                compression);
+        else
+            nRet = snprintf_s(cmd,
+                sizeof(cmd),
+                sizeof(cmd) - 1,
+                "START_REPLICATION %X/%X%s",
+                (uint32)(*startpoint >> 32),
+                (uint32)(*startpoint),
+                compression);
+        securec_check_ss(nRet, "", "");
 
-    res = libpqrcv_PQexec(cmd);
+        res = libpqrcv_PQexec(cmd);
+        if (compression[0] == '\0' || !libpqrcv_compression_rejected(res))
+            break;
+
+        /*
+         * A primary of an older version, or one built without the method, streams
+         * uncompressed. Its walsender exits on the error, so start over on a new
+         * connection to the same server, which has passed the checks above.
+         */
+        ereport(LOG,
+            (errmsg("primary does not support WAL stream compression, streaming uncompressed: %s",
+                PQerrorMessage(t_thrd.libwalreceiver_cxt.streamConn))));
+        PQclear(res);
+        compression = "";
+        libpqrcv_disconnect();
+        t_thrd.libwalreceiver_cxt.streamConn = PQconnectdb(conninfoRepl);
+        if (PQstatus(t_thrd.libwalreceiver_cxt.streamConn) != CONNECTION_OK) {
+            ereport(ERROR,
+                (errcode(ERRCODE_CONNECTION_TIMED_OUT),
+                    errmsg("walreceiver could not connect to the remote server,the connection info :%s : %s",
+                        conninfo,
+                        PQerrorMessage(t_thrd.libwalreceiver_cxt.streamConn))));
+        }
+    }
     if (PQresultStatus(res) != PGRES_COPY_BOTH) {
         PQclear(res);
         ereport(ERROR,
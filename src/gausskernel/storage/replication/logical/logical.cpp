@@ -63,6 +63,12 @@ static void begin_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
 static void commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 static void change_cb_wrapper(
     ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+static void stream_start_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr first_lsn);
+static void stream_change_cb_wrapper(
+    ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+static void stream_stop_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr last_lsn);
+static void stream_abort_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void stream_commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 static void LoadOutputPlugin(OutputPluginCallbacks* callbacks, const char* plugin);
 
 /*
@@ -155,6 +161,11 @@ static LogicalDecodingContext* StartupDecodingContext(List* output_plugin_option
     ctx->reorder->begin = begin_cb_wrapper;
     ctx->reorder->apply_change = change_cb_wrapper;
     ctx->reorder->commit = commit_cb_wrapper;
+    ctx->reorder->stream_start = stream_start_cb_wrapper;
+    ctx->reorder->stream_change = stream_change_cb_wrapper;
+    ctx->reorder->stream_stop = stream_stop_cb_wrapper;
+    ctx->reorder->stream_abort = stream_abort_cb_wrapper;
+    ctx->reorder->stream_commit = stream_commit_cb_wrapper;
 
     ctx->out = makeStringInfo();
     ctx->prepare_write = prepare_write;
@@ -163,6 +174,9 @@ static LogicalDecodingContext* StartupDecodingContext(List* output_plugin_option
     ctx->output_plugin_options = output_plugin_options;
     ctx->fast_forward = fast_forward;
 
+    /* stream in-progress transactions if the plugin can, it may still opt out in its startup callback */
+    ctx->streaming = !fast_forward && ctx->callbacks.stream_start_cb != NULL;
+
     (void)MemoryContextSwitchTo(old_context);
 
     return ctx;
@@ -324,6 +338,8 @@ LogicalDecodingContext* CreateInitDecodingContext(const char* plugin, List* outp
         startup_cb_wrapper(ctx, &ctx->options, true);
     (void)MemoryContextSwitchTo(old_context);
 
+    ctx->reorder->streaming = ctx->streaming;
+
     return ctx;
 }
 
@@ -409,6 +425,8 @@ LogicalDecodingContext* CreateDecodingContext(XLogRecPtr start_lsn, List* output
         startup_cb_wrapper(ctx, &ctx->options, false);
     (void)MemoryContextSwitchTo(old_context);
 
+    ctx->reorder->streaming = ctx->streaming;
+
     if (!RecoveryInProgress())
         ereport(LOG,
             (errmsg("starting logical decoding for slot %s", NameStr(slot->data.name)),
@@ -545,6 +563,18 @@ static void LoadOutputPlugin(OutputPluginCallbacks* callbacks, const char* plugi
     if (callbacks->commit_cb == NULL)
         ereport(ERROR,
             (errcode(ERRCODE_LOGICAL_DECODE_ERROR), errmsg("output plugins have to register a commit callback")));
+
+    /* streaming of in-progress transactions is optional, but needs all of its callbacks */
+    if (callbacks->stream_start_cb != NULL || callbacks->stream_change_cb != NULL ||
+        callbacks->stream_stop_cb != NULL || callbacks->stream_abort_cb != NULL ||
+        callbacks->stream_commit_cb != NULL) {
+        if (callbacks->stream_start_cb == NULL || callbacks->stream_change_cb == NULL ||
+            callbacks->stream_stop_cb == NULL || callbacks->stream_abort_cb == NULL ||
+            callbacks->stream_commit_cb == NULL)
+            ereport(ERROR,
+                (errcode(ERRCODE_LOGICAL_DECODE_ERROR),
+                    errmsg("output plugins have to register either all or none of the stream callbacks")));
+    }
 }
 
 static void output_plugin_error_callback(void* arg)
@@ -712,6 +742,154 @@ static void change_cb_wrapper(
     t_thrd.log_cxt.error_context_stack = errcallback.previous;
 }
 
+/*
+ * Callbacks for streaming in-progress transactions, see ReorderBufferStreamTXN.
+ */
+static void stream_start_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr first_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_start";
+    state.report_location = first_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = first_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_start_cb(ctx, txn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_change_cb_wrapper(
+    ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_change";
+    state.report_location = change->lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state, see change_cb_wrapper */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = change->lsn;
+
+    ctx->callbacks.stream_change_cb(ctx, txn, relation, change);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_stop_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr last_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_stop";
+    state.report_location = last_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = last_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_stop_cb(ctx, txn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_abort_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_abort";
+    state.report_location = abort_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state, transactions lost in a crash have no abort record */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = XLogRecPtrIsInvalid(abort_lsn) ? txn->first_lsn : abort_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_abort_cb(ctx, txn, abort_lsn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_commit";
+    state.report_location = txn->final_lsn; /* beginning of commit record */
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->end_lsn; /* points to the end of the record */
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_commit_cb(ctx, txn, commit_lsn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
 bool filter_by_origin_cb_wrapper(LogicalDecodingContext* ctx, RepOriginId origin_id)
 {
     LogicalErrorCallbackState state;
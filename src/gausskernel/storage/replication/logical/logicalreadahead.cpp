@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * logicalreadahead.cpp
+ *        Reading WAL ahead of logical decoding in a walsender.
+ *
+ * The read-ahead thread is a plain thread without any backend state, so it must not
+ * palloc, ereport or touch shared memory. It only reads whole flushed pages from the WAL
+ * segment files into a ring. Any failure just stops it, and the walsender reads the
+ * pages itself from then on, reporting the error if there really is one.
+ *
+ * The ring holds the pages from head up to tail. The walsender consumes pages from the
+ * head and the thread appends at the tail. If the walsender asks for a page outside the
+ * ring, the ring is restarted at that page; a page the thread was reading meanwhile is
+ * thrown away, which is detected by the generation counter.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/replication/logical/logicalreadahead.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include "access/xlog_internal.h"
+#include "miscadmin.h"
+#include "replication/logicalreadahead.h"
+
+struct LogicalReadAhead {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond; /* signaled whenever any of the fields below change */
+
+    TimeLineID tli;
+    int npages;
+    char* pages;
+
+    XLogRecPtr head;     /* first page held by the ring */
+    XLogRecPtr tail;     /* page the thread reads next */
+    XLogRecPtr limit;    /* WAL is flushed up to here */
+    uint64 generation;   /* bumped whenever the ring is restarted */
+    bool failed;         /* could not read a page, give up */
+    bool shutdown;
+
+    /* used by the thread only */
+    int fd;
+    XLogSegNo segno;
+};
+
+#define READAHEAD_SLOT(readahead, pageptr) \
+    ((readahead)->pages + ((pageptr) / XLOG_BLCKSZ % (uint64)(readahead)->npages) * XLOG_BLCKSZ)
+/* the walsender checks for interrupts this often while it waits for a page */
+#define READAHEAD_WAIT_MS 100
+#define NSECS_PER_MSEC 1000000L
+#define NSECS_PER_SEC 1000000000L
+
+#define READAHEAD_FULL(readahead) \
+    ((readahead)->tail - (readahead)->head >= (uint64)(readahead)->npages * XLOG_BLCKSZ)
+
+static void* LogicalReadAheadMain(void* arg);
+static bool LogicalReadAheadReadPage(LogicalReadAhead* readahead, XLogRecPtr pageptr, char* page);
+
+/*
+ * Start a read-ahead thread that keeps up to npages pages following startptr. Returns
+ * NULL if the thread cannot be started, the caller then reads all the pages itself.
+ */
+LogicalReadAhead* LogicalReadAheadStart(XLogRecPtr startptr, TimeLineID tli, int npages)
+{
+    LogicalReadAhead* readahead = NULL;
+    sigset_t sigs;
+    sigset_t oldsigs;
+    int rc;
+
+    Assert(npages > 0);
+
+    readahead = (LogicalReadAhead*)malloc(sizeof(LogicalReadAhead));
+    if (readahead == NULL) {
+        ereport(WARNING, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("could not start WAL read-ahead: out of memory")));
+        return NULL;
+    }
+    readahead->pages = (char*)malloc((Size)npages * XLOG_BLCKSZ);
+    if (readahead->pages == NULL) {
+        free(readahead);
+        ereport(WARNING, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("could not start WAL read-ahead: out of memory")));
+        return NULL;
+    }
+
+    (void)pthread_mutex_init(&readahead->lock, NULL);
+    (void)pthread_cond_init(&readahead->cond, NULL);
+    readahead->tli = tli;
+    readahead->npages = npages;
+    readahead->head = startptr - startptr % XLOG_BLCKSZ;
+    readahead->tail = readahead->head;
+    readahead->limit = InvalidXLogRecPtr;
+    readahead->generation = 0;
+    readahead->failed = false;
+    readahead->shutdown = false;
+    readahead->fd = -1;
+    readahead->segno = 0;
+
+    /* signals are meant for the walsender, keep them away from the thread */
+    (void)sigfillset(&sigs);
+    (void)pthread_sigmask(SIG_SETMASK, &sigs, &oldsigs);
+    rc = pthread_create(&readahead->thread, NULL, LogicalReadAheadMain, readahead);
+    (void)pthread_sigmask(SIG_SETMASK, &oldsigs, NULL);
+
+    if (rc != 0) {
+        (void)pthread_cond_destroy(&readahead->cond);
+        (void)pthread_mutex_destroy(&readahead->lock);
+        free(readahead->pages);
+        free(readahead);
+        ereport(WARNING, (errmsg("could not start WAL read-ahead thread: error code %d", rc)));
+        return NULL;
+    }
+
+    return readahead;
+}
+
+/*
+ * Let the thread read the pages before limit, which has been flushed.
+ */
+void LogicalReadAheadSetLimit(LogicalReadAhead* readahead, XLogRecPtr limit)
+{
+    (void)pthread_mutex_lock(&readahead->lock);
+    if (XLByteLT(readahead->limit, limit)) {
+        readahead->limit = limit;
+        (void)pthread_cond_broadcast(&readahead->cond);
+    }
+    (void)pthread_mutex_unlock(&readahead->lock);
+}
+
+/*
+ * Wait for the thread with the lock held, but no longer than READAHEAD_WAIT_MS at a
+ * time, so that the walsender still handles its interrupts if a read hangs on a slow
+ * disk. The lock is released while interrupts are checked, as they may throw.
+ */
+static void LogicalReadAheadWait(LogicalReadAhead* readahead)
+{
+    struct timespec deadline;
+
+    (void)clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += READAHEAD_WAIT_MS * NSECS_PER_MSEC;
+    if (deadline.tv_nsec >= NSECS_PER_SEC) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= NSECS_PER_SEC;
+    }
+
+    if (pthread_cond_timedwait(&readahead->cond, &readahead->lock, &deadline) == ETIMEDOUT) {
+        (void)pthread_mutex_unlock(&readahead->lock);
+        CHECK_FOR_INTERRUPTS();
+        (void)pthread_mutex_lock(&readahead->lock);
+    }
+}
+
+/*
+ * Copy the page at pageptr into page if it has been read ahead, and release the pages
+ * before it. Returns false if the caller has to read the page itself.
+ */
+bool LogicalReadAheadGetPage(LogicalReadAhead* readahead, XLogRecPtr pageptr, char* page)
+{
+    errno_t rc;
+
+    Assert(pageptr % XLOG_BLCKSZ == 0);
+
+    (void)pthread_mutex_lock(&readahead->lock);
+    while (XLByteLE(readahead->head, pageptr) && XLByteLE(pageptr, readahead->tail)) {
+        if (XLByteLT(readahead->head, pageptr)) {
+            /* done with the pages before, make room for the thread */
+            readahead->head = pageptr;
+            (void)pthread_cond_broadcast(&readahead->cond);
+        }
+
+        if (XLByteLT(pageptr, readahead->tail)) {
+            rc = memcpy_s(page, XLOG_BLCKSZ, READAHEAD_SLOT(readahead, pageptr), XLOG_BLCKSZ);
+            securec_check_c(rc, "\0", "\0");
+            (void)pthread_mutex_unlock(&readahead->lock);
+            return true;
+        }
+
+        /* the thread is about to read the page, rather wait than read it twice */
+        if (readahead->failed || XLByteLT(readahead->limit, pageptr + XLOG_BLCKSZ))
+            break;
+        LogicalReadAheadWait(readahead);
+    }
+
+    /* restart the ring at the page, unless the thread is going to read it anyway */
+    if (!readahead->failed && !XLByteEQ(readahead->tail, pageptr)) {
+        readahead->head = pageptr;
+        readahead->tail = pageptr;
+        readahead->generation++;
+        (void)pthread_cond_broadcast(&readahead->cond);
+    }
+    (void)pthread_mutex_unlock(&readahead->lock);
+
+    return false;
+}
+
+/*
+ * Stop the thread and free the ring.
+ */
+void LogicalReadAheadStop(LogicalReadAhead* readahead)
+{
+    (void)pthread_mutex_lock(&readahead->lock);
+    readahead->shutdown = true;
+    (void)pthread_cond_broadcast(&readahead->cond);
+    (void)pthread_mutex_unlock(&readahead->lock);
+
+    (void)pthread_join(readahead->thread, NULL);
+
+    (void)pthread_cond_destroy(&readahead->cond);
+    (void)pthread_mutex_destroy(&readahead->lock);
+    free(readahead->pages);
+    free(readahead);
+}
+
+static void* LogicalReadAheadMain(void* arg)
+{
+    LogicalReadAhead* readahead = (LogicalReadAhead*)arg;
+
+    for (;;) {
+        XLogRecPtr pageptr;
+        uint64 generation;
+        bool done = false;
+
+        (void)pthread_mutex_lock(&readahead->lock);
+        while (!readahead->shutdown && !readahead->failed &&
+               (READAHEAD_FULL(readahead) || XLByteLT(readahead->limit, readahead->tail + XLOG_BLCKSZ)))
+            (void)pthread_cond_wait(&readahead->cond, &readahead->lock);
+        if (readahead->shutdown || readahead->failed) {
+            (void)pthread_mutex_unlock(&readahead->lock);
+            break;
+        }
+        pageptr = readahead->tail;
+        generation = readahead->generation;
+        (void)pthread_mutex_unlock(&readahead->lock);
+
+        /* the slot is past the tail, so the walsender doesn't look at it while we fill it */
+        done = LogicalReadAheadReadPage(readahead, pageptr, READAHEAD_SLOT(readahead, pageptr));
+
+        (void)pthread_mutex_lock(&readahead->lock);
+        if (!done)
+            readahead->failed = true;
+        else if (generation == readahead->generation)
+            readahead->tail = pageptr + XLOG_BLCKSZ;
+        (void)pthread_cond_broadcast(&readahead->cond);
+        (void)pthread_mutex_unlock(&readahead->lock);
+    }
+
+    if (readahead->fd >= 0) {
+        (void)close(readahead->fd);
+        readahead->fd = -1;
+    }
+
+    return NULL;
+}
+
+static bool LogicalReadAheadReadPage(LogicalReadAhead* readahead, XLogRecPtr pageptr, char* page)
+{
+    XLogSegNo segno;
+
+    XLByteToSeg(pageptr, segno);
+    if (readahead->fd < 0 || segno != readahead->segno) {
+        char path[MAXPGPATH];
+
+        if (readahead->fd >= 0)
+            (void)close(readahead->fd);
+
+        XLogFilePath(path, readahead->tli, segno);
+        readahead->fd = open(path, O_RDONLY | PG_BINARY, 0);
+        if (readahead->fd < 0)
+            return false;
+        readahead->segno = segno;
+    }
+
+    return pread(readahead->fd, page, XLOG_BLCKSZ, (off_t)(pageptr % XLogSegSize)) == XLOG_BLCKSZ;
+}
@@ -37,6 +37,14 @@
  *	contents of individual (sub-)transactions will be read from disk in
  *	chunks.
  *
+ *	If the output plugin supports it, large transactions are streamed
+ *	instead: once a transaction's changes use more than
+ *	logical_decoding_work_mem, or as many as would be spilled to disk, the
+ *	changes received so far are sent to the plugin in a block of streamed
+ *	changes and freed, and the rest follows at commit. This is only done as
+ *	long as the transaction, including its subtransactions, hasn't modified
+ *	the catalog and hasn't been spilled, see ReorderBufferCanStreamTXN().
+ *
  *	This module also has to deal with reassembling toast records from the
  *	individual chunks stored in WAL. When a new (or initial) version of a
  *	tuple is stored in WAL it will always be preceded by the toast chunks
@@ -167,7 +175,10 @@ static void ReorderBufferTransferSnapToParent(ReorderBufferTXN* txn, ReorderBuff
 static ReorderBufferIterTXNState* ReorderBufferIterTXNInit(ReorderBuffer* rb, ReorderBufferTXN* txn);
 static ReorderBufferChange* ReorderBufferIterTXNNext(ReorderBuffer* rb, ReorderBufferIterTXNState* state);
 static void ReorderBufferIterTXNFinish(ReorderBuffer* rb, ReorderBufferIterTXNState* state);
+static XLogRecPtr ReorderBufferIterTXNPeekLSN(ReorderBufferIterTXNState* state);
 static void ReorderBufferExecuteInvalidations(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static bool ReorderBufferApplyTupleChange(
+    ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change, ReorderBufferApplyChangeCB apply_change);
 
 /*
  * ---------------------------------------
@@ -181,6 +192,16 @@ static Size ReorderBufferRestoreChanges(ReorderBuffer* rb, ReorderBufferTXN* txn
 static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn, char* change);
 static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn);
 
+/*
+ * ---------------------------------------
+ * Streaming support functions
+ * ---------------------------------------
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange* change);
+static void ReorderBufferUpdateMemory(ReorderBufferTXN* txn, Size sz, bool addition);
+static bool ReorderBufferCanStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
 static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap);
 static Snapshot ReorderBufferCopySnap(ReorderBuffer* rb, Snapshot orig_snap, ReorderBufferTXN* txn, CommandId cid);
 
@@ -529,10 +550,12 @@ void ReorderBufferQueueChange(ReorderBuffer* rb, TransactionId xid, XLogRecPtr l
     txn = ReorderBufferTXNByXid(rb, xid, true, NULL, lsn, true);
 
     change->lsn = lsn;
+    change->txn = txn;
     Assert(!XLByteEQ(InvalidXLogRecPtr, lsn));
     dlist_push_tail(&txn->changes, &change->node);
     txn->nentries++;
     txn->nentries_mem++;
+    ReorderBufferUpdateMemory(txn, ReorderBufferChangeSize(change), true);
 
     ReorderBufferCheckSerializeTXN(rb, txn);
 }
@@ -673,7 +696,12 @@ void ReorderBufferAssignChild(ReorderBuffer* rb, TransactionId xid, TransactionI
     }
     subtxn->is_known_as_subxact = true;
     subtxn->toplevel_xid = xid;
+    subtxn->toptxn = txn;
     Assert(subtxn->nsubtxns == 0);
+
+    /* the subtxn's changes are accounted to its top-level txn from now on */
+    txn->total_size += subtxn->size;
+    subtxn->total_size = 0;
     /* add to subtransaction list */
     dlist_push_tail(&txn->subtxns, &subtxn->node);
     txn->nsubtxns++;
@@ -1007,6 +1035,18 @@ static void ReorderBufferIterTXNFinish(ReorderBuffer* rb, ReorderBufferIterTXNSt
     state = NULL;
 }
 
+/*
+ * LSN of the change the next ReorderBufferIterTXNNext() call returns, or
+ * InvalidXLogRecPtr if there is none.
+ */
+static XLogRecPtr ReorderBufferIterTXNPeekLSN(ReorderBufferIterTXNState* state)
+{
+    if (state->heap->bh_size == 0)
+        return InvalidXLogRecPtr;
+
+    return state->entries[DatumGetInt32(binaryheap_first(state->heap))].lsn;
+}
+
 /*
  * Cleanup the contents of a transaction, usually after the transaction
  * committed or aborted.
@@ -1064,6 +1104,15 @@ static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
         dlist_delete(&txn->base_snapshot_node);
     }
 
+    /* and the snapshot streaming stopped at */
+    if (txn->stream_snapshot != NULL) {
+        SnapBuildSnapDecRefcount(txn->stream_snapshot);
+        txn->stream_snapshot = NULL;
+    }
+
+    /* toast chunks may be left over when the last streamed change was one */
+    ReorderBufferToastReset(rb, txn);
+
     /*
      * Remove TXN from its containing list.
      *
@@ -1225,6 +1274,93 @@ static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap)
         SnapBuildSnapDecRefcount(snap);
 }
 
+/*
+ * Look up the relation of an INSERT/UPDATE/DELETE change and pass the change
+ * to apply_change, reassembling toasted datums on the way.
+ *
+ * Returns true if the change is a toast chunk that has been moved to the
+ * transaction's toast hash, so it must not be freed by the caller.
+ */
+static bool ReorderBufferApplyTupleChange(
+    ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change, ReorderBufferApplyChangeCB apply_change)
+{
+    Relation relation = NULL;
+    Oid reloid;
+    Oid partitionReltoastrelid = InvalidOid;
+    bool kept = false;
+
+    reloid = RelidByRelfilenode(change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode);
+    if (reloid == InvalidOid) {
+        reloid = PartitionRelidByRelfilenode(
+            change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode, partitionReltoastrelid);
+    }
+    /*
+     * Catalog tuple without data, emitted while catalog was
+     * in the process of being rewritten.
+     */
+    if (reloid == InvalidOid && change->data.tp.newtuple == NULL && change->data.tp.oldtuple == NULL)
+        return false;
+    else if (reloid == InvalidOid) {
+        /*
+         * description:
+         * When we try to decode a table who is already dropped.
+         * Maybe we could not find it relnode.In this time, we will undecode this log.
+         * It will be solve when we use MVCC.
+         */
+        ereport(DEBUG1,
+            (errmsg("could not lookup relation %s", relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
+        return false;
+    }
+
+    relation = RelationIdGetRelation(reloid);
+    if (relation == NULL) {
+        ereport(DEBUG1,
+            (errmsg("could open relation descriptor %s", relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
+        return false;
+    }
+
+    if (CSTORE_NAMESPACE == get_rel_namespace(RelationGetRelid(relation))) {
+        RelationClose(relation);
+        return false;
+    }
+
+    if (RelationIsLogicallyLogged(relation)) {
+        /*
+         * For now ignore sequence changes entirely. Most of
+         * the time they don't log changes using records we
+         * understand, so it doesn't make sense to handle the
+         * few cases we do.
+         */
+        if (relation->rd_rel->relkind == RELKIND_SEQUENCE) {
+        } else if (!IsToastRelation(relation)) { /* user-triggered change */
+            ReorderBufferToastReplace(rb, txn, relation, change, partitionReltoastrelid);
+            apply_change(rb, txn, relation, change);
+            /*
+             * Only clear reassembled toast chunks if we're
+             * sure they're not required anymore. The creator
+             * of the tuple tells us.
+             */
+            if (change->data.tp.clear_toast_afterwards)
+                ReorderBufferToastReset(rb, txn);
+        } else if (change->action == REORDER_BUFFER_CHANGE_INSERT) {
+            /* we're not interested in toast deletions
+             *
+             * Need to reassemble the full toasted Datum in
+             * memory, to ensure the chunks don't get reused
+             * till we're done remove it from the list of this
+             * transaction's changes. Otherwise it will get
+             * freed/reused while restoring spooled data from
+             * disk.
+             */
+            dlist_delete(&change->node);
+            ReorderBufferToastAppendChunk(rb, txn, relation, change);
+            kept = true;
+        }
+    }
+    RelationClose(relation);
+    return kept;
+}
+
 /*
  * Perform the replay of a transaction and its non-aborted subtransactions.
  *
@@ -1237,6 +1373,10 @@ static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap)
  * invalidations. Thus, once a toplevel commit is read, we iterate over the top
  * and subtransactions (using a k-way merge) and replay the changes in lsn
  * order.
+ *
+ * If parts of the transaction have been streamed already, the remaining
+ * changes are sent as a last block of streamed changes, followed by the
+ * stream commit.
  */
 void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
     RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time)
@@ -1249,6 +1389,7 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
     volatile Snapshot snapshot_now = NULL;
     volatile bool txn_started = false;
     volatile bool subtxn_started = false;
+    ReorderBufferApplyChangeCB apply_change;
 
     txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr, false);
     /* unknown transaction, nothing to replay */
@@ -1273,7 +1414,12 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         return;
     }
 
-    snapshot_now = txn->base_snapshot;
+    /* a streamed transaction continues with the snapshot the last block ended with */
+    if (txn->stream_snapshot != NULL)
+        snapshot_now = txn->stream_snapshot;
+    else
+        snapshot_now = txn->base_snapshot;
+    apply_change = txn->streamed ? rb->stream_change : rb->apply_change;
 
     /* build data to be able to lookup the CommandIds of catalog tuples */
     ReorderBufferBuildTupleCidHash(rb, txn);
@@ -1303,89 +1449,23 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
             txn_started = true;
         }
 
-        rb->begin(rb, txn);
-
         iterstate = ReorderBufferIterTXNInit(rb, txn);
-        while ((change = ReorderBufferIterTXNNext(rb, iterstate))) {
-            Relation relation = NULL;
-            Oid reloid;
-            Oid partitionReltoastrelid = InvalidOid;
 
+        if (txn->streamed) {
+            XLogRecPtr first_lsn = ReorderBufferIterTXNPeekLSN(iterstate);
+
+            rb->stream_start(rb, txn, XLogRecPtrIsInvalid(first_lsn) ? commit_lsn : first_lsn);
+        } else
+            rb->begin(rb, txn);
+
+        while ((change = ReorderBufferIterTXNNext(rb, iterstate))) {
             switch (change->action) {
                 case REORDER_BUFFER_CHANGE_INSERT:
                 case REORDER_BUFFER_CHANGE_UPDATE:
                 case REORDER_BUFFER_CHANGE_DELETE:
                     Assert(snapshot_now);
 
-                    reloid = RelidByRelfilenode(change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode);
-                    if (reloid == InvalidOid) {
-                        reloid = PartitionRelidByRelfilenode(
-                            change->data.tp.relnode.spcNode, change->data.tp.relnode.relNode, partitionReltoastrelid);
-                    }
-                    /*
-                     * Catalog tuple without data, emitted while catalog was
-                     * in the process of being rewritten.
-                     */
-                    if (reloid == InvalidOid && change->data.tp.newtuple == NULL && change->data.tp.oldtuple == NULL)
-                        continue;
-                    else if (reloid == InvalidOid) {
-                        /*
-                         * description:
-                         * When we try to decode a table who is already dropped.
-                         * Maybe we could not find it relnode.In this time, we will undecode this log.
-                         * It will be solve when we use MVCC.
-                         */
-                        ereport(DEBUG1,
-                            (errmsg(
-                                "could not lookup relation %s", relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
-                        continue;
-                    }
-
-                    relation = RelationIdGetRelation(reloid);
-                    if (relation == NULL) {
-                        ereport(DEBUG1,
-                            (errmsg("could open relation descriptor %s",
-                                relpathperm(change->data.tp.relnode, MAIN_FORKNUM))));
-                        continue;
-                    }
-
-                    if (CSTORE_NAMESPACE == get_rel_namespace(RelationGetRelid(relation))) {
-                        continue;
-                    }
-
-                    if (RelationIsLogicallyLogged(relation)) {
-                        /*
-                         * For now ignore sequence changes entirely. Most of
-                         * the time they don't log changes using records we
-                         * understand, so it doesn't make sense to handle the
-                         * few cases we do.
-                         */
-                        if (relation->rd_rel->relkind == RELKIND_SEQUENCE) {
-                        } else if (!IsToastRelation(relation)) { /* user-triggered change */
-                            ReorderBufferToastReplace(rb, txn, relation, change, partitionReltoastrelid);
-                            rb->apply_change(rb, txn, relation, change);
-                            /*
-                             * Only clear reassembled toast chunks if we're
-                             * sure they're not required anymore. The creator
-                             * of the tuple tells us.
-                             */
-                            if (change->data.tp.clear_toast_afterwards)
-                                ReorderBufferToastReset(rb, txn);
-                        } else if (change->action == REORDER_BUFFER_CHANGE_INSERT) {
-                            /* we're not interested in toast deletions
-                             *
-                             * Need to reassemble the full toasted Datum in
-                             * memory, to ensure the chunks don't get reused
-                             * till we're done remove it from the list of this
-                             * transaction's changes. Otherwise it will get
-                             * freed/reused while restoring spooled data from
-                             * disk.
-                             */
-                            dlist_delete(&change->node);
-                            ReorderBufferToastAppendChunk(rb, txn, relation, change);
-                        }
-                    }
-                    RelationClose(relation);
+                    (void)ReorderBufferApplyTupleChange(rb, txn, change, apply_change);
                     break;
                 case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT:
                     /* get rid of the old */
@@ -1445,7 +1525,11 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         iterstate = NULL;
 
         /* call commit callback */
-        rb->commit(rb, txn, commit_lsn);
+        if (txn->streamed) {
+            rb->stream_stop(rb, txn, commit_lsn);
+            rb->stream_commit(rb, txn, commit_lsn);
+        } else
+            rb->commit(rb, txn, commit_lsn);
 
         /* this is just a sanity check against bad output plugin behaviour */
         if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
@@ -1530,6 +1614,10 @@ void ReorderBufferAbort(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     /* cosmetic... */
     txn->final_lsn = lsn;
 
+    /* the output plugin has to discard what has been streamed of it */
+    if (txn->streamed)
+        rb->stream_abort(rb, txn, lsn);
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1561,6 +1649,9 @@ void ReorderBufferAbortOld(ReorderBuffer* rb, TransactionId oldestRunningXid)
             if (!RecoveryInProgress())
                 ereport(DEBUG2, (errmsg("aborting old transaction %lu", txn->xid)));
 
+            if (txn->streamed)
+                rb->stream_abort(rb, txn, InvalidXLogRecPtr);
+
             /* remove potential on-disk data, and deallocate this tx */
             ReorderBufferCleanupTXN(rb, txn);
         } else
@@ -1616,6 +1707,13 @@ void ReorderBufferForget(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     } else
         Assert(txn->ninvalidations == 0);
 
+    /*
+     * A streamed transaction is forgotten only if its commit isn't decoded
+     * after all, e.g. because of its origin, so what was streamed is void.
+     */
+    if (txn->streamed && !txn->is_known_as_subxact)
+        rb->stream_abort(rb, txn, lsn);
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1810,6 +1908,251 @@ bool ReorderBufferXidHasBaseSnapshot(ReorderBuffer* rb, TransactionId xid)
     return txn->base_snapshot != NULL;
 }
 
+/*
+ * ---------------------------------------
+ * Streaming support
+ * ---------------------------------------
+ *
+ *
+ * Memory used by a change kept in memory.
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange* change)
+{
+    Size sz = sizeof(ReorderBufferChange);
+
+    switch (change->action) {
+        case REORDER_BUFFER_CHANGE_INSERT:
+        case REORDER_BUFFER_CHANGE_UPDATE:
+        case REORDER_BUFFER_CHANGE_DELETE:
+            if (change->data.tp.oldtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.oldtuple->tuple.t_len;
+            if (change->data.tp.newtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.newtuple->tuple.t_len;
+            break;
+        case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT:
+            /* the snapshot is shared with the snapshot builder, only count the change */
+        case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+        case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+            break;
+    }
+
+    return sz;
+}
+
+/*
+ * Account for sz bytes of changes being added to or removed from the memory
+ * of txn, and of its top-level transaction.
+ */
+static void ReorderBufferUpdateMemory(ReorderBufferTXN* txn, Size sz, bool addition)
+{
+    ReorderBufferTXN* toptxn = (txn->toptxn != NULL) ? txn->toptxn : txn;
+
+    if (addition) {
+        txn->size += sz;
+        toptxn->total_size += sz;
+    } else {
+        Assert(txn->size >= sz && toptxn->total_size >= sz);
+        txn->size -= sz;
+        toptxn->total_size -= sz;
+    }
+}
+
+/*
+ * Can the in-memory changes of the top-level transaction txn be streamed
+ * before it commits?
+ *
+ * Every subtransaction is known to be one before its first change has been
+ * decoded, since with wal_level=logical the assignment of subtransaction xids
+ * is logged right away. So all the changes we hold for txn are queued in txn
+ * or its known subtransactions, and can be streamed in LSN order.
+ *
+ * Streaming a transaction that modifies the catalog would need its changes to
+ * be decoded with its own intermediate catalog contents, which may vanish if
+ * it aborts concurrently, so that is not done. Neither is streaming after any
+ * part of it has been spilled to disk, since the spilled changes would have
+ * to be sent before the ones still in memory.
+ */
+static bool ReorderBufferCanStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)rb->private_data;
+    dlist_iter iter;
+
+    if (!rb->streaming || txn->is_known_as_subxact || txn->base_snapshot == NULL)
+        return false;
+
+    /*
+     * Only stream what will be decoded at commit. Before decoding reaches the
+     * position the client asked for, commits are skipped, see DecodeCommit().
+     */
+    if (SnapBuildCurrentState(ctx->snapshot_builder) != SNAPBUILD_CONSISTENT ||
+        SnapBuildXactNeedsSkip(ctx->snapshot_builder, ctx->reader->EndRecPtr))
+        return false;
+
+    if (txn->has_catalog_changes || txn->serialized)
+        return false;
+
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (subtxn->has_catalog_changes || subtxn->serialized)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Remove a streamed change from its transaction and free it.
+ */
+static void ReorderBufferForgetStreamedChange(ReorderBuffer* rb, ReorderBufferChange* change, bool kept)
+{
+    ReorderBufferTXN* txn = change->txn;
+
+    ReorderBufferUpdateMemory(txn, ReorderBufferChangeSize(change), false);
+    txn->nentries--;
+    txn->nentries_mem--;
+
+    /* toast chunks have been moved to the toast hash, which frees them */
+    if (!kept) {
+        dlist_delete(&change->node);
+        ReorderBufferReturnChange(rb, change);
+    }
+}
+
+/*
+ * Send the changes of txn and its subtransactions held in memory to the
+ * output plugin as a block of streamed changes, and free them.
+ *
+ * The changes are decoded with the snapshot valid at their position, like at
+ * commit. The snapshot the block ends with is kept for the next block, and
+ * toast chunks of a tuple that hasn't been streamed yet are kept in the toast
+ * hash. Changes queued later are added to the emptied lists, so the next
+ * block or the final replay in ReorderBufferCommit() carries on from here.
+ */
+static void ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    ReorderBufferIterTXNState* volatile iterstate = NULL;
+    ReorderBufferChange* change = NULL;
+    volatile Snapshot snapshot_now = NULL;
+    volatile bool txn_started = false;
+    volatile bool subtxn_started = false;
+    XLogRecPtr last_lsn = InvalidXLogRecPtr;
+    dlist_iter iter;
+
+    if (txn->stream_snapshot != NULL)
+        snapshot_now = txn->stream_snapshot;
+    else
+        snapshot_now = txn->base_snapshot;
+
+    /* no catalog changes, so no need for the CommandIds of catalog tuples */
+    SetupHistoricSnapshot(snapshot_now, NULL);
+
+    PG_TRY();
+    {
+        /* catalog access needs a transaction, see ReorderBufferCommit() */
+        if (IsTransactionOrTransactionBlock()) {
+            BeginInternalSubTransaction("stream");
+            subtxn_started = true;
+        } else {
+            StartTransactionCommand();
+            txn_started = true;
+        }
+
+        iterstate = ReorderBufferIterTXNInit(rb, txn);
+
+        rb->stream_start(rb, txn, ReorderBufferIterTXNPeekLSN(iterstate));
+
+        while ((change = ReorderBufferIterTXNNext(rb, iterstate)) != NULL) {
+            bool kept = false;
+
+            last_lsn = change->lsn;
+
+            switch (change->action) {
+                case REORDER_BUFFER_CHANGE_INSERT:
+                case REORDER_BUFFER_CHANGE_UPDATE:
+                case REORDER_BUFFER_CHANGE_DELETE:
+                    kept = ReorderBufferApplyTupleChange(rb, txn, change, rb->stream_change);
+                    break;
+
+                case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT:
+                    /*
+                     * Snapshots of a transaction without catalog changes are
+                     * never copied. Keep a reference of our own, the change
+                     * goes away below.
+                     */
+                    Assert(!change->data.snapshot->copied);
+                    TeardownHistoricSnapshot(false);
+
+                    SnapBuildSnapIncRefcount(change->data.snapshot);
+                    if (txn->stream_snapshot != NULL)
+                        SnapBuildSnapDecRefcount(txn->stream_snapshot);
+                    txn->stream_snapshot = change->data.snapshot;
+                    snapshot_now = txn->stream_snapshot;
+
+                    SetupHistoricSnapshot(snapshot_now, NULL);
+                    break;
+
+                case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+                    /* only matters for catalog modifying transactions */
+                    break;
+
+                case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+                    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("tuplecid value in changequeue")));
+                    break;
+            }
+
+            ReorderBufferForgetStreamedChange(rb, change, kept);
+        }
+
+        ReorderBufferIterTXNFinish(rb, iterstate);
+        iterstate = NULL;
+
+        rb->stream_stop(rb, txn, last_lsn);
+
+        /* this is just a sanity check against bad output plugin behaviour */
+        if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
+            ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                    errmsg("output plugin used xid %lu", GetCurrentTransactionId())));
+
+        TeardownHistoricSnapshot(false);
+
+        if (subtxn_started)
+            RollbackAndReleaseCurrentSubTransaction();
+        else if (txn_started)
+            AbortCurrentTransaction();
+    }
+    PG_CATCH();
+    {
+        if (iterstate != NULL)
+            ReorderBufferIterTXNFinish(rb, iterstate);
+
+        TeardownHistoricSnapshot(true);
+
+        if (subtxn_started)
+            RollbackAndReleaseCurrentSubTransaction();
+        else if (txn_started)
+            AbortCurrentTransaction();
+
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+
+    if (!RecoveryInProgress())
+        ereport(DEBUG2,
+            (errmsg("streamed changes of tx %lu up to %X/%X", txn->xid, (uint32)(last_lsn >> 32), (uint32)last_lsn)));
+
+    /* the rest of the transaction has to be streamed as well, and aborts of its subxacts sent */
+    txn->streamed = true;
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        subtxn->streamed = true;
+    }
+}
+
 /*
  * ---------------------------------------
  * Disk serialization support
@@ -1830,10 +2173,24 @@ static void ReorderBufferSerializeReserve(ReorderBuffer* rb, Size sz)
 }
 
 /*
- * Check whether the transaction tx should spill its data to disk.
+ * Check whether the transaction tx should stream or spill its data to disk.
  */
 static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
 {
+    ReorderBufferTXN* toptxn = (txn->toptxn != NULL) ? txn->toptxn : txn;
+
+    /*
+     * Rather than spilling a transaction, stream it if we can. Large
+     * transactions are streamed before they reach the spilling limit, too.
+     */
+    if ((toptxn->total_size >= (Size)u_sess->attr.attr_storage.logical_decoding_work_mem * 1024L ||
+            txn->nentries_mem >= (unsigned)g_instance.attr.attr_common.max_changes_in_memory) &&
+        ReorderBufferCanStreamTXN(rb, toptxn)) {
+        ReorderBufferStreamTXN(rb, toptxn);
+        Assert(txn->nentries_mem == 0);
+        return;
+    }
+
     /*
      * description: improve accounting so we cheaply can take subtransactions into
      * account here.
@@ -1924,6 +2281,7 @@ static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
     Assert(dlist_is_empty(&txn->changes));
     txn->nentries_mem = 0;
     txn->serialized = true;
+    ReorderBufferUpdateMemory(txn, txn->size, false);
 
     if (fd != -1) {
         (void)CloseTransientFile(fd);
@@ -2182,6 +2540,7 @@ static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn,
     /* copy static part */
     rc = memcpy_s(change, sizeof(ReorderBufferChange), &ondisk->change, sizeof(ReorderBufferChange));
     securec_check(rc, "", "");
+    change->txn = txn;
 
     data += sizeof(ReorderBufferDiskChange);
 
@@ -267,8 +267,6 @@ static Snapshot SnapBuildBuildSnapshot(SnapBuild* builder, TransactionId xid);
 
 static void SnapBuildFreeSnapshot(Snapshot snap);
 
-static void SnapBuildSnapIncRefcount(Snapshot snap);
-
 static void SnapBuildDistributeNewCatalogSnapshot(SnapBuild* builder, XLogRecPtr lsn);
 
 /* xlog reading helper functions for SnapBuildProcessRecord */
@@ -409,7 +407,7 @@ bool SnapBuildXactNeedsSkip(SnapBuild* builder, XLogRecPtr ptr)
  * This is used when handing out a snapshot to some external resource or when
  * adding a Snapshot as builder->snapshot.
  */
-static void SnapBuildSnapIncRefcount(Snapshot snap)
+void SnapBuildSnapIncRefcount(Snapshot snap)
 {
     snap->active_count++;
 }
@@ -86,6 +86,9 @@
 %token K_FAST
 %token K_NOWAIT
 %token K_WAL
+%token K_INCREMENTAL
+%token K_PARALLEL
+%token K_WORKER
 %token K_DATA
 %token K_START_REPLICATION
 %token K_FETCH_MOT_CHECKPOINT
@@ -94,6 +97,7 @@
 %token K_PHYSICAL
 %token K_LOGICAL
 %token K_SLOT
+%token K_COMPRESSION
 
 %type <node>	command
 %type <node>	base_backup start_replication start_data_replication fetch_mot_checkpoint start_logical_replication identify_system identify_version identify_mode identify_consistence create_replication_slot drop_replication_slot identify_maxlsn identify_channel
@@ -102,7 +106,7 @@
 %type <list>    plugin_options plugin_opt_list
 %type <defelt>  plugin_opt_elem
 %type <node>    plugin_opt_arg
-%type <str>		opt_slot
+%type <str>		opt_slot opt_compression
 %%
 
 firstcmd: command opt_semicolon
@@ -202,7 +206,9 @@ identify_channel:
 			;
 
 /*
- * BASE_BACKUP [LABEL '<label>'] [PROGRESS] [FAST] [WAL] [NOWAIT]
+ * BASE_BACKUP [LABEL '<label>'] [PROGRESS] [FAST] [WAL] [NOWAIT] [INCREMENTAL '%X/%X']
+ *             [PARALLEL] [COMPRESSION method]
+ * BASE_BACKUP WORKER '<backup id>' [COMPRESSION method]
  */
 base_backup:
 			K_BASE_BACKUP base_backup_opt_list
@@ -242,14 +248,34 @@ base_backup_opt:
 				  $$ = makeDefElem("nowait",
 						   (Node *)makeInteger(TRUE));
 				}
+			| K_INCREMENTAL SCONST
+				{
+				  $$ = makeDefElem("incremental",
+						   (Node *)makeString($2));
+				}
+			| K_PARALLEL
+				{
+				  $$ = makeDefElem("parallel",
+						   (Node *)makeInteger(TRUE));
+				}
+			| K_WORKER SCONST
+				{
+				  $$ = makeDefElem("worker",
+						   (Node *)makeString($2));
+				}
+			| K_COMPRESSION IDENT
+				{
+				  $$ = makeDefElem("compression",
+						   (Node *)makeString($2));
+				}
 			;
 
 /*
  * START_REPLICATION %X/%X
- * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X
+ * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X [COMPRESSION method]
  */
 start_replication:
-			K_START_REPLICATION opt_slot opt_physical RECPTR
+			K_START_REPLICATION opt_slot opt_physical RECPTR opt_compression
 				{
 					StartReplicationCmd *cmd;
 
@@ -257,6 +283,7 @@ start_replication:
 					cmd->kind = REPLICATION_KIND_PHYSICAL;
  					cmd->slotname = $2;
  					cmd->startpoint = $4;
+					cmd->compression = $5;
 
 					$$ = (Node *) cmd;
 				}
@@ -282,16 +309,17 @@ fetch_mot_checkpoint:
                                 }
                         ;
 
-/* START_REPLICATION SLOT slot LOGICAL %X/%X options */
+/* START_REPLICATION SLOT slot LOGICAL %X/%X [COMPRESSION method] options */
 start_logical_replication:
-            K_START_REPLICATION K_SLOT IDENT K_LOGICAL RECPTR plugin_options
+            K_START_REPLICATION K_SLOT IDENT K_LOGICAL RECPTR opt_compression plugin_options
 				{
 					StartReplicationCmd *cmd;
 					cmd = makeNode(StartReplicationCmd);
 					cmd->kind = REPLICATION_KIND_LOGICAL;;
 					cmd->slotname = $3;
 					cmd->startpoint = $5;
-					cmd->options = $6;
+					cmd->compression = $6;
+					cmd->options = $7;
 					$$ = (Node *) cmd;
 				}
 			;
@@ -333,6 +361,13 @@ start_logical_replication:
 
 
 opt_physical :	K_PHYSICAL | /* EMPTY */;
+
+opt_compression :	K_COMPRESSION IDENT
+				{
+					$$ = $2;
+				}
+				| /* EMPTY */			{ $$ = NULL; }
+				;
  
  
 opt_slot :	K_SLOT IDENT
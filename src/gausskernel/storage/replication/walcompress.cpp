@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * walcompress.cpp
+ *        Streaming compression of the data sent by walsender.
+ *
+ * The compressor and decompressor never report errors themselves, so this file is
+ * shared with the frontend tools that receive a compressed logical stream.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/replication/walcompress.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#ifdef FRONTEND
+#include "postgres_fe.h"
+#else
+#include "postgres.h"
+#include "knl/knl_variable.h"
+#endif
+
+#include "securec_check.h"
+#include "replication/walcompress.h"
+
+bool WalStreamCompressionIsSupported(const char* method)
+{
+    return strcmp(method, WAL_STREAM_COMPRESSION_LZ4) == 0;
+}
+
+int WalStreamCompressBound(int rawLen)
+{
+    return LZ4_compressBound(rawLen);
+}
+
+void WalStreamCompressorReset(WalStreamCompressor* compressor)
+{
+    LZ4_resetStream(&compressor->stream);
+    compressor->ringPos = 0;
+}
+
+/*
+ * Compress the next message of the stream, referencing the data of the previous messages.
+ * Returns the compressed length, or a value <= 0 if dstCapacity is too small.
+ */
+int WalStreamCompress(WalStreamCompressor* compressor, const char* src, int srcLen, char* dst, int dstCapacity)
+{
+    int compressedLen;
+
+    if (srcLen > WAL_STREAM_DICT_SIZE) {
+        /* large messages are their own history, keep their tail since the caller reuses src */
+        compressedLen = LZ4_compress_fast_continue(&compressor->stream, src, dst, srcLen, dstCapacity, 1);
+        compressor->ringPos = LZ4_saveDict(&compressor->stream, compressor->ring, WAL_STREAM_DICT_SIZE);
+        return compressedLen;
+    }
+
+    /*
+     * Small messages are appended to the ring so the history spans several of them. LZ4 shrinks
+     * the dictionary by itself when the ring wraps around and overwrites part of it.
+     */
+    if (compressor->ringPos + srcLen > (int)sizeof(compressor->ring)) {
+        compressor->ringPos = 0;
+    }
+    char* input = compressor->ring + compressor->ringPos;
+    errno_t rc = memcpy_s(input, sizeof(compressor->ring) - compressor->ringPos, src, srcLen);
+    securec_check_c(rc, "\0", "\0");
+    compressor->ringPos += srcLen;
+
+    return LZ4_compress_fast_continue(&compressor->stream, input, dst, srcLen, dstCapacity, 1);
+}
+
+void WalStreamDecompressorReset(WalStreamDecompressor* decompressor)
+{
+    decompressor->historyLen = 0;
+}
+
+/*
+ * Decompress the next message of the stream. Returns the decompressed length, or a negative
+ * value if the message is malformed or doesn't fit into dstCapacity.
+ */
+int WalStreamDecompress(WalStreamDecompressor* decompressor, const char* src, int srcLen, char* dst, int dstCapacity)
+{
+    int dictLen = Min(decompressor->historyLen, WAL_STREAM_DICT_SIZE);
+    const char* dict = decompressor->history + decompressor->historyLen - dictLen;
+    int rawLen = LZ4_decompress_safe_usingDict(src, dst, srcLen, dstCapacity, dict, dictLen);
+    errno_t rc;
+
+    if (rawLen <= 0) {
+        return rawLen;
+    }
+
+    if (rawLen >= WAL_STREAM_DICT_SIZE) {
+        rc = memcpy_s(decompressor->history, sizeof(decompressor->history), dst + rawLen - WAL_STREAM_DICT_SIZE,
+            WAL_STREAM_DICT_SIZE);
+        securec_check_c(rc, "\0", "\0");
+        decompressor->historyLen = WAL_STREAM_DICT_SIZE;
+        return rawLen;
+    }
+
+    /* append to the history, compacting it to the dictionary once in a while */
+    if (decompressor->historyLen + rawLen > (int)sizeof(decompressor->history)) {
+        rc = memmove_s(decompressor->history, sizeof(decompressor->history),
+            decompressor->history + decompressor->historyLen - WAL_STREAM_DICT_SIZE, WAL_STREAM_DICT_SIZE);
+        securec_check_c(rc, "\0", "\0");
+        decompressor->historyLen = WAL_STREAM_DICT_SIZE;
+    }
+    rc = memcpy_s(decompressor->history + decompressor->historyLen,
+        sizeof(decompressor->history) - decompressor->historyLen, dst, rawLen);
+    securec_check_c(rc, "\0", "\0");
+    decompressor->historyLen += rawLen;
+    return rawLen;
+}
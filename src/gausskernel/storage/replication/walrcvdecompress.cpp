@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * walrcvdecompress.cpp
+ *        Decompressing the WAL stream of a walreceiver in a thread of its own.
+ *
+ * The decompression thread is a plain thread without any backend state, so it must not
+ * palloc, ereport or touch shared memory. The walreceiver allocates the slot buffers and
+ * reports a message that could not be decompressed.
+ *
+ * The messages are numbered as they are pushed. Slots before popped are free, slots
+ * from popped up to decompressed hold decompressed messages, and slots from decompressed
+ * up to pushed wait for the thread. The thread only touches the slot at decompressed,
+ * and the walreceiver only touches the others.
+ *
+ * If the thread cannot be started, the walreceiver decompresses each message itself
+ * when it pushes it.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/replication/walrcvdecompress.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include <pthread.h>
+#include <signal.h>
+
+#include "replication/walcompress.h"
+#include "replication/walrcvdecompress.h"
+
+/* the number of messages that can be queued for decompression */
+#define DECOMPRESS_SLOTS 4
+
+typedef struct WalRcvDecompressSlot {
+    XLogRecPtr dataStart;
+    uint32 len;        /* compressed length */
+    uint32 rawLen;     /* length announced by the primary */
+    int dataLen;       /* decompressed length, negative if the message is malformed */
+    char* buf;
+    uint32 bufSize;
+    char* data;
+    uint32 dataSize;
+} WalRcvDecompressSlot;
+
+struct WalRcvDecompressor {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond; /* signaled whenever any of the counters below change */
+    bool threaded;
+
+    uint64 pushed;
+    uint64 decompressed;
+    uint64 popped;
+    bool shutdown;
+
+    WalRcvDecompressSlot slots[DECOMPRESS_SLOTS];
+
+    /* used by the thread only, or by the walreceiver if there is no thread */
+    WalStreamDecompressor stream;
+};
+
+#define DECOMPRESS_SLOT(decompressor, n) (&(decompressor)->slots[(n) % DECOMPRESS_SLOTS])
+
+static void* WalRcvDecompressorMain(void* arg);
+
+static void WalRcvDecompressSlotRun(WalRcvDecompressor* decompressor, WalRcvDecompressSlot* slot)
+{
+    slot->dataLen = WalStreamDecompress(&decompressor->stream, slot->buf, (int)slot->len, slot->data, (int)slot->rawLen);
+    if (slot->dataLen != (int)slot->rawLen)
+        slot->dataLen = -1;
+}
+
+/* make sure *buf holds at least size bytes, the slot must be free */
+static void WalRcvDecompressSlotReserve(char** buf, uint32* bufSize, uint32 size)
+{
+    char* newbuf = NULL;
+
+    if (*bufSize >= size)
+        return;
+
+    newbuf = (char*)realloc(*buf, size);
+    if (newbuf == NULL)
+        ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("out of memory decompressing the WAL stream")));
+    *buf = newbuf;
+    *bufSize = size;
+}
+
+/*
+ * Start the decompression thread of a walreceiver. If the thread cannot be started,
+ * the messages are decompressed as they are pushed.
+ */
+WalRcvDecompressor* WalRcvDecompressorStart(void)
+{
+    WalRcvDecompressor* decompressor = NULL;
+    sigset_t sigs;
+    sigset_t oldsigs;
+    int rc;
+    errno_t errorno;
+
+    decompressor = (WalRcvDecompressor*)malloc(sizeof(WalRcvDecompressor));
+    if (decompressor == NULL)
+        ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("out of memory decompressing the WAL stream")));
+    errorno = memset_s(decompressor, sizeof(WalRcvDecompressor), 0, sizeof(WalRcvDecompressor));
+    securec_check(errorno, "\0", "\0");
+    WalStreamDecompressorReset(&decompressor->stream);
+
+    (void)pthread_mutex_init(&decompressor->lock, NULL);
+    (void)pthread_cond_init(&decompressor->cond, NULL);
+
+    /* signals are meant for the walreceiver, keep them away from the thread */
+    (void)sigfillset(&sigs);
+    (void)pthread_sigmask(SIG_SETMASK, &sigs, &oldsigs);
+    rc = pthread_create(&decompressor->thread, NULL, WalRcvDecompressorMain, decompressor);
+    (void)pthread_sigmask(SIG_SETMASK, &oldsigs, NULL);
+
+    decompressor->threaded = (rc == 0);
+    if (!decompressor->threaded)
+        ereport(WARNING,
+            (errmsg("could not start WAL stream decompression thread, decompressing in walreceiver: error code %d",
+                rc)));
+
+    return decompressor;
+}
+
+/*
+ * Queue the compressed data of a message for decompression. Returns false if all slots
+ * are taken, the caller then has to pop a message first.
+ */
+bool WalRcvDecompressorPush(
+    WalRcvDecompressor* decompressor, XLogRecPtr dataStart, const char* buf, uint32 len, uint32 rawLen)
+{
+    WalRcvDecompressSlot* slot = NULL;
+    errno_t errorno;
+
+    (void)pthread_mutex_lock(&decompressor->lock);
+    if (decompressor->pushed - decompressor->popped == DECOMPRESS_SLOTS) {
+        (void)pthread_mutex_unlock(&decompressor->lock);
+        return false;
+    }
+    (void)pthread_mutex_unlock(&decompressor->lock);
+
+    /* the slot is past pushed, so the thread doesn't look at it while we fill it */
+    slot = DECOMPRESS_SLOT(decompressor, decompressor->pushed);
+    WalRcvDecompressSlotReserve(&slot->buf, &slot->bufSize, Max(len, 1));
+    WalRcvDecompressSlotReserve(&slot->data, &slot->dataSize, Max(rawLen, 1));
+    if (len > 0) {
+        errorno = memcpy_s(slot->buf, slot->bufSize, buf, len);
+        securec_check(errorno, "\0", "\0");
+    }
+    slot->dataStart = dataStart;
+    slot->len = len;
+    slot->rawLen = rawLen;
+
+    if (!decompressor->threaded) {
+        WalRcvDecompressSlotRun(decompressor, slot);
+        decompressor->decompressed++;
+    }
+
+    (void)pthread_mutex_lock(&decompressor->lock);
+    decompressor->pushed++;
+    (void)pthread_cond_broadcast(&decompressor->cond);
+    (void)pthread_mutex_unlock(&decompressor->lock);
+
+    return true;
+}
+
+/*
+ * Take the oldest decompressed message. If wait is set and it is still being
+ * decompressed, wait for it. Returns false if there is no such message. *dataLen is
+ * negative if the message is malformed. *data stays valid until the next push.
+ */
+bool WalRcvDecompressorPop(
+    WalRcvDecompressor* decompressor, bool wait, XLogRecPtr* dataStart, char** data, int* dataLen)
+{
+    WalRcvDecompressSlot* slot = NULL;
+
+    (void)pthread_mutex_lock(&decompressor->lock);
+    while (decompressor->popped == decompressor->decompressed) {
+        if (!wait || decompressor->popped == decompressor->pushed) {
+            (void)pthread_mutex_unlock(&decompressor->lock);
+            return false;
+        }
+        /* decompressing a message takes a bounded time, so there is no need to check for interrupts */
+        (void)pthread_cond_wait(&decompressor->cond, &decompressor->lock);
+    }
+    slot = DECOMPRESS_SLOT(decompressor, decompressor->popped);
+    decompressor->popped++;
+    (void)pthread_mutex_unlock(&decompressor->lock);
+
+    *dataStart = slot->dataStart;
+    *data = slot->data;
+    *dataLen = slot->dataLen;
+    return true;
+}
+
+/*
+ * Stop the thread and free the slots. Messages still queued are thrown away.
+ */
+void WalRcvDecompressorStop(WalRcvDecompressor* decompressor)
+{
+    int i;
+
+    if (decompressor->threaded) {
+        (void)pthread_mutex_lock(&decompressor->lock);
+        decompressor->shutdown = true;
+        (void)pthread_cond_broadcast(&decompressor->cond);
+        (void)pthread_mutex_unlock(&decompressor->lock);
+
+        (void)pthread_join(decompressor->thread, NULL);
+    }
+
+    (void)pthread_cond_destroy(&decompressor->cond);
+    (void)pthread_mutex_destroy(&decompressor->lock);
+    for (i = 0; i < DECOMPRESS_SLOTS; i++) {
+        free(decompressor->slots[i].buf);
+        free(decompressor->slots[i].data);
+    }
+    free(decompressor);
+}
+
+static void* WalRcvDecompressorMain(void* arg)
+{
+    WalRcvDecompressor* decompressor = (WalRcvDecompressor*)arg;
+
+    for (;;) {
+        WalRcvDecompressSlot* slot = NULL;
+
+        (void)pthread_mutex_lock(&decompressor->lock);
+        while (!decompressor->shutdown && decompressor->decompressed == decompressor->pushed)
+            (void)pthread_cond_wait(&decompressor->cond, &decompressor->lock);
+        if (decompressor->shutdown) {
+            (void)pthread_mutex_unlock(&decompressor->lock);
+            break;
+        }
+        slot = DECOMPRESS_SLOT(decompressor, decompressor->decompressed);
+        (void)pthread_mutex_unlock(&decompressor->lock);
+
+        WalRcvDecompressSlotRun(decompressor, slot);
+
+        (void)pthread_mutex_lock(&decompressor->lock);
+        decompressor->decompressed++;
+        (void)pthread_cond_broadcast(&decompressor->cond);
+        (void)pthread_mutex_unlock(&decompressor->lock);
+    }
+
+    return NULL;
+}
@@ -41,6 +41,7 @@
 #include <syscall.h>
 #endif
 #include <sys/stat.h>
+#include <arpa/inet.h>
 
 #include "access/xlog_internal.h"
 #include "access/xlog.h"
@@ -53,6 +54,7 @@
 #include "miscadmin.h"
 #include "replication/replicainternal.h"
 #include "replication/dataqueue.h"
+#include "replication/walrcvdecompress.h"
 #include "replication/walprotocol.h"
 #include "replication/walreceiver.h"
 #include "replication/walsender.h"
@@ -127,6 +129,9 @@ static void WalRcvDie(int code, Datum arg);
 static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len);
 static void XLogWalRcvReceive(char* buf, Size nbytes, XLogRecPtr recptr);
 static void XLogWalRcvReceiveInBuf(char* buf, Size nbytes, XLogRecPtr recptr);
+static void XLogWalRcvDecompress(XLogRecPtr dataStart, const char* buf, Size len, uint32 rawLen);
+static bool XLogWalRcvReceiveDecompressed(bool wait);
+static void XLogWalRcvFinishDecompress(void);
 static void XLogWalRcvSendHSFeedback(void);
 static void XLogWalRcvSendSwitchRequest(void);
 static void WalDataRcvReceive(char* buf, Size nbytes, XLogRecPtr recptr);
@@ -555,6 +560,9 @@ void WalReceiverMain(void)
                 XLogWalRcvProcessMsg(type, buf, len);
             }
 
+            /* the socket is drained, hand over what is still being decompressed */
+            XLogWalRcvFinishDecompress();
+
             /* Let the master know that we received some data. */
             XLogWalRcvSendReply(false, false);
         } else {
@@ -711,6 +719,11 @@ static void WalRcvDie(int code, Datum arg)
 
     walRcvDataCleanup();
 
+    if (t_thrd.walreceiver_cxt.decompressor != NULL) {
+        WalRcvDecompressorStop(t_thrd.walreceiver_cxt.decompressor);
+        t_thrd.walreceiver_cxt.decompressor = NULL;
+    }
+
     LWLockAcquire(WALWriteLock, LW_EXCLUSIVE);
     SpinLockAcquire(&walrcv->mutex);
     Assert(walrcv->walRcvState == WALRCV_RUNNING || walrcv->walRcvState == WALRCV_STOPPING);
@@ -818,6 +831,10 @@ static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len)
 
     ereport(DEBUG5, (errmsg("received wal message type: %c", type)));
 
+    /* keep the order of the stream, compressed messages may still be in the decompression thread */
+    if (type != 'z')
+        XLogWalRcvFinishDecompress();
+
     switch (type) {
         case 'e': /* dummy standby sendxlog end. */
         {
@@ -856,6 +873,29 @@ static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len)
             }
             break;
         }
+        case 'z': /* WAL records compressed with the negotiated stream compression */
+        {
+            WalDataMessageHeader msghdr;
+            uint32 rawLen;
+
+            if (len < sizeof(WalDataMessageHeader) + sizeof(uint32))
+                ereport(ERROR,
+                    (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                        errmsg_internal("invalid compressed WAL message received from primary")));
+            /* memcpy is required here for alignment reasons */
+            errorno = memcpy_s(&msghdr, sizeof(WalDataMessageHeader), buf, sizeof(WalDataMessageHeader));
+            securec_check(errorno, "\0", "\0");
+            errorno = memcpy_s(&rawLen, sizeof(uint32), buf + sizeof(WalDataMessageHeader), sizeof(uint32));
+            securec_check(errorno, "\0", "\0");
+
+            ProcessWalHeaderMessage(&msghdr);
+
+            buf += sizeof(WalDataMessageHeader) + sizeof(uint32);
+            len -= sizeof(WalDataMessageHeader) + sizeof(uint32);
+            rawLen = ntohl(rawLen);
+            XLogWalRcvDecompress(msghdr.dataStart, buf, len, rawLen);
+            break;
+        }
         case 'd': /* Data page replication for the logical xlog */
         {
             WalDataPageMessageHeader msghdr;
@@ -1113,6 +1153,71 @@ static void WalDataRcvReceive(char* buf, Size nbytes, XLogRecPtr recptr)
     wakeupWalRcvWriter();
 }
 
+/*
+ * Queue the data of a 'z' message for decompression, and hand over the messages
+ * decompressed so far.
+ *
+ * The decompression thread works on the message while the walreceiver goes on reading
+ * the socket, so decompressing it delays neither the receipt of the next messages nor
+ * the walrcvwriter's flush of the previous ones.
+ */
+static void XLogWalRcvDecompress(XLogRecPtr dataStart, const char* buf, Size len, uint32 rawLen)
+{
+    if (t_thrd.walreceiver_cxt.decompressor == NULL)
+        t_thrd.walreceiver_cxt.decompressor = WalRcvDecompressorStart();
+
+    if (rawLen > MaxAllocSize)
+        ereport(ERROR,
+            (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                errmsg_internal("invalid compressed WAL message length %u received from primary", rawLen)));
+
+    /* all slots taken, wait for the oldest message */
+    while (!WalRcvDecompressorPush(t_thrd.walreceiver_cxt.decompressor, dataStart, buf, (uint32)len, rawLen))
+        (void)XLogWalRcvReceiveDecompressed(true);
+
+    /* hand over what the thread has finished meanwhile */
+    while (XLogWalRcvReceiveDecompressed(false)) {
+        ;
+    }
+}
+
+/*
+ * Hand the oldest decompressed message over to the walrcvwriter. With wait, wait for it
+ * if it is still being decompressed. Returns false if there is no such message.
+ */
+static bool XLogWalRcvReceiveDecompressed(bool wait)
+{
+    XLogRecPtr dataStart;
+    char* data = NULL;
+    int dataLen;
+
+    if (t_thrd.walreceiver_cxt.decompressor == NULL ||
+        !WalRcvDecompressorPop(t_thrd.walreceiver_cxt.decompressor, wait, &dataStart, &data, &dataLen))
+        return false;
+
+    if (dataLen < 0)
+        ereport(ERROR,
+            (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                errmsg_internal("could not decompress WAL message received from primary")));
+
+    if (IsExtremeRedo()) {
+        XLogWalRcvReceiveInBuf(data, (Size)dataLen, dataStart);
+    } else {
+        XLogWalRcvReceive(data, (Size)dataLen, dataStart);
+    }
+    return true;
+}
+
+/*
+ * Hand over all compressed messages received so far, waiting for their decompression.
+ */
+static void XLogWalRcvFinishDecompress(void)
+{
+    while (XLogWalRcvReceiveDecompressed(true)) {
+        ;
+    }
+}
+
 /*
  * Receive XLOG data into receiver buffer.
  */
@@ -35,6 +35,7 @@
 #include "replication/walreceiver.h"
 #include "replication/slot.h"
 #include "storage/pmsignal.h"
+#include "storage/proc.h"
 #include "storage/shmem.h"
 #include "utils/guc.h"
 #include "utils/timestamp.h"
@@ -211,6 +212,211 @@ void WalRcvShmemInit(void)
     }
 }
 
+/* the most backends ReplayWaitData wakes up at a time, without holding its spinlock */
+#define REPLAY_WAKEUP_BATCH 64
+/* how often a backend waiting for replay checks whether recovery has ended */
+#define REPLAY_WAIT_CHECK_INTERVAL_MS 1000
+
+/* Report shared memory space needed by ReplayWaitShmemInit */
+Size ReplayWaitShmemSize(void)
+{
+    Size size = offsetof(ReplayWaitData, waitLSN);
+
+    size = add_size(size, mul_size(GLOBAL_ALL_PROCS, sizeof(XLogRecPtr)));
+
+    return size;
+}
+
+/* Allocate and initialize the shared memory of backends waiting for replay */
+void ReplayWaitShmemInit(void)
+{
+    bool found = false;
+    errno_t rc = 0;
+
+    t_thrd.walreceiverfuncs_cxt.ReplayWait =
+        (ReplayWaitData*)ShmemInitStruct("Replay Wait Ctl", ReplayWaitShmemSize(), &found);
+
+    if (!found) {
+        rc = memset_s(t_thrd.walreceiverfuncs_cxt.ReplayWait, ReplayWaitShmemSize(), 0, ReplayWaitShmemSize());
+        securec_check(rc, "\0", "\0");
+        pg_atomic_init_u64(&t_thrd.walreceiverfuncs_cxt.ReplayWait->minWaitLSN, PG_UINT64_MAX);
+        SpinLockInit(&t_thrd.walreceiverfuncs_cxt.ReplayWait->mutex);
+    }
+}
+
+static void ReplayWaitUnregister(ReplayWaitData* replayWait, int procno)
+{
+    /* minWaitLSN may stay too low, the next wakeup recomputes it */
+    SpinLockAcquire(&replayWait->mutex);
+    replayWait->waitLSN[procno] = InvalidXLogRecPtr;
+    SpinLockRelease(&replayWait->mutex);
+}
+
+/*
+ * Wait until WAL has been replayed up to lsn, sleeping on the process latch. Gives up
+ * after timeout_ms milliseconds, unless it is 0, or when recovery ends. Returns true
+ * if lsn has been replayed.
+ */
+bool WaitForReplayLSN(XLogRecPtr lsn, int timeout_ms)
+{
+    ReplayWaitData* replayWait = t_thrd.walreceiverfuncs_cxt.ReplayWait;
+    int procno = t_thrd.proc->pgprocno;
+    TimestampTz start;
+    bool reached = false;
+
+    if (XLByteLE(lsn, GetXLogReplayRecPtr(NULL))) {
+        return true;
+    }
+
+    start = GetCurrentTimestamp();
+
+    SpinLockAcquire(&replayWait->mutex);
+    replayWait->waitLSN[procno] = lsn;
+    if (XLByteLT(lsn, pg_atomic_read_u64(&replayWait->minWaitLSN))) {
+        pg_atomic_write_u64(&replayWait->minWaitLSN, lsn);
+    }
+    SpinLockRelease(&replayWait->mutex);
+
+    PG_TRY();
+    {
+        for (;;) {
+            long sleepMs = REPLAY_WAIT_CHECK_INTERVAL_MS;
+            int rc;
+
+            ResetLatch(&t_thrd.proc->procLatch);
+
+            /* registered before looking, so a replay that gets past lsn now wakes us */
+            if (XLByteLE(lsn, GetXLogReplayRecPtr(NULL))) {
+                reached = true;
+                break;
+            }
+            if (!RecoveryInProgress()) {
+                break;
+            }
+            if (timeout_ms > 0) {
+                long secs;
+                int usecs;
+                long elapsedMs;
+
+                TimestampDifference(start, GetCurrentTimestamp(), &secs, &usecs);
+                elapsedMs = secs * 1000 + usecs / 1000;
+                if (elapsedMs >= timeout_ms) {
+                    break;
+                }
+                sleepMs = Min(sleepMs, timeout_ms - elapsedMs);
+            }
+
+            CHECK_FOR_INTERRUPTS();
+
+            rc = WaitLatch(&t_thrd.proc->procLatch, WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH, sleepMs);
+            if (rc & WL_POSTMASTER_DEATH) {
+                ereport(FATAL,
+                    (errcode(ERRCODE_ADMIN_SHUTDOWN),
+                        errmsg("terminating connection due to unexpected postmaster exit")));
+            }
+        }
+    }
+    PG_CATCH();
+    {
+        ReplayWaitUnregister(replayWait, procno);
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+
+    ReplayWaitUnregister(replayWait, procno);
+    return reached;
+}
+
+/*
+ * Wake up the backends waiting for WAL to be replayed up to replayed or less. Called
+ * whenever the replay position advances, so it only reads minWaitLSN unless somebody
+ * is about to be woken up.
+ */
+void WakeupReplayWaiters(XLogRecPtr replayed)
+{
+    ReplayWaitData* replayWait = t_thrd.walreceiverfuncs_cxt.ReplayWait;
+    uint32 procCount = (uint32)GLOBAL_ALL_PROCS;
+    int wakeup[REPLAY_WAKEUP_BATCH];
+    int nwakeup;
+    bool more = true;
+
+    if (replayWait == NULL || XLByteLT(replayed, pg_atomic_read_u64(&replayWait->minWaitLSN))) {
+        return;
+    }
+
+    while (more) {
+        XLogRecPtr minWaitLSN = PG_UINT64_MAX;
+
+        nwakeup = 0;
+        more = false;
+        SpinLockAcquire(&replayWait->mutex);
+        for (uint32 i = 0; i < procCount; i++) {
+            XLogRecPtr lsn = replayWait->waitLSN[i];
+
+            if (XLogRecPtrIsInvalid(lsn)) {
+                continue;
+            }
+            if (XLByteLE(lsn, replayed) && nwakeup < REPLAY_WAKEUP_BATCH) {
+                replayWait->waitLSN[i] = InvalidXLogRecPtr;
+                wakeup[nwakeup++] = (int)i;
+                continue;
+            }
+            if (XLByteLE(lsn, replayed)) {
+                more = true;
+            }
+            if (XLByteLT(lsn, minWaitLSN)) {
+                minWaitLSN = lsn;
+            }
+        }
+        pg_atomic_write_u64(&replayWait->minWaitLSN, minWaitLSN);
+        SpinLockRelease(&replayWait->mutex);
+
+        for (int i = 0; i < nwakeup; i++) {
+            SetLatch(&g_instance.proc_base_all_procs[wakeup[i]]->procLatch);
+        }
+    }
+}
+
+/*
+ * Make a session on a hot standby see its own writes: before a transaction starts,
+ * wait for WAL to be replayed up to standby_read_lsn, normally the commit LSN the
+ * primary reported to the client for its last write.
+ */
+void StandbyWaitForReadLSN(void)
+{
+    const char* lsnString = u_sess->attr.attr_storage.standby_read_lsn;
+    uint32 hi = 0;
+    uint32 lo = 0;
+    XLogRecPtr lsn;
+
+    if (lsnString == NULL || lsnString[0] == '\0' || !RecoveryInProgress()) {
+        return;
+    }
+
+    /* checked by the GUC machinery already */
+    if (sscanf_s(lsnString, "%X/%X", &hi, &lo) != 2) {
+        return;
+    }
+    lsn = (((uint64)hi) << 32) | lo;
+
+    if (WaitForReplayLSN(lsn, u_sess->attr.attr_storage.standby_read_lsn_timeout)) {
+        return;
+    }
+
+    XLogRecPtr replayed = GetXLogReplayRecPtr(NULL);
+    if (!RecoveryInProgress()) {
+        ereport(ERROR,
+            (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                errmsg("recovery ended before replaying WAL up to %X/%X", hi, lo),
+                errdetail("WAL was replayed up to %X/%X.", (uint32)(replayed >> 32), (uint32)replayed)));
+    }
+    ereport(ERROR,
+        (errcode(ERRCODE_QUERY_CANCELED),
+            errmsg("timed out while waiting for WAL to be replayed up to %X/%X", hi, lo),
+            errdetail("WAL has been replayed up to %X/%X.", (uint32)(replayed >> 32), (uint32)replayed),
+            errhint("Run the query on the primary, or increase standby_read_lsn_timeout.")));
+}
+
 /* Is walreceiver in progress (or starting up)? */
 bool WalRcvInProgress(void)
 {
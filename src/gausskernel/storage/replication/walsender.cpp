@@ -68,9 +68,11 @@
 #include "replication/catchup.h"
 #include "replication/decode.h"
 #include "replication/logical.h"
+#include "replication/logicalreadahead.h"
 #include "replication/slot.h"
 #include "replication/snapbuild.h"
 #include "replication/syncrep.h"
+#include "replication/walcompress.h"
 #include "replication/walprotocol.h"
 #include "replication/walreceiver.h"
 #include "replication/walsender.h"
@@ -158,6 +160,8 @@ static void CreateReplicationSlot(const CreateReplicationSlotCmd* cmd);
 static void DropReplicationSlot(DropReplicationSlotCmd* cmd);
 static void StartReplication(StartReplicationCmd* cmd);
 static void StartLogicalReplication(StartReplicationCmd* cmd);
+static void WalSndInitStreamCompression(const char* method);
+static void WalSndPutCompressedMessage(const char* header, Size headerLen, const char* data, Size dataLen);
 static void ProcessStandbyMessage(void);
 static void ProcessStandbyReplyMessage(void);
 static void ProcessStandbyHSFeedbackMessage(void);
@@ -999,6 +1003,8 @@ static void StartReplication(StartReplicationCmd* cmd)
      */
     WalSndSetState(WALSNDSTATE_CATCHUP);
 
+    WalSndInitStreamCompression(cmd->compression);
+
     /* Send a CopyBothResponse message, and start streaming */
     pq_beginmessage(&buf, 'W');
     pq_sendbyte(&buf, 0);
@@ -1018,6 +1024,72 @@ static void StartReplication(StartReplicationCmd* cmd)
     }
 }
 
+/*
+ * Set up the stream compression requested by START_REPLICATION, if any.
+ *
+ * The compressor keeps the recent stream data as the dictionary of the next
+ * message, so the receiver must decompress every message of the stream in order.
+ */
+static void WalSndInitStreamCompression(const char* method)
+{
+    if (t_thrd.walsender_cxt.stream_compressor != NULL) {
+        pfree(t_thrd.walsender_cxt.stream_compressor);
+        t_thrd.walsender_cxt.stream_compressor = NULL;
+    }
+
+    if (method == NULL)
+        return;
+
+    if (!WalStreamCompressionIsSupported(method))
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmsg("unsupported WAL stream compression method \"%s\"", method)));
+
+    t_thrd.walsender_cxt.stream_compressor =
+        (WalStreamCompressor*)MemoryContextAlloc(t_thrd.top_mem_cxt, sizeof(WalStreamCompressor));
+    WalStreamCompressorReset(t_thrd.walsender_cxt.stream_compressor);
+
+    ereport(LOG, (errmsg("streaming with %s compression", method)));
+}
+
+/*
+ * Send a data message compressed with the negotiated stream compression.
+ *
+ * The 'z' message consists of the header of the equivalent 'w' message, the
+ * length of the uncompressed data in network byte order, and the compressed data.
+ */
+static void WalSndPutCompressedMessage(const char* header, Size headerLen, const char* data, Size dataLen)
+{
+    int bound = WalStreamCompressBound((int)dataLen);
+    Size prefixLen = 1 + headerLen + sizeof(uint32);
+    Size msgSize = prefixLen + (Size)bound;
+    uint32 rawLen = htonl((uint32)dataLen);
+    int compressedLen;
+    char* msg = NULL;
+    errno_t rc;
+
+    if (t_thrd.walsender_cxt.output_compressed_message_size < msgSize) {
+        if (t_thrd.walsender_cxt.output_compressed_message != NULL)
+            pfree(t_thrd.walsender_cxt.output_compressed_message);
+        t_thrd.walsender_cxt.output_compressed_message = (char*)MemoryContextAlloc(t_thrd.top_mem_cxt, msgSize);
+        t_thrd.walsender_cxt.output_compressed_message_size = (uint32)msgSize;
+    }
+    msg = t_thrd.walsender_cxt.output_compressed_message;
+
+    msg[0] = 'z';
+    rc = memcpy_s(msg + 1, t_thrd.walsender_cxt.output_compressed_message_size - 1, header, headerLen);
+    securec_check(rc, "\0", "\0");
+    rc = memcpy_s(msg + 1 + headerLen, sizeof(uint32), &rawLen, sizeof(uint32));
+    securec_check(rc, "\0", "\0");
+
+    compressedLen = WalStreamCompress(
+        t_thrd.walsender_cxt.stream_compressor, data, (int)dataLen, msg + prefixLen, bound);
+    if (compressedLen <= 0)
+        ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR), errmsg("could not compress WAL stream data")));
+
+    (void)pq_putmessage_noblock('d', msg, prefixLen + compressedLen);
+}
+
 /*
  * read_page callback for logical decoding contexts, as a walsender process.
  *
@@ -1042,6 +1114,21 @@ static int logical_read_xlog_page(XLogReaderState* state, XLogRecPtr targetPageP
     else
         count = flushptr - targetPagePtr; /* part of the page available */
 
+    /* take the page from the read-ahead ring if it's there, and let it read further */
+    if (t_thrd.walsender_cxt.logical_read_ahead != NULL) {
+        LogicalReadAhead* readahead = t_thrd.walsender_cxt.logical_read_ahead;
+
+        LogicalReadAheadSetLimit(readahead, flushptr);
+        if (count == XLOG_BLCKSZ && LogicalReadAheadGetPage(readahead, targetPagePtr, cur_page)) {
+            XLogSegNo segno;
+
+            /* the segment may have been recycled since the page was read, see XLogRead */
+            XLByteToSeg(targetPagePtr, segno);
+            CheckXLogRemoved(segno, t_thrd.xlog_cxt.ThisTimeLineID);
+            return count;
+        }
+    }
+
     /* now actually read the data, we know it's there */
     XLogRead(cur_page, targetPagePtr, XLOG_BLCKSZ);
 
@@ -1295,6 +1382,8 @@ static void StartLogicalReplication(StartReplicationCmd* cmd)
 
     WalSndSetState(WALSNDSTATE_CATCHUP);
 
+    WalSndInitStreamCompression(cmd->compression);
+
     /* Send a CopyBothResponse message, and start streaming */
     pq_beginmessage(&buf, 'W');
     pq_sendbyte(&buf, 0);
@@ -1312,6 +1401,11 @@ static void StartLogicalReplication(StartReplicationCmd* cmd)
     /* Start reading WAL from the oldest required WAL. */
     t_thrd.walsender_cxt.logical_startptr = t_thrd.slot_cxt.MyReplicationSlot->data.restart_lsn;
 
+    /* read WAL in a thread of its own while we decode */
+    if (u_sess->attr.attr_storage.logical_decoding_read_ahead > 0)
+        t_thrd.walsender_cxt.logical_read_ahead = LogicalReadAheadStart(t_thrd.walsender_cxt.logical_startptr,
+            t_thrd.xlog_cxt.ThisTimeLineID, u_sess->attr.attr_storage.logical_decoding_read_ahead);
+
     /*
      * Report the location after which we'll send out further commits as the
      * current sentPtr.
@@ -1335,6 +1429,10 @@ static void StartLogicalReplication(StartReplicationCmd* cmd)
     /* Main loop of walsender */
     WalSndLoop(XLogSendLogical);
 
+    if (t_thrd.walsender_cxt.logical_read_ahead != NULL) {
+        LogicalReadAheadStop(t_thrd.walsender_cxt.logical_read_ahead);
+        t_thrd.walsender_cxt.logical_read_ahead = NULL;
+    }
     FreeDecodingContext(t_thrd.walsender_cxt.logical_decoding_ctx);
     ReplicationSlotRelease();
 
@@ -1385,7 +1483,13 @@ static void WalSndWriteData(LogicalDecodingContext* ctx, XLogRecPtr lsn, Transac
     errno_t rc;
 
     /* output previously gathered data in a CopyData packet */
-    pq_putmessage_noblock('d', ctx->out->data, ctx->out->len);
+    if (t_thrd.walsender_cxt.stream_compressor != NULL) {
+        Size headerLen = sizeof(int64) * 3; /* dataStart, walEnd and sendtime */
+        WalSndPutCompressedMessage(
+            ctx->out->data + 1, headerLen, ctx->out->data + 1 + headerLen, ctx->out->len - 1 - headerLen);
+    } else {
+        pq_putmessage_noblock('d', ctx->out->data, ctx->out->len);
+    }
 
     /*
      * Fill the send timestamp last, so that it is taken as late as
@@ -3187,6 +3291,12 @@ static void WalSndKill(int code, Datum arg)
 
     DisownLatch(&walsnd->latch);
 
+    /* the read-ahead thread must not outlive us */
+    if (t_thrd.walsender_cxt.logical_read_ahead != NULL) {
+        LogicalReadAheadStop(t_thrd.walsender_cxt.logical_read_ahead);
+        t_thrd.walsender_cxt.logical_read_ahead = NULL;
+    }
+
     if (code > 0) {
         /* Sleep at least 0.1 second to wait for reporting the error to the client */
         pg_usleep(100000L);
@@ -3585,13 +3695,20 @@ static void XLogSendPhysical(void)
         msghdr.sender_replay_location = GetXLogReplayRecPtr(NULL);
     }
 
-    errorno = memcpy_s(t_thrd.walsender_cxt.output_xlog_message + 1,
-        sizeof(WalDataMessageHeader) + g_instance.attr.attr_storage.MaxSendSize * 1024,
-        &msghdr,
-        sizeof(WalDataMessageHeader));
-    securec_check(errorno, "\0", "\0");
-    (void)pq_putmessage_noblock(
-        'd', t_thrd.walsender_cxt.output_xlog_message, 1 + sizeof(WalDataMessageHeader) + nbytes);
+    if (t_thrd.walsender_cxt.stream_compressor != NULL) {
+        WalSndPutCompressedMessage((const char*)&msghdr,
+            sizeof(WalDataMessageHeader),
+            t_thrd.walsender_cxt.output_xlog_message + 1 + sizeof(WalDataMessageHeader),
+            nbytes);
+    } else {
+        errorno = memcpy_s(t_thrd.walsender_cxt.output_xlog_message + 1,
+            sizeof(WalDataMessageHeader) + g_instance.attr.attr_storage.MaxSendSize * 1024,
+            &msghdr,
+            sizeof(WalDataMessageHeader));
+        securec_check(errorno, "\0", "\0");
+        (void)pq_putmessage_noblock(
+            'd', t_thrd.walsender_cxt.output_xlog_message, 1 + sizeof(WalDataMessageHeader) + nbytes);
+    }
 
     t_thrd.walsender_cxt.sentPtr = endptr;
 
@@ -164,6 +164,7 @@ static MdfdVec* _mdfd_openseg(SMgrRelation reln, ForkNumber forkno, BlockNumber
 static MdfdVec* _mdfd_getseg(
     SMgrRelation reln, ForkNumber forkno, BlockNumber blkno, bool skipFsync, ExtensionBehavior behavior);
 static BlockNumber _mdnblocks(SMgrRelation reln, ForkNumber forknum, const MdfdVec* seg);
+static MdfdVec* _mdfd_getseg_noextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blkno);
 
 /*
  *  mdinit() -- Initialize private state for magnetic disk storage manager.
@@ -622,7 +623,11 @@ void mdprefetch(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum)
     off_t seekpos;
     MdfdVec* v = NULL;
 
-    v = _mdfd_getseg(reln, forknum, blocknum, false, EXTENSION_FAIL);
+    v = _mdfd_getseg_noextend(reln, forknum, blocknum);
+    if (v == NULL) {
+        /* prefetch is only a hint, so never fail or create segments for it */
+        return;
+    }
 
     seekpos = (off_t)BLCKSZ * (blocknum % ((BlockNumber)RELSEG_SIZE));
 
@@ -2114,6 +2119,39 @@ static MdfdVec* _mdfd_openseg(SMgrRelation reln, ForkNumber forknum, BlockNumber
     return v;
 }
 
+/*
+ *  _mdfd_getseg_noextend() -- Find the segment of the relation holding the
+ *      specified block, without creating any missing segment.
+ *
+ * Unlike _mdfd_getseg(), this never creates segments even during WAL recovery,
+ * and returns NULL rather than ereport if the file or segment doesn't exist.
+ * Used for prefetching, which may run ahead of the redo that creates them.
+ */
+static MdfdVec* _mdfd_getseg_noextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blkno)
+{
+    MdfdVec* v = mdopen(reln, forknum, EXTENSION_RETURN_NULL);
+    BlockNumber targetseg;
+    BlockNumber nextsegno;
+
+    if (v == NULL) {
+        return NULL;
+    }
+
+    targetseg = blkno / ((BlockNumber)RELSEG_SIZE);
+    for (nextsegno = 1; nextsegno <= targetseg; nextsegno++) {
+        Assert(nextsegno == v->mdfd_segno + 1);
+
+        if (v->mdfd_chain == NULL) {
+            v->mdfd_chain = _mdfd_openseg(reln, forknum, nextsegno, 0);
+            if (v->mdfd_chain == NULL) {
+                return NULL;
+            }
+        }
+        v = v->mdfd_chain;
+    }
+    return v;
+}
+
 /*
  *  _mdfd_getseg() -- Find the segment of the relation holding the
  *      specified block.
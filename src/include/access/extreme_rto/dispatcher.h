@@ -37,6 +37,7 @@
 #include "access/extreme_rto/redo_item.h"
 #include "access/extreme_rto/page_redo.h"
 #include "access/extreme_rto/txn_redo.h"
+#include "access/redo_statistic.h"
 
 namespace extreme_rto {
 
@@ -217,6 +218,7 @@ void SetPageWorkStateByThreadId(uint32 threadState);
 void UpdateDispatcherStandbyState(HotStandbyState* state);
 void GetReplayedRecPtr(XLogRecPtr *startPtr, XLogRecPtr *endPtr);
 void StartupSendLsnFowarder();
+void redo_get_wroker_statistic(uint32* realNum, RedoWorkerStatsData* worker, uint32 workerLen);
 
 }  // namespace extreme_rto
 
@@ -30,6 +30,8 @@
 static const int MOST_FAST_RECOVERY_LIMIT = 20;
 static const int MAX_PARSE_WORKERS = 16;
 static const int MAX_REDO_WORKERS_PER_PARSE = 8;
+/* max number of blocks prefetched by the dispatcher ahead of redo workers */
+static const int MAX_RECOVERY_PREFETCH_DISTANCE = 65536;
 
 
 
@@ -55,6 +55,7 @@ typedef struct {
     int nattrs;
     PrinttupAttrInfo* myinfo; /* Cached info about each attr */
     int16* formats;     /* format code for each column */
+    TupleDesc batchinfo; /* descriptor given at startup, used for vector batches */
 } DR_printtup;
 
 typedef struct {
@@ -29,6 +29,9 @@
 #include "knl/knl_instance.h"
 #include "pgstat.h"
 #include "access/redo_statistic_msg.h"
+#include "access/xlogreader.h"
+#include "access/xlogproc.h"
+#include "portability/instr_time.h"
 
 typedef Datum (*GetViewDataFunc)();
 
@@ -65,6 +68,12 @@ extern void redo_fill_redo_event();
 extern void redo_refresh_stats(uint64 speed);
 extern void redo_unlink_stats_file();
 
+extern void redo_stat_reset(RedoReplayStat* stat);
+extern bool redo_stat_sample_begin(instr_time* start);
+extern void redo_stat_sample_end(XLogReaderState* record, const instr_time* start);
+extern void redo_stat_sample_block_end(XLogBlockHead* blockhead, const instr_time* start);
+extern void redo_stat_sample_queues();
+
 static const uint64 US_TRANSFER_TO_S = (1000000);
 static const uint64 BYTES_TRANSFER_KBYTES = (1024);
 
@@ -49,6 +49,7 @@ typedef struct knl_instance_attr_common {
     bool Logging_collector;
     bool allowSystemTableMods;
     bool enable_thread_pool;
+    bool thread_pool_reuseport;
 	bool enable_global_plancache;
     int max_files_per_process;
     int pgstat_track_activity_query_size;
@@ -43,6 +43,7 @@
 typedef struct knl_instance_attr_network {
     bool PoolerStatelessReuse;
     bool comm_tcp_mode;
+    bool comm_shm_mode;
     int MaxConnections;
     int maxInnerToolConnections;
     int ReservedBackends;
@@ -74,6 +74,7 @@ typedef struct knl_instance_attr_storage {
     int max_recovery_parallelism;
     int recovery_parse_workers;
     int recovery_redo_workers_per_paser_worker;
+    int recovery_prefetch_distance;
     int pagewriter_thread_num;
     int real_recovery_parallelism;
 	int batch_redo_num;
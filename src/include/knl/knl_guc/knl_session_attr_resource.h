@@ -76,6 +76,7 @@ typedef struct knl_session_attr_resource {
     char* session_resource_pool;
     int resource_track_level;
     int io_priority;
+    int session_latency_class;
     bool use_workload_manager;
     bool enable_control_group;
 
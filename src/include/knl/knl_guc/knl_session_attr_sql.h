@@ -82,6 +82,7 @@ typedef struct knl_session_attr_sql {
     bool enable_stream_operator;
     bool enable_stream_concurrent_update;
     bool enable_vector_engine;
+    bool enable_pipeline_mode;
     bool enable_force_vector_engine;
     bool enable_random_datanode;
     bool enable_fstream;
@@ -66,6 +66,8 @@ typedef struct knl_session_attr_storage {
     bool HaModuleDebug;
     bool hot_standby_feedback;
     bool enable_stream_replication;
+    bool enable_wal_stream_compression;
+    bool report_commit_lsn;
     bool EnforceTwoPhaseCommit;
     bool enable_show_any_tuples;
     bool enable_debug_vacuum;
@@ -80,6 +82,7 @@ typedef struct knl_session_attr_storage {
     int max_standby_archive_delay;
     int max_standby_streaming_delay;
     int wal_receiver_status_interval;
+    int standby_read_lsn_timeout;
     int wal_receiver_timeout;
     int wal_receiver_connect_timeout;
     int wal_receiver_connect_retries;
@@ -114,6 +117,8 @@ typedef struct knl_session_attr_storage {
     int CheckPointWaitTimeOut;
     int WalWriterDelay;
     int wal_sender_timeout;
+    int logical_decoding_work_mem;
+    int logical_decoding_read_ahead;
     int CommitDelay;
     int partition_lock_upgrade_timeout;
     int CommitSiblings;
@@ -158,6 +163,7 @@ typedef struct knl_session_attr_storage {
     char* SyncRepStandbyNames;
     char* ReplConnInfoArr[GUC_MAX_REPLNODE_NUM];
     char* PrimarySlotName;
+    char* standby_read_lsn;
     char* logging_module;
     char* Inplace_upgrade_next_system_object_oids;
     int resource_track_log;
@@ -36,6 +36,7 @@
 #include "gs_thread.h"
 #include "knl/knl_guc.h"
 #include "nodes/pg_list.h"
+#include "storage/relfilenode.h"
 #include "storage/s_lock.h"
 #include "access/double_write_basic.h"
 #include "utils/palloc.h"
@@ -49,6 +50,7 @@
 #include "postmaster/pagewriter.h"
 #include "replication/heartbeat.h"
 #include "access/multi_redo_settings.h"
+#include "access/rmgr.h"
 #include "access/redo_statistic_msg.h"
 #include "portability/instr_time.h"
 #include "replication/rto_statistic.h"
@@ -198,6 +200,14 @@ typedef struct knl_g_stat_context {
     volatile uint32 snapshot_thread_counter;
     /* Record the sum of file io stat */
     struct FileIOStat* fileIOStat;
+
+    /* hits and lookups of the per-thread transaction status caches in transam.cpp */
+    pg_atomic_uint64 xactCSNSingleHits;
+    pg_atomic_uint64 xactCSNCacheLookups;
+    pg_atomic_uint64 xactCSNCacheHits;
+    pg_atomic_uint64 xactStatusSingleHits;
+    pg_atomic_uint64 xactStatusCacheLookups;
+    pg_atomic_uint64 xactStatusCacheHits;
 } knl_g_stat_context;
 
 /*
@@ -378,6 +388,52 @@ typedef struct {
     XLogRecPtr local_max_lsn;
 } RedoPerf;
 
+/*
+ * Sampled replay statistics. Each redo thread times one record out of every
+ * REDO_STAT_SAMPLE_INTERVAL records it applies, and adds the latency to the histogram
+ * of the record's resource manager and record type, and to the heat map slot of the
+ * relation of its first block. The startup thread samples the queue depth of every
+ * redo worker about once every REDO_STAT_QUEUE_SAMPLE_MS into a ring.
+ */
+const static uint32 REDO_STAT_SAMPLE_INTERVAL = 64;
+const static uint32 REDO_STAT_RECORD_TYPES = 16;     /* record type is the high 4 bits of xl_info */
+const static uint32 REDO_STAT_LATENCY_BUCKETS = 24;  /* bucket i holds latencies below 2^i us, the last is open */
+const static uint32 REDO_STAT_REL_SLOTS = 1024;
+const static uint32 REDO_STAT_REL_PROBES = 8;
+const static uint32 REDO_STAT_QUEUE_SAMPLES = 60;
+const static uint32 REDO_STAT_QUEUE_SAMPLE_MS = 1000;
+
+typedef struct RedoLatencyBucket {
+    pg_atomic_uint64 count;
+    pg_atomic_uint64 total_us;
+} RedoLatencyBucket;
+
+typedef struct RedoRelHeat {
+    RelFileNode rnode;
+    uint64 count; /* zero if the slot is free */
+    uint64 total_us;
+} RedoRelHeat;
+
+typedef struct RedoQueueSample {
+    TimestampTz sample_time;
+    uint32 worker_num;
+    uint32 depth[MAX_RECOVERY_THREAD_NUM];
+} RedoQueueSample;
+
+typedef struct RedoReplayStat {
+    RedoLatencyBucket latency[RM_MAX_ID + 1][REDO_STAT_RECORD_TYPES][REDO_STAT_LATENCY_BUCKETS];
+
+    slock_t rel_lock; /* protects the fields below up to queue_lock */
+    RedoRelHeat rel_heat[REDO_STAT_REL_SLOTS];
+    uint64 rel_overflow_count; /* samples of relations that found no free slot */
+    uint64 rel_overflow_us;
+
+    slock_t queue_lock; /* protects the fields below */
+    uint32 queue_next;  /* slot the next sample goes to */
+    uint32 queue_num;   /* number of valid samples */
+    RedoQueueSample queue_samples[REDO_STAT_QUEUE_SAMPLES];
+} RedoReplayStat;
+
 
 typedef enum{
     DEFAULT_REDO,
@@ -394,6 +450,7 @@ typedef struct knl_g_parallel_redo_context {
     uint32 totalNum;
     volatile PageRedoWorkerStatus pageRedoThreadStatusList[MAX_RECOVERY_THREAD_NUM];
     RedoPerf redoPf; /* redo Performance statistics */
+    RedoReplayStat replayStat; /* sampled replay latency, relation and queue statistics */
     pg_atomic_uint32 isLocalRedoFinish;
     pg_atomic_uint64 endRecPtr;
 } knl_g_parallel_redo_context;
@@ -352,10 +352,13 @@ typedef struct knl_u_utils_context {
 
     struct DistributeTestParam* distribute_test_param;
 
+    /* pglz history, allocated on first use and released when idle */
     struct PGLZ_HistEntry** hist_start;
 
     struct PGLZ_HistEntry* hist_entries;
 
+    TimestampTz hist_last_used;
+
     char* analysis_options_configure;
 
     int* guc_new_value;
@@ -1108,6 +1111,9 @@ typedef struct knl_u_xact_context {
     char* savePrepareGID;
 
     bool pbe_execute_complete;
+
+    /* end of the last commit record not reported to the client yet, see report_commit_lsn */
+    uint64 lastCommitLSN;
 } knl_u_xact_context;
 
 typedef struct knl_u_plpgsql_context {
@@ -1615,6 +1621,9 @@ typedef struct knl_u_unique_sql_context {
     uint64 unique_sql_soft_parse;
     uint64 unique_sql_hard_parse;
 
+    /* average elapsed time of the unique SQL run last, in us, for the thread pool */
+    int64 last_avg_elapse_time;
+
     /*
      * last_stat_counter - store pgStatTabList's total counter values when
      * 			exit from pgstat_report_stat last time
@@ -2001,6 +2010,10 @@ typedef struct knl_session_context {
     Dlelem elem;
 
     ThreadId attachPid;
+    /* when the thread pool queued it in the long latency class */
+    TimestampTz ready_time;
+    /* handed to a worker of the thread pool only to release its idle state, off the epoll meanwhile */
+    bool release_idle;
 
     MemoryContext top_mem_cxt;
     MemoryContext cache_mem_cxt;
@@ -2080,6 +2093,8 @@ typedef struct knl_session_context {
 extern knl_session_context* create_session_context(MemoryContext parent, uint64 id);
 
 extern void knl_session_init(knl_session_context* sess_cxt);
+extern long knl_session_idle_release_delay(knl_session_context* sess_cxt);
+extern void knl_session_release_idle(knl_session_context* sess_cxt);
 
 extern THR_LOCAL knl_session_context* u_sess;
 
@@ -197,6 +197,24 @@ typedef struct knl_t_xact_context {
     CLogXidStatus cachedFetchXidStatus;
     XLogRecPtr cachedCommitLSN;
 
+    /*
+     * Direct-mapped caches of finished transactions behind the single-item
+     * caches above, allocated on first use. A finished transaction never
+     * changes its status or CSN again, so the entries need no invalidation.
+     */
+    struct XidCSNCacheEntry* csnCache;
+    struct XidStatusCacheEntry* statusCache;
+    /*
+     * hits of the single-item caches, and lookups and hits of the caches
+     * behind them, not yet added to g_instance.stat_cxt
+     */
+    uint32 csnSingleHits;
+    uint32 csnCacheLookups;
+    uint32 csnCacheHits;
+    uint32 statusSingleHits;
+    uint32 statusCacheLookups;
+    uint32 statusCacheHits;
+
     /* var in multixact.cpp */
     struct mXactCacheEnt* MXactCache;
     MemoryContext MXactContext;
@@ -1889,6 +1907,18 @@ typedef struct knl_t_basebackup_context {
     char g_xlog_location[MAXPGPATH];
 
     char* buf_block;
+
+    /* changed blocks by relation fork, only set while sending an incremental base backup */
+    HTAB* incremental_block_hash;
+    /* tablespace of the relation files being sent */
+    Oid incremental_spcnode;
+
+    /* stream history of the compression asked for by BASE_BACKUP, NULL if not compressing */
+    struct WalStreamCompressor* stream_compressor;
+    char* compressed_message;
+    uint32 compressed_message_size;
+    /* the parallel base backup this walsender leads or works for, 0 if none */
+    uint64 parallel_backup_id;
 } knl_t_basebackup_context;
 
 typedef struct knl_t_datarcvwriter_context {
@@ -2039,6 +2069,8 @@ typedef struct knl_t_walreceiver_context {
     bool AmWalReceiverForFailover;
     bool AmWalReceiverForStandby;
     int control_file_writed;
+    /* decompression thread of the compressed WAL stream, NULL until compressed data is received */
+    struct WalRcvDecompressor* decompressor;
 } knl_t_walreceiver_context;
 
 typedef struct knl_t_walsender_context {
@@ -2137,11 +2169,18 @@ typedef struct knl_t_walsender_context {
     struct cbmarray* CheckCUArray;
     struct LogicalDecodingContext* logical_decoding_ctx;
     XLogRecPtr logical_startptr;
+    /* thread reading WAL ahead of logical decoding, NULL if not used */
+    struct LogicalReadAhead* logical_read_ahead;
     int remotePort;
+    /* stream history of the compression negotiated by START_REPLICATION, NULL if not compressing */
+    struct WalStreamCompressor* stream_compressor;
+    char* output_compressed_message;
+    uint32 output_compressed_message_size;
 } knl_t_walsender_context;
 
 typedef struct knl_t_walreceiverfuncs_context {
     struct WalRcvData* WalRcv;
+    struct ReplayWaitData* ReplayWait;
     int WalReplIndex;
 } knl_t_walreceiverfuncs_context;
 
@@ -64,7 +64,10 @@ public:
     ~DllistWithLock();
     void Remove(Dlelem* e);
     void AddTail(Dlelem* e);
+    void AddHead(Dlelem* e);
     Dlelem* RemoveHead();
+    Dlelem* RemoveHeadIf(bool (*cond)(Dlelem* e, void* arg), void* arg);
+    void RemoveAllIf(bool (*cond)(Dlelem* e, void* arg), void* arg, Dllist* removed);
     bool IsEmpty();
 
 private:
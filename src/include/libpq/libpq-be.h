@@ -129,6 +129,7 @@ typedef struct Port {
     char* user_name;
     char* cmdline_options;
     List* guc_options;
+    bool columnar_result; /* client reads vectorized results as columnar batches */
 
     /*
      * Information that needs to be held during the authentication cycle.
@@ -301,6 +301,7 @@ struct pg_conn {
     char* dbName;                  /* database name */
     char* replication;             /* connect as the replication standby? */
     char* backend_version;         /* backend version to be passed to the remote end */
+    char* columnar_result;         /* ask for vectorized results as columnar batches? */
     char* pguser;                  /* Postgres username and password, if any */
     char* pgpass;
     char* keepalives;          /* use TCP keepalives? */
@@ -56,6 +56,8 @@ extern int pq_getmessage(StringInfo s, int maxlen);
 extern int pq_getbyte(void);
 extern int pq_peekbyte(void);
 extern int pq_getbyte_if_available(unsigned char* c);
+extern bool pq_has_buffered_message(void);
+extern bool pq_wait_for_input(long timeout);
 extern int pq_putbytes(const char* s, size_t len);
 extern int pq_flush(void);
 extern int pq_flush_if_writable(void);
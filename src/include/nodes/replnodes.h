@@ -88,6 +88,7 @@ typedef struct StartReplicationCmd {
     ReplicationKind kind;
     char* slotname;
     XLogRecPtr startpoint;
+    char* compression; /* stream compression method, NULL if not compressed */
     List* options;
 } StartReplicationCmd;
 
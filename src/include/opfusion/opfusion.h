@@ -60,6 +60,8 @@ public:
 
     static bool process(int op, StringInfo msg, char* completionTag, bool isTopLevel);
 
+    static unsigned long processBatch(ParamListInfo* params_set, int batch_count, bool isTopLevel);
+
     void CopyFormats(int16* formats, int numRFormats);
 
     void updatePreAllocParamter(StringInfo msg);
@@ -80,6 +82,18 @@ public:
         return;
     }
 
+    /* true if executeBatch can run all the parameter sets of a batch bind-execute at once */
+    virtual bool isBatchable()
+    {
+        return false;
+    }
+
+    virtual unsigned long executeBatch(ParamListInfo* params_set, int batch_count)
+    {
+        Assert(false);
+        return 0;
+    }
+
     void setPreparedDestReceiver(DestReceiver* preparedDest);
 
     Datum CalFuncNodeVal(Oid functionId, List* args, bool* is_null);
@@ -100,6 +114,8 @@ public:
 
     void auditRecord();
 
+    void reportExecution();
+
     static bool isQueryCompleted();
 
     void bindClearPosition();
@@ -185,6 +201,13 @@ public:
 
     bool execute(long max_rows, char* completionTag);
 
+    bool isBatchable()
+    {
+        return true;
+    }
+
+    unsigned long executeBatch(ParamListInfo* params_set, int batch_count);
+
 private:
     void refreshParameterIfNecessary();
 
@@ -208,6 +231,13 @@ public:
 
     bool execute(long max_rows, char* completionTag);
 
+    bool isBatchable()
+    {
+        return true;
+    }
+
+    unsigned long executeBatch(ParamListInfo* params_set, int batch_count);
+
 private:
     class ScanFusion* m_scan;
 
@@ -215,6 +245,8 @@ private:
 
     void refreshTargetParameterIfNecessary();
 
+    unsigned long updateScanTuples(ResultRelInfo* result_rel_info);
+
     EState* m_estate;
 
     /* targetlist */
@@ -246,7 +278,16 @@ public:
 
     bool execute(long max_rows, char* completionTag);
 
+    bool isBatchable()
+    {
+        return true;
+    }
+
+    unsigned long executeBatch(ParamListInfo* params_set, int batch_count);
+
 private:
+    unsigned long deleteScanTuples(ResultRelInfo* result_rel_info);
+
     class ScanFusion* m_scan;
 
     EState* m_estate;
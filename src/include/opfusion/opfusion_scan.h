@@ -50,6 +50,8 @@ public:
 
     virtual void Init(long max_rows) = 0;
 
+    virtual void Rescan(ParamListInfo params) = 0;
+
     virtual HeapTuple getTuple() = 0;
 
     virtual void End(bool isCompleted) = 0;
@@ -88,6 +90,11 @@ public:
 
     virtual void Init(long max_rows) = 0;
 
+    void Rescan(ParamListInfo params);
+
+    /* begin m_scandesc on the open relation and index, with the active snapshot and the current keys */
+    virtual void BeginScan() = 0;
+
     virtual HeapTuple getTuple() = 0;
 
     virtual void End(bool isCompleted) = 0;
@@ -140,6 +147,8 @@ public:
 
     void Init(long max_rows);
 
+    void BeginScan();
+
     HeapTuple getTuple();
 
     void End(bool isCompleted);
@@ -161,6 +170,8 @@ public:
 
     void Init(long max_rows);
 
+    void BeginScan();
+
     HeapTuple getTuple();
 
     void End(bool isCompleted);
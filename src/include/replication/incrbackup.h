@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * incrbackup.h
+ *        On-disk format of the files of an incremental base backup.
+ *
+ * An incremental base backup sends each segment of a relation data file as an incremental
+ * file, which holds only the blocks changed since the start LSN of the previous backup. The
+ * file is named after the segment with INCREMENTAL_FILE_PREFIX prepended, and consists of an
+ * IncrementalFileHeader, the segment-relative numbers of the blocks it holds in ascending
+ * order, and the contents of those blocks.
+ *
+ * IDENTIFICATION
+ *        src/include/replication/incrbackup.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef INCRBACKUP_H
+#define INCRBACKUP_H
+
+#define INCREMENTAL_FILE_PREFIX "INCREMENTAL."
+#define INCREMENTAL_FILE_MAGIC 0xd3ae1f0d
+
+/* written next to backup_label, records the LSN the incremental backup is taken from */
+#define INCREMENTAL_LABEL_FILE "backup_incremental"
+#define INCREMENTAL_LABEL_FORMAT "INCREMENTAL FROM LSN: %X/%X\n"
+
+typedef struct IncrementalFileHeader {
+    uint32 magic;
+    /* number of blocks held by the file */
+    uint32 blockCount;
+    /* unchanged blocks below this are taken from the previous backup, unchanged blocks above are zero */
+    uint32 truncateBlockLength;
+    /* length of the reconstructed segment in blocks */
+    uint32 fileBlockLength;
+} IncrementalFileHeader;
+
+#endif /* INCRBACKUP_H */
@@ -43,6 +43,12 @@ typedef struct LogicalDecodingContext {
      */
     bool fast_forward;
 
+    /*
+     * Does the output plugin support streaming of in-progress transactions?
+     * The plugin may switch it off in its startup callback.
+     */
+    bool streaming;
+
     OutputPluginCallbacks callbacks;
     OutputPluginOptions options;
 
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * logicalreadahead.h
+ *        Reading WAL ahead of logical decoding in a walsender.
+ *
+ * The reader stage of a logical walsender runs in a thread of its own, which reads the
+ * pages following the decoding position into a ring while the walsender decodes and
+ * sends the previous ones. The walsender tells it how far WAL has been flushed.
+ *
+ * IDENTIFICATION
+ *        src/include/replication/logicalreadahead.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef LOGICALREADAHEAD_H
+#define LOGICALREADAHEAD_H
+
+#include "access/xlogdefs.h"
+
+typedef struct LogicalReadAhead LogicalReadAhead;
+
+extern LogicalReadAhead* LogicalReadAheadStart(XLogRecPtr startptr, TimeLineID tli, int npages);
+extern void LogicalReadAheadSetLimit(LogicalReadAhead* readahead, XLogRecPtr limit);
+extern bool LogicalReadAheadGetPage(LogicalReadAhead* readahead, XLogRecPtr pageptr, char* page);
+extern void LogicalReadAheadStop(LogicalReadAhead* readahead);
+
+#endif /* LOGICALREADAHEAD_H */
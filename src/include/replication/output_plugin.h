@@ -63,6 +63,36 @@ typedef void (*LogicalDecodeChangeCB)(
  */
 typedef void (*LogicalDecodeCommitCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
+/*
+ * Called before a block of changes of an in-progress transaction is streamed.
+ */
+typedef void (*LogicalDecodeStreamStartCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+
+/*
+ * Callback for every individual change of a streamed transaction.
+ */
+typedef void (*LogicalDecodeStreamChangeCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+
+/*
+ * Called after a block of changes of an in-progress transaction is streamed.
+ */
+typedef void (*LogicalDecodeStreamStopCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+
+/*
+ * Called when a streamed transaction or subtransaction aborts, the changes
+ * streamed for it have to be discarded.
+ */
+typedef void (*LogicalDecodeStreamAbortCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+
+/*
+ * Called when a streamed transaction commits, after its last changes have
+ * been streamed.
+ */
+typedef void (*LogicalDecodeStreamCommitCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
 /*
  * Called to shutdown an output plugin.
  */
@@ -83,6 +113,12 @@ typedef struct OutputPluginCallbacks {
     LogicalDecodeCommitCB commit_cb;
     LogicalDecodeShutdownCB shutdown_cb;
     LogicalDecodeFilterByOriginCB filter_by_origin_cb;
+    /* streaming of in-progress transactions, either all or none are set */
+    LogicalDecodeStreamStartCB stream_start_cb;
+    LogicalDecodeStreamChangeCB stream_change_cb;
+    LogicalDecodeStreamStopCB stream_stop_cb;
+    LogicalDecodeStreamAbortCB stream_abort_cb;
+    LogicalDecodeStreamCommitCB stream_commit_cb;
 } OutputPluginCallbacks;
 
 extern void OutputPluginPrepareWrite(struct LogicalDecodingContext* ctx, bool last_write);
@@ -69,6 +69,9 @@ typedef struct ReorderBufferChange {
 
     RepOriginId origin_id;
 
+    /* The (sub-)transaction this change belongs to. */
+    struct ReorderBufferTXN* txn;
+
     /*
      * Context data for the change, which part of the union is valid depends
      * on action/action_internal.
@@ -130,6 +133,9 @@ typedef struct ReorderBufferTXN {
 
     TransactionId toplevel_xid;
 
+    /* Toplevel transaction of a known subxact, NULL otherwise */
+    struct ReorderBufferTXN* toptxn;
+
     /*
      * LSN of the first data carrying, WAL record with knowledge about this
      * xid. This is allowed to *not* be first record adorned with this xid, if
@@ -205,6 +211,26 @@ typedef struct ReorderBufferTXN {
      */
     bool serialized;
 
+    /*
+     * Have changes of this transaction been streamed to the output plugin
+     * before its commit? If so, the rest of the transaction is sent through
+     * the stream callbacks as well, see ReorderBufferStreamTXN().
+     */
+    bool streamed;
+
+    /*
+     * Snapshot the changes streamed last were decoded with, NULL if that is
+     * still the base snapshot. We hold a reference on it.
+     */
+    Snapshot stream_snapshot;
+
+    /*
+     * Memory used by the changes kept in memory, by this transaction alone and,
+     * for toplevel transactions, together with its subtransactions.
+     */
+    Size size;
+    Size total_size;
+
     /*
      * List of ReorderBufferChange structs, including new Snapshots and new
      * CommandIds
@@ -267,6 +293,18 @@ typedef void (*ReorderBufferBeginCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
 /* commit callback signature */
 typedef void (*ReorderBufferCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
+/* start of a block of streamed changes callback signature */
+typedef void (*ReorderBufferStreamStartCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr first_lsn);
+
+/* end of a block of streamed changes callback signature */
+typedef void (*ReorderBufferStreamStopCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr last_lsn);
+
+/* abort of a streamed (sub-)transaction callback signature */
+typedef void (*ReorderBufferStreamAbortCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+
+/* commit of a streamed transaction callback signature */
+typedef void (*ReorderBufferStreamCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
 struct ReorderBuffer {
     /*
      * xid => ReorderBufferTXN lookup table
@@ -302,6 +340,17 @@ struct ReorderBuffer {
     ReorderBufferApplyChangeCB apply_change;
     ReorderBufferCommitCB commit;
 
+    /*
+     * Callbacks to be called when changes of large in-progress transactions
+     * are streamed, only used if streaming is set.
+     */
+    bool streaming;
+    ReorderBufferStreamStartCB stream_start;
+    ReorderBufferApplyChangeCB stream_change;
+    ReorderBufferStreamStopCB stream_stop;
+    ReorderBufferStreamAbortCB stream_abort;
+    ReorderBufferStreamCommitCB stream_commit;
+
     /*
      * Pointer that will be passed untouched to the callbacks.
      */
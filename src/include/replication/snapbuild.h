@@ -62,6 +62,7 @@ extern SnapBuild* AllocateSnapshotBuilder(
     struct ReorderBuffer* cache, TransactionId xmin_horizon, XLogRecPtr start_lsn, bool need_full_snapshot);
 extern void FreeSnapshotBuilder(SnapBuild* cache);
 
+extern void SnapBuildSnapIncRefcount(Snapshot snap);
 extern void SnapBuildSnapDecRefcount(Snapshot snap);
 
 extern const char* SnapBuildExportSnapshot(SnapBuild* snapstate);
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * walcompress.h
+ *        Streaming compression of the data sent by walsender.
+ *
+ * Both ends of a compressed replication stream keep the most recent stream data as the
+ * dictionary of the next message, so small messages compress as well as large ones.
+ *
+ * IDENTIFICATION
+ *        src/include/replication/walcompress.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef WALCOMPRESS_H
+#define WALCOMPRESS_H
+
+#include "lz4.h"
+
+/* compression method given to START_REPLICATION ... COMPRESSION */
+#define WAL_STREAM_COMPRESSION_LZ4 "lz4"
+
+/* the size of the stream history, the maximum distance LZ4 can reference */
+#define WAL_STREAM_DICT_SIZE (64 * 1024)
+
+typedef struct WalStreamCompressor {
+    LZ4_stream_t stream;
+    /* copy of the recent input, messages no larger than the dictionary are compressed from here */
+    char ring[2 * WAL_STREAM_DICT_SIZE];
+    int ringPos;
+} WalStreamCompressor;
+
+typedef struct WalStreamDecompressor {
+    /* recent output, the last WAL_STREAM_DICT_SIZE bytes are the dictionary of the next message */
+    char history[2 * WAL_STREAM_DICT_SIZE];
+    int historyLen;
+} WalStreamDecompressor;
+
+extern bool WalStreamCompressionIsSupported(const char* method);
+extern int WalStreamCompressBound(int rawLen);
+extern void WalStreamCompressorReset(WalStreamCompressor* compressor);
+extern int WalStreamCompress(WalStreamCompressor* compressor, const char* src, int srcLen, char* dst, int dstCapacity);
+extern void WalStreamDecompressorReset(WalStreamDecompressor* decompressor);
+extern int WalStreamDecompress(
+    WalStreamDecompressor* decompressor, const char* src, int srcLen, char* dst, int dstCapacity);
+
+#endif /* WALCOMPRESS_H */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * walrcvdecompress.h
+ *        Decompressing the WAL stream of a walreceiver in a thread of its own.
+ *
+ * The walreceiver queues the compressed messages as it receives them and takes the
+ * decompressed ones back in the same order, so it keeps reading the socket while the
+ * previous messages are decompressed.
+ *
+ * IDENTIFICATION
+ *        src/include/replication/walrcvdecompress.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef WALRCVDECOMPRESS_H
+#define WALRCVDECOMPRESS_H
+
+#include "access/xlogdefs.h"
+
+typedef struct WalRcvDecompressor WalRcvDecompressor;
+
+extern WalRcvDecompressor* WalRcvDecompressorStart(void);
+extern bool WalRcvDecompressorPush(
+    WalRcvDecompressor* decompressor, XLogRecPtr dataStart, const char* buf, uint32 len, uint32 rawLen);
+extern bool WalRcvDecompressorPop(
+    WalRcvDecompressor* decompressor, bool wait, XLogRecPtr* dataStart, char** data, int* dataLen);
+extern void WalRcvDecompressorStop(WalRcvDecompressor* decompressor);
+
+#endif /* WALRCVDECOMPRESS_H */
@@ -184,6 +184,18 @@ typedef struct WalRcvData {
     slock_t mutex; /* locks shared variables shown above */
 } WalRcvData;
 
+/*
+ * Sessions on a hot standby waiting for WAL to be replayed up to some location, see
+ * standby_read_lsn. waitLSN is indexed by pgprocno and is InvalidXLogRecPtr for a
+ * backend that doesn't wait. No backend waits for less than minWaitLSN, which lets
+ * the replaying thread skip the array almost always.
+ */
+typedef struct ReplayWaitData {
+    pg_atomic_uint64 minWaitLSN;
+    slock_t mutex; /* protects waitLSN and the update of minWaitLSN */
+    XLogRecPtr waitLSN[FLEXIBLE_ARRAY_MEMBER];
+} ReplayWaitData;
+
 extern XLogRecPtr latestValidRecord;
 
 extern bool ws_dummy_data_writer_use_file;
@@ -201,6 +213,11 @@ extern void WSDataRcvCheck(char* data_buf, Size nbytes);
 /* prototypes for functions in walreceiverfuncs.c */
 extern Size WalRcvShmemSize(void);
 extern void WalRcvShmemInit(void);
+extern Size ReplayWaitShmemSize(void);
+extern void ReplayWaitShmemInit(void);
+extern bool WaitForReplayLSN(XLogRecPtr lsn, int timeout_ms);
+extern void WakeupReplayWaiters(XLogRecPtr replayed);
+extern void StandbyWaitForReadLSN(void);
 extern void ShutdownWalRcv(void);
 extern bool WalRcvInProgress(void);
 extern void connect_dn_str(char* conninfo, int replIndex);
@@ -193,6 +193,7 @@ struct WritebackContext;
  * prototypes for functions in bufmgr.c
  */
 extern void PrefetchBuffer(Relation reln, ForkNumber forkNum, BlockNumber blockNum);
+extern bool PrefetchSharedBuffer(struct SMgrRelationData* smgr, ForkNumber forkNum, BlockNumber blockNum);
 extern void PageRangePrefetch(
     Relation reln, ForkNumber forkNum, BlockNumber blockNum, int32 n, uint32 flags, uint32 col);
 extern void PageListPrefetch(
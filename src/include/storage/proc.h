@@ -212,6 +212,11 @@ struct PGPROC {
                                              * transaction id of clog group member */
     XLogRecPtr clogGroupMemberLsn;          /* WAL location of commit record for clog
                                              * group member */
+
+    /* global plan cache epoch this proc is reading the lookup lists under, 0 if none */
+    volatile uint64 gpcEpoch;
+    /* global plan cache lookups of this proc per bucket, NULL until its first lookup */
+    struct GPCProcLookupStat* volatile gpcLookupStat;
 #ifdef __aarch64__
     /* Support for group xlog insert. */
     bool xlogGroupMember;
@@ -65,6 +65,8 @@ public:
     void ShutDownWorker(bool forceWait = false);
     int DispatchSession(Port* port);
     void AddWorkerIfNecessary();
+    void LendWaitingSession(ThreadPoolGroup* victim);
+    ThreadPoolGroup* FindOverloadedGroup(ThreadPoolGroup* thief);
     void SetThreadPoolInfo();
     int GetThreadNum();
     ThreadPoolStat* GetThreadPoolStat(uint32* num);
@@ -73,6 +75,7 @@ public:
     void CloseAllSessions();
     bool CheckNumaDistribute(int numaNodeNum) const;
     CPUBindType GetCpuBindType() const;
+    void SetListenSockets(const pgsocket* sockets, int num);
 
     inline ThreadPoolSessControl* GetSessionCtrl()
     {
@@ -84,6 +87,12 @@ public:
         return m_groupNum;
     }
 
+    inline int GetListenSockets(const pgsocket** sockets)
+    {
+        *sockets = m_listenSockets;
+        return m_listenSocketNum;
+    }
+
     void BindThreadToAllAvailCpu(ThreadId thread) const;
 
 private:
@@ -111,6 +120,8 @@ private:
     int m_groupNum;
     int m_threadNum;
     int m_maxPoolSize;
+    pgsocket m_listenSockets[MAXLISTEN]; /* client sockets of the postmaster, for thread_pool_reuseport */
+    int m_listenSocketNum;
 };
 
 #endif /* THREAD_POOL_CONTROLER_H */
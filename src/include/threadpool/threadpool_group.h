@@ -33,6 +33,31 @@
 #define NUM_THREADPOOL_STATUS_ELEM 7
 #define STATUS_INFO_SIZE 256
 
+/*
+ * Work stealing between groups: once this many sessions wait in a group, idle workers of
+ * other groups take them, until none are left waiting. Workers on another NUMA node only
+ * help when THREAD_STEAL_NUMA_PENALTY more sessions wait, as the session memory is remote.
+ */
+#define THREAD_STEAL_HIGH_WATERMARK 2
+#define THREAD_STEAL_LOW_WATERMARK 0
+#define THREAD_STEAL_NUMA_PENALTY 4
+
+/*
+ * Latency classes: a session whose statements take THREAD_LONG_LATENCY_US or more on
+ * average waits behind the short ones, and may not take the last idle workers, one in
+ * THREAD_SHORT_RESERVE_RATIO of the group. Once it has waited THREAD_LONG_MAX_WAIT_MS it
+ * is served ahead of them.
+ */
+#define THREAD_LONG_LATENCY_US 100000
+#define THREAD_SHORT_RESERVE_RATIO 8
+#define THREAD_LONG_MAX_WAIT_MS 1000
+
+/* how often the listener hands the sessions it holds to idle workers to release their idle state */
+#define THREAD_IDLE_RELEASE_CHECK_MS 10000
+
+/* values of session_latency_class */
+typedef enum { LATENCY_CLASS_AUTO = 0, LATENCY_CLASS_SHORT, LATENCY_CLASS_LONG } SessionLatencyClass;
+
 typedef enum { WORKER_SLOT_UNUSE = 0, WORKER_SLOT_INUSE } WorkerSlotStatus;
 
 typedef struct WorkerStatus {
@@ -76,6 +101,7 @@ public:
     float4 GetSessionPerThread();
     void GetThreadPoolGroupStat(ThreadPoolStat* stat);
     bool IsGroupHang();
+    bool IsOverloaded();
 
     inline ThreadPoolListener* GetListener()
     {
@@ -102,6 +128,21 @@ public:
         return (m_workerNum <= 0);
     }
 
+    inline int GetIdleWorkerNum()
+    {
+        return m_idleWorkerNum;
+    }
+
+    inline int GetWaitServeSessionCount()
+    {
+        return m_waitServeSessionCount;
+    }
+
+    inline int GetShortReservedWorkerNum()
+    {
+        return m_expectWorkerNum / THREAD_SHORT_RESERVE_RATIO;
+    }
+
     friend class ThreadPoolWorker;
     friend class ThreadPoolListener;
     friend class ThreadPoolScheduler;
@@ -126,7 +167,11 @@ private:
     volatile int m_pendingWorkerNum;
     volatile int m_sessionCount;           // all session count;
     volatile int m_waitServeSessionCount;  // wait for worker to server
+    volatile int m_waitLongSessionCount;   // of which in the long latency class
     volatile int m_processTaskCount;
+    volatile uint32 m_stealInCount;   // sessions of other groups served by our workers
+    volatile uint32 m_stealOutCount;  // sessions of ours served by workers of other groups
+    volatile uint32 m_overloaded;     // sessions may be stolen, see IsOverloaded()
 
     int m_groupId;
     int m_numaId;
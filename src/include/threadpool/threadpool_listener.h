@@ -42,6 +42,8 @@ public:
     void CreateEpoll();
     void NotifyReady();
     bool TryFeedWorker(ThreadPoolWorker* worker);
+    bool WakeUpWorkerToSteal(ThreadPoolGroup* victim);
+    knl_session_context* StealSession();
     void AddNewSession(knl_session_context* session);
     void WaitTask();
     void DelSessionFromEpoll(knl_session_context* session);
@@ -49,6 +51,7 @@ public:
     void AddEpoll(knl_session_context* session);
     void SendShutDown();
     void ReaperAllSession();
+    void ServeAgedSessions();
 
     inline ThreadPoolGroup* GetGroup()
     {
@@ -57,16 +60,26 @@ public:
 
 private:
     void HandleConnEvent(int nevets);
+    void CreateAcceptSockets();
+    void AcceptSession(pgsocket sock);
     knl_session_context* GetSessionBaseOnEvent(struct epoll_event* ev);
     void DispatchSession(knl_session_context* session);
+    bool HandToFreeWorker(knl_session_context* session);
+    void ReadySession(knl_session_context* session, bool isLong);
+    knl_session_context* GetReadySession(bool takeLong);
+    void ReleaseIdleSessions();
 
 private:
     ThreadId m_tid;
     int m_epollFd;
     struct epoll_event* m_epollEvents;
+    pgsocket m_acceptSockets[MAXLISTEN]; /* our own client sockets with thread_pool_reuseport */
+    int m_acceptSocketNum;
+    TimestampTz m_lastIdleRelease;
 
     DllistWithLock* m_freeWorkerList;
-    DllistWithLock* m_readySessionList;
+    DllistWithLock* m_readySessionList;     /* short latency class */
+    DllistWithLock* m_longSessionList;      /* long latency class */
     DllistWithLock* m_idleSessionList;
 };
 
@@ -117,7 +117,7 @@ private:
 
 private:
     /* session id generate */
-    uint64 m_sessionId;
+    volatile uint64 m_sessionId;
     /* current session count. */
     volatile int m_activeSessionCount;
     /* max session count we can accept. */
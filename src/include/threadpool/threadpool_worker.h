@@ -88,6 +88,8 @@ public:
     void CleanUpSessionWithLock();
     bool WakeUpToWork(knl_session_context* session);
     void WakeUpToUpdate(ThreadStatus status);
+    bool WakeUpToSteal(ThreadPoolGroup* victim);
+    bool StealSessionFrom(ThreadPoolGroup* victim);
 
     friend class ThreadPoolListener;
 
@@ -139,6 +141,8 @@ private:
     ThreadStayReason m_reason;
     Dlelem m_elem;
     ThreadPoolGroup* m_group;
+    ThreadPoolGroup* m_sessionGroup; /* group the current session belongs to */
+    ThreadPoolGroup* m_stealFrom;    /* overloaded group to take a session from */
     pthread_mutex_t* m_mutex;
     pthread_cond_t* m_cond;
 };
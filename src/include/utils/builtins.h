@@ -1406,6 +1406,8 @@ extern Datum pg_pool_ping(PG_FUNCTION_ARGS);
 extern Datum pgxc_is_committed(PG_FUNCTION_ARGS);
 extern Datum pgxc_get_csn(PG_FUNCTION_ARGS);
 #endif
+extern Datum gs_xact_status_cache_stat(PG_FUNCTION_ARGS);
+extern Datum gs_redo_stat(PG_FUNCTION_ARGS);
 
 /*adapt a's empty_blob*/
 extern Datum get_empty_blob(PG_FUNCTION_ARGS);
@@ -74,6 +74,8 @@ typedef struct GPCPreparedStatement
                                     * linked list instead of HTAB */
 } GPCPreparedStatement;
 
+struct GPCLookupNode;
+
 typedef struct GPCBucketInfo
 {
     int64    bucket_size;
@@ -83,8 +85,31 @@ typedef struct GPCBucketInfo
     MemoryContext context;
     uint32     curr_hash_code;
     uint32    curr_cache_votes;
+    /* shared plans of the bucket for lock-free PlanFetch, changed under the bucket X-lock */
+    struct GPCLookupNode* volatile lookup_head;
 } GPCBucketInfo;
 
+/*
+ * Per bucket writer lock waits, kept apart from GPCBucketInfo so that bumping
+ * them does not bounce the cache line holding lookup_head.
+ */
+typedef struct GPCBucketStat
+{
+    volatile uint64 lock_waits;
+    char padding[PG_CACHE_LINE_SIZE - sizeof(uint64)];
+} GPCBucketStat;
+
+/*
+ * Per bucket lookups of one proc. Only the proc itself bumps them, so PlanFetch
+ * writes no shared cache line; plancache_status() sums them over all procs.
+ * Allocated on the first lookup of the proc and kept with the PGPROC after.
+ */
+typedef struct GPCProcLookupStat
+{
+    uint64 hits[GPC_NUM_OF_BUCKETS];
+    uint64 misses[GPC_NUM_OF_BUCKETS];
+} GPCProcLookupStat;
+
 typedef struct GPCKey
 {
     uint32        query_length;
@@ -176,6 +201,25 @@ typedef struct GPCEnv
     int dateorder;
 } GPCEnv;
 
+/*
+ * Lookup node published for a shared GPCEnv. Readers walk the bucket's list
+ * without any lock, so a node unlinked by a writer is only freed, together
+ * with its env if drop_env is set, once no proc is still reading under an
+ * epoch older than retire_epoch.
+ */
+typedef struct GPCLookupNode
+{
+    struct GPCLookupNode* volatile next;
+    uint64 fingerprint;        /* hash of the query and the compilation environment */
+    GPCEnv *env;
+    int num_params;
+    uint32 query_length;
+    uint64 retire_epoch;
+    struct GPCLookupNode *retire_next;
+    bool drop_env;
+    char query_string[FLEXIBLE_ARRAY_MEMBER];
+} GPCLookupNode;
+
 typedef struct GPCStatus
 {
     char *query;
@@ -185,6 +229,10 @@ typedef struct GPCStatus
     Oid DatabaseID;
     char *schema_name;
     int params_num;
+    int bucket_id;          /* -1 for a plansource no longer in the cache */
+    int64 bucket_hits;
+    int64 bucket_misses;
+    int64 bucket_lock_waits;
 } GPCStatus;
 
 typedef struct GPCPrepareStatus
@@ -207,7 +255,7 @@ public:
     /* global plan cache htab control */
     void PlanInit();
     void PlanStore(CachedPlanSource *plansource);
-    GPCEnv* PlanFetch(const char *query_string, uint32 query_len, int num_params);
+    CachedPlanSource* PlanFetch(const char *query_string, uint32 query_len, int num_params);
     void InvalidPlanDrop();
     void PlanDrop(GPCEnv *cachedenv);
     Datum PlanClean();
@@ -243,9 +291,21 @@ public:
     void SendPrepareDestoryMsg();
 
 private:
+    void BucketLockAcquire(uint32 bucket, LWLockMode mode);
+    GPCProcLookupStat* ProcLookupStat();
+
+    /* lock-free lookup lists */
+    void LookupPublish(CachedPlanSource *plansource, uint32 bucket);
+    GPCLookupNode* LookupUnlink(GPCEnv *env, uint32 bucket);
+    void LookupRetire(GPCLookupNode *node);
+    void LookupReclaim();
+    uint64 OldestReadingEpoch();
 
     HTAB* m_global_plan_cache;
     struct GPCBucketInfo *m_gpc_bucket_info_array;
+    struct GPCBucketStat *m_gpc_bucket_stat_array;
+    volatile uint64 m_gpc_epoch;
+    GPCLookupNode *m_gpc_retired_nodes; /* protected by GPCClearLock */
     DList *m_gpc_invalid_plansource;
 
     HTAB* m_global_prepared;
@@ -255,6 +315,7 @@ private:
 
 extern GlobalPlanCache *GPC;
 extern uint64 generate_global_sessid(uint64 local_id);
+extern uint32 GPCHashFunc(const void *key, Size keysize);
 
 extern Datum GPCPlanClean(PG_FUNCTION_ARGS);
 
@@ -65,6 +65,8 @@ typedef struct GPCSource
     int refcount;
 
     bool in_revalidate;
+
+    uint64 retire_epoch; /* global plan cache epoch it was dropped at, see PlanDrop */
 } GPCSource;
 
 /*
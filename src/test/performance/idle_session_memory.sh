@@ -0,0 +1,66 @@
+#!/bin/bash
+#
+# Measures the session memory held by idle sessions, as a connection pool keeps them.
+#
+# N sessions each compress a value with pglz and then wait for their client. The
+# memory of all sessions is summed from gs_session_memory_detail before they connect,
+# while they are freshly idle, and once they have been idle long enough for their
+# idle state to be released (SESSION_IDLE_RELEASE_TIME plus one round of the thread
+# pool listener). The difference divided by N is the memory per idle session. Then
+# every session compresses again, which checks that the sessions are still served
+# after the release and allocate their state anew.
+#
+# usage: idle_session_memory.sh [-p port] [-d dbname] [-n sessions] [-w seconds]
+#
+# gsql is taken from PATH. Works with and without enable_thread_pool.
+
+set -e
+
+PORT=5432
+DBNAME=postgres
+SESSIONS=100
+WAIT=75
+
+while getopts "p:d:n:w:" opt; do
+    case $opt in
+        p) PORT=$OPTARG ;;
+        d) DBNAME=$OPTARG ;;
+        n) SESSIONS=$OPTARG ;;
+        w) WAIT=$OPTARG ;;
+        *) echo "usage: $0 [-p port] [-d dbname] [-n sessions] [-w seconds]"; exit 1 ;;
+    esac
+done
+
+# session_bytes: total bytes of the session memory contexts of all sessions
+session_bytes()
+{
+    gsql -p "$PORT" -d "$DBNAME" -t -A -c "SELECT sum(totalsize) FROM gs_session_memory_detail"
+}
+
+gsql -p "$PORT" -d "$DBNAME" -q -c "DROP TABLE IF EXISTS idle_session_memory; CREATE TABLE idle_session_memory (v text)"
+
+base=$(session_bytes)
+
+# each client compresses a value, holds its session open without sending anything,
+# and compresses again once its idle state has been released
+INSERT="INSERT INTO idle_session_memory SELECT repeat('idle session memory', 1000);"
+for i in $(seq 1 "$SESSIONS"); do
+    (echo "$INSERT"; sleep $((WAIT + 10)); echo "$INSERT") | gsql -p "$PORT" -d "$DBNAME" -q > /dev/null &
+done
+sleep 5
+busy=$(session_bytes)
+
+sleep "$WAIT"
+idle=$(session_bytes)
+
+wait
+rows=$(gsql -p "$PORT" -d "$DBNAME" -t -A -c "SELECT count(*) FROM idle_session_memory")
+gsql -p "$PORT" -d "$DBNAME" -q -c "DROP TABLE idle_session_memory"
+if [ "$rows" -ne $((SESSIONS * 2)) ]; then
+    echo "$0: $rows rows inserted, expected $((SESSIONS * 2)): sessions were lost after their idle state was released"
+    exit 1
+fi
+
+printf "%-40s %12s\n" "$SESSIONS idle sessions" "bytes/session"
+printf "%-40s %12d\n" "just idle" $(((busy - base) / SESSIONS))
+printf "%-40s %12d\n" "idle for ${WAIT}s" $(((idle - base) / SESSIONS))
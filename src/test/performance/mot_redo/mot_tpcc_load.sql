@@ -0,0 +1,30 @@
+-- TPC-C style schema in MOT tables for the redo handler benchmark.
+-- Run with: gsql -v warehouses=<N> -f mot_tpcc_load.sql
+DROP FOREIGN TABLE IF EXISTS mot_order_line;
+DROP FOREIGN TABLE IF EXISTS mot_new_order;
+DROP FOREIGN TABLE IF EXISTS mot_orders;
+DROP FOREIGN TABLE IF EXISTS mot_stock;
+DROP FOREIGN TABLE IF EXISTS mot_customer;
+DROP FOREIGN TABLE IF EXISTS mot_district;
+DROP FOREIGN TABLE IF EXISTS mot_warehouse;
+
+CREATE FOREIGN TABLE mot_warehouse (w_id int NOT NULL, w_ytd float8, PRIMARY KEY (w_id));
+CREATE FOREIGN TABLE mot_district (d_w_id int NOT NULL, d_id int NOT NULL, d_next_o_id int, d_ytd float8,
+    PRIMARY KEY (d_w_id, d_id));
+CREATE FOREIGN TABLE mot_customer (c_w_id int NOT NULL, c_d_id int NOT NULL, c_id int NOT NULL, c_balance float8,
+    c_ytd_payment float8, c_payment_cnt int, PRIMARY KEY (c_w_id, c_d_id, c_id));
+CREATE FOREIGN TABLE mot_stock (s_w_id int NOT NULL, s_i_id int NOT NULL, s_quantity int, s_ytd int,
+    s_order_cnt int, PRIMARY KEY (s_w_id, s_i_id));
+CREATE FOREIGN TABLE mot_orders (o_w_id int NOT NULL, o_d_id int NOT NULL, o_id int NOT NULL, o_c_id int,
+    o_ol_cnt int, o_entry_d timestamp, PRIMARY KEY (o_w_id, o_d_id, o_id));
+CREATE FOREIGN TABLE mot_new_order (no_w_id int NOT NULL, no_d_id int NOT NULL, no_o_id int NOT NULL,
+    PRIMARY KEY (no_w_id, no_d_id, no_o_id));
+CREATE FOREIGN TABLE mot_order_line (ol_w_id int NOT NULL, ol_d_id int NOT NULL, ol_o_id int NOT NULL,
+    ol_number int NOT NULL, ol_i_id int, ol_quantity int, ol_amount float8,
+    PRIMARY KEY (ol_w_id, ol_d_id, ol_o_id, ol_number));
+
+INSERT INTO mot_warehouse SELECT w, 300000 FROM generate_series(1, :warehouses) w;
+INSERT INTO mot_district SELECT w, d, 3001, 30000 FROM generate_series(1, :warehouses) w, generate_series(1, 10) d;
+INSERT INTO mot_customer SELECT w, d, c, -10, 10, 1
+    FROM generate_series(1, :warehouses) w, generate_series(1, 10) d, generate_series(1, 3000) c;
+INSERT INTO mot_stock SELECT w, i, 50, 0, 0 FROM generate_series(1, :warehouses) w, generate_series(1, 100000) i;
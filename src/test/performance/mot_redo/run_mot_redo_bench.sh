@@ -0,0 +1,84 @@
+#!/bin/bash
+#
+# Compares the MOT redo log handlers under a TPC-C style New-Order/Payment mix.
+#
+# For every handler the instance is restarted with the matching mot.conf and
+# synchronous_commit settings, the MOT tables are reloaded, and one pgbench
+# client per warehouse runs for the given duration. Each client works on its
+# own warehouse, so the clients do not abort each other's transactions.
+#
+# usage: run_mot_redo_bench.sh -D datadir [-p port] [-d dbname] [-c clients] [-T seconds] [-l lanes]
+#
+# gs_ctl, gs_guc, gsql and pgbench are taken from PATH.
+
+set -e
+
+DATADIR=""
+PORT=5432
+DBNAME=postgres
+CLIENTS=16
+DURATION=60
+LANES=4
+SCRIPTDIR=$(cd "$(dirname "$0")" && pwd)
+
+while getopts "D:p:d:c:T:l:" opt; do
+    case $opt in
+        D) DATADIR=$OPTARG ;;
+        p) PORT=$OPTARG ;;
+        d) DBNAME=$OPTARG ;;
+        c) CLIENTS=$OPTARG ;;
+        T) DURATION=$OPTARG ;;
+        l) LANES=$OPTARG ;;
+        *) echo "usage: $0 -D datadir [-p port] [-d dbname] [-c clients] [-T seconds] [-l lanes]"; exit 1 ;;
+    esac
+done
+
+if [ -z "$DATADIR" ]; then
+    echo "$0: no data directory given"
+    exit 1
+fi
+
+# set_mot_option <name> <value>: replaces any active setting of name in mot.conf
+set_mot_option()
+{
+    sed -i "/^[[:space:]]*$1[[:space:]]*=/d" "$DATADIR/mot.conf"
+    echo "$1 = $2" >> "$DATADIR/mot.conf"
+}
+
+# run_handler <label> <synchronous_commit> <enable_group_commit> <group_commit_lanes> <enable_adaptive_group_commit>
+run_handler()
+{
+    gs_ctl stop -D "$DATADIR" -m fast > /dev/null 2>&1 || true
+    gs_guc set -D "$DATADIR" -c "synchronous_commit=$2" > /dev/null
+    set_mot_option enable_group_commit "$3"
+    set_mot_option group_commit_lanes "$4"
+    set_mot_option enable_adaptive_group_commit "$5"
+    gs_ctl start -D "$DATADIR" -o "-p $PORT" > /dev/null
+
+    gsql -p "$PORT" -d "$DBNAME" -q -v warehouses="$CLIENTS" -f "$SCRIPTDIR/mot_tpcc_load.sql" > /dev/null
+
+    local outdir
+    outdir=$(mktemp -d)
+    for w in $(seq 1 "$CLIENTS"); do
+        pgbench -p "$PORT" -n -M prepared -c 1 -T "$DURATION" -D w_id="$w" \
+            -f "$SCRIPTDIR/mot_new_order.pgbench" -f "$SCRIPTDIR/mot_payment.pgbench" "$DBNAME" \
+            > "$outdir/$w.out" 2>&1 &
+    done
+    wait
+
+    # the clients run concurrently, so their rates add up
+    local tps
+    tps=$(grep -h "excluding connections" "$outdir"/*.out | awk '{ sum += $3 } END { printf "%.0f", sum }')
+    rm -rf "$outdir"
+    printf "%-40s %12s\n" "$1" "$tps"
+}
+
+printf "%-40s %12s\n" "handler ($CLIENTS clients, ${DURATION}s)" "tps"
+run_handler "synchronous" on false 1 false
+run_handler "segmented_group_synchronous" on true 1 false
+run_handler "parallel_group_synchronous ($LANES lanes)" on true "$LANES" false
+run_handler "parallel_group_synchronous (adaptive)" on true 1 true
+run_handler "parallel_group_synchronous ($LANES lanes, adaptive)" on true "$LANES" true
+run_handler "asynchronous" off false 1 false
+
+gs_ctl stop -D "$DATADIR" -m fast > /dev/null
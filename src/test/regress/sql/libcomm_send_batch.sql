@@ -0,0 +1,26 @@
+--
+-- the streams of a query that send to the same datanode queue their messages on
+-- its data connection, and whoever sends next takes all of them in one batch.
+-- Between datanodes of one host the batches go through the shared memory rings,
+-- run with comm_shm_mode = off to send them with sendmsg on one host as well.
+--
+create schema libcomm_send_batch;
+set current_schema = libcomm_send_batch;
+set enable_broadcast = off;
+
+create table batch_t (a int, b int, c int, d text) distribute by hash(a);
+insert into batch_t select g, g, 100001 - g, repeat('y', 200) || g from generate_series(1, 100000) g;
+analyze batch_t;
+
+-- three redistributions of small rows run at the same time and send to every datanode
+select count(*), sum(x.a::bigint) as x, sum(y.a::bigint) as y, sum(z.a::bigint) as z
+from batch_t x join batch_t y on x.b = y.c join batch_t z on y.b = z.c;
+
+-- wide rows fill the socket buffers, so batches are sent in parts
+select count(*), sum(length(x.d)) as x, sum(length(y.d)) as y
+from batch_t x join batch_t y on x.b = y.c where x.d <> y.d;
+
+drop table batch_t;
+reset enable_broadcast;
+reset current_schema;
+drop schema libcomm_send_batch;
@@ -0,0 +1,29 @@
+--
+-- libcomm data connections between the datanodes of this host move their
+-- messages through shared memory rings, with the tcp socket as doorbell
+--
+create schema libcomm_shm_ring;
+set current_schema = libcomm_shm_ring;
+
+create table shm_from (a int, b int, c text) distribute by hash(a);
+create table shm_to (a int, b int, c text) distribute by hash(b);
+insert into shm_from select g, g % 1000, repeat('x', 200) || g from generate_series(1, 200000) g;
+
+-- each insert redistributes about 40MB, so the rings of all pairs of datanodes
+-- wrap around over the three of them
+insert into shm_to select * from shm_from;
+insert into shm_to select * from shm_from;
+insert into shm_to select * from shm_from;
+
+select count(*) as rows, sum(length(c)) as bytes, sum(a::bigint) as a, sum(b::bigint) as b from shm_to;
+
+-- every row arrived three times and intact
+select count(*) from (select a, b, c, count(*) as n from shm_to group by a, b, c) t join shm_from using (a, b, c) where n = 3;
+
+-- the receivers unlink the rings as soon as they have mapped them
+\! ls /dev/shm | grep -c '^gs_libcomm_'
+
+drop table shm_to;
+drop table shm_from;
+reset current_schema;
+drop schema libcomm_shm_ring;
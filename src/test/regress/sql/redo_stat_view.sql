@@ -0,0 +1,25 @@
+--
+-- sampled replay statistics views
+--
+-- the content depends on what was replayed at startup, so only check the shape
+-- of the views and the invariants every row must satisfy
+\d gs_redo_record_latency
+\d gs_redo_relation_heat
+\d gs_redo_worker_queue
+
+select count(*) from pg_catalog.gs_redo_stat()
+    where stat_type not in ('record_latency', 'relation_heat', 'worker_queue');
+
+-- histogram buckets are powers of two (or the open-ended last bucket) and never empty
+select count(*) from gs_redo_record_latency
+    where sampled_count <= 0 or total_us < 0 or rmgr is null or record_type is null
+       or (bucket_us is not null and (bucket_us <= 0 or (bucket_us & (bucket_us - 1)) <> 0));
+
+select count(*) from gs_redo_relation_heat
+    where sampled_count <= 0 or total_us < 0 or relfilenode is null;
+
+select count(*) from gs_redo_worker_queue
+    where worker_id < 0 or queue_depth < 0 or sample_time is null;
+
+-- the views are read only
+insert into gs_redo_worker_queue values (0, now(), 0);
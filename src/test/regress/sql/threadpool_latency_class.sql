@@ -0,0 +1,31 @@
+--
+-- latency classes of the thread pool scheduler
+--
+show session_latency_class;
+set session_latency_class = long;
+show session_latency_class;
+set session_latency_class = short;
+show session_latency_class;
+set session_latency_class = medium;
+reset session_latency_class;
+show session_latency_class;
+
+-- the class can be set per user
+create user latency_class_user password 'ttest@123';
+alter user latency_class_user set session_latency_class = long;
+select rolname, rolconfig from pg_roles where rolname = 'latency_class_user';
+alter user latency_class_user reset session_latency_class;
+select rolname, rolconfig from pg_roles where rolname = 'latency_class_user';
+drop user latency_class_user;
+
+-- a statement of the session runs whatever its class
+set session_latency_class = long;
+select count(*) from generate_series(1, 1000);
+set session_latency_class = short;
+select count(*) from generate_series(1, 1000);
+reset session_latency_class;
+
+-- every group reports how many of its waiting sessions are in the long class
+select count(*) > 0 from DBE_PERF.local_threadpool_status;
+select count(*) from DBE_PERF.local_threadpool_status
+    where session_info !~ '^total: [0-9]+ waiting: [0-9]+ \(long: [0-9]+\) running:[0-9]+ idle: [0-9]+ ';